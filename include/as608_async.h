@@ -0,0 +1,352 @@
+/**
+ * @file as608_async.h
+ * @brief Driver não bloqueante do protocolo de pacotes do AS608 (UART)
+ * @version 1.3.0
+ * @date 2025-12-07
+ *
+ * A Adafruit_Fingerprint faz cada comando como pedido/resposta síncrono a
+ * 57600 bps: verifyFinger() encadeava GenImg → Img2Tz → HighSpeedSearch no
+ * loop, parando LVGL/touch/RFID durante toda a troca (dezenas a centenas de ms).
+ *
+ * Aqui o pacote de resposta é montado byte a byte no callback onReceive()
+ * do HardwareSerial (tarefa de eventos da UART do core). O chamador só
+ * envia o comando e chama poll() no loop: resultado e timeout chegam por
+ * callback, sempre no contexto de quem chama poll() (seguro para LVGL).
+ *
+ *   Pacote: EF 01 | endereço(4) | PID | tamanho(2) | payload | soma(2)
+ *   PID 0x01 = comando, 0x07 = ACK (payload[0] = código de confirmação)
+ *
+ * Transferência de templates (v1.1): UpChar/DownChar trocam o modelo em
+ * pacotes de dados (PID 0x02, último 0x08) logo após o ACK. upload() e
+ * download() escrevem os comandos e os pacotes de uma vez (sem esperar
+ * cada ACK) e recolhem as respostas em sequência. Com pipelined = false
+ * cada comando só é escrito após o ACK do anterior (recuperação quando o
+ * sensor perde bytes com a escrita contínua).
+ *
+ * Match 1:1 (v1.2): com cartão + digital o cartão já diz qual slot
+ * conferir; startMatch() troca a busca por LoadChar(2, slot) + Match
+ * (CharBuffer1 x CharBuffer2), uma comparação no lugar da biblioteca toda.
+ *
+ * Respostas atrasadas (v1.3): o ACK de um comando que deu timeout pode
+ * chegar depois e seria lido como resposta do comando seguinte. Após um
+ * timeout, bytes recebidos durante AS608_ASYNC_LATE_MS são descartados e o
+ * próximo comando só é escrito na UART quando essa janela fecha (fica em
+ * txBuf; send() continua retornando na hora). Além disso cada ACK é
+ * conferido pelo tamanho esperado para o comando armado.
+ *
+ * Um comando em andamento por vez. A Adafruit_Fingerprint continua sendo
+ * usada para o resto (cadastro, parâmetros): enquanto nada está em
+ * andamento o callback não consome bytes da UART, e quem for usar a API
+ * síncrona chama cancel() + waitIdle() antes.
+ */
+
+#ifndef AS608_ASYNC_H
+#define AS608_ASYNC_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+#define AS608_ASYNC_MAX_PAYLOAD     32      // ACKs de comando (dados de imagem não passam aqui)
+#define AS608_ASYNC_MAX_DATA        256     // Maior pacote de dados (packet_len 256)
+#define AS608_TEMPLATE_MAX          768     // Maior arquivo de característica (AS608: 512)
+#define AS608_ASYNC_CMD_TIMEOUT_MS  1000    // Igual ao DEFAULTTIMEOUT da Adafruit_Fingerprint
+#define AS608_ASYNC_SEARCH_TIMEOUT_MS 2000  // Busca 1:N em banco cheio
+#define AS608_ASYNC_LATE_MS         200     // Após timeout: janela de descarte de ACK atrasado
+#define AS608_ASYNC_TX_DEFER        1100    // Maior escrita adiada (DownChar + 768 B em pacotes de 32 + Store)
+
+// Comandos usados pelo pipeline de verificação
+#define AS608_CMD_GENIMG            0x01
+#define AS608_CMD_IMG2TZ            0x02
+#define AS608_CMD_MATCH             0x03    // CharBuffer1 x CharBuffer2 (1:1)
+#define AS608_CMD_REGMODEL          0x05    // CharBuffer1 + CharBuffer2 → modelo (cadastro)
+#define AS608_CMD_HISPEEDSEARCH     0x1B
+#define AS608_CMD_STORE             0x06
+#define AS608_CMD_LOADCHAR          0x07
+#define AS608_CMD_UPCHAR            0x08
+#define AS608_CMD_DOWNCHAR          0x09
+#define AS608_CMD_READINDEX         0x1F    // Tabela de ocupação: 32 bytes = 256 IDs por página
+
+// Códigos de confirmação (mesmos valores de FINGERPRINT_* da Adafruit)
+#define AS608_OK                    0x00
+#define AS608_NOFINGER              0x02
+#define AS608_NOMATCH               0x08
+#define AS608_NOTFOUND              0x09
+#define AS608_ENROLLMISMATCH        0x0A
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Resultado de transporte de um comando
+ */
+enum As608Transport {
+    AS608_REPLY_OK = 0,         // ACK recebido (ver 'code')
+    AS608_REPLY_TIMEOUT,        // Sem resposta no prazo
+    AS608_REPLY_BAD_FRAME       // Soma/tamanho/PID inválido
+};
+
+/**
+ * @brief Resposta de um comando
+ */
+struct As608Reply {
+    As608Transport transport;
+    uint8_t command;            // Comando que originou a resposta
+    uint8_t code;               // Código de confirmação do sensor
+    uint8_t data[AS608_ASYNC_MAX_PAYLOAD];  // Payload após o código
+    uint8_t dataLen;
+    uint16_t bulkLen;           // Bytes recebidos em pacotes de dados (upload)
+    uint32_t elapsedUs;         // Envio → resposta completa
+};
+
+/**
+ * @brief Resultado do pipeline captura → extração → busca
+ */
+struct As608SearchResult {
+    As608Transport transport;   // Falha de transporte na etapa que parou
+    uint8_t stage;              // Comando da última etapa executada
+    uint8_t code;               // Código de confirmação dessa etapa
+    bool fingerSeen;            // GenImg capturou imagem
+    uint16_t id;                // Página encontrada/conferida (code == AS608_OK)
+    uint16_t score;             // Pontuação do match
+    uint32_t searchUs;          // Só o HighSpeedSearch/Match (0 se não chegou à busca)
+    uint32_t elapsedUs;         // Pipeline completo
+};
+
+typedef void (*As608ReplyCallback)(const As608Reply& reply, void* ctx);
+typedef void (*As608SearchCallback)(const As608SearchResult& result, void* ctx);
+
+// ═══════════════════════════════════════════════════════════════════════
+// CLASSE AS608ASYNC
+// ═══════════════════════════════════════════════════════════════════════
+
+class As608Async {
+public:
+    /**
+     * @brief Construtor
+     */
+    As608Async();
+
+    /**
+     * @brief Associa à UART já inicializada e instala o callback de recepção
+     * @param serial UART do sensor (Serial2.begin() já chamado)
+     * @param address Endereço do módulo (padrão de fábrica 0xFFFFFFFF)
+     */
+    void begin(HardwareSerial* serial, uint32_t address = 0xFFFFFFFF);
+
+    /**
+     * @brief Envia um comando sem esperar a resposta
+     * @param cmd Código do comando
+     * @param params Parâmetros (podem ser NULL se len = 0)
+     * @param timeoutMs Prazo para o ACK
+     * @param cb Chamado em poll() com a resposta ou o timeout
+     * @return false se já houver comando em andamento
+     */
+    bool send(uint8_t cmd, const uint8_t* params, uint8_t len, uint32_t timeoutMs,
+              As608ReplyCallback cb, void* ctx);
+
+    /**
+     * @brief Inicia o pipeline GenImg → Img2Tz(1) → HighSpeedSearch(1)
+     * @param startPage Primeira página da busca
+     * @param pageCount Quantidade de páginas
+     * @param cb Chamado em poll() ao fim do pipeline (qualquer etapa)
+     * @return false se já houver comando em andamento
+     */
+    bool startSearch(uint16_t startPage, uint16_t pageCount, As608SearchCallback cb, void* ctx);
+
+    /**
+     * @brief Inicia o pipeline GenImg → Img2Tz(1) → LoadChar(2, page) → Match
+     * @param page Slot do template a conferir (escolhido pelo cartão)
+     * @param cb Mesmo resultado de startSearch(); code AS608_NOMATCH se não confere
+     * @return false se já houver comando em andamento
+     */
+    bool startMatch(uint16_t page, As608SearchCallback cb, void* ctx);
+
+    /**
+     * @brief Lê um template do sensor: LoadChar(1, id) + UpChar(1) + pacotes de dados
+     * @param dst Destino do arquivo de característica (AS608_TEMPLATE_MAX bytes)
+     * @param cb Resposta final; reply.bulkLen = bytes recebidos
+     * @return false se já houver comando em andamento
+     */
+    bool upload(uint16_t id, uint8_t* dst, uint16_t cap, uint32_t timeoutMs,
+                As608ReplyCallback cb, void* ctx, bool pipelined = true);
+
+    /**
+     * @brief Grava um template no sensor: DownChar(1) + pacotes de dados + Store(1, id)
+     * Tudo é escrito de uma vez; os dois ACKs são recolhidos na sequência.
+     * @param packetLen Tamanho do pacote de dados do sensor (getParameters)
+     * @param cb Resposta do Store (ou do primeiro ACK com erro)
+     * @return false se já houver comando em andamento
+     */
+    bool download(uint16_t id, const uint8_t* tpl, uint16_t len, uint16_t packetLen,
+                  uint32_t timeoutMs, As608ReplyCallback cb, void* ctx, bool pipelined = true);
+
+    /**
+     * @brief Entrega respostas/timeouts e avança o pipeline (chamar no loop)
+     */
+    void poll();
+
+    /**
+     * @brief Há comando aguardando resposta
+     */
+    bool busy() const { return inFlight; }
+
+    /**
+     * @brief Abandona o pipeline (o comando em andamento ainda é aguardado)
+     */
+    void cancel();
+
+    /**
+     * @brief Aguarda o comando em andamento terminar (antes da API síncrona)
+     * @return true se ocioso
+     */
+    bool waitIdle(uint32_t timeoutMs);
+
+    /**
+     * @brief Comandos enviados / respostas inválidas / timeouts
+     */
+    uint32_t commandCount() const { return commands; }
+    uint32_t badFrameCount() const { return badFrames; }
+    uint32_t timeoutCount() const { return timeouts; }
+    uint32_t staleCount() const { return stale; }   // Respostas atrasadas descartadas
+
+private:
+    enum ParseState {
+        PARSE_HDR1 = 0,
+        PARSE_HDR2,
+        PARSE_ADDR,
+        PARSE_PID,
+        PARSE_LEN,
+        PARSE_BODY
+    };
+
+    HardwareSerial* serial;
+    uint32_t address;
+    portMUX_TYPE lock;
+
+    // Comando em andamento (dono: chamador de send()/poll())
+    volatile bool inFlight;
+    uint8_t command;
+    uint32_t sentUs;
+    uint32_t sentMs;
+    uint32_t timeoutMs;
+    As608ReplyCallback replyCb;
+    void* replyCtx;
+
+    // Montagem do pacote (dono: tarefa de eventos da UART)
+    ParseState parseState;
+    uint16_t parseIdx;
+    uint8_t pid;
+    uint16_t bodyLen;
+    uint8_t body[AS608_ASYNC_MAX_DATA + 2];     // payload + soma(2)
+    volatile uint32_t generation;   // Incrementa a cada send(): bytes antigos são ignorados
+    bool frameError;
+    uint8_t ackCmd[2];              // Comando de cada ACK esperado (em ordem)
+    uint8_t ackCount;
+    uint8_t ackIdx;                 // Próximo ACK esperado
+    uint8_t* sink;                  // Destino dos pacotes de dados (upload)
+    uint16_t sinkCap;
+    uint16_t sinkLen;
+
+    // Janela após timeout (ACK atrasado) e escrita adiada até ela fechar
+    volatile bool lateWindow;
+    uint32_t lateUntilMs;
+    volatile bool deferTx;
+    uint8_t txBuf[AS608_ASYNC_TX_DEFER];
+    uint16_t txLen;
+
+    // Resposta pronta para poll()
+    volatile bool replyReady;
+    As608Reply reply;
+
+    // Pipeline de busca
+    As608SearchCallback searchCb;
+    void* searchCtx;
+    As608SearchResult search;
+    uint32_t searchStartUs;
+    uint16_t searchStart;
+    uint16_t searchCount;
+    uint16_t matchPage;             // != 0: Match 1:1 no lugar da busca
+
+    // Transferência passo a passo (pipelined = false)
+    As608ReplyCallback xferCb;
+    void* xferCtx;
+    const uint8_t* xferTpl;
+    uint8_t* xferDst;
+    uint16_t xferLen;
+    uint16_t xferPacketLen;
+    uint16_t xferId;
+    uint32_t xferTimeout;
+
+    uint32_t commands;
+    uint32_t badFrames;
+    uint32_t timeouts;
+    uint32_t stale;
+
+    /**
+     * @brief Arma a espera de respostas (chamado antes de escrever)
+     */
+    bool arm(uint8_t cmd1, uint8_t cmd2, uint8_t* dst, uint16_t cap, uint32_t timeout,
+             As608ReplyCallback cb, void* ctx);
+
+    /**
+     * @brief Janela de descarte após timeout ainda aberta
+     */
+    bool lateActive();
+
+    /**
+     * @brief Fecha a janela: descarta o RX e escreve o comando adiado
+     */
+    void flushDeferred();
+
+    /**
+     * @brief Tamanho do payload do ACK (código + dados) de cada comando
+     */
+    static uint8_t ackPayloadLen(uint8_t cmd);
+
+    /**
+     * @brief Escreve um pacote (comando ou dados) na UART (ou em txBuf, se adiado)
+     */
+    void writePacket(uint8_t pid, const uint8_t* payload, uint16_t len);
+    void writeCommand(uint8_t cmd, const uint8_t* params, uint8_t len);
+    void writeData(const uint8_t* tpl, uint16_t len, uint16_t packetLen);
+
+    /**
+     * @brief Callback onReceive: consome bytes só com comando em andamento
+     */
+    void onUartData();
+
+    /**
+     * @brief Um byte no parser; true quando o pacote fecha
+     */
+    bool feed(uint8_t b);
+
+    /**
+     * @brief Trata o pacote montado; true quando a resposta final está em 'reply'
+     */
+    bool frameDone();
+
+    /**
+     * @brief Fecha a resposta final em 'reply'
+     */
+    void finishReply(As608Transport transport, uint8_t code, const uint8_t* data, uint8_t len);
+
+    /**
+     * @brief Próxima etapa do pipeline (ou entrega do resultado)
+     */
+    static void onSearchStep(const As608Reply& r, void* ctx);
+    void searchStep(const As608Reply& r);
+    void searchFinish(const As608Reply& r);
+
+    /**
+     * @brief Próxima etapa da transferência passo a passo
+     */
+    static void onXferStep(const As608Reply& r, void* ctx);
+    void xferStep(const As608Reply& r);
+};
+
+#endif // AS608_ASYNC_H
@@ -0,0 +1,226 @@
+/**
+ * @file bio_batch.h
+ * @brief Cadastro biométrico em lote a partir de uma lista (turma/equipe)
+ * @version 1.1.0
+ * @date 2025-12-07
+ *
+ * Cadastrar uma turma era digitar cada nome no teclado virtual e rodar
+ * processEnrollment() um usuário por vez. Aqui a lista chega pronta (CSV
+ * pelo Serial ou loadCSV()) e o equipamento percorre os usuários com slot
+ * e nome já definidos; só falta cada um colocar o dedo duas vezes.
+ *
+ * Formato do CSV (uma linha por usuário, ',' ou ';'):
+ *   slot,nome      → slot fixo
+ *   ,nome  | nome  → próximo slot livre (reservado na carga)
+ *   Linhas com '#' ou cabeçalho (slot não numérico) são ignoradas
+ *
+ * Pipeline (As608Async, sem bloquear o loop, via update()):
+ *   GenImg → Img2Tz(1) → [dedo sai] → GenImg → Img2Tz(2) → RegModel
+ *   → HiSpeedSearch → Store
+ *   A busca recusa (ROSTER_FAILED) um dedo que já está em outro slot: a
+ *   mesma pessoa não fica com dois IDs se a lista repetir alguém.
+ *   Assim que o Store confirma, o sensor já passa a esperar a retirada do
+ *   dedo e a captura do próximo da lista; os metadados (NVS + LittleFS) do
+ *   usuário concluído são gravados enquanto esse comando está na UART.
+ *
+ * Progresso em LittleFS (/bio_roster.bin): cada usuário tem um byte de
+ * status regravado no lugar. Um lote interrompido (reset, falta de energia,
+ * BATCH PAUSE) continua do primeiro pendente com BATCH START.
+ *
+ * A verificação contínua fica pausada durante o lote (beginBulk).
+ */
+
+#ifndef BIO_BATCH_H
+#define BIO_BATCH_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "biometric_manager.h"
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+#define BIO_BATCH_FILE              "/bio_roster.bin"
+#define BIO_BATCH_MAGIC             0x524F5331  // "ROS1"
+#define BIO_BATCH_POLL_MS           60          // Intervalo entre GenImg sem dedo
+#define BIO_BATCH_FINGER_TIMEOUT_MS 30000       // Ninguém no sensor: lote pausa
+#define BIO_BATCH_MAX_TRIES         3           // Leituras que não conferem antes de pular
+#define BIO_BATCH_MAX_ERRORS        5           // Falhas de UART seguidas antes de pausar
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Situação de cada usuário da lista (gravada no arquivo)
+ */
+enum BioRosterStatus : uint8_t {
+    ROSTER_PENDING = 0,
+    ROSTER_DONE,
+    ROSTER_SKIPPED,             // BATCH SKIP ou slot ocupado na carga
+    ROSTER_FAILED               // Leituras não conferem / dedo já cadastrado / erro do sensor
+};
+
+/**
+ * @brief Cabeçalho do arquivo
+ */
+struct __attribute__((packed)) BioRosterHeader {
+    uint32_t magic;             // BIO_BATCH_MAGIC
+    uint16_t count;             // Registros a seguir
+};
+
+/**
+ * @brief Um usuário da lista
+ */
+struct __attribute__((packed)) BioRosterEntry {
+    uint16_t slot;
+    char name[FINGER_NAME_LENGTH];
+    uint8_t status;             // BioRosterStatus
+};
+
+/**
+ * @brief Etapa do lote
+ */
+enum BioBatchState {
+    BATCH_IDLE = 0,             // Sem lote em andamento
+    BATCH_RECEIVING,            // Recebendo linhas do CSV pelo Serial
+    BATCH_FINGER_1,             // Aguardando 1ª captura
+    BATCH_REMOVE,               // Aguardando retirar o dedo
+    BATCH_FINGER_2,             // Aguardando 2ª captura
+    BATCH_PAUSED                // Interrompido (timeout/comando), progresso salvo
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// CLASSE BIOBATCHENROLL
+// ═══════════════════════════════════════════════════════════════════════
+
+class BioBatchEnroll {
+public:
+    /**
+     * @brief Construtor
+     */
+    BioBatchEnroll();
+
+    /**
+     * @brief Início/fim da lista pelo Serial (linhas entregues a feedLine())
+     */
+    void beginReceive();
+    bool isReceiving() const { return state == BATCH_RECEIVING; }
+    void feedLine(const String& line);
+
+    /**
+     * @brief Carrega uma lista CSV completa (substitui a anterior)
+     * @return false se nenhuma linha for válida
+     */
+    bool loadCSV(const String& csv);
+
+    /**
+     * @brief ⭐ v6.1.19: Acrescenta um usuário à lista atual (API HTTP, pelo loop)
+     * @param slot Slot fixo ou 0 (próximo livre)
+     * @return Slot reservado ou 0 se recusado
+     */
+    uint16_t addUser(uint16_t slot, const char* name);
+
+    /**
+     * @brief Inicia ou continua o lote (lê o arquivo se a lista não estiver na RAM)
+     * @return false sem lista, sem pendentes ou com o sensor ocupado
+     */
+    bool start();
+
+    /**
+     * @brief Interrompe o lote mantendo o progresso
+     */
+    void pause();
+
+    /**
+     * @brief Pula o usuário atual (fica como ROSTER_SKIPPED)
+     */
+    void skip();
+
+    /**
+     * @brief Apaga a lista e o progresso
+     */
+    void clear();
+
+    /**
+     * @brief Avança o lote (chamar no loop)
+     */
+    void update();
+
+    /**
+     * @brief ⭐ v6.1.20: Há lista (RAM ou arquivo) - ela guarda slots fixos
+     */
+    bool hasRoster() const;
+
+    /**
+     * @brief Lote capturando digitais
+     */
+    bool busy() const { return state >= BATCH_FINGER_1 && state <= BATCH_FINGER_2; }
+
+    /**
+     * @brief Texto para a tela (nome + instrução); true uma vez a cada mudança
+     */
+    bool promptChanged();
+    const char* prompt() const { return promptText; }
+
+    /**
+     * @brief Imprime lista/progresso e usuários por minuto no Serial
+     */
+    void printStatus();
+
+private:
+    BioBatchState state;
+    BioRosterEntry entries[MAX_FINGERPRINTS];
+    uint16_t count;
+    int16_t cur;                // Usuário em captura (-1 = nenhum)
+    int16_t stored;             // Store confirmado, metadados ainda não gravados
+    BioBatchState afterRemove;  // Etapa seguinte quando o dedo sair
+    uint8_t tries;
+    uint8_t errors;
+
+    // Resposta entregue em poll()
+    bool waiting;
+    bool replyPending;
+    As608Reply lastReply;
+    uint32_t nextPollMs;
+    uint32_t fingerWaitMs;      // Início da espera por dedo (timeout)
+
+    // Recepção pelo Serial
+    uint16_t rxLines;
+    uint16_t rxRejected;
+
+    // Tela
+    char promptText[48];
+    bool promptDirty;
+
+    // Medição (só o tempo com o lote rodando)
+    uint16_t sessionDone;
+    uint32_t runStartMs;
+    uint32_t activeMs;
+    uint32_t userStartMs;
+    uint32_t lastUserMs;
+
+    static void onReply(const As608Reply& reply, void* ctx);
+
+    bool issue(uint8_t cmd, const uint8_t* params, uint8_t len);
+    void handleReply(const As608Reply& r);
+    void advance();
+    bool nextUser();
+    void commitStored();
+    void finish(bool paused);
+    void setPrompt(const char* fmt, ...);
+
+    void addLine(const String& line);
+    bool parseLine(const String& line, uint16_t& slot, String& name);
+    void assignSlots();
+    bool loadFile();
+    bool saveFile();
+    void saveStatus(uint16_t i);
+    uint16_t pendingCount() const;
+};
+
+// Instância global (definida em bio_batch.cpp)
+extern BioBatchEnroll bioBatch;
+
+#endif // BIO_BATCH_H
@@ -16,9 +16,18 @@
  * Sistema completo de gerenciamento de biometria com:
  * - Cadastro com 2 leituras + nome personalizado
  * - Edição de nomes após cadastro
- * - Armazenamento no sensor AS608 + metadados em NVS
+ * - Armazenamento no sensor AS608 + metadados em LittleFS
  * - Log de acessos com timestamp
  * - Exportação/importação de metadados via JSON
+ * 
+ * ⭐ v6.1.19: A API HTTP (tarefa async_tcp) lê os metadados; quem os altera
+ * no loop toma o mutex recursivo (BioLock). Alterações pedidas pela API
+ * são aplicadas pelo loop (credentialApiUpdate), nunca na tarefa HTTP.
+ * 
+ * ⭐ v6.1.20: Metadados numa RecordTable em LittleFS (BIO_TABLE_FILE): o blob
+ * "fp_table" do NVS (~10KB com 300 digitais) era regravado inteiro a cada
+ * acesso e não cabia com a partição dividida. Nome/ativo regravam só o
+ * registro; contadores de acesso vão para flash em flushStats().
  */
 
 #ifndef BIOMETRIC_MANAGER_H
@@ -27,16 +36,36 @@
 #include <Arduino.h>
 #include <Adafruit_Fingerprint.h>
 #include <Preferences.h>
+#include "record_table.h"
 #include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "as608_async.h"
+#include "slot_bitmap.h"
 
 // ════════════════════════════════════════════════════════════════
 // CONFIGURAÇÕES
 // ════════════════════════════════════════════════════════════════
 
-#define MAX_FINGERPRINTS    127             // Limite do AS608
+#define MAX_FINGERPRINTS    300             // Tabela de slots = AS608_MAX_CAPACITY (limite real: getCapacity())
+#define BIO_NVS_TABLE_KEY   "fp_table"      // Blob do NVS anterior ao v6.1.20 (migrado para BIO_TABLE_FILE)
+#define BIO_TABLE_FILE      "/bio_table.bin"    // ⭐ v6.1.20: Metadados em LittleFS
+#define BIO_TABLE_TMP       "/bio_table.tmp"
+#define BIO_TABLE_MAGIC     0x46505431          // "FPT1"
+#define BIO_STATS_FLUSH_MS  60000           // ⭐ v6.1.20: Contadores de acesso pendentes → flash
 #define FINGER_NAME_LENGTH  20              // Comprimento do nome
 #define MAX_BIO_LOGS        100             // Máximo de logs de acesso
 #define ENROLL_TIMEOUT      10000           // Timeout de cadastro (10s)
+#define BIO_SEARCH_BUCKETS  10              // Faixas de tamanho da busca no relatório de latência
+
+// ⭐ v6.1.19: Campos do JSON de uma digital (filtro ?fields= da API)
+#define BIO_FIELD_ID            (1 << 0)
+#define BIO_FIELD_NAME          (1 << 1)
+#define BIO_FIELD_TIMESTAMP     (1 << 2)
+#define BIO_FIELD_ACTIVE        (1 << 3)
+#define BIO_FIELD_ACCESS_COUNT  (1 << 4)
+#define BIO_FIELD_LAST_ACCESS   (1 << 5)
+#define BIO_FIELDS_ALL          0x3F
 
 // ════════════════════════════════════════════════════════════════
 // ESTRUTURAS
@@ -46,7 +75,7 @@
  * @brief Estrutura de impressão digital cadastrada (metadados)
  */
 typedef struct __attribute__((packed)) {
-    uint16_t id;                        // ID no sensor (1-127)
+    uint16_t id;                        // ID no sensor (1-getCapacity())
     char name[FINGER_NAME_LENGTH];      // Nome do usuário
     uint32_t timestamp;                 // Data de cadastro (Unix timestamp)
     bool active;                        // Ativo/inativo
@@ -84,11 +113,38 @@ enum BiometricEnrollState {
     BIO_ERROR_TIMEOUT,              // Erro: timeout
     BIO_ERROR_NO_MATCH,             // Erro: leituras não correspondem
     BIO_ERROR_DUPLICATE,            // Erro: digital já cadastrada
-    BIO_ERROR_FULL,                 // Erro: memória cheia (127)
+    BIO_ERROR_FULL,                 // Erro: memória cheia (capacidade do sensor)
     BIO_ERROR_SENSOR,               // Erro: falha no sensor
     BIO_ERROR_HARDWARE              // Erro: AS608 desconectado
 };
 
+/**
+ * @brief Resultado da verificação assíncrona (startVerify/pollVerify)
+ */
+enum BioVerifyResult {
+    BIO_VERIFY_PENDING,             // Pipeline em andamento
+    BIO_VERIFY_GRANTED,             // Reconhecida, ativa e com metadados
+    BIO_VERIFY_REJECTED,            // Reconhecida mas desativada/sem metadados
+    BIO_VERIFY_NOT_FOUND,           // Dedo presente, digital não cadastrada
+    BIO_VERIFY_NO_FINGER,           // Sem dedo no sensor
+    BIO_VERIFY_ERROR                // Falha de imagem/UART ou cancelada
+};
+
+/**
+ * @brief Latência da busca 1:N por faixa de páginas pesquisadas
+ */
+struct BioSearchStats {
+    uint32_t searches;
+    uint64_t totalUs;
+    uint32_t maxUs;
+};
+
+/**
+ * @brief Aviso de template movido pela compactação (atualizar quem guarda o slot)
+ * to == 0: template removido (quem aponta para 'from' deve soltar o vínculo)
+ */
+typedef void (*BioSlotMovedFn)(uint16_t from, uint16_t to);
+
 // ════════════════════════════════════════════════════════════════
 // CLASSE PRINCIPAL
 // ════════════════════════════════════════════════════════════════
@@ -103,10 +159,17 @@ public:
     bool init();                        // Inicializa AS608 e carrega NVS
     bool isHardwareConnected();         // Verifica se AS608 está respondendo
     uint16_t getSensorTemplateCount();  // Quantidade no sensor
+    uint16_t getCapacity() const { return sensor_capacity; }  // ⭐ v6.1.15: Capacidade real (getParameters)
+    
+    // ═══ RECONCILIAÇÃO SENSOR × METADADOS (v6.1.15) ═══
+    bool reconcileSensor();             // ReadIndexTable + comparação com os metadados (relatório no Serial)
+    bool isTemplateMissing(uint16_t id) const;  // Metadados sem template no sensor
+    uint16_t getOrphanCount() const { return orphan_count; }    // Templates "sem metadados"
+    uint16_t getMissingCount() const { return missing_count; }
     
     // ═══ GERENCIAMENTO DE DIGITAIS ═══
     bool addFingerprint(uint16_t id, const char* name);  // Adiciona metadados
-    bool deleteFingerprint(int index);  // Remove por índice (sensor + NVS)
+    bool deleteFingerprint(int index);  // Remove por índice (sensor + NVS); false se o sensor recusar
     bool deleteFingerprintByID(uint16_t id);
     bool editFingerprintName(int index, const char* new_name);
     bool toggleFingerprintActive(int index);  // Ativa/desativa
@@ -121,6 +184,33 @@ public:
     uint16_t getLastMatchedID();            // Retorna último ID reconhecido
     uint16_t getLastConfidence();           // Retorna última confiança
     bool hasFingerOnSensor();               // Verifica se há dedo no sensor
+    bool lastVerifyHadFinger();             // ⭐ Última verifyFinger()/pollVerify() capturou imagem (dedo presente)
+    
+    // ═══ VERIFICAÇÃO ASSÍNCRONA (v6.1.11) ═══
+    bool isReady() const { return finger != nullptr && !bulk_active; }  // Sensor inicializado e livre (sem tráfego UART)
+    bool startVerify();                     // Dispara captura → extração → busca (não bloqueia)
+    BioVerifyResult pollVerify();           // Chamar no loop até != BIO_VERIFY_PENDING
+    bool fingerWaiting();                   // ⭐ v6.1.12: Dedo no sensor (WAK) ou hora do polling de segurança
+    
+    // ═══ BUSCA LIMITADA (v6.1.16) ═══
+    uint16_t getSearchRange();              // Páginas 1..N pesquisadas (maior slot ocupado)
+    int compactSlots();                     // Move templates para os buracos mais baixos (retorna movidos)
+    void setSlotMovedCallback(BioSlotMovedFn fn) { slot_moved_cb = fn; }
+    void printSearchStats();                // Latência da busca por faixa de páginas
+    
+    // ═══ CARTÃO + DIGITAL (v6.1.17) ═══
+    bool startVerifySlot(uint16_t id);      // Captura → extração → Match 1:1 só no slot do cartão
+    
+    // ═══ CADASTRO EM LOTE (v6.1.18) ═══
+    bool isIDUsed(uint16_t id);             // Verifica se ID está em uso
+    uint16_t nextHole(uint16_t from);       // Slot livre em metadados e no sensor (0 = cheio)
+    
+    // ═══ TRANSFERÊNCIA DE TEMPLATES (v6.1.13) ═══
+    bool beginBulk();                   // Pausa a verificação e reserva o driver para UpChar/DownChar
+    void endBulk();
+    bool isBulkActive() const { return bulk_active; }
+    As608Async& driver() { return as608; }
+    uint16_t getPacketLength();         // Pacote de dados do sensor (getParameters)
     
     // ═══ CONSULTAS ═══
     int getCount();                     // Total de metadados
@@ -137,10 +227,19 @@ public:
     
     // ═══ IMPORTAÇÃO/EXPORTAÇÃO ═══
     String exportToJSON();              // Exporta metadados (não exporta templates!)
+    void fingerprintToJSON(const Fingerprint& fp, JsonObject obj, uint16_t fields = BIO_FIELDS_ALL);
     bool importFromJSON(const String& json);
-    void clearAll();                    // Remove tudo (sensor + NVS)
+    void clearAll();                    // Remove tudo (sensor + metadados)
     void clearAllTemplates();           // Limpa banco do sensor
     
+    // ═══ ACESSO CONCORRENTE (v6.1.19) ═══
+    bool lock(uint32_t timeoutMs = portMAX_DELAY);  // Mutex recursivo dos metadados (loop × API HTTP)
+    void unlock();
+    uint32_t generation() const { return data_gen; }  // Muda a cada gravação dos metadados (ETag)
+    
+    // ═══ PERSISTÊNCIA (v6.1.20) ═══
+    void flushStats();                  // Contadores de acesso pendentes há BIO_STATS_FLUSH_MS (chamar no loop)
+    
     // ═══ MÁQUINA DE ESTADOS (CADASTRO) ═══
     BiometricEnrollState enrollState;
     uint16_t tempID;                    // ID temporário durante cadastro
@@ -154,18 +253,74 @@ public:
 private:
     Adafruit_Fingerprint *finger;
     Preferences preferences;
+    RecordTable table;                  // ⭐ v6.1.20: fingerprints[] em LittleFS
     Fingerprint fingerprints[MAX_FINGERPRINTS];
     BiometricLog logs[MAX_BIO_LOGS];
     int finger_count;
     int log_count;
+    SemaphoreHandle_t mutex;            // ⭐ v6.1.19: fingerprints[] (recursivo)
+    volatile uint32_t data_gen;         // ⭐ v6.1.19: Incrementado a cada gravação dos metadados
+    int16_t stats_lo;                   // ⭐ v6.1.20: Faixa de índices com contadores não gravados (-1 = nenhum)
+    int16_t stats_hi;
+    uint32_t stats_since;               // Primeiro contador pendente (millis)
+    
+    // ⭐ v6.1.14: Tabela por slot (O(1) em busca, alocação e remoção)
+    SlotBitmap<MAX_FINGERPRINTS> slot_used;         // Slots com metadados
+    int16_t slot_index[MAX_FINGERPRINTS + 1];       // Slot → índice em fingerprints[]
+    
+    // ⭐ v6.1.15: Ocupação real do sensor (ReadIndexTable)
+    SlotBitmap<MAX_FINGERPRINTS> sensor_used;
+    bool sensor_index_valid;            // sensor_used lido com sucesso
+    uint16_t sensor_capacity;           // min(capacidade do sensor, MAX_FINGERPRINTS)
+    uint16_t orphan_count;
+    uint16_t missing_count;
+    
+    // ⭐ v6.1.16: Busca só na faixa ocupada (compactada)
+    BioSlotMovedFn slot_moved_cb;
+    BioSearchStats search_stats[BIO_SEARCH_BUCKETS];
+    uint16_t last_search_pages;
+    BioSearchStats match_stats;         // ⭐ v6.1.17: Match 1:1 (cartão + digital)
+    uint16_t verify_slot;               // != 0: verificação atual é 1:1 neste slot
     uint32_t last_verify_time;          // Debounce de verificação
+    bool last_finger_seen;              // ⭐ Dedo presente na última verifyFinger()
+    
+    // Verificação assíncrona
+    As608Async as608;                   // Driver de pacotes não bloqueante (mesma UART)
+    bool verify_active;                 // startVerify() aguardando resultado
+    bool verify_done;                   // Resultado do pipeline disponível
+    As608SearchResult verify_result;
+    bool bulk_active;                   // Backup/restauração de templates em andamento
     
-    void loadFromNVS();
-    void saveToNVS();
+    static void onVerifyDone(const As608SearchResult& result, void* ctx);
+    bool finishVerify(uint16_t id, uint16_t confidence);  // Metadados e log após o match
+    void syncSensor();                  // Encerra o assíncrono antes da API síncrona
+    
+    // Saída de toque do AS608 (BIO_TOUCH_PIN)
+    static volatile bool touch_irq;     // Borda de subida do WAK desde a última consulta
+    static void onTouchIrq();
+    uint32_t last_fallback_poll;        // Último polling de segurança (sem IRQ)
+    
+    void loadFingerprints();            // ⭐ v6.1.20: Tabela (ou NVS antigo, migrado)
+    bool saveFingerprints();            // ⭐ v6.1.20: Tabela inteira (temporário + rename)
+    bool saveFingerprint(int index);    // ⭐ v6.1.20: Só o registro (nome, ativo, inclusão no fim)
+    void markStats(int index);          // ⭐ v6.1.20: Contador alterado, gravado em flushStats()
     void loadLogsFromNVS();
     void saveLogsToNVS();
-    uint16_t getFreeID();               // Retorna próximo ID livre (1-127)
-    bool isIDUsed(uint16_t id);         // Verifica se ID está em uso
+    uint16_t getFreeID();               // Próximo ID livre em metadados e no sensor (0 = cheio)
+    void rebuildSlotIndex();            // Refaz bitmap/tabela a partir de fingerprints[]
+    bool readIndexTable();              // Preenche sensor_used (32 bytes = 256 IDs por comando)
+    bool moveTemplate(uint16_t from, uint16_t to);  // LoadChar + Store + Delete, metadados acompanham
+};
+
+/**
+ * @brief Lock dos metadados enquanto durar o escopo
+ */
+class BioLock {
+public:
+    explicit BioLock(BiometricManager& m) : mgr(m) { mgr.lock(); }
+    ~BioLock() { mgr.unlock(); }
+private:
+    BiometricManager& mgr;
 };
 
 // ════════════════════════════════════════════════════════════════
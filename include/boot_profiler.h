@@ -0,0 +1,96 @@
+/**
+ * @file boot_profiler.h
+ * @brief Profiler do boot: etapas, tarefa/core e tempo até "porta pronta"
+ * @version 1.0.0
+ * @date 2025-12-07
+ *
+ * Cada etapa do setup() e das tarefas de inicialização paralelas registra
+ * início/fim com begin()/end(). "Porta pronta" é o instante em que a tela
+ * HOME está desenhada com backlight ligado, o relé responde e o PN532 já
+ * carregou os cartões (ou falhou) - a partir daí um cartão abre a porta.
+ *
+ * Tempos em ms desde o início do app (esp_timer), sem contar ROM e
+ * bootloader de 2º estágio (~100-300 ms antes do app_main).
+ *
+ * Thread-safe: as etapas chegam de tarefas em cores diferentes.
+ */
+
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+#define BOOT_PROF_MAX_STAGES    24      // Etapas registradas
+#define BOOT_PROF_TARGET_MS     1000    // Meta de porta pronta (destacada no relatório)
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Uma etapa do boot
+ */
+struct BootStage {
+    const char* name;           // Literal (não copiado)
+    const char* task;           // Tarefa FreeRTOS que executou
+    uint8_t core;               // Core da tarefa
+    uint32_t startUs;           // Desde o início do app
+    uint32_t endUs;             // 0 = em andamento
+    bool ok;
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// CLASSE BOOTPROFILER
+// ═══════════════════════════════════════════════════════════════════════
+
+class BootProfiler {
+public:
+    /**
+     * @brief Construtor
+     */
+    BootProfiler();
+
+    /**
+     * @brief Início de uma etapa
+     * @param name Nome (literal)
+     * @return Índice para end() (-1 se a tabela estiver cheia)
+     */
+    int begin(const char* name);
+
+    /**
+     * @brief Fim de uma etapa
+     * @param ok Resultado (falha aparece no relatório)
+     */
+    void end(int stage, bool ok = true);
+
+    /**
+     * @brief Marca a porta como pronta e imprime o relatório
+     */
+    void doorReady();
+
+    /**
+     * @brief Tempo até porta pronta em ms (0 = ainda não)
+     */
+    uint32_t doorReadyMs() const { return doorReadyUs / 1000; }
+
+    /**
+     * @brief Imprime todas as etapas no Serial
+     */
+    void print();
+
+private:
+    portMUX_TYPE lock;
+    BootStage stages[BOOT_PROF_MAX_STAGES];
+    uint8_t count;
+    uint32_t doorReadyUs;
+};
+
+// Instância global (definida em boot_profiler.cpp)
+extern BootProfiler bootProfiler;
+
+#endif // BOOT_PROFILER_H
@@ -20,6 +20,31 @@
 #define SCREEN_HEIGHT       320
 #define SCREEN_ROTATION     1       // 0=0°, 1=90°, 2=180°, 3=270°
 
+/* Pipeline de flush LVGL → ILI9488 (SPI + DMA) */
+#define LVGL_BUF_LINES          20      // Altura de cada buffer de desenho (linhas)
+#define LVGL_DOUBLE_BUFFER      1       // 1=Dois buffers DMA (LVGL desenha enquanto o SPI envia)
+                                        // 0=Buffer único (flush bloqueante)
+#define DISPLAY_BENCH_ON_BOOT   0       // 1=Mede redraw completo da HOME no boot (ms/FPS) - só diagnóstico
+#define FLUSH_TASK_CORE         0       // Tarefa lv_flush (conversão + DMA); LVGL fica no core 1
+#define FLUSH_TASK_PRIORITY     2       // Acima do loop: a faixa seguinte não espera o loop
+#define FLUSH_TASK_STACK        3072
+#define SCREEN_CACHE_ENABLED    1       // 1=Mantém HOME/AJUDA vivas (ocultas) entre trocas de tela
+#define LVGL_FULL_FRAME         0       // 1=Framebuffer 480x320 em PSRAM (direct_mode),
+                                        //   envia só os retângulos invalidados
+                                        // 0=Faixas parciais em RAM DMA (padrão)
+
+/* Ociosidade: esmaecer → apagar backlight e pausar LVGL (instalações 24/7) */
+#define IDLE_DIM_TIMEOUT_MS     30000   // Sem atividade → brilho reduzido
+#define IDLE_OFF_TIMEOUT_MS     120000  // Sem atividade → backlight off, refresh/touch pausados
+#define IDLE_BRIGHTNESS_ACTIVE  200     // Brilho normal (0-255)
+#define IDLE_BRIGHTNESS_DIM     40      // Brilho esmaecido (0-255)
+#define IDLE_CARD_PROBE_MS      500     // Tela apagada: intervalo de sondagem do PN532
+#define IDLE_OFF_LOOP_DELAY_MS  20      // Tela apagada: delay do loop (5ms quando ativo)
+
+/* Saúde do display: reaplica MADCTL/COLMOD/DISPON sem tft.init() */
+#define DISPLAY_HEALTH_ENABLED      1       // 1=Reparo leve após tráfego do PN532 / pico do AS608
+#define DISPLAY_HEALTH_BURST_MS     250     // Intervalo mínimo entre reparos pós-PN532
+
 /* ============================================================================
  * CALIBRAÇÃO TOUCH XPT2046 - VALORES FINAIS DE PRODUÇÃO ✅
  * ============================================================================
@@ -83,6 +108,8 @@
 #define PN532_TIMEOUT           100     // Timeout de leitura (ms)
 #define PN532_MAX_RETRY         3       // Tentativas de leitura
 #define PN532_READ_INTERVAL     500     // Intervalo entre leituras (ms)
+#define PN532_READY_TIMEOUT_MS  500     // Boot: prazo para o PN532 responder (polling)
+#define PN532_READY_POLL_MS     10      // Boot: intervalo entre tentativas
 
 /* Tipos de cartões suportados */
 #define PN532_SUPPORT_MIFARE    1       // Mifare Classic 1K/4K
@@ -93,6 +120,10 @@
 /* Chave padrão Mifare Classic (FF FF FF FF FF FF) */
 #define MIFARE_DEFAULT_KEY      { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }
 
+/* ⭐ v6.1.17: Cartão + digital - o cartão escolhe o slot e o AS608 só confere
+ * esse template (Match 1:1). Cartão sem digital vinculada (RFID LINK) é negado. */
+#define AUTH_CARD_AND_FINGER    0       // 1=Cartão exige a digital do titular, 0=Só cartão
+
 /* ============================================================================
  * CONFIGURAÇÕES DE WIFI - SISTEMA COMPLETO
  * ========================================================================== */
@@ -163,6 +194,11 @@
 #define AS608_SECURITY_LEVEL    3       // Nível de segurança (1-5, 3=médio)
 #define AS608_SCAN_TIMEOUT      10000   // Timeout para scan de dedo (ms)
 #define AS608_MATCH_THRESHOLD   50      // Threshold de matching (0-255)
+#define AS608_READY_TIMEOUT_MS  3000    // Boot: prazo para o AS608 responder ao handshake
+#define AS608_READY_POLL_MS     50      // Boot: intervalo entre tentativas
+#define AS608_TOUCH_FALLBACK_MS 1000    // Com BIO_TOUCH_PIN: verificação de segurança sem IRQ (0 = desliga)
+#define AS608_UART_RX_BUFFER    1024    // UART2: template inteiro (UpChar) sem perder bytes
+#define AS608_UART_TX_BUFFER    1024    // UART2: DownChar + pacotes + Store sem bloquear o loop
 
 /* ============================================================================
  * FEATURES HABILITADAS
@@ -172,6 +208,18 @@
 #define FEATURE_WIFI        1       // WiFi
 #define FEATURE_MAINTENANCE 1       // Sistema de manutenção
 
+/* ============================================================================
+ * CONFIGURAÇÕES DE BOOT
+ * ============================================================================
+ * LittleFS/NVS, AS608 e Wi-Fi sobem em tarefas paralelas no core 0 enquanto
+ * o core 1 inicializa display, LVGL e PN532. setup() só espera o necessário
+ * para a porta funcionar (PN532 + pico do AS608); o resto termina depois.
+ * ========================================================================== */
+#define BOOT_TASK_CORE          0       // Core das tarefas de inicialização
+#define BOOT_TASK_STACK         6144    // Pilha das tarefas de sensores/storage
+#define BOOT_WIFI_TASK_STACK    8192    // Pilha da tarefa do Wi-Fi
+#define BOOT_DOOR_WAIT_MS       1500    // Teto de espera do setup() por PN532/AS608
+
 /* ============================================================================
  * CONFIGURAÇÕES DE SEGURANÇA
  * ========================================================================== */
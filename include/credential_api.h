@@ -0,0 +1,64 @@
+/**
+ * @file credential_api.h
+ * @brief API REST paginada de credenciais (cartões RFID + digitais)
+ * @version 1.0.0
+ * @date 2025-12-07
+ *
+ * Ferramentas de administração listavam /api/rfid/list (lista inteira) a
+ * cada consulta. Aqui as listas são paginadas por cursor e filtradas por
+ * campo, com ETag derivado do contador de geração do RFIDManager /
+ * BiometricManager: lista sem mudança responde 304 só comparando números
+ * em RAM (nada de NVS/LittleFS, nada de montar JSON).
+ *
+ * Endpoints (header X-API-Key):
+ *   GET    /api/cards[?cursor=&limit=&fields=]     Cartões, ordem de UID
+ *   GET    /api/cards/<uid>                        Um cartão
+ *   POST   /api/cards          {uid,name[,active][,finger_slot]}
+ *   PATCH  /api/cards/<uid>    {name?,active?,finger_slot?}
+ *   DELETE /api/cards/<uid>
+ *   GET    /api/fingers[?cursor=&limit=&fields=]   Digitais, ordem de slot
+ *   GET    /api/fingers/<id>
+ *   POST   /api/fingers        {name[,id]}  → entra no cadastro em lote (202)
+ *   PATCH  /api/fingers/<id>   {name?,active?}                        (202)
+ *   DELETE /api/fingers/<id>                                          (202)
+ *
+ * Cursor = chave do último item da página (UID em hex / slot), estável
+ * com inserções e remoções entre páginas. "next_cursor": null = fim.
+ *
+ * Cartões são alterados direto na tarefa HTTP (sob RFIDLock). Digitais
+ * envolvem o AS608 e o BiometricStorage, que são do loop: o pedido entra
+ * numa fila e credentialApiUpdate() o aplica (resposta 202).
+ */
+
+#ifndef CREDENTIAL_API_H
+#define CREDENTIAL_API_H
+
+#include <Arduino.h>
+
+class AsyncWebServer;
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+#define CRED_API_DEFAULT_LIMIT  20      // Itens por página sem ?limit=
+#define CRED_API_MAX_LIMIT      50      // Maior página aceita
+#define CRED_API_LOCK_MS        200     // Espera pelos metadados antes de 503
+#define CRED_API_QUEUE_LEN      8       // Alterações de digitais aguardando o loop
+#define CRED_API_MAX_BODY       256     // Corpo JSON de POST/PATCH
+
+// ═══════════════════════════════════════════════════════════════════════
+// FUNÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Registra as rotas /api/cards e /api/fingers
+ */
+void setupCredentialEndpoints(AsyncWebServer& server);
+
+/**
+ * @brief Aplica as alterações de digitais pedidas pela API (chamar no loop)
+ */
+void credentialApiUpdate();
+
+#endif // CREDENTIAL_API_H
@@ -0,0 +1,53 @@
+/**
+ * @file credential_import.h
+ * @brief Importação de cartões em massa por upload (CSV ou NDJSON em stream)
+ * @version 1.1.0
+ * @date 2025-12-07
+ *
+ * RFIDManager::importFromJSON() precisa do arquivo inteiro numa String e
+ * de um DynamicJsonDocument(8192). Aqui o corpo do POST é lido à medida
+ * que chega do TCP: cada linha é interpretada num buffer fixo e os
+ * registros vão para a lista em lotes (upsertCards: um lock e uma gravação
+ * na NVS por lote). A memória por upload é fixa, qualquer que seja o
+ * tamanho do arquivo.
+ *
+ * Endpoint (header X-API-Key):
+ *   POST /api/cards/import
+ *
+ * Formato (uma credencial por linha, os dois podem se misturar):
+ *   CSV:    uid,nome[,ativo][,finger_slot]     (',' ou ';', ativo = 1/0)
+ *   NDJSON: {"uid":"..","name":"..","active":true,"finger_slot":3}
+ *   Linhas vazias, com '#' ou cabeçalho "uid,..." são ignoradas
+ *
+ * Cartão já cadastrado é atualizado (nome e os campos informados); o
+ * resumo devolve inseridos, atualizados, iguais e erros (com as primeiras
+ * linhas recusadas).
+ */
+
+#ifndef CREDENTIAL_IMPORT_H
+#define CREDENTIAL_IMPORT_H
+
+#include <Arduino.h>
+
+class AsyncWebServer;
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+#define CRED_IMPORT_LINE_MAX    160         // Maior linha aceita (CSV/NDJSON)
+#define CRED_IMPORT_BATCH       32          // Registros por transação
+#define CRED_IMPORT_MAX_ERRORS  8           // Linhas recusadas listadas no resumo
+#define CRED_IMPORT_MAX_BODY    (1024 * 1024)   // Maior upload aceito
+
+// ═══════════════════════════════════════════════════════════════════════
+// FUNÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Registra POST /api/cards/import
+ * Chamar antes de setupCredentialEndpoints(): "/api/cards" casaria a rota.
+ */
+void setupCredentialImport(AsyncWebServer& server);
+
+#endif // CREDENTIAL_IMPORT_H
@@ -0,0 +1,59 @@
+/**
+ * @file email_template.h
+ * @brief Renderizador de templates HTML de e-mail (sem String)
+ * @version 1.0.0
+ * @date 2025-12-05
+ *
+ * O texto estático do e-mail fica em flash (PROGMEM) com marcadores
+ * {{CHAVE}}. O renderizador faz duas passagens sobre o template:
+ *   1. out == nullptr → apenas mede o tamanho final
+ *   2. grava em um único buffer pré-alocado com o tamanho exato
+ *
+ * Evita as dezenas de realocações de "String +=" que fragmentavam o heap
+ * logo antes do handshake TLS (que precisa de blocos contíguos grandes).
+ */
+
+#ifndef EMAIL_TEMPLATE_H
+#define EMAIL_TEMPLATE_H
+
+#include <Arduino.h>
+#include "maintenance_types.h"
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Valor de um marcador {{CHAVE}} do template
+ */
+struct EmailTemplateField {
+    const char* key;            // Nome do marcador (sem chaves)
+    const char* value;          // Valor a inserir
+    bool escape;                // true = escapar HTML (dados do usuário)
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// FUNÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Renderiza um template substituindo os marcadores
+ * @param tpl Template (PROGMEM)
+ * @param fields Valores dos marcadores
+ * @param fieldCount Quantidade de campos
+ * @param out Buffer de saída (nullptr = só medir)
+ * @param cap Capacidade do buffer (incluindo '\0')
+ * @return Tamanho do texto renderizado (sem '\0')
+ */
+size_t email_template_render(const char* tpl, const EmailTemplateField* fields, size_t fieldCount,
+                             char* out, size_t cap);
+
+/**
+ * @brief Renderiza o e-mail HTML de uma requisição de manutenção
+ * @param req Requisição
+ * @param outLen Tamanho do HTML gerado (opcional)
+ * @return Buffer alocado (PSRAM se disponível) - liberar com free()
+ */
+char* email_render_manutencao(const MaintenanceRequest* req, size_t* outLen);
+
+#endif // EMAIL_TEMPLATE_H
@@ -0,0 +1,132 @@
+/**
+ * @file idle_manager.h
+ * @brief Gerenciador de ociosidade: backlight e suspensão do LVGL
+ * @version 1.0.0
+ * @date 2025-12-06
+ *
+ * Em instalações 24/7 a tela passava horas acesa em 200/255 com o LVGL
+ * redesenhando a cada LV_REFR_PERIOD e lendo o touch via SPI.
+ *
+ *   ATIVO ──(IDLE_DIM_TIMEOUT_MS)──▶ ESMAECIDO ──(IDLE_OFF_TIMEOUT_MS)──▶ DESLIGADO
+ *     ▲                                                                   │
+ *     └──────────── toque (IRQ XPT2046) / cartão / dedo ◀─────────────────┘
+ *
+ * DESLIGADO: backlight 0, refr_timer e leitura do touch (indev) pausados.
+ * O ILI9488 mantém a GRAM com o backlight apagado, então ao acordar basta
+ * religar o backlight; o primeiro frame redesenha só o que mudou.
+ *
+ * O toque que acorda a tela é descartado (não vira clique) até ser solto.
+ */
+
+#ifndef IDLE_MANAGER_H
+#define IDLE_MANAGER_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include "config.h"
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+enum IdleState {
+    IDLE_ACTIVE = 0,            // Brilho normal, LVGL rodando
+    IDLE_DIMMED,                // Brilho reduzido, LVGL rodando
+    IDLE_OFF                    // Backlight apagado, refresh/touch pausados
+};
+
+enum IdleWakeSource {
+    IDLE_WAKE_TOUCH = 0,
+    IDLE_WAKE_CARD,
+    IDLE_WAKE_FINGER,
+    IDLE_WAKE_OTHER
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// CLASSE IDLEMANAGER
+// ═══════════════════════════════════════════════════════════════════════
+
+class IdleManager {
+public:
+    typedef void (*BrightnessFn)(uint8_t level);
+    typedef bool (*TouchIrqFn)();
+
+    /**
+     * @brief Construtor
+     */
+    IdleManager();
+
+    /**
+     * @brief Inicializa (chamar após registrar display e touch no LVGL)
+     * @param disp Display LVGL (refr_timer é pausado no modo DESLIGADO)
+     * @param indev Touch LVGL (read_timer é pausado no modo DESLIGADO)
+     * @param setBrightness Função que aplica o brilho do backlight
+     * @param touchIrq Função que indica IRQ de toque pendente (sem SPI)
+     */
+    void begin(lv_disp_t* disp, lv_indev_t* indev, BrightnessFn setBrightness, TouchIrqFn touchIrq);
+
+    /**
+     * @brief Registra atividade do usuário (zera o contador de ociosidade)
+     * Acorda a tela se estiver esmaecida/desligada.
+     */
+    void activity(IdleWakeSource source);
+
+    /**
+     * @brief Atualizar estado (chamar no loop)
+     */
+    void update();
+
+    /**
+     * @brief Chamar no flush do último pedaço de cada frame
+     * Fecha a medição de latência acordar → primeiro frame.
+     */
+    void onFrameFlushed();
+
+    /**
+     * @brief Filtro do touch: true enquanto o toque que acordou a tela não for solto
+     * @param pressed Estado atual lido do touch
+     */
+    bool swallowTouch(bool pressed);
+
+    /**
+     * @brief Estado atual
+     */
+    IdleState getState() const { return state; }
+
+    /**
+     * @brief Tela apagada (sensores devem continuar operando)
+     */
+    bool isOff() const { return state == IDLE_OFF; }
+
+    /**
+     * @brief Imprime estado e latências no Serial
+     */
+    void printStatus();
+
+private:
+    IdleState state;
+    lv_disp_t* disp;
+    lv_indev_t* indev;
+    BrightnessFn setBrightness;
+    TouchIrqFn touchIrq;
+
+    uint32_t lastActivity;
+    bool swallowing;
+
+    // Latência acordar → primeiro frame
+    bool wakePending;
+    uint32_t wakeStartUs;
+    uint32_t lastWakeUs;
+    uint32_t maxWakeUs;
+    uint32_t wakeCount;
+
+    /**
+     * @brief Transição de estado (aplica brilho e pausa/retoma timers)
+     */
+    void enterState(IdleState newState);
+};
+
+// Instância global (definida em idle_manager.cpp)
+extern IdleManager idleManager;
+
+#endif // IDLE_MANAGER_H
@@ -16,15 +16,19 @@
  * CONFIGURAÇÕES DE CORES E DISPLAY
  * ========================================================================== */
 #define LV_COLOR_DEPTH 16                   // 16-bit (RGB565)
-#define LV_COLOR_16_SWAP 0                  // Swap bytes
+#define LV_COLOR_16_SWAP 1                  // Swap bytes (layout swap565_t da LovyanGFX; o painel recebe RGB666)
 #define LV_COLOR_SCREEN_TRANSP 0
 #define LV_COLOR_MIX_ROUND_OFS 128
 
 /* ============================================================================
  * CONFIGURAÇÕES DE MEMÓRIA
  * ========================================================================== */
-#define LV_MEM_CUSTOM 0                     // Usar malloc/free padrão
-#define LV_MEM_SIZE (64U * 1024U)          // 64KB para LVGL
+#define LV_MEM_CUSTOM 1                     // Alocador próprio (pool TLSF em PSRAM)
+#define LV_MEM_CUSTOM_INCLUDE "lvgl_mem.h"
+#define LV_MEM_CUSTOM_ALLOC   lvgl_mem_alloc
+#define LV_MEM_CUSTOM_FREE    lvgl_mem_free
+#define LV_MEM_CUSTOM_REALLOC lvgl_mem_realloc
+#define LV_MEM_SIZE (64U * 1024U)          // Ignorado com LV_MEM_CUSTOM=1 (ver LVGL_MEM_POOL_SIZE)
 #define LV_MEM_ATTR                         // Nenhum atributo especial
 
 /* ============================================================================
@@ -151,11 +155,53 @@ typedef void * lv_fs_drv_user_data_t;
 #define LV_FONT_MONTSERRAT_46 0
 #define LV_FONT_MONTSERRAT_48 1             // Habilitado para ícones grandes
 
+/* Subset de glifos gerado no build (scripts/font_subset.py → src/fonts/)
+ * Os arquivos gerados usam os MESMOS nomes (lv_font_montserrat_N), então as
+ * fontes embutidas da LVGL são desligadas aqui. LV_FONT_SUBSET só é definido
+ * pelo script quando a geração deu certo; senão, ficam as fontes completas. */
+#ifndef LV_FONT_SUBSET
+#define LV_FONT_SUBSET 0
+#endif
+
+#if LV_FONT_SUBSET
+#undef LV_FONT_MONTSERRAT_8
+#undef LV_FONT_MONTSERRAT_10
+#undef LV_FONT_MONTSERRAT_12
+#undef LV_FONT_MONTSERRAT_14
+#undef LV_FONT_MONTSERRAT_16
+#undef LV_FONT_MONTSERRAT_18
+#undef LV_FONT_MONTSERRAT_20
+#undef LV_FONT_MONTSERRAT_24
+#undef LV_FONT_MONTSERRAT_48
+#define LV_FONT_MONTSERRAT_8  0
+#define LV_FONT_MONTSERRAT_10 0
+#define LV_FONT_MONTSERRAT_12 0
+#define LV_FONT_MONTSERRAT_14 0
+#define LV_FONT_MONTSERRAT_16 0
+#define LV_FONT_MONTSERRAT_18 0
+#define LV_FONT_MONTSERRAT_20 0
+#define LV_FONT_MONTSERRAT_24 0
+#define LV_FONT_MONTSERRAT_48 0
+#endif
+
 /* Outras fontes */
 #define LV_FONT_UNSCII_8 0
 
 /* Font customizado (se necessário) */
+#if LV_FONT_SUBSET
+#define LV_FONT_CUSTOM_DECLARE \
+    LV_FONT_DECLARE(lv_font_montserrat_8) \
+    LV_FONT_DECLARE(lv_font_montserrat_10) \
+    LV_FONT_DECLARE(lv_font_montserrat_12) \
+    LV_FONT_DECLARE(lv_font_montserrat_14) \
+    LV_FONT_DECLARE(lv_font_montserrat_16) \
+    LV_FONT_DECLARE(lv_font_montserrat_18) \
+    LV_FONT_DECLARE(lv_font_montserrat_20) \
+    LV_FONT_DECLARE(lv_font_montserrat_24) \
+    LV_FONT_DECLARE(lv_font_montserrat_48)
+#else
 #define LV_FONT_CUSTOM_DECLARE
+#endif
 
 /* Default font */
 #define LV_FONT_DEFAULT &lv_font_montserrat_14
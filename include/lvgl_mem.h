@@ -0,0 +1,98 @@
+/**
+ * @file lvgl_mem.h
+ * @brief Alocador do LVGL: pool TLSF em PSRAM + objetos pequenos em RAM interna
+ * @version 1.0.0
+ * @date 2025-12-06
+ *
+ * Substitui o heap fixo de 64KB (LV_MEM_SIZE) em RAM interna. Incluído pelo
+ * lv_conf.h via LV_MEM_CUSTOM_INCLUDE, por isso a interface é C pura.
+ *
+ *   - size <= LVGL_MEM_INTERNAL_MAX → heap interno (objetos pequenos e
+ *     acessados a cada frame: estilos, descritores de timer, nós de lista)
+ *   - demais alocações             → pool dedicado em PSRAM, gerenciado por
+ *     multi_heap do ESP-IDF (TLSF desde o IDF 4.3)
+ *
+ * Estatísticas (uso, fragmentação, pico) são acumuladas globalmente e por
+ * "tag"; main.cpp usa o índice da tela atual como tag em mudar_tela().
+ */
+
+#ifndef LVGL_MEM_H
+#define LVGL_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+#define LVGL_MEM_POOL_SIZE      (256U * 1024U)  // Pool TLSF em PSRAM
+#define LVGL_MEM_INTERNAL_MAX   64              // Maior alocação servida pela RAM interna
+#define LVGL_MEM_MAX_TAGS       16              // Quantidade de tags (telas) rastreadas
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Retrato do uso de memória do LVGL
+ */
+typedef struct {
+    uint32_t pool_total;        // Tamanho do pool PSRAM (0 = pool indisponível)
+    uint32_t pool_used;         // Bytes em uso no pool
+    uint32_t pool_free;         // Bytes livres no pool
+    uint32_t pool_largest_free; // Maior bloco livre contíguo
+    uint32_t pool_peak;         // Pico de uso do pool desde o boot
+    uint32_t internal_used;     // Bytes em uso na RAM interna
+    uint32_t internal_peak;     // Pico de uso da RAM interna
+    uint32_t alloc_count;       // Blocos vivos (pool + interna)
+    uint32_t failed_count;      // Alocações que falharam
+    uint8_t  used_pct;          // Uso do pool (%)
+    uint8_t  frag_pct;          // Fragmentação do pool (%): 100 - maior_livre/livre
+} LvglMemStats;
+
+// ═══════════════════════════════════════════════════════════════════════
+// ALOCADOR (LV_MEM_CUSTOM_ALLOC/FREE/REALLOC)
+// ═══════════════════════════════════════════════════════════════════════
+
+void* lvgl_mem_alloc(size_t size);
+void  lvgl_mem_free(void* ptr);
+void* lvgl_mem_realloc(void* ptr, size_t size);
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTATÍSTICAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Preenche as estatísticas atuais
+ */
+void lvgl_mem_get_stats(LvglMemStats* out);
+
+/**
+ * @brief Define a tag ativa (ex.: índice da tela)
+ * O pico da tag acumula entre visitas (máximo observado desde o boot).
+ * @param tag 0..LVGL_MEM_MAX_TAGS-1 (valores fora da faixa são ignorados)
+ */
+void lvgl_mem_set_tag(int tag);
+
+/**
+ * @brief Pico de uso total (pool + interna) observado com a tag ativa
+ */
+uint32_t lvgl_mem_tag_peak(int tag);
+
+/**
+ * @brief Imprime estatísticas globais e por tag no Serial
+ * @param tag_names Nomes das tags (opcional, pode ser NULL)
+ * @param tag_count Quantidade de nomes
+ */
+void lvgl_mem_print_stats(const char* const* tag_names, int tag_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LVGL_MEM_H
@@ -0,0 +1,179 @@
+/**
+ * @file maintenance_store.h
+ * @brief Armazenamento indexado de requisições de manutenção (LittleFS)
+ * @version 1.0.0
+ * @date 2025-12-05
+ *
+ * Substitui os blobs "req_NNNNN" no NVS (partição de 20KB, nunca limpos)
+ * por um arquivo por requisição em LittleFS + um índice compacto por status.
+ *
+ * Layout em disco:
+ *   /manut/index.bin      - Cabeçalho + lista (id, status) de todas as requisições
+ *   /manut/00001.req      - MaintenanceRequest (blob binário, 1 por arquivo)
+ *
+ * O índice é mantido em RAM separado por status, então listar as pendentes
+ * custa O(pendentes) e não O(todas). Ao atingir MAINT_STORE_MAX_RECORDS,
+ * as requisições mais antigas já finalizadas (enviadas/atendidas/canceladas)
+ * são descartadas primeiro; requisições pendentes nunca são descartadas.
+ */
+
+#ifndef MAINTENANCE_STORE_H
+#define MAINTENANCE_STORE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <vector>
+#include "maintenance_types.h"
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+#define MAINT_STORE_DIR             "/manut"
+#define MAINT_STORE_INDEX_FILE      "/manut/index.bin"
+#define MAINT_STORE_INDEX_TMP       "/manut/index.tmp"
+#define MAINT_STORE_MAX_RECORDS     100     // Retenção máxima de requisições
+#define MAINT_STORE_MAGIC           0x4D4E5431  // "MNT1"
+#define MAINT_STORE_STATUS_COUNT    5       // Quantidade de StatusRequisicao
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Entrada do índice em disco (5 bytes por requisição)
+ */
+struct __attribute__((packed)) MaintenanceIndexEntry {
+    uint32_t id;                // ID da requisição
+    uint8_t status;             // StatusRequisicao
+};
+
+/**
+ * @brief Cabeçalho do arquivo de índice
+ */
+struct __attribute__((packed)) MaintenanceIndexHeader {
+    uint32_t magic;             // MAINT_STORE_MAGIC
+    uint32_t lastId;            // Último ID atribuído (contador)
+    uint16_t count;             // Quantidade de entradas a seguir
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// CLASSE MAINTENANCESTORE
+// ═══════════════════════════════════════════════════════════════════════
+
+class MaintenanceStore {
+public:
+    /**
+     * @brief Construtor
+     */
+    MaintenanceStore();
+
+    /**
+     * @brief Monta LittleFS, carrega o índice e migra blobs antigos do NVS
+     * @return true se inicializou com sucesso
+     */
+    bool begin();
+
+    /**
+     * @brief Salva (ou sobrescreve) uma requisição e atualiza o índice
+     * @param req Requisição com ID já atribuído
+     * @return true se salva com sucesso
+     */
+    bool save(const MaintenanceRequest* req);
+
+    /**
+     * @brief Carrega uma requisição pelo ID
+     * @param id ID da requisição
+     * @param out Estrutura de destino
+     * @return true se encontrada
+     */
+    bool load(uint32_t id, MaintenanceRequest* out);
+
+    /**
+     * @brief Remove uma requisição
+     * @param id ID da requisição
+     * @return true se removida
+     */
+    bool remove(uint32_t id);
+
+    /**
+     * @brief Lista IDs com um status, do mais antigo ao mais novo
+     * @param status Status desejado
+     * @param out Vetor de saída (é limpo antes)
+     * @param maxItems Limite de itens (0 = todos)
+     * @return Quantidade de IDs retornados
+     */
+    size_t listByStatus(StatusRequisicao status, std::vector<uint32_t>& out, size_t maxItems = 0);
+
+    /**
+     * @brief Quantidade de requisições com um status (O(1))
+     */
+    size_t countByStatus(StatusRequisicao status) const;
+
+    /**
+     * @brief Quantidade total de requisições armazenadas
+     */
+    size_t count() const;
+
+    /**
+     * @brief Reserva o próximo ID (persiste o contador)
+     * @return Novo ID
+     */
+    uint32_t nextId();
+
+    /**
+     * @brief Imprime resumo do índice no Serial
+     */
+    void printSummary();
+
+private:
+    bool initialized;
+    uint32_t lastId;
+    std::vector<uint32_t> byStatus[MAINT_STORE_STATUS_COUNT];  // IDs ordenados por status
+
+    /**
+     * @brief Carrega índice do LittleFS
+     */
+    bool loadIndex();
+
+    /**
+     * @brief Grava índice no LittleFS (arquivo temporário + rename)
+     */
+    bool saveIndex();
+
+    /**
+     * @brief Migra blobs "req_NNNNN" do NVS e libera o espaço
+     */
+    void migrateFromNVS();
+
+    /**
+     * @brief Descarta requisições antigas até caber mais uma
+     * @return false se não há o que descartar (tudo pendente)
+     */
+    bool enforceRetention();
+
+    /**
+     * @brief Retorna o status indexado de um ID (-1 se inexistente)
+     */
+    int findStatus(uint32_t id) const;
+
+    /**
+     * @brief Insere ID mantendo a ordem crescente do bucket
+     */
+    void indexInsert(uint8_t status, uint32_t id);
+
+    /**
+     * @brief Remove ID de um bucket
+     */
+    void indexErase(uint8_t status, uint32_t id);
+
+    /**
+     * @brief Monta caminho do arquivo da requisição
+     */
+    static void recordPath(uint32_t id, char* buf, size_t len);
+};
+
+// Instância global (definida em maintenance_store.cpp)
+extern MaintenanceStore maintenanceStore;
+
+#endif // MAINTENANCE_STORE_H
@@ -35,7 +35,7 @@ bool bioHardwareConnected();
 
 /**
  * @brief Retorna quantidade de templates no sensor AS608
- * @return Número de templates (0-127)
+ * @return Número de templates (0-capacidade do sensor)
  */
 int bioSensorTemplateCount();
 
@@ -120,9 +120,12 @@
 #define BIO_PASSWORD    0x00000000  // Default password
 #define BIO_SECURITY    3       // Security level (1-5, 3=medium)
 
+// Saída de toque do AS608 (WAK/TOUT: HIGH com dedo no sensor; alimentar "Touch VIN" em 3.3V)
+#define BIO_TOUCH_PIN   14      // GPIO14 → WAK do AS608 (-1 = sem fio, polling contínuo)
+
 // AS608 Settings
 #define BIO_ADDR        0xFFFFFFFF  // Default address
-#define BIO_MAX_FINGERS 256         // Maximum fingerprint capacity
+#define BIO_MAX_FINGERS 300         // Maximum fingerprint capacity (= AS608_MAX_CAPACITY; real value read from the sensor)
 
 /* ============================================================================
  * PN532 NFC/RFID - SPI Interface (v5.1.0)
@@ -225,9 +228,9 @@
  * ========================================================================== */
 /*
  * GPIOs Livres (testados e seguros para uso):
- * - GPIO 3, 6, 7, 8, 14, 15, 16, 33, 34, 41, 42
+ * - GPIO 3, 6, 7, 8, 15, 16, 33, 34, 41, 42
  * 
- * Total: 11 GPIOs disponíveis para expansão
+ * Total: 10 GPIOs disponíveis para expansão (GPIO14 → WAK do AS608)
  */
 
 /* ============================================================================
@@ -0,0 +1,119 @@
+/**
+ * @file record_table.h
+ * @brief Tabela de registros de tamanho fixo em LittleFS (cartões, digitais)
+ * @version 1.0.0
+ * @date 2025-12-07
+ *
+ * A partição NVS tem 20KB e é dividida com logs e configurações: uma chave
+ * por registro (~128 bytes de NVS cada) ou um blob da tabela inteira (várias
+ * páginas, regravado por completo a cada alteração) não cabem ou falham
+ * cedo. A tabela vai para um arquivo no LittleFS:
+ *
+ *   RecordTableHeader (magic, tamanho do registro, total) + registros
+ *
+ * - save(): arquivo temporário + rename (troca atômica, como o índice do
+ *   MaintenanceStore) - inclusão no meio, remoção, importação
+ * - saveRange()/saveRecord(): regrava só os registros alterados no lugar
+ *   ("r+", como o status do lote biométrico); cabeçalho por último quando
+ *   o total cresce. Remoção ou arquivo divergente → save()
+ * - load(): arquivo; sem ele, formato antigo do NVS ("count" + prefixo_N
+ *   ou um blob). As chaves antigas só saem depois de o arquivo estar
+ *   gravado; até lá cada save() que falhar grava também o formato antigo.
+ *
+ * Não tem lock próprio: quem chama segura o mutex da lista (RFIDLock/BioLock).
+ */
+
+#ifndef RECORD_TABLE_H
+#define RECORD_TABLE_H
+
+#include <Arduino.h>
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Cabeçalho do arquivo
+ */
+struct __attribute__((packed)) RecordTableHeader {
+    uint32_t magic;             // Identifica a tabela (cartões ≠ digitais)
+    uint16_t recordSize;        // sizeof do registro ao gravar
+    uint16_t count;             // Registros a seguir
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// CLASSE RECORDTABLE
+// ═══════════════════════════════════════════════════════════════════════
+
+class RecordTable {
+public:
+    /**
+     * @brief Construtor
+     * @param path Arquivo da tabela (ex.: "/rfid_table.bin")
+     * @param tmpPath Arquivo temporário do save()
+     * @param magic Identificador gravado no cabeçalho
+     * @param recordSize Tamanho de um registro
+     * @param maxRecords Capacidade do array em RAM
+     * @param nvsNamespace Namespace do formato antigo no NVS
+     * @param nvsPrefix Prefixo das chaves antigas ("card_" → card_0, card_1...)
+     * @param nvsBlobKey Blob antigo com a tabela inteira (NULL = não existe)
+     */
+    RecordTable(const char* path, const char* tmpPath, uint32_t magic, uint16_t recordSize,
+                uint16_t maxRecords, const char* nvsNamespace, const char* nvsPrefix,
+                const char* nvsBlobKey = NULL);
+
+    /**
+     * @brief Lê a tabela (LittleFS já montado); migra o formato antigo do NVS
+     * @param records Array com maxRecords registros
+     * @return Registros lidos (0 sem arquivo nem formato antigo)
+     */
+    uint16_t load(void* records);
+
+    /**
+     * @brief Regrava a tabela inteira (temporário + rename)
+     * @return true se os dados estão em flash (arquivo ou, na migração, NVS)
+     */
+    bool save(const void* records, uint16_t count);
+
+    /**
+     * @brief Regrava os registros [first, first + n) no lugar
+     * Total menor que o do arquivo, arquivo divergente ou migração pendente → save()
+     * @return true se gravado
+     */
+    bool saveRange(const void* records, uint16_t count, uint16_t first, uint16_t n);
+
+    /**
+     * @brief Regrava um registro no lugar (acesso, nome, ativo)
+     */
+    bool saveRecord(const void* records, uint16_t count, uint16_t index) {
+        return saveRange(records, count, index, 1);
+    }
+
+    /**
+     * @brief Formato antigo ainda no NVS (arquivo não confirmado)
+     */
+    bool legacyPending() const { return legacyCount >= 0 || legacyBlob; }
+
+private:
+    const char* path;
+    const char* tmpPath;
+    uint32_t magic;
+    uint16_t recordSize;
+    uint16_t maxRecords;
+    const char* nvsNamespace;
+    const char* nvsPrefix;
+    const char* nvsBlobKey;
+
+    int32_t fileCount;          // Total no cabeçalho do arquivo (-1 = sem arquivo válido)
+    int32_t legacyCount;        // "count" das chaves antigas (-1 = não há)
+    bool legacyBlob;            // Blob antigo ainda no NVS
+
+    bool readFile(void* records, uint16_t& count);
+    bool writeFile(const void* records, uint16_t count);
+    uint16_t loadLegacy(void* records);
+    bool saveLegacy(const void* records, uint16_t count);
+    void removeLegacy();
+    void legacyKey(char* key, size_t len, int i) const;
+};
+
+#endif // RECORD_TABLE_H
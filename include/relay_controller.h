@@ -1,19 +1,27 @@
 /**
  * @file relay_controller.h
  * @brief Controlador de relé para porta/fechadura
- * @version 1.1.0
+ * @version 1.2.0
  * @date 2025-11-28
  * 
  * Gerencia acionamento do relé GPIO19 (v5.1.0) para controle de acesso.
  * Suporta destravamento temporizado e permanente.
  * 
  * ATUALIZADO: GPIO20 → GPIO19 conforme pinagem v5.1.0
+ * 
+ * v1.2.0: O retravamento saía de update(), só quando o loop chegava lá;
+ * durante um envio SMTP ou conexão Wi-Fi bloqueante a porta ficava aberta
+ * bem além do tempo pedido. Agora um esp_timer one-shot (tarefa do
+ * esp_timer, prioridade alta) trava no instante certo, faça o loop o que
+ * fizer. Cada acionamento vira um evento com timestamp (esp_timer_get_time)
+ * e o tempo aberto medido; update() só imprime os eventos no Serial.
  */
 
 #ifndef RELAY_CONTROLLER_H
 #define RELAY_CONTROLLER_H
 
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "pins.h"
 
 // ═══════════════════════════════════════════════════════════════════════
@@ -22,6 +30,31 @@
 
 #define RELAY_DEFAULT_UNLOCK_TIME   5000    // 5 segundos (ms)
 #define RELAY_ACTIVE_HIGH           true    // true=HIGH destrava, false=LOW destrava
+#define RELAY_EVENT_LOG             32      // Eventos mantidos para RELAY LOG
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Tipo de acionamento
+ */
+enum RelayEventType : uint8_t {
+    RELAY_EV_UNLOCK = 0,        // Destravamento temporizado
+    RELAY_EV_UNLOCK_PERMANENT,  // Destravamento sem prazo
+    RELAY_EV_LOCK,              // Travamento pedido (lock())
+    RELAY_EV_LOCK_TIMER         // Travamento pelo esp_timer (prazo expirou)
+};
+
+/**
+ * @brief Evento do relé
+ */
+struct RelayEvent {
+    uint64_t timestampUs;       // esp_timer_get_time() no acionamento do GPIO
+    RelayEventType type;
+    uint32_t requestedMs;       // Prazo pedido (destravamento temporizado)
+    uint64_t openUs;            // Travamentos: tempo aberto medido (64 bits: 32 estouram em ~71 min)
+};
 
 // ═══════════════════════════════════════════════════════════════════════
 // CLASSE RELAYCONTROLLER
@@ -73,13 +106,41 @@ public:
      * @param user Nome do usuário
      */
     void logAccess(const char* method, const char* user);
+    
+    /**
+     * @brief Imprime os últimos eventos (tempo aberto medido × pedido)
+     */
+    void printEvents();
 
 private:
-    bool unlocked;
-    bool temporaryUnlock;
+    volatile bool unlocked;
+    volatile bool temporaryUnlock;
     uint32_t unlockStartTime;
     uint32_t unlockDuration;
     
+    // ⭐ v1.2.0: Travamento exato pelo esp_timer
+    esp_timer_handle_t lockTimer;
+    portMUX_TYPE mux;
+    uint64_t unlockUs;                      // Instante do último destravamento
+    RelayEvent events[RELAY_EVENT_LOG];     // Anel de eventos
+    uint32_t eventHead;                     // Total de eventos gravados
+    uint32_t eventPrinted;                  // Já impressos por update()
+    
+    /**
+     * @brief Callback do esp_timer (tarefa do esp_timer)
+     */
+    static void onLockTimer(void* arg);
+    
+    /**
+     * @brief Aciona o GPIO e grava o evento (dentro da seção crítica)
+     */
+    void applyLocked(bool unlock, RelayEventType type, uint32_t requestedMs);
+    
+    /**
+     * @brief Imprime um evento no Serial
+     */
+    void printEvent(const RelayEvent& ev);
+    
     /**
      * @brief Ativa relé (porta abre)
      */
@@ -0,0 +1,104 @@
+/**
+ * @file render_profiler.h
+ * @brief Profiler de renderização LVGL com overlay de FPS
+ * @version 1.0.0
+ * @date 2025-12-06
+ *
+ * Mede, por frame:
+ *   - tempo de render  (CPU desenhando: refresh total - flush)
+ *   - tempo de flush   (CPU bloqueada enviando ao painel / aguardando DMA)
+ *   - pixels enviados  (soma das áreas passadas ao flush_cb)
+ * e, por chamada do loop, a duração de lv_timer_handler().
+ *
+ * O refresh é medido embrulhando o callback do refr_timer do display
+ * (_lv_disp_refr_timer), sem alterar a lib. Os agregados são separados por
+ * tela: main.cpp passa o índice de Screen em mudar_tela().
+ *
+ * Desligado em runtime por padrão (custo de poucos micros() por frame);
+ * ativado pelo comando serial "PROF ON".
+ */
+
+#ifndef RENDER_PROFILER_H
+#define RENDER_PROFILER_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+#define RENDER_PROF_MAX_SCREENS     16      // Telas rastreadas
+#define RENDER_PROF_OVERLAY_MS      500     // Período de atualização do overlay
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Agregados de uma tela (ou de uma janela do overlay)
+ */
+struct RenderProfStats {
+    uint32_t frames;            // Frames com pixels enviados
+    uint64_t render_us;         // Soma do tempo de render
+    uint32_t render_max_us;
+    uint64_t flush_us;          // Soma do tempo de flush
+    uint32_t flush_max_us;
+    uint64_t pixels;            // Soma de pixels enviados
+    uint32_t handler_calls;     // Chamadas de lv_timer_handler()
+    uint64_t handler_us;        // Soma da duração de lv_timer_handler()
+    uint32_t handler_max_us;
+    uint32_t active_ms;         // Tempo com a tela ativa (para FPS médio)
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// FUNÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Instala o wrapper no refr_timer do display
+ * @param disp Display retornado por lv_disp_drv_register()
+ */
+void render_prof_install(lv_disp_t* disp);
+
+/**
+ * @brief Liga/desliga a coleta e o overlay
+ */
+void render_prof_enable(bool on);
+
+/**
+ * @brief Indica se o profiler está coletando
+ */
+bool render_prof_enabled();
+
+/**
+ * @brief Troca a tela à qual os próximos frames são atribuídos
+ * @param screen Índice de Screen (0..RENDER_PROF_MAX_SCREENS-1)
+ */
+void render_prof_set_screen(int screen);
+
+/**
+ * @brief Registra um flush (chamar dentro do flush_cb)
+ * @param us Tempo gasto no flush_cb
+ * @param px Pixels enviados
+ */
+void render_prof_add_flush(uint32_t us, uint32_t px);
+
+/**
+ * @brief Registra a duração de uma chamada de lv_timer_handler()
+ */
+void render_prof_add_handler(uint32_t us);
+
+/**
+ * @brief Zera todos os agregados
+ */
+void render_prof_reset();
+
+/**
+ * @brief Imprime os agregados por tela no Serial
+ * @param names Nomes das telas (opcional, pode ser NULL)
+ * @param count Quantidade de nomes
+ */
+void render_prof_print(const char* const* names, int count);
+
+#endif // RENDER_PROFILER_H
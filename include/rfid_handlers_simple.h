@@ -1,11 +1,16 @@
 /**
  * @file rfid_handlers_simple.h
  * @brief Handlers HTTP simplificados para endpoints RFID
- * @version 1.0.0 (simplificado para evitar stack overflow)
+ * @version 1.1.0 (simplificado para evitar stack overflow)
  * @date 2025-11-27
  * 
  * Endpoints REST profissionais para gerenciamento de cartões RFID/NFC.
  * Versão otimizada com funções separadas para reduzir uso de stack.
+ * 
+ * v1.1.0: Ativos no AsyncWebServer (wifi_api.cpp). Os handlers rodam na
+ * tarefa async_tcp, fora do loop: só tocam a lista do RFIDManager sob o
+ * lock dele e nunca acessam o PN532 (a leitura de cartões fica no loop).
+ * Autenticação pelo header X-API-Key, como a API Wi-Fi.
  */
 
 #ifndef RFID_HANDLERS_SIMPLE_H
@@ -13,6 +18,8 @@
 
 #include <Arduino.h>
 
+#define RFID_API_MAX_BODY   256     // Corpo do POST /api/rfid/register
+
 // Forward declaration (será definido onde este header for incluído)
 class AsyncWebServer;
 class AsyncWebServerRequest;
@@ -30,7 +37,7 @@ class Adafruit_PN532;
  * Endpoints criados:
  * - GET    /api/rfid/status      - Status do PN532
  * - POST   /api/rfid/register    - Cadastrar cartão
- * - DELETE /api/rfid/delete/:uid - Remover cartão
+ * - DELETE /api/rfid/delete/:uid - Remover cartão (ou ?uid=)
  * - GET    /api/rfid/list        - Listar cartões
  * - GET    /api/rfid/stats       - Estatísticas
  */
@@ -61,6 +68,9 @@ void handleRFIDStats(AsyncWebServerRequest *request);
 /**
  * @brief POST /api/rfid/register (body handler)
  * Cadastra novo cartão RFID
+ * 
+ * Body JSON: { "uid": "04:A2:3B:1C", "name": "Maria" }
+ * Respostas: 201 criado | 409 já cadastrado | 507 memória cheia
  */
 void handleRFIDRegister(AsyncWebServerRequest *request, uint8_t *data, size_t len);
 
@@ -82,6 +92,12 @@ void handleRFIDDelete(AsyncWebServerRequest *request);
  */
 void sendRFIDError(AsyncWebServerRequest *request, const char* message, int code = 400);
 
+/**
+ * @brief Converte "04:A2:3B:1C" / "04A23B1C" em bytes
+ * @return Comprimento do UID (4 ou 7) ou 0 se inválido
+ */
+uint8_t parseRFIDUid(const String& text, uint8_t* uid);
+
 /**
  * @brief Envia resposta JSON de sucesso
  * @param request Request HTTP
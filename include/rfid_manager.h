@@ -17,10 +17,20 @@
  * Sistema completo de gerenciamento de cartões RFID com:
  * - Cadastro com nome personalizado
  * - Edição de nomes após cadastro
- * - Armazenamento em NVS (até 50 cartões)
+ * - Armazenamento em LittleFS (até MAX_RFID_CARDS cartões)
  * - Log de acessos com timestamp
  * - Exportação/importação via JSON
  * - Suporte: Mifare Classic, Ultralight, NTAG, FeliCa
+ * 
+ * ⭐ v6.1.19: A API HTTP (AsyncWebServer, tarefa async_tcp) lê e altera a
+ * lista junto com o loop. Os métodos públicos que tocam cards[]/logs[]
+ * tomam um mutex recursivo; quem guarda um RFIDCard* de getCard() entre
+ * chamadas segura o lock (RFIDLock) enquanto usa o ponteiro.
+ * 
+ * ⭐ v6.1.20: Cartões numa RecordTable em LittleFS (RFID_CARDS_FILE) em vez
+ * de uma chave "card_N" por cartão no NVS, que limitava a lista a 50. Acesso,
+ * nome, ativo e digital regravam só o registro do cartão. A lista antiga do
+ * NVS é migrada no boot (depois de o LittleFS estar montado).
  */
 
 #ifndef RFID_MANAGER_H
@@ -28,18 +38,36 @@
 
 #include <Arduino.h>
 #include <Preferences.h>
+#include "record_table.h"
 #include <ArduinoJson.h>
 #include <Adafruit_PN532.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 // ════════════════════════════════════════════════════════════════
 // CONFIGURAÇÕES
 // ════════════════════════════════════════════════��═══════════════
 
-#define MAX_RFID_CARDS      50      // Máximo de cartões cadastrados
+#define MAX_RFID_CARDS      500     // Máximo de cartões cadastrados (⭐ v6.1.20: era 50 no NVS)
 #define RFID_UID_LENGTH     8       // Comprimento do UID (até 7 bytes + 1 null)
 #define RFID_NAME_LENGTH    20      // Comprimento do nome
 #define MAX_ACCESS_LOGS     100     // Máximo de logs de acesso
 
+// ⭐ v6.1.20: Tabela de cartões em LittleFS
+#define RFID_CARDS_FILE     "/rfid_table.bin"
+#define RFID_CARDS_TMP      "/rfid_table.tmp"
+#define RFID_CARDS_MAGIC    0x52464331      // "RFC1"
+
+// ⭐ v6.1.19: Campos do JSON de um cartão (filtro ?fields= da API)
+#define RFID_FIELD_UID          (1 << 0)
+#define RFID_FIELD_NAME         (1 << 1)
+#define RFID_FIELD_TIMESTAMP    (1 << 2)
+#define RFID_FIELD_ACTIVE       (1 << 3)
+#define RFID_FIELD_ACCESS_COUNT (1 << 4)
+#define RFID_FIELD_LAST_ACCESS  (1 << 5)
+#define RFID_FIELD_FINGER_SLOT  (1 << 6)
+#define RFID_FIELDS_ALL         0x7F
+
 // ════════════════════════════════════════════════════════════════
 // ESTRUTURAS
 // ════════════════════════════════════════════════════════════════
@@ -55,6 +83,7 @@ typedef struct __attribute__((packed)) {
     bool active;                     // Ativo/inativo
     uint16_t access_count;           // Contador de acessos
     uint32_t last_access;            // Último acesso (Unix timestamp)
+    uint16_t finger_slot;            // ⭐ v6.1.17: Slot da digital do titular no AS608 (0 = sem vínculo)
 } RFIDCard;
 
 /**
@@ -68,6 +97,30 @@ typedef struct __attribute__((packed)) {
     bool granted;                    // Acesso concedido/negado
 } AccessLog;
 
+/**
+ * @brief ⭐ v6.1.20: Resultado de cada registro de upsertCards()
+ */
+enum RFIDUpsertResult : uint8_t {
+    RFID_UPSERT_INSERTED = 0,   // Cartão novo
+    RFID_UPSERT_UPDATED,        // Já existia, nome/ativo/digital mudou
+    RFID_UPSERT_UNCHANGED,      // Já existia igual
+    RFID_UPSERT_FULL,           // Lista cheia (MAX_RFID_CARDS)
+    RFID_UPSERT_FAILED          // Gravação falhou (lote desfeito)
+};
+
+/**
+ * @brief ⭐ v6.1.20: Registro da importação em lote (upload da API)
+ */
+struct RFIDUpsert {
+    uint8_t uid[RFID_UID_LENGTH];
+    uint8_t uid_length;
+    char name[RFID_NAME_LENGTH];
+    bool active;
+    uint16_t finger_slot;
+    uint8_t fields;             // RFID_FIELD_ACTIVE / RFID_FIELD_FINGER_SLOT informados
+    uint8_t result;             // RFIDUpsertResult (preenchido por upsertCards)
+};
+
 /**
  * @brief Estados da máquina de cadastro RFID
  */
@@ -76,7 +129,7 @@ enum RFIDEnrollState {
     RFID_WAITING_CARD,          // Aguardando aproximar cartão
     RFID_READING,               // Lendo UID
     RFID_CARD_READ,             // Cartão lido, aguardando nome
-    RFID_SAVING,                // Salvando no NVS
+    RFID_SAVING,                // Salvando na tabela
     RFID_SUCCESS,               // Cadastrado com sucesso
     RFID_ERROR_DUPLICATE,       // Erro: cartão já cadastrado
     RFID_ERROR_FULL,            // Erro: memória cheia
@@ -95,8 +148,15 @@ public:
     ~RFIDManager();
     
     // ═══ INICIALIZAÇÃO ═══
-    bool init();                        // Inicializa PN532 e carrega NVS
+    bool init();                        // Carrega a lista e inicializa o PN532
     bool isHardwareConnected();         // Verifica se PN532 está conectado
+    bool isReady() const { return pn532 != nullptr; }  // init() concluído (sem acessar o SPI)
+    bool isLoaded() const { return loaded; }           // ⭐ v6.1.20: Lista lida da flash (com ou sem PN532)
+    
+    // ═══ ACESSO CONCORRENTE (v6.1.19) ═══
+    bool lock(uint32_t timeoutMs = portMAX_DELAY);  // Mutex recursivo da lista (loop × API HTTP)
+    void unlock();
+    uint32_t generation() const { return data_gen; }  // Muda a cada gravação da lista (ETag)
     
     // ═══ GERENCIAMENTO DE CARTÕES ═══
     bool addCard(uint8_t* uid, uint8_t uid_length, const char* name);
@@ -105,6 +165,10 @@ public:
     bool editCardName(int index, const char* new_name);
     bool toggleCardActive(int index);   // Ativa/desativa cartão
     
+    // ═══ CARTÃO + DIGITAL (v6.1.17) ═══
+    bool linkFinger(int index, uint16_t slot);      // Vincula o slot da digital (0 = desvincula)
+    void moveFingerSlot(uint16_t from, uint16_t to); // Template movido/removido (to = 0)
+    
     // ═══ AUTENTICAÇÃO ═══
     bool isCardAuthorized(uint8_t* uid, uint8_t uid_length);
     int findCardIndex(uint8_t* uid, uint8_t uid_length);
@@ -129,7 +193,9 @@ public:
     
     // ═══ IMPORTAÇÃO/EXPORTAÇÃO ═══
     String exportToJSON();              // Exporta todos os cartões
+    void cardToJSON(const RFIDCard& card, JsonObject obj, uint16_t fields = RFID_FIELDS_ALL);
     bool importFromJSON(const String& json);
+    int upsertCards(RFIDUpsert* batch, uint8_t n);  // ⭐ v6.1.20: Um lock e uma gravação por lote
     void clearAll();                    // Remove todos os cartões
     
     // ═══ MÁQUINA DE ESTADOS (CADASTRO) ═══
@@ -144,19 +210,35 @@ public:
 private:
     Adafruit_PN532 *pn532;              // Instância do PN532
     Preferences preferences;
+    RecordTable table;                  // ⭐ v6.1.20: cards[] em LittleFS
     RFIDCard cards[MAX_RFID_CARDS];
     AccessLog logs[MAX_ACCESS_LOGS];
     int card_count;
     int log_count;
     uint32_t last_read_time;            // Debounce de leitura
+    SemaphoreHandle_t mutex;            // ⭐ v6.1.19: cards[]/logs[] (recursivo)
+    volatile uint32_t data_gen;         // ⭐ v6.1.19: Incrementado a cada gravação da lista
+    volatile bool loaded;               // ⭐ v6.1.20: cards[] já reflete a tabela (API antes disso: 503)
     
-    void loadFromNVS();
-    void saveToNVS();
+    void loadCards();                   // ⭐ v6.1.20: Tabela (ou NVS antigo, migrado)
+    bool saveCards();                   // ⭐ v6.1.20: Tabela inteira (temporário + rename)
+    bool saveCard(int index);           // ⭐ v6.1.20: Só o registro do cartão
     void loadLogsFromNVS();
     void saveLogsToNVS();
     bool compareUID(uint8_t* uid1, uint8_t* uid2, uint8_t len);
 };
 
+/**
+ * @brief Lock da lista enquanto durar o escopo (ponteiros de getCard/getLog)
+ */
+class RFIDLock {
+public:
+    explicit RFIDLock(RFIDManager& m) : mgr(m) { mgr.lock(); }
+    ~RFIDLock() { mgr.unlock(); }
+private:
+    RFIDManager& mgr;
+};
+
 // ════════════════════════════════════════════════════════════════
 // INSTÂNCIA GLOBAL
 // ════════════════════════════════════════════════════════════════
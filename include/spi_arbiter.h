@@ -0,0 +1,165 @@
+/**
+ * @file spi_arbiter.h
+ * @brief Árbitro do barramento SPI2 compartilhado (display, touch, PN532)
+ * @version 1.1.0
+ * @date 2025-12-07
+ *
+ * ILI9488 (LovyanGFX), XPT2046 e PN532 (Arduino SPI) dividem SCK/MOSI e
+ * nada coordenava as transações: uma troca do PN532 com o CS do display
+ * ainda baixo chegava ao ILI9488 como comando (ex.: MADCTL corrompido).
+ *
+ * Regras:
+ *   - Um dispositivo por vez (mutex FreeRTOS com herança de prioridade)
+ *   - O display segura o barramento do primeiro ao último flush do frame;
+ *     o PN532 nunca entra no meio de um frame (acquire falha/espera)
+ *   - Pedido pendente de dispositivo de menor índice (DISPLAY < TOUCH <
+ *     PN532) faz os demais desistirem/esperarem. Só tem efeito entre
+ *     tarefas diferentes: tarefa lv_flush (core 0) e tarefas de boot
+ *     contra o loop; dentro do loop os pedidos já são sequenciais
+ *
+ * O árbitro não configura clock/modo: o display usa SPI_ARB_DISPLAY_HZ
+ * via LovyanGFX (cfg.freq_write); XPT2046 e Adafruit_PN532 abrem a
+ * própria SPI.beginTransaction() com os valores fixos das bibliotecas.
+ * Os CS são de cada driver; o árbitro só os leva a HIGH no begin().
+ */
+
+#ifndef SPI_ARBITER_H
+#define SPI_ARBITER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+#define SPI_ARB_DISPLAY_HZ      27000000    // ILI9488 escrita (validado) - cfg.freq_write
+
+#define SPI_ARB_WAIT_FOREVER    0xFFFFFFFF
+#define SPI_ARB_PN532_WAIT_MS   20          // PN532 desiste se o barramento não liberar
+#define SPI_ARB_TOUCH_WAIT_MS   0           // Touch: tenta uma vez (próxima leitura em 30ms)
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Dispositivos do barramento (ordem = prioridade entre tarefas, 0 = maior)
+ */
+enum SpiDevice {
+    SPI_DEV_DISPLAY = 0,
+    SPI_DEV_TOUCH,
+    SPI_DEV_PN532,
+    SPI_DEV_COUNT
+};
+
+/**
+ * @brief Identificação de um dispositivo do barramento
+ */
+struct SpiDeviceConfig {
+    const char* name;
+    int8_t csPin;               // Chip select (ativo baixo), HIGH no begin()
+};
+
+/**
+ * @brief Uso do barramento por dispositivo
+ */
+struct SpiDeviceStats {
+    uint32_t acquisitions;      // Transações concedidas
+    uint32_t deferred;          // Pedidos que desistiram (timeout)
+    uint64_t holdUs;            // Tempo total com o barramento
+    uint32_t holdMaxUs;         // Maior transação
+    uint64_t waitUs;            // Tempo total aguardando
+    uint32_t waitMaxUs;         // Maior espera
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// CLASSE SPIARBITER
+// ═══════════════════════════════════════════════════════════════════════
+
+class SpiArbiter {
+public:
+    /**
+     * @brief Construtor
+     */
+    SpiArbiter();
+
+    /**
+     * @brief Cria o mutex e leva todos os CS para HIGH
+     */
+    void begin();
+
+    /**
+     * @brief Pede o barramento
+     * @param dev Dispositivo
+     * @param timeoutMs 0 = tentar uma vez, SPI_ARB_WAIT_FOREVER = aguardar
+     * @return true se concedido (chamar release() depois)
+     */
+    bool acquire(SpiDevice dev, uint32_t timeoutMs);
+
+    /**
+     * @brief Libera o barramento
+     */
+    void release(SpiDevice dev);
+
+    /**
+     * @brief Dispositivo dono do barramento (SPI_DEV_COUNT = livre)
+     */
+    SpiDevice owner() const { return currentOwner; }
+
+    /**
+     * @brief Nome e CS de um dispositivo
+     */
+    const SpiDeviceConfig& config(SpiDevice dev) const;
+
+    /**
+     * @brief Estatísticas de um dispositivo (contadores crescentes)
+     */
+    const SpiDeviceStats& deviceStats(SpiDevice dev) const { return stats[dev]; }
+
+    /**
+     * @brief Zera as estatísticas
+     */
+    void resetStats();
+
+    /**
+     * @brief Imprime uso do barramento por dispositivo no Serial
+     */
+    void printStats();
+
+private:
+    SemaphoreHandle_t mutex;
+    volatile SpiDevice currentOwner;
+    volatile uint8_t waiting[SPI_DEV_COUNT];
+    uint32_t holdStartUs;
+    uint32_t statsSinceMs;
+    SpiDeviceStats stats[SPI_DEV_COUNT];
+
+    /**
+     * @brief Há pedido pendente de dispositivo mais prioritário?
+     */
+    bool higherPriorityWaiting(SpiDevice dev) const;
+};
+
+/**
+ * @brief Guarda de escopo: acquire no construtor, release no destrutor
+ *
+ *   SpiBusGuard bus(SPI_DEV_PN532, 20);
+ *   if (!bus) return false;
+ */
+class SpiBusGuard {
+public:
+    SpiBusGuard(SpiDevice dev, uint32_t timeoutMs);
+    ~SpiBusGuard();
+    explicit operator bool() const { return granted; }
+
+private:
+    SpiDevice device;
+    bool granted;
+};
+
+// Instância global (definida em spi_arbiter.cpp)
+extern SpiArbiter spiArbiter;
+
+#endif // SPI_ARBITER_H
@@ -0,0 +1,162 @@
+/**
+ * @file template_archive.h
+ * @brief Backup e restauração dos templates do AS608 em LittleFS
+ * @version 1.0.0
+ * @date 2025-12-07
+ *
+ * O export JSON só leva metadados: trocar o sensor (ou limpar o banco)
+ * obrigava a recadastrar todo mundo. Aqui cada template é lido do sensor
+ * (LoadChar + UpChar) e gravado num arquivo binário; a restauração devolve
+ * cada um com DownChar + Store no mesmo ID.
+ *
+ * Layout em disco (/bio_templates.bin):
+ *   TplArchiveHeader
+ *   N × { TplRecordHeader | template (len bytes) }
+ *
+ * Pipeline (sem bloquear o loop, via update()):
+ *   - Dois buffers: enquanto um template está na UART, o outro é gravado
+ *     (backup) ou já lido do arquivo e conferido (restauração)
+ *   - Cada transferência escreve comandos e pacotes de uma vez
+ *     (As608Async::upload/download); se falhar, repete passo a passo
+ *
+ * A verificação contínua fica pausada durante a operação
+ * (BiometricManager::beginBulk). Os metadados continuam no NVS/JSON.
+ */
+
+#ifndef TEMPLATE_ARCHIVE_H
+#define TEMPLATE_ARCHIVE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "biometric_manager.h"
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+#define TPL_ARCHIVE_FILE        "/bio_templates.bin"
+#define TPL_ARCHIVE_TMP         "/bio_templates.tmp"
+#define TPL_ARCHIVE_MAGIC       0x54504C31  // "TPL1"
+#define TPL_ARCHIVE_TIMEOUT_MS  2000        // Uma transferência (2 comandos + ~600 bytes a 57600)
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Cabeçalho do arquivo
+ */
+struct __attribute__((packed)) TplArchiveHeader {
+    uint32_t magic;             // TPL_ARCHIVE_MAGIC
+    uint16_t count;             // Registros a seguir
+    uint16_t packetLen;         // Pacote de dados do sensor de origem
+};
+
+/**
+ * @brief Cabeçalho de cada registro
+ */
+struct __attribute__((packed)) TplRecordHeader {
+    uint16_t id;                // Página no sensor
+    uint16_t len;               // Bytes do template
+    uint32_t crc;               // CRC32 do template
+};
+
+/**
+ * @brief Operação em andamento
+ */
+enum TplArchiveState {
+    TPL_ARCHIVE_IDLE = 0,
+    TPL_ARCHIVE_BACKUP,
+    TPL_ARCHIVE_RESTORE
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// CLASSE TEMPLATEARCHIVE
+// ═══════════════════════════════════════════════════════════════════════
+
+class TemplateArchive {
+public:
+    /**
+     * @brief Construtor
+     */
+    TemplateArchive();
+
+    /**
+     * @brief Inicia o backup de todos os IDs com metadados
+     * @return false se o sensor não estiver pronto ou já houver operação
+     */
+    bool startBackup();
+
+    /**
+     * @brief Inicia a gravação no sensor dos templates do arquivo
+     * @return false se o arquivo for inválido ou o sensor não estiver pronto
+     */
+    bool startRestore();
+
+    /**
+     * @brief Avança a operação (chamar no loop)
+     */
+    void update();
+
+    /**
+     * @brief Há operação em andamento
+     */
+    bool busy() const { return state != TPL_ARCHIVE_IDLE; }
+
+    /**
+     * @brief Imprime progresso/último resultado no Serial
+     */
+    void printStatus();
+
+private:
+    TplArchiveState state;
+    TplArchiveState lastOp;
+    File file;
+
+    // Backup: IDs a ler
+    uint16_t ids[MAX_FINGERPRINTS];
+    uint16_t idCount;
+    uint16_t nextId;
+
+    // Restauração: registros ainda não lidos do arquivo
+    uint16_t remaining;
+    uint16_t packetLen;
+
+    // Buffers alternados (um na UART, outro no arquivo)
+    uint8_t buf[2][AS608_TEMPLATE_MAX];
+    uint16_t bufLen[2];
+    uint16_t bufId[2];
+    bool bufValid[2];
+    uint8_t cur;                // Buffer da transferência em andamento
+    bool pipelined;             // Modo da tentativa atual
+
+    // Resposta entregue em poll()
+    bool waiting;
+    bool replyPending;
+    As608Reply lastReply;
+
+    // Resultado
+    uint16_t total;
+    uint16_t okCount;
+    uint16_t failCount;
+    uint16_t retryCount;
+    uint16_t corruptCount;
+    uint32_t bytes;
+    uint32_t startUs;
+    uint32_t elapsedUs;
+    bool aborted;
+
+    static void onReply(const As608Reply& reply, void* ctx);
+
+    bool issue();
+    void backupStep(bool ok);
+    void restoreStep(bool ok);
+    bool readRecord(uint8_t slot);
+    bool writeRecord(uint8_t slot);
+    void finish();
+};
+
+// Instância global (definida em template_archive.cpp)
+extern TemplateArchive templateArchive;
+
+#endif // TEMPLATE_ARCHIVE_H
@@ -2,7 +2,7 @@
  * @file wifi_config.h
  * @brief Configurações e estruturas para Wi-Fi e API REST
  * @date 22/11/2025
- * @version 1.0
+ * @version 1.1
  * 
  * Sistema completo de gerenciamento Wi-Fi para ESP32
  * - Modo Station (conectar a redes existentes)
@@ -11,6 +11,12 @@
  * - Persistência de credenciais em NVS
  * - Reconexão automática
  * - mDNS para acesso por nome
+ * 
+ * v1.1: Servidor HTTP passou para o AsyncWebServer. O WebServer síncrono
+ * dependia de handleClient() no loop; agora as requisições são atendidas
+ * pela tarefa async_tcp (núcleo 0), longe do LVGL/leitores no loop.
+ * Handlers não podem bloquear: scan e conexão rodam em segundo plano e
+ * respondem 202 enquanto não terminam.
  */
 
 #ifndef WIFI_CONFIG_H
@@ -18,7 +24,8 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <WebServer.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
 #include <Preferences.h>
 #include <ArduinoJson.h>
 
@@ -26,8 +33,8 @@
  * VARIÁVEIS GLOBAIS WI-FI
  * ========================================================================== */
 
-// Servidor Web
-extern WebServer server;
+// Servidor Web (AsyncWebServer, tarefa async_tcp)
+extern AsyncWebServer server;
 
 // Armazenamento persistente
 extern Preferences wifiPrefs;
@@ -43,6 +50,28 @@ extern unsigned long lastWiFiCheck;
  * ESTRUTURAS DE DADOS
  * ========================================================================== */
 
+/**
+ * @brief Carga da API HTTP (API STATS)
+ */
+struct ApiStats {
+    uint32_t requests;      // Requisições atendidas
+    uint64_t busyUs;        // Tempo total nos handlers (tarefa async_tcp)
+    uint32_t maxUs;         // Handler mais lento
+};
+
+extern ApiStats apiStats;
+
+/**
+ * @brief Mede o handler do início ao fim do escopo
+ */
+class ApiRequestTimer {
+public:
+    ApiRequestTimer() : t0(micros()) {}
+    ~ApiRequestTimer();
+private:
+    uint32_t t0;
+};
+
 /**
  * @brief Informações de rede Wi-Fi escaneada
  */
@@ -148,12 +177,19 @@ void setupAPIRoutes();
  * @brief Verifica autenticação via API Key
  * @return true se autenticado (header X-API-Key válido)
  */
-bool checkAPIKey();
+bool checkAPIKey(AsyncWebServerRequest *request);
 
 /**
  * @brief Envia headers CORS para requisições OPTIONS
  */
-void handleCORS();
+void handleCORS(AsyncWebServerRequest *request);
+
+/**
+ * @brief Imprime requisições/s e tempo nos handlers desde a última chamada
+ * @param loopMaxUs Maior intervalo entre loops no mesmo período (medido no loop)
+ * @param loopAvgUs Intervalo médio entre loops
+ */
+void printApiStats(uint32_t loopMaxUs, uint32_t loopAvgUs);
 
 /* ============================================================================
  * HANDLERS DA API - DECLARAÇÕES
@@ -162,6 +198,7 @@ void handleCORS();
 /**
  * @brief GET /api/wifi/scan - Escaneia redes Wi-Fi disponíveis
  * 
+ * Scan assíncrono: 202 {"scanning":true} enquanto roda (repetir a chamada)
  * Retorna JSON com array de redes encontradas
  * Exemplo de resposta:
  * {
@@ -176,7 +213,7 @@ void handleCORS();
  *   ]
  * }
  */
-void handleWiFiScan();
+void handleWiFiScan(AsyncWebServerRequest *request);
 
 /**
  * @brief POST /api/wifi/connect - Conecta a uma rede Wi-Fi
@@ -187,15 +224,14 @@ void handleWiFiScan();
  *   "password": "minhaSenha"
  * }
  * 
- * Resposta JSON:
+ * Resposta JSON (202 - a conexão roda em uma tarefa própria):
  * {
  *   "success": true,
- *   "message": "Conectado com sucesso",
- *   "ip": "192.168.1.100",
- *   "rssi": -45
+ *   "message": "Conectando..."
  * }
+ * Resultado em GET /api/wifi/status ("connecting" / "connected")
  */
-void handleWiFiConnect();
+void handleWiFiConnect(AsyncWebServerRequest *request, uint8_t *data, size_t len);
 
 /**
  * @brief GET /api/wifi/status - Retorna status da conexão atual
@@ -211,7 +247,7 @@ void handleWiFiConnect();
  *   "dns": "8.8.8.8"
  * }
  */
-void handleWiFiStatus();
+void handleWiFiStatus(AsyncWebServerRequest *request);
 
 /**
  * @brief POST /api/wifi/disconnect - Desconecta da rede atual
@@ -223,7 +259,7 @@ void handleWiFiStatus();
  *   "success": true
  * }
  */
-void handleWiFiDisconnect();
+void handleWiFiDisconnect(AsyncWebServerRequest *request);
 
 /**
  * @brief GET / - Página inicial (portal de configuração)
@@ -231,11 +267,11 @@ void handleWiFiDisconnect();
  * Retorna HTML completo do portal de configuração
  * Interface web para escanear e conectar a redes Wi-Fi
  */
-void handleRoot();
+void handleRoot(AsyncWebServerRequest *request);
 
 /**
  * @brief 404 - Página não encontrada
  */
-void handleNotFound();
+void handleNotFound(AsyncWebServerRequest *request);
 
 #endif // WIFI_CONFIG_H
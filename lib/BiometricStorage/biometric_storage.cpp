@@ -14,6 +14,7 @@
 BiometricStorage::BiometricStorage() : initialized(false) {
     // Reservar espaço para evitar realocações
     users.reserve(MAX_FINGERPRINTS);
+    rebuildIndex();
 }
 
 // ═══════════════════════════════════════════════════════════════════════
@@ -75,6 +76,10 @@ bool BiometricStorage::addUser(const BiometricUser& user) {
         users.pop_back();  // Remover se falhou
         return false;
     }
+    if (occupied.valid(user.slotId)) {
+        occupied.set(user.slotId);
+        slotIndex[user.slotId] = users.size() - 1;
+    }
     
     Serial.printf("✅ [BiometricStorage] Usuário %s cadastrado (Slot %d)\n", 
         user.userName.c_str(), user.slotId);
@@ -91,8 +96,16 @@ bool BiometricStorage::removeUser(uint16_t slotId) {
         return false;
     }
     
-    // Remover do vetor
-    users.erase(users.begin() + index);
+    // Remover do vetor em O(1): o último ocupa o lugar
+    occupied.reset(slotId);
+    if ((size_t)index != users.size() - 1) {
+        uint16_t moved = users.back().slotId;
+        users[index] = users.back();
+        if (occupied.test(moved) && slotIndex[moved] == (int16_t)(users.size() - 1)) {
+            slotIndex[moved] = index;
+        }
+    }
+    users.pop_back();
     
     // Salvar
     if (!save()) {
@@ -128,6 +141,19 @@ bool BiometricStorage::updateLastAccess(uint16_t slotId, uint16_t confidence) {
     return save();
 }
 
+bool BiometricStorage::moveUser(uint16_t fromSlot, uint16_t toSlot) {
+    if (!initialized) return false;
+    
+    int index = findUserIndex(fromSlot);
+    if (index < 0 || findUserIndex(toSlot) >= 0) return false;
+    
+    users[index].slotId = toSlot;
+    rebuildIndex();
+    
+    Serial.printf("🔀 [BiometricStorage] Slot %d → %d\n", fromSlot, toSlot);
+    return save();
+}
+
 // ═══════════════════════════════════════════════════════════════════════
 // CONSULTAS
 // ═══════════════════════════════════════════════════════════════════════
@@ -150,30 +176,18 @@ int BiometricStorage::count() {
 }
 
 uint16_t BiometricStorage::getNextFreeSlot() {
-    // Criar set com slots ocupados
-    bool occupied[MAX_FINGERPRINTS + 1] = {false};
-    
-    for (const BiometricUser& user : users) {
-        if (user.slotId <= MAX_FINGERPRINTS) {
-            occupied[user.slotId] = true;
-        }
-    }
-    
-    // Encontrar primeiro slot livre (começando do 1)
-    for (uint16_t i = 1; i <= MAX_FINGERPRINTS; i++) {
-        if (!occupied[i]) {
-            return i;
-        }
-    }
+    // Primeiro bit zero do bitmap (começando do 1)
+    uint16_t slot = occupied.firstFree();
     
     // Nenhum slot livre
-    return MAX_FINGERPRINTS + 1;
+    return slot ? slot : MAX_FINGERPRINTS + 1;
 }
 
 bool BiometricStorage::clearAll() {
     if (!initialized) return false;
     
     users.clear();
+    rebuildIndex();
     return save();
 }
 
@@ -184,7 +198,7 @@ bool BiometricStorage::clearAll() {
 String BiometricStorage::exportJSON() {
     if (!initialized) return "{}";
     
-    StaticJsonDocument<4096> doc;
+    DynamicJsonDocument doc(BIO_STORAGE_DOC_SIZE(users.size()));
     JsonArray array = doc.createNestedArray("users");
     
     for (const BiometricUser& user : users) {
@@ -207,7 +221,7 @@ String BiometricStorage::exportJSON() {
 bool BiometricStorage::importJSON(const String& json) {
     if (!initialized) return false;
     
-    StaticJsonDocument<4096> doc;
+    DynamicJsonDocument doc(BIO_STORAGE_PARSE_SIZE(json.length()));
     DeserializationError error = deserializeJson(doc, json);
     
     if (error) {
@@ -238,6 +252,7 @@ bool BiometricStorage::importJSON(const String& json) {
         
         users.push_back(user);
     }
+    rebuildIndex();
     
     Serial.printf("✅ [BiometricStorage] Importados %d usuário(s)\n", users.size());
     
@@ -272,7 +287,7 @@ bool BiometricStorage::load() {
     }
     
     // Parsear JSON
-    StaticJsonDocument<4096> doc;
+    DynamicJsonDocument doc(BIO_STORAGE_PARSE_SIZE(content.length()));
     DeserializationError error = deserializeJson(doc, content);
     
     if (error) {
@@ -302,6 +317,7 @@ bool BiometricStorage::load() {
         
         users.push_back(user);
     }
+    rebuildIndex();
     
     Serial.printf("✅ [BiometricStorage] Carregados %d usuário(s)\n", users.size());
     
@@ -310,7 +326,7 @@ bool BiometricStorage::load() {
 
 bool BiometricStorage::save() {
     // Criar JSON
-    StaticJsonDocument<4096> doc;
+    DynamicJsonDocument doc(BIO_STORAGE_DOC_SIZE(users.size()));
     JsonArray array = doc.createNestedArray("users");
     
     for (const BiometricUser& user : users) {
@@ -351,6 +367,11 @@ bool BiometricStorage::save() {
 // ═══════════════════════════════════════════════════════════════════════
 
 int BiometricStorage::findUserIndex(uint16_t slotId) {
+    if (occupied.valid(slotId)) {
+        return occupied.test(slotId) ? slotIndex[slotId] : -1;
+    }
+    
+    // Slot fora da faixa (arquivo antigo/importado): fora da tabela
     for (size_t i = 0; i < users.size(); i++) {
         if (users[i].slotId == slotId) {
             return i;
@@ -358,3 +379,15 @@ int BiometricStorage::findUserIndex(uint16_t slotId) {
     }
     return -1;
 }
+
+void BiometricStorage::rebuildIndex() {
+    occupied.clear();
+    memset(slotIndex, 0xFF, sizeof(slotIndex));
+    
+    for (size_t i = 0; i < users.size(); i++) {
+        uint16_t slot = users[i].slotId;
+        if (!occupied.valid(slot) || occupied.test(slot)) continue;  // Duplicado: vale o primeiro
+        occupied.set(slot);
+        slotIndex[slot] = i;
+    }
+}
@@ -15,13 +15,18 @@
 #include <LittleFS.h>
 #include <ArduinoJson.h>
 #include <vector>
+#include "slot_bitmap.h"
 
 // ═══════════════════════════════════════════════════════════════════════
 // CONFIGURAÇÕES
 // ═══════════════════════════════════════════════════════════════════════
 
 #define BIOMETRIC_STORAGE_FILE  "/biometric_users.json"
-#define MAX_FINGERPRINTS        127
+#define MAX_FINGERPRINTS        300     // = AS608_MAX_CAPACITY (mesmo valor de biometric_manager.h)
+
+// JSON dimensionado pela quantidade (4KB fixos cabiam ~25 usuários)
+#define BIO_STORAGE_DOC_SIZE(n)     (JSON_ARRAY_SIZE(n) + (n) * (JSON_OBJECT_SIZE(8) + 96) + 256)
+#define BIO_STORAGE_PARSE_SIZE(len) ((len) * 2 + 1024)
 
 // ═══════════════════════════════════════════════════════════════════════
 // ESTRUTURAS
@@ -31,7 +36,7 @@
  * @brief Estrutura de metadados de usuário biométrico
  */
 struct BiometricUser {
-    uint16_t slotId;            // ID no sensor AS608 (1-127)
+    uint16_t slotId;            // ID no sensor AS608 (1-MAX_FINGERPRINTS)
     String userId;              // ID único do usuário
     String userName;            // Nome do usuário
     uint32_t registeredAt;      // Timestamp de cadastro
@@ -88,6 +93,14 @@ public:
      */
     bool updateLastAccess(uint16_t slotId, uint16_t confidence);
     
+    /**
+     * @brief Troca o slot de um usuário (template movido no sensor)
+     * @param fromSlot Slot atual
+     * @param toSlot Novo slot (deve estar livre)
+     * @return true se movido com sucesso
+     */
+    bool moveUser(uint16_t fromSlot, uint16_t toSlot);
+    
     /**
      * @brief Busca usuário por slot ID
      * @param slotId ID do slot
@@ -109,7 +122,7 @@ public:
     
     /**
      * @brief Retorna próximo slot livre
-     * @return ID do próximo slot livre (1-127, ou >127 se cheio)
+     * @return ID do próximo slot livre (1-MAX_FINGERPRINTS, ou MAX_FINGERPRINTS+1 se cheio)
      */
     uint16_t getNextFreeSlot();
     
@@ -135,6 +148,8 @@ public:
 private:
     std::vector<BiometricUser> users;
     bool initialized;
+    SlotBitmap<MAX_FINGERPRINTS> occupied;      // Slots com usuário
+    int16_t slotIndex[MAX_FINGERPRINTS + 1];    // Slot → índice em users
     
     /**
      * @brief Carrega dados do arquivo
@@ -154,6 +169,11 @@ private:
      * @return Índice (-1 se não encontrado)
      */
     int findUserIndex(uint16_t slotId);
+    
+    /**
+     * @brief Refaz bitmap e tabela slot → índice a partir de users
+     */
+    void rebuildIndex();
 };
 
 #endif // BIOMETRIC_STORAGE_H
@@ -0,0 +1,78 @@
+/**
+ * @file slot_bitmap.h
+ * @brief Bitmap de ocupação dos slots do sensor biométrico
+ * @version 1.0.0
+ * @date 2025-12-07
+ *
+ * Um bit por slot (bit i = slot i; o slot 0 não é usado pelo cadastro).
+ * Consulta/marcação em O(1) e próximo slot livre por "find first zero"
+ * de 32 em 32 slots (__builtin_ctz), no lugar das varreduras lineares de
+ * BiometricManager e BiometricStorage.
+ */
+
+#ifndef SLOT_BITMAP_H
+#define SLOT_BITMAP_H
+
+#include <Arduino.h>
+
+template <uint16_t MAX_SLOT>
+class SlotBitmap {
+public:
+    SlotBitmap() { clear(); }
+
+    void clear() { memset(words, 0, sizeof(words)); }
+
+    bool valid(uint16_t slot) const { return slot >= 1 && slot <= MAX_SLOT; }
+
+    bool test(uint16_t slot) const {
+        return valid(slot) && (words[slot >> 5] & (1UL << (slot & 31)));
+    }
+
+    void set(uint16_t slot) {
+        if (valid(slot)) words[slot >> 5] |= (1UL << (slot & 31));
+    }
+
+    void reset(uint16_t slot) {
+        if (valid(slot)) words[slot >> 5] &= ~(1UL << (slot & 31));
+    }
+
+    /**
+     * @brief Primeiro slot livre a partir de 'from' (0 = cheio)
+     */
+    uint16_t firstFree(uint16_t from = 1) const {
+        if (from < 1) from = 1;
+        for (uint16_t w = from >> 5; w < WORDS; w++) {
+            uint32_t bits = ~words[w];
+            if (w == (from >> 5)) bits &= ~((1UL << (from & 31)) - 1);  // Abaixo de 'from'
+            if (bits == 0) continue;
+            uint16_t slot = (w << 5) + __builtin_ctz(bits);
+            return slot <= MAX_SLOT ? slot : 0;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Maior slot ocupado (0 = vazio)
+     */
+    uint16_t highest() const {
+        for (int16_t w = WORDS - 1; w >= 0; w--) {
+            if (words[w]) return (w << 5) + 31 - __builtin_clz(words[w]);
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Slots ocupados
+     */
+    uint16_t count() const {
+        uint16_t n = 0;
+        for (uint16_t w = 0; w < WORDS; w++) n += __builtin_popcount(words[w]);
+        return n;
+    }
+
+private:
+    static const uint16_t WORDS = (MAX_SLOT >> 5) + 1;
+    uint32_t words[WORDS];
+};
+
+#endif // SLOT_BITMAP_H
@@ -0,0 +1,363 @@
+"""
+@file font_subset.py
+@brief Gera fontes Montserrat com apenas os glifos usados pela UI (pre-build)
+@version 1.0.0
+@date 2025-12-06
+
+Executado pelo PlatformIO antes da compilação (extra_scripts = pre:...).
+
+1. Lê em include/lv_conf.h quais tamanhos LV_FONT_MONTSERRAT_N estão ativos
+2. Varre src/ e include/ atrás de literais de string e LV_SYMBOL_*
+3. Para cada tamanho decide o conjunto de glifos:
+   - "estático": todos os labels com essa fonte recebem só literais
+     (ex.: ícone de 48px) → apenas esses glifos
+   - "dinâmico": texto em runtime, estilo compartilhado, tema/padrão ou
+     textarea → ASCII imprimível + acentos PT-BR + glifos de todos os
+     literais + símbolos usados internamente pelos widgets da LVGL
+4. Gera src/fonts/lv_font_montserrat_N.c com lv_font_conv (mesmos nomes
+   das fontes embutidas, que são desligadas em lv_conf.h via LV_FONT_SUBSET)
+5. Imprime o relatório: glifos e bytes de bitmap (subset x embutida)
+
+Se lv_font_conv (npx) ou os arquivos de fonte não estiverem disponíveis,
+o build segue com as fontes completas da LVGL (LV_FONT_SUBSET não é definido).
+
+Desativar: custom_font_subset = 0 no platformio.ini.
+"""
+
+Import("env")  # noqa: F821 (injetado pelo PlatformIO)
+
+import glob
+import hashlib
+import os
+import re
+import subprocess
+
+SCRIPT_VERSION = "2"
+
+PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+OUT_DIR = os.path.join(PROJECT_DIR, "src", "fonts")
+LV_CONF = os.path.join(PROJECT_DIR, "include", "lv_conf.h")
+LVGL_DIR = os.path.join(env.subst("$PROJECT_LIBDEPS_DIR"), env.subst("$PIOENV"), "lvgl")  # noqa: F821
+HASH_FILE = os.path.join(OUT_DIR, ".subset_hash")
+
+LV_FONT_CONV = ["npx", "--yes", "lv_font_conv@1.5.2"]
+
+# Fontes de origem: pasta do projeto tem prioridade sobre a da LVGL
+FONT_DIRS = [
+    os.path.join(PROJECT_DIR, "scripts", "fonts"),
+    os.path.join(LVGL_DIR, "scripts", "built_in_font"),
+]
+FONT_TEXT = "Montserrat-Medium.ttf"
+FONT_SYMBOLS = "FontAwesome5-Solid+Brands+Regular.woff"
+
+# Texto que pode chegar em runtime (nomes, IP, datas, teclado virtual)
+PT_BR_ACCENTS = "ÀÁÂÃÇÉÊÍÓÔÕÚàáâãçéêíóôõúº°"
+
+# Símbolos usados pelos próprios widgets (teclado, dropdown, msgbox, textarea)
+LVGL_INTERNAL_SYMBOLS = [
+    "LV_SYMBOL_BACKSPACE", "LV_SYMBOL_NEW_LINE", "LV_SYMBOL_OK", "LV_SYMBOL_CLOSE",
+    "LV_SYMBOL_KEYBOARD", "LV_SYMBOL_LEFT", "LV_SYMBOL_RIGHT", "LV_SYMBOL_UP",
+    "LV_SYMBOL_DOWN", "LV_SYMBOL_BULLET",
+]
+
+# Faixas cobertas pela Montserrat (o resto, ex.: emoji, não é renderizável)
+TEXT_RANGES = [(0x20, 0x7E), (0xA0, 0x17F)]
+
+
+# ════════════════════════════════════════════════════════════════
+# PARSE DE C
+# ════════════════════════════════════════════════════════════════
+
+STRING_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+SYMBOL_RE = re.compile(r"\bLV_SYMBOL_\w+\b")
+# Declarações (lv_conf.h, LV_FONT_CUSTOM_DECLARE) não são uso da fonte
+DECLARE_RE = re.compile(r"\bLV_FONT_DECLARE\(\s*\w+\s*\)")
+
+
+def decode_c_string(body):
+    """Converte o conteúdo de um literal C (com escapes) em texto UTF-8."""
+    out = bytearray()
+    i = 0
+    while i < len(body):
+        c = body[i]
+        if c != "\\":
+            out += c.encode("utf-8")
+            i += 1
+            continue
+        nxt = body[i + 1] if i + 1 < len(body) else ""
+        if nxt == "x":
+            m = re.match(r"[0-9a-fA-F]{1,2}", body[i + 2:])
+            if m:
+                out.append(int(m.group(0), 16))
+                i += 2 + len(m.group(0))
+                continue
+        elif nxt in "01234567":
+            m = re.match(r"[0-7]{1,3}", body[i + 1:])
+            out.append(int(m.group(0), 8) & 0xFF)
+            i += 1 + len(m.group(0))
+            continue
+        out += {"n": b"\n", "t": b"\t", "r": b"\r"}.get(nxt, nxt.encode("utf-8"))
+        i += 2
+    return out.decode("utf-8", errors="ignore")
+
+
+def call_args(text, start):
+    """Retorna o texto entre parênteses balanceados a partir de text[start] == '('."""
+    depth = 0
+    i = start
+    in_str = False
+    while i < len(text):
+        c = text[i]
+        if in_str:
+            if c == "\\":
+                i += 1
+            elif c == '"':
+                in_str = False
+        elif c == '"':
+            in_str = True
+        elif c == "(":
+            depth += 1
+        elif c == ")":
+            depth -= 1
+            if depth == 0:
+                return text[start + 1:i]
+        i += 1
+    return ""
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", " ", text, flags=re.S)
+    return re.sub(r"//[^\n]*", " ", text)
+
+
+# ════════════════════════════════════════════════════════════════
+# COLETA
+# ════════════════════════════════════════════════════════════════
+
+def load_symbols():
+    """Mapa LV_SYMBOL_X → codepoint, lido do lv_symbol_def.h da LVGL."""
+    path = os.path.join(LVGL_DIR, "src", "font", "lv_symbol_def.h")
+    symbols = {}
+    with open(path, encoding="utf-8") as f:
+        for m in re.finditer(r'#define\s+(LV_SYMBOL_\w+)\s+"([^"]+)"', f.read()):
+            txt = decode_c_string(m.group(2))
+            if len(txt) == 1:
+                symbols[m.group(1)] = ord(txt)
+    return symbols
+
+
+def enabled_sizes():
+    with open(LV_CONF, encoding="utf-8") as f:
+        return sorted({int(s) for s in re.findall(r"#define\s+LV_FONT_MONTSERRAT_(\d+)\s+1\b", f.read())})
+
+
+def source_files():
+    files = []
+    for pattern in ("src/**/*.cpp", "src/**/*.c", "src/**/*.h", "include/**/*.h"):
+        files += glob.glob(os.path.join(PROJECT_DIR, pattern), recursive=True)
+    return [f for f in files if not f.startswith(OUT_DIR)]
+
+
+def literal_codepoints(expr, symbols):
+    cps = set()
+    for m in STRING_RE.finditer(expr):
+        cps.update(ord(c) for c in decode_c_string(m.group(1)))
+    for name in SYMBOL_RE.findall(expr):
+        if name in symbols:
+            cps.add(symbols[name])
+    return cps
+
+
+def is_literal_only(expr):
+    rest = STRING_RE.sub("", expr)
+    rest = SYMBOL_RE.sub("", rest)
+    return rest.strip() == ""
+
+
+def collect(symbols, sizes):
+    """Retorna (glifos globais, {tamanho: glifos estáticos ou None se dinâmico})."""
+    sources = {}
+    for path in source_files():
+        with open(path, encoding="utf-8", errors="ignore") as f:
+            sources[path] = DECLARE_RE.sub(" ", strip_comments(f.read()))
+
+    global_cps = set()
+    for text in sources.values():
+        global_cps |= literal_codepoints(text, symbols)
+
+    per_size = {}
+    for size in sizes:
+        font_ref = "lv_font_montserrat_%d" % size
+        direct = re.compile(r"lv_obj_set_style_text_font\(\s*(\w+)\s*,\s*&%s\b" % font_ref)
+
+        total_refs = sum(len(re.findall(r"\b%s\b" % font_ref, t)) for t in sources.values())
+        variables = set()
+        for text in sources.values():
+            variables.update(direct.findall(text))
+        direct_refs = sum(len(direct.findall(t)) for t in sources.values())
+
+        # Referência fora de lv_obj_set_style_text_font (estilo, tema, padrão) → dinâmico
+        if total_refs == 0 or total_refs != direct_refs:
+            per_size[size] = None
+            continue
+
+        cps = {0x20}
+        dynamic = False
+        for var in variables:
+            setter = re.compile(r"\b(lv_\w+)\(\s*%s\s*," % re.escape(var))
+            found = False
+            for text in sources.values():
+                for m in setter.finditer(text):
+                    fn = m.group(1)
+                    if fn in ("lv_label_set_text", "lv_label_set_text_static"):
+                        args = call_args(text, text.index("(", m.start()))
+                        expr = args.split(",", 1)[1] if "," in args else ""
+                        if not is_literal_only(expr):
+                            dynamic = True
+                        cps |= literal_codepoints(expr, symbols)
+                        found = True
+                    elif fn.startswith(("lv_label_set_text", "lv_textarea_", "lv_btnmatrix_",
+                                        "lv_dropdown_", "lv_roller_", "lv_keyboard_")):
+                        dynamic = True
+            if not found:
+                dynamic = True
+        per_size[size] = None if dynamic else cps
+
+    return global_cps, per_size
+
+
+def split_ranges(cps, symbol_cps):
+    def in_text_range(cp):
+        return any(lo <= cp <= hi for lo, hi in TEXT_RANGES)
+
+    text = sorted(cp for cp in cps if in_text_range(cp))
+    syms = sorted(cp for cp in cps if cp in symbol_cps)
+    return text, syms
+
+
+def to_range_arg(cps):
+    """[0x20,0x21,0x22,0x30] → '0x20-0x22,0x30' (formato do lv_font_conv)."""
+    parts = []
+    i = 0
+    while i < len(cps):
+        j = i
+        while j + 1 < len(cps) and cps[j + 1] == cps[j] + 1:
+            j += 1
+        parts.append("0x%X" % cps[i] if i == j else "0x%X-0x%X" % (cps[i], cps[j]))
+        i = j + 1
+    return ",".join(parts)
+
+
+# ════════════════════════════════════════════════════════════════
+# GERAÇÃO
+# ════════════════════════════════════════════════════════════════
+
+def find_font(name):
+    for d in FONT_DIRS:
+        path = os.path.join(d, name)
+        if os.path.isfile(path):
+            return path
+    return None
+
+
+def generate(size, text_cps, sym_cps, font_text, font_sym):
+    out = os.path.join(OUT_DIR, "lv_font_montserrat_%d.c" % size)
+    cmd = LV_FONT_CONV + [
+        "--no-compress", "--no-prefilter", "--bpp", "4", "--size", str(size),
+        "--font", font_text, "-r", to_range_arg(text_cps or [0x20]),
+    ]
+    if sym_cps:
+        cmd += ["--font", font_sym, "-r", to_range_arg(sym_cps)]
+    cmd += ["--format", "lvgl", "--force-fast-kern-format",
+            "--lv-font-name", "lv_font_montserrat_%d" % size, "-o", out]
+
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+
+    # Mesmo nome da fonte embutida: o guard passa a ser LV_FONT_SUBSET
+    with open(out, encoding="utf-8") as f:
+        src = f.read()
+    src = re.sub(r"^#if LV_FONT_MONTSERRAT_%d\s*$" % size, "#if LV_FONT_SUBSET", src, flags=re.M)
+    with open(out, "w", encoding="utf-8") as f:
+        f.write(src)
+    return out
+
+
+def font_cost(path):
+    """(glifos, bytes de bitmap, cmaps) de um .c gerado pelo lv_font_conv."""
+    with open(path, encoding="utf-8") as f:
+        src = f.read()
+    m = re.search(r"glyph_bitmap\[\]\s*=\s*\{(.*?)\};", src, flags=re.S)
+    bitmap = len(re.findall(r"0x[0-9a-fA-F]{2}", m.group(1))) if m else 0
+    glyphs = max(len(re.findall(r"\{\.bitmap_index", src)) - 1, 0)  # id 0 é reservado
+    cmaps = len(re.findall(r"\.type\s*=\s*LV_FONT_FMT_TXT_CMAP_", src))
+    return glyphs, bitmap, cmaps
+
+
+def report(sizes):
+    print("🔤 [FontSubset] Tamanho  Glifos (sub/orig)  Bitmap bytes (sub/orig)  cmaps (sub/orig)")
+    saved = 0
+    for size in sizes:
+        sub = font_cost(os.path.join(OUT_DIR, "lv_font_montserrat_%d.c" % size))
+        orig_path = os.path.join(LVGL_DIR, "src", "font", "lv_font_montserrat_%d.c" % size)
+        orig = font_cost(orig_path) if os.path.isfile(orig_path) else (0, 0, 0)
+        # glyph_dsc = 8 bytes por glifo
+        saved += (orig[1] + orig[0] * 8) - (sub[1] + sub[0] * 8)
+        print("🔤 [FontSubset]   %3d px   %5d / %-5d        %7d / %-7d         %d / %d"
+              % (size, sub[0], orig[0], sub[1], orig[1], sub[2], orig[2]))
+    print("🔤 [FontSubset] Flash economizada (bitmap + glyph_dsc): ~%d KB" % (saved // 1024))
+
+
+def main():
+    if env.GetProjectOption("custom_font_subset", "1").strip() in ("0", "false", "no"):  # noqa: F821
+        print("🔤 [FontSubset] Desativado (custom_font_subset = 0) - fontes completas")
+        return
+
+    font_text = find_font(FONT_TEXT)
+    font_sym = find_font(FONT_SYMBOLS)
+    if not os.path.isdir(LVGL_DIR) or not font_text or not font_sym:
+        print("⚠️ [FontSubset] LVGL ou arquivos .ttf/.woff não encontrados - fontes completas")
+        return
+
+    symbols = load_symbols()
+    symbol_cps = set(symbols.values())
+    sizes = enabled_sizes()
+    global_cps, per_size = collect(symbols, sizes)
+
+    dynamic_cps = set(global_cps)
+    dynamic_cps |= set(range(0x20, 0x7F))
+    dynamic_cps |= {ord(c) for c in PT_BR_ACCENTS}
+    dynamic_cps |= {symbols[s] for s in LVGL_INTERNAL_SYMBOLS if s in symbols}
+
+    plan = {}
+    for size in sizes:
+        cps = per_size[size] if per_size[size] is not None else dynamic_cps
+        plan[size] = split_ranges(cps, symbol_cps)
+
+    digest = hashlib.sha1(repr((SCRIPT_VERSION, sorted(plan.items()))).encode()).hexdigest()
+    os.makedirs(OUT_DIR, exist_ok=True)
+    outputs = [os.path.join(OUT_DIR, "lv_font_montserrat_%d.c" % s) for s in sizes]
+    cached = (os.path.isfile(HASH_FILE) and open(HASH_FILE).read().strip() == digest
+              and all(os.path.isfile(o) for o in outputs))
+
+    if not cached:
+        try:
+            for size in sizes:
+                text_cps, sym_cps = plan[size]
+                kind = "estático" if per_size[size] is not None else "dinâmico"
+                print("🔤 [FontSubset] montserrat_%d (%s): %d texto + %d símbolos"
+                      % (size, kind, len(text_cps), len(sym_cps)))
+                generate(size, text_cps, sym_cps, font_text, font_sym)
+        except (OSError, subprocess.CalledProcessError) as e:
+            print("⚠️ [FontSubset] lv_font_conv falhou (%s) - fontes completas" % e)
+            for o in outputs:
+                if os.path.isfile(o):
+                    os.remove(o)
+            return
+        with open(HASH_FILE, "w") as f:
+            f.write(digest)
+
+    report(sizes)
+    env.Append(CPPDEFINES=[("LV_FONT_SUBSET", 1)])  # noqa: F821
+
+
+main()
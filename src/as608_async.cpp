@@ -0,0 +1,599 @@
+/**
+ * @file as608_async.cpp
+ * @brief Implementação do driver não bloqueante do AS608
+ * @version 1.3.1
+ * @date 2025-12-07
+ */
+
+#include "as608_async.h"
+
+#define AS608_HDR1      0xEF
+#define AS608_HDR2      0x01
+#define AS608_PID_CMD   0x01
+#define AS608_PID_ACK   0x07
+#define AS608_PID_DATA  0x02
+#define AS608_PID_END   0x08
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONSTRUTOR / INICIALIZAÇÃO
+// ═══════════════════════════════════════════════════════════════════════
+
+As608Async::As608Async()
+    : serial(NULL),
+      address(0xFFFFFFFF),
+      inFlight(false),
+      command(0),
+      sentUs(0),
+      sentMs(0),
+      timeoutMs(0),
+      replyCb(NULL),
+      replyCtx(NULL),
+      parseState(PARSE_HDR1),
+      parseIdx(0),
+      pid(0),
+      bodyLen(0),
+      generation(0),
+      frameError(false),
+      ackCount(0),
+      ackIdx(0),
+      sink(NULL),
+      sinkCap(0),
+      sinkLen(0),
+      lateWindow(false),
+      lateUntilMs(0),
+      deferTx(false),
+      txLen(0),
+      replyReady(false),
+      searchCb(NULL),
+      searchCtx(NULL),
+      searchStartUs(0),
+      searchStart(0),
+      searchCount(0),
+      matchPage(0),
+      xferCb(NULL),
+      xferCtx(NULL),
+      xferTpl(NULL),
+      xferDst(NULL),
+      xferLen(0),
+      xferPacketLen(0),
+      xferId(0),
+      xferTimeout(0),
+      commands(0),
+      badFrames(0),
+      timeouts(0),
+      stale(0) {
+    lock = portMUX_INITIALIZER_UNLOCKED;
+    memset(&reply, 0, sizeof(reply));
+    memset(&search, 0, sizeof(search));
+    memset(ackCmd, 0, sizeof(ackCmd));
+}
+
+void As608Async::begin(HardwareSerial* s, uint32_t addr) {
+    serial = s;
+    address = addr;
+    // Callback roda na tarefa de eventos da UART criada pelo HardwareSerial
+    serial->onReceive([this]() { onUartData(); });
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// ENVIO
+// ═══════════════════════════════════════════════════════════════════════
+
+bool As608Async::send(uint8_t cmd, const uint8_t* params, uint8_t len, uint32_t timeout,
+                      As608ReplyCallback cb, void* ctx) {
+    if (len > AS608_ASYNC_MAX_PAYLOAD) return false;
+    if (!arm(cmd, 0, NULL, 0, timeout, cb, ctx)) return false;
+
+    writeCommand(cmd, params, len);
+    return true;
+}
+
+bool As608Async::arm(uint8_t cmd1, uint8_t cmd2, uint8_t* dst, uint16_t cap, uint32_t timeout,
+                     As608ReplyCallback cb, void* ctx) {
+    if (serial == NULL || inFlight) return false;
+
+    // Resposta atrasada de um comando que já deu timeout: descartar
+    while (serial->available()) serial->read();
+    bool defer = lateActive();
+
+    portENTER_CRITICAL(&lock);
+    generation++;
+    parseState = PARSE_HDR1;
+    parseIdx = 0;
+    frameError = false;
+    replyReady = false;
+    ackCmd[0] = cmd1;
+    ackCmd[1] = cmd2;
+    ackCount = cmd2 ? 2 : 1;
+    ackIdx = 0;
+    sink = dst;
+    sinkCap = cap;
+    sinkLen = 0;
+    command = cmd1;
+    replyCb = cb;
+    replyCtx = ctx;
+    timeoutMs = timeout;
+    sentUs = micros();
+    sentMs = millis();
+    deferTx = defer;
+    txLen = 0;
+    inFlight = true;
+    portEXIT_CRITICAL(&lock);
+    return true;
+}
+
+bool As608Async::lateActive() {
+    if (lateWindow && (int32_t)(millis() - lateUntilMs) >= 0) lateWindow = false;
+    return lateWindow;
+}
+
+void As608Async::flushDeferred() {
+    while (serial->available()) serial->read();
+
+    portENTER_CRITICAL(&lock);
+    generation++;                           // Nada recebido até aqui vale para este comando
+    parseState = PARSE_HDR1;
+    frameError = false;
+    sentUs = micros();
+    sentMs = millis();
+    deferTx = false;
+    portEXIT_CRITICAL(&lock);
+
+    serial->write(txBuf, txLen);
+    txLen = 0;
+}
+
+uint8_t As608Async::ackPayloadLen(uint8_t cmd) {
+    switch (cmd) {
+        case AS608_CMD_HISPEEDSEARCH: return 5;     // código + página(2) + pontuação(2)
+        case AS608_CMD_MATCH:         return 3;     // código + pontuação(2)
+        case AS608_CMD_READINDEX:     return 33;    // código + 32 bytes da tabela
+        default:                      return 1;
+    }
+}
+
+void As608Async::writePacket(uint8_t packetPid, const uint8_t* payload, uint16_t len) {
+    uint16_t pktLen = len + 2;              // payload + soma
+    uint8_t hdr[9];
+    hdr[0] = AS608_HDR1;
+    hdr[1] = AS608_HDR2;
+    hdr[2] = (uint8_t)(address >> 24);
+    hdr[3] = (uint8_t)(address >> 16);
+    hdr[4] = (uint8_t)(address >> 8);
+    hdr[5] = (uint8_t)(address);
+    hdr[6] = packetPid;
+    hdr[7] = (uint8_t)(pktLen >> 8);
+    hdr[8] = (uint8_t)(pktLen);
+
+    uint16_t sum = packetPid + (pktLen >> 8) + (pktLen & 0xFF);
+    for (uint16_t i = 0; i < len; i++) sum += payload[i];
+    uint8_t tail[2] = { (uint8_t)(sum >> 8), (uint8_t)(sum) };
+
+    if (deferTx) {
+        // Janela de ACK atrasado aberta: sai em flushDeferred()
+        if (txLen + sizeof(hdr) + len + sizeof(tail) > sizeof(txBuf)) return;  // Não cabe: comando dá timeout
+        memcpy(&txBuf[txLen], hdr, sizeof(hdr));
+        memcpy(&txBuf[txLen + sizeof(hdr)], payload, len);
+        memcpy(&txBuf[txLen + sizeof(hdr) + len], tail, sizeof(tail));
+        txLen += sizeof(hdr) + len + sizeof(tail);
+        return;
+    }
+
+    // Com buffer de TX na UART as escritas só copiam (ver BiometricManager::init)
+    serial->write(hdr, sizeof(hdr));
+    serial->write(payload, len);
+    serial->write(tail, sizeof(tail));
+}
+
+void As608Async::writeCommand(uint8_t cmd, const uint8_t* params, uint8_t len) {
+    uint8_t payload[1 + AS608_ASYNC_MAX_PAYLOAD];
+    payload[0] = cmd;
+    if (len) memcpy(&payload[1], params, len);
+    writePacket(AS608_PID_CMD, payload, (uint16_t)len + 1);
+    commands++;
+}
+
+void As608Async::writeData(const uint8_t* tpl, uint16_t len, uint16_t packetLen) {
+    uint16_t off = 0;
+    while (off < len) {
+        uint16_t n = min((uint16_t)(len - off), packetLen);
+        writePacket(off + n >= len ? AS608_PID_END : AS608_PID_DATA, &tpl[off], n);
+        off += n;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// RECEPÇÃO (TAREFA DE EVENTOS DA UART)
+// ═══════════════════════════════════════════════════════════════════════
+
+void As608Async::onUartData() {
+    // Janela após timeout sem comando na UART: só pode ser o ACK atrasado
+    if (lateWindow && (!inFlight || deferTx)) {
+        bool dropped = false;
+        while (serial->available()) {
+            serial->read();
+            dropped = true;
+        }
+        if (dropped) stale++;
+        return;
+    }
+
+    // Sem comando em andamento os bytes ficam para a API síncrona
+    if (!inFlight || replyReady) return;
+
+    uint8_t buf[32];
+    while (true) {
+        uint32_t gen = generation;
+        size_t n = 0;
+        while (n < sizeof(buf) && serial->available()) {
+            buf[n++] = (uint8_t)serial->read();
+        }
+        if (n == 0) return;
+
+        portENTER_CRITICAL(&lock);
+        // Bytes lidos antes de um novo send(): pertencem ao comando anterior
+        if (gen == generation && inFlight && !replyReady) {
+            for (size_t i = 0; i < n; i++) {
+                if (feed(buf[i]) && frameDone()) break;
+            }
+        }
+        bool stop = replyReady || !inFlight;
+        portEXIT_CRITICAL(&lock);
+
+        if (stop) return;
+    }
+}
+
+bool As608Async::feed(uint8_t b) {
+    switch (parseState) {
+        case PARSE_HDR1:
+            if (b == AS608_HDR1) parseState = PARSE_HDR2;
+            return false;
+
+        case PARSE_HDR2:
+            if (b == AS608_HDR2) {
+                parseState = PARSE_ADDR;
+                parseIdx = 0;
+            } else if (b != AS608_HDR1) {
+                parseState = PARSE_HDR1;
+            }
+            return false;
+
+        case PARSE_ADDR:
+            // Endereço não é conferido: só há um módulo na UART
+            if (++parseIdx == 4) parseState = PARSE_PID;
+            return false;
+
+        case PARSE_PID:
+            pid = b;
+            bodyLen = 0;
+            parseIdx = 0;
+            parseState = PARSE_LEN;
+            return false;
+
+        case PARSE_LEN:
+            bodyLen = (bodyLen << 8) | b;
+            if (++parseIdx < 2) return false;
+            if (bodyLen < 3 || bodyLen > sizeof(body)) {
+                frameError = true;
+                return true;
+            }
+            parseIdx = 0;
+            parseState = PARSE_BODY;
+            return false;
+
+        case PARSE_BODY:
+            body[parseIdx++] = b;
+            return parseIdx == bodyLen;
+    }
+    return false;
+}
+
+bool As608Async::frameDone() {
+    parseState = PARSE_HDR1;
+
+    if (!frameError) {
+        uint16_t sum = pid + (bodyLen >> 8) + (bodyLen & 0xFF);
+        for (uint16_t i = 0; i < bodyLen - 2; i++) sum += body[i];
+        uint16_t rx = ((uint16_t)body[bodyLen - 2] << 8) | body[bodyLen - 1];
+        frameError = (sum != rx);
+    }
+    if (frameError) {
+        finishReply(AS608_REPLY_BAD_FRAME, 0xFF, NULL, 0);
+        return true;
+    }
+
+    if (pid == AS608_PID_ACK && ackIdx < ackCount) {
+        // ACK com o tamanho de outro comando: resposta atrasada, segue esperando
+        if (bodyLen - 2 != ackPayloadLen(ackCmd[ackIdx])) {
+            stale++;
+            return false;
+        }
+        uint8_t dataLen = min(bodyLen - 3, AS608_ASYNC_MAX_PAYLOAD);
+        command = ackCmd[ackIdx++];
+        // Erro encerra a sequência: os comandos seguintes não valem mais
+        if (body[0] != AS608_OK || (ackIdx == ackCount && sink == NULL)) {
+            finishReply(AS608_REPLY_OK, body[0], &body[1], dataLen);
+            return true;
+        }
+        return false;                       // Próximo ACK ou pacotes de dados
+    }
+
+    if ((pid == AS608_PID_DATA || pid == AS608_PID_END) && sink && ackIdx == ackCount) {
+        uint16_t n = bodyLen - 2;
+        if (sinkLen + n > sinkCap) {
+            finishReply(AS608_REPLY_BAD_FRAME, 0xFF, NULL, 0);
+            return true;
+        }
+        memcpy(&sink[sinkLen], body, n);
+        sinkLen += n;
+        if (pid == AS608_PID_END) {
+            finishReply(AS608_REPLY_OK, AS608_OK, NULL, 0);
+            return true;
+        }
+        return false;
+    }
+
+    // PID fora de sequência
+    finishReply(AS608_REPLY_BAD_FRAME, 0xFF, NULL, 0);
+    return true;
+}
+
+void As608Async::finishReply(As608Transport transport, uint8_t code, const uint8_t* data, uint8_t len) {
+    reply.transport = transport;
+    reply.command = command;
+    reply.code = code;
+    reply.dataLen = len;
+    if (len) memcpy(reply.data, data, len);
+    reply.bulkLen = sinkLen;
+    reply.elapsedUs = micros() - sentUs;
+    replyReady = true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// ENTREGA (CONTEXTO DO CHAMADOR)
+// ═══════════════════════════════════════════════════════════════════════
+
+void As608Async::poll() {
+    if (!inFlight) return;
+
+    // Comando armado dentro da janela de ACK atrasado: escreve quando ela fechar
+    if (deferTx) {
+        if (!lateActive()) flushDeferred();
+        return;
+    }
+
+    As608Reply r;
+    bool done = false;
+
+    portENTER_CRITICAL(&lock);
+    if (replyReady) {
+        r = reply;
+        done = true;
+        // Sequência encerrada antes do fim (erro no 1º ACK, pacote de dados
+        // inválido): o sensor ainda responde ao resto - não é do próximo comando
+        if ((ackCount > 1 && ackIdx < ackCount) || (sink && r.transport != AS608_REPLY_OK)) {
+            lateUntilMs = millis() + AS608_ASYNC_LATE_MS;
+            lateWindow = true;
+        }
+    } else if (millis() - sentMs >= timeoutMs) {
+        r.transport = AS608_REPLY_TIMEOUT;
+        r.command = command;
+        r.code = 0xFF;
+        r.dataLen = 0;
+        r.bulkLen = sinkLen;
+        r.elapsedUs = micros() - sentUs;
+        done = true;
+        // O sensor pode ainda responder: descartar o que chegar na janela
+        lateUntilMs = millis() + AS608_ASYNC_LATE_MS;
+        lateWindow = true;
+    }
+    if (done) {
+        replyReady = false;
+        inFlight = false;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (!done) return;
+
+    if (r.transport == AS608_REPLY_TIMEOUT) timeouts++;
+    if (r.transport == AS608_REPLY_BAD_FRAME) badFrames++;
+
+    // Callback pode enviar o próximo comando (inFlight já liberado)
+    As608ReplyCallback cb = replyCb;
+    void* ctx = replyCtx;
+    replyCb = NULL;
+    if (cb) cb(r, ctx);
+}
+
+void As608Async::cancel() {
+    replyCb = NULL;
+    searchCb = NULL;
+    xferCb = NULL;
+}
+
+bool As608Async::waitIdle(uint32_t timeout) {
+    uint32_t start = millis();
+    // A API síncrona também não pode ler o ACK atrasado de um timeout
+    while (inFlight || lateActive()) {
+        poll();
+        if (!inFlight && !lateActive()) break;
+        if (millis() - start >= timeout) return false;
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// PIPELINE: CAPTURA → EXTRAÇÃO → BUSCA
+// ═══════════════════════════════════════════════════════════════════════
+
+bool As608Async::startSearch(uint16_t startPage, uint16_t pageCount,
+                             As608SearchCallback cb, void* ctx) {
+    if (inFlight) return false;
+
+    memset(&search, 0, sizeof(search));
+    searchStart = startPage;
+    searchCount = pageCount;
+    matchPage = 0;
+    searchCb = cb;
+    searchCtx = ctx;
+    searchStartUs = micros();
+
+    if (!send(AS608_CMD_GENIMG, NULL, 0, AS608_ASYNC_CMD_TIMEOUT_MS, onSearchStep, this)) {
+        searchCb = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool As608Async::startMatch(uint16_t page, As608SearchCallback cb, void* ctx) {
+    if (page == 0 || !startSearch(0, 0, cb, ctx)) return false;
+    matchPage = page;   // Respostas só são tratadas em poll(), no mesmo contexto
+    return true;
+}
+
+void As608Async::onSearchStep(const As608Reply& r, void* ctx) {
+    static_cast<As608Async*>(ctx)->searchStep(r);
+}
+
+void As608Async::searchStep(const As608Reply& r) {
+    if (r.transport != AS608_REPLY_OK || r.code != AS608_OK) {
+        searchFinish(r);
+        return;
+    }
+
+    bool sent = false;
+    switch (r.command) {
+        case AS608_CMD_GENIMG: {
+            search.fingerSeen = true;
+            const uint8_t p[] = { 1 };     // CharBuffer1
+            sent = send(AS608_CMD_IMG2TZ, p, sizeof(p), AS608_ASYNC_CMD_TIMEOUT_MS, onSearchStep, this);
+            break;
+        }
+        case AS608_CMD_IMG2TZ: {
+            if (matchPage) {
+                const uint8_t p[] = { 2, (uint8_t)(matchPage >> 8), (uint8_t)matchPage };
+                sent = send(AS608_CMD_LOADCHAR, p, sizeof(p), AS608_ASYNC_CMD_TIMEOUT_MS, onSearchStep, this);
+                break;
+            }
+            const uint8_t p[] = { 1,
+                                  (uint8_t)(searchStart >> 8), (uint8_t)searchStart,
+                                  (uint8_t)(searchCount >> 8), (uint8_t)searchCount };
+            sent = send(AS608_CMD_HISPEEDSEARCH, p, sizeof(p), AS608_ASYNC_SEARCH_TIMEOUT_MS,
+                        onSearchStep, this);
+            break;
+        }
+        case AS608_CMD_LOADCHAR:
+            sent = send(AS608_CMD_MATCH, NULL, 0, AS608_ASYNC_CMD_TIMEOUT_MS, onSearchStep, this);
+            break;
+        case AS608_CMD_MATCH:
+            search.id = matchPage;
+            if (r.dataLen >= 2) search.score = ((uint16_t)r.data[0] << 8) | r.data[1];
+            break;
+        case AS608_CMD_HISPEEDSEARCH:
+            if (r.dataLen >= 4) {
+                search.id = ((uint16_t)r.data[0] << 8) | r.data[1];
+                search.score = ((uint16_t)r.data[2] << 8) | r.data[3];
+            }
+            break;
+    }
+
+    if (!sent) searchFinish(r);
+}
+
+void As608Async::searchFinish(const As608Reply& r) {
+    search.transport = r.transport;
+    search.stage = r.command;
+    search.code = r.code;
+    if (r.command == AS608_CMD_HISPEEDSEARCH || r.command == AS608_CMD_MATCH) search.searchUs = r.elapsedUs;
+    if (r.command == AS608_CMD_GENIMG && r.transport == AS608_REPLY_OK) {
+        search.fingerSeen = (r.code == AS608_OK);
+    }
+    search.elapsedUs = micros() - searchStartUs;
+
+    As608SearchCallback cb = searchCb;
+    searchCb = NULL;
+    if (cb) cb(search, searchCtx);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// TRANSFERÊNCIA DE TEMPLATES (UPCHAR / DOWNCHAR)
+// ═══════════════════════════════════════════════════════════════════════
+
+bool As608Async::upload(uint16_t id, uint8_t* dst, uint16_t cap, uint32_t timeout,
+                        As608ReplyCallback cb, void* ctx, bool pipelined) {
+    const uint8_t load[] = { 1, (uint8_t)(id >> 8), (uint8_t)id };
+    const uint8_t up[] = { 1 };
+
+    if (pipelined) {
+        if (!arm(AS608_CMD_LOADCHAR, AS608_CMD_UPCHAR, dst, cap, timeout, cb, ctx)) return false;
+        writeCommand(AS608_CMD_LOADCHAR, load, sizeof(load));
+        writeCommand(AS608_CMD_UPCHAR, up, sizeof(up));
+        return true;
+    }
+
+    if (!send(AS608_CMD_LOADCHAR, load, sizeof(load), timeout, onXferStep, this)) return false;
+    xferCb = cb;
+    xferCtx = ctx;
+    xferDst = dst;
+    xferLen = cap;
+    xferTimeout = timeout;
+    return true;
+}
+
+bool As608Async::download(uint16_t id, const uint8_t* tpl, uint16_t len, uint16_t packetLen,
+                          uint32_t timeout, As608ReplyCallback cb, void* ctx, bool pipelined) {
+    if (len == 0 || packetLen == 0 || packetLen > AS608_ASYNC_MAX_DATA) return false;
+    const uint8_t down[] = { 1 };
+    const uint8_t store[] = { 1, (uint8_t)(id >> 8), (uint8_t)id };
+
+    if (pipelined) {
+        // O sensor só lê os pacotes depois de responder ao DownChar; o
+        // buffer de RX dele segura o resto enquanto o ACK sai
+        if (!arm(AS608_CMD_DOWNCHAR, AS608_CMD_STORE, NULL, 0, timeout, cb, ctx)) return false;
+        writeCommand(AS608_CMD_DOWNCHAR, down, sizeof(down));
+        writeData(tpl, len, packetLen);
+        writeCommand(AS608_CMD_STORE, store, sizeof(store));
+        return true;
+    }
+
+    if (!send(AS608_CMD_DOWNCHAR, down, sizeof(down), timeout, onXferStep, this)) return false;
+    xferCb = cb;
+    xferCtx = ctx;
+    xferTpl = tpl;
+    xferLen = len;
+    xferPacketLen = packetLen;
+    xferId = id;
+    xferTimeout = timeout;
+    return true;
+}
+
+void As608Async::onXferStep(const As608Reply& r, void* ctx) {
+    static_cast<As608Async*>(ctx)->xferStep(r);
+}
+
+void As608Async::xferStep(const As608Reply& r) {
+    As608ReplyCallback cb = xferCb;
+    void* ctx = xferCtx;
+    if (cb == NULL) return;                 // cancel()
+
+    bool sent = false;
+    if (r.transport == AS608_REPLY_OK && r.code == AS608_OK) {
+        if (r.command == AS608_CMD_LOADCHAR) {
+            const uint8_t up[] = { 1 };
+            if (arm(AS608_CMD_UPCHAR, 0, xferDst, xferLen, xferTimeout, cb, ctx)) {
+                writeCommand(AS608_CMD_UPCHAR, up, sizeof(up));
+                sent = true;
+            }
+        } else if (r.command == AS608_CMD_DOWNCHAR) {
+            const uint8_t store[] = { 1, (uint8_t)(xferId >> 8), (uint8_t)xferId };
+            writeData(xferTpl, xferLen, xferPacketLen);
+            // O Store não responde antes de os pacotes de dados terminarem
+            sent = send(AS608_CMD_STORE, store, sizeof(store), xferTimeout, cb, ctx);
+        }
+    }
+
+    xferCb = NULL;
+    if (!sent) cb(r, ctx);
+}
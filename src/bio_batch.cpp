@@ -0,0 +1,601 @@
+/**
+ * @file bio_batch.cpp
+ * @brief Implementação do cadastro biométrico em lote
+ * @version 1.1.0
+ * @date 2025-12-07
+ */
+
+#include "bio_batch.h"
+#include <stdarg.h>
+#include "biometric_storage.h"
+
+extern BiometricStorage bioStorage;     // Definido em storage_init.cpp
+
+BioBatchEnroll bioBatch;
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONSTRUTOR
+// ═══════════════════════════════════════════════════════════════════════
+
+BioBatchEnroll::BioBatchEnroll()
+    : state(BATCH_IDLE),
+      count(0),
+      cur(-1),
+      stored(-1),
+      afterRemove(BATCH_FINGER_1),
+      tries(0),
+      errors(0),
+      waiting(false),
+      replyPending(false),
+      nextPollMs(0),
+      fingerWaitMs(0),
+      rxLines(0),
+      rxRejected(0),
+      promptDirty(false),
+      sessionDone(0),
+      runStartMs(0),
+      activeMs(0),
+      userStartMs(0),
+      lastUserMs(0) {
+    memset(&lastReply, 0, sizeof(lastReply));
+    promptText[0] = '\0';
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// LISTA (CSV)
+// ═══════════════════════════════════════════════════════════════════════
+
+void BioBatchEnroll::beginReceive() {
+    if (busy()) {
+        Serial.println("❌ [LOTE] Lote em andamento (BATCH PAUSE antes)");
+        return;
+    }
+    count = 0;
+    rxLines = rxRejected = 0;
+    state = BATCH_RECEIVING;
+    Serial.println("📋 [LOTE] Envie as linhas 'slot,nome' (ou só 'nome'); ROSTER END para terminar");
+}
+
+void BioBatchEnroll::feedLine(const String& line) {
+    if (line.equalsIgnoreCase("ROSTER END")) {
+        assignSlots();
+        saveFile();
+        state = BATCH_IDLE;
+        Serial.printf("✅ [LOTE] Lista recebida: %u usuários (%u linhas ignoradas)\n", count, rxRejected);
+        printStatus();
+        return;
+    }
+    addLine(line);
+}
+
+bool BioBatchEnroll::loadCSV(const String& csv) {
+    if (busy()) return false;
+
+    count = 0;
+    rxLines = rxRejected = 0;
+    int start = 0;
+    while (start < (int)csv.length()) {
+        int end = csv.indexOf('\n', start);
+        if (end < 0) end = csv.length();
+        addLine(csv.substring(start, end));
+        start = end + 1;
+    }
+    assignSlots();
+    saveFile();
+    state = BATCH_IDLE;
+    Serial.printf("✅ [LOTE] Lista carregada: %u usuários (%u linhas ignoradas)\n", count, rxRejected);
+    return count > 0;
+}
+
+uint16_t BioBatchEnroll::addUser(uint16_t slot, const char* name) {
+    if (state == BATCH_RECEIVING) return 0;
+    if (count == 0) loadFile();         // Continua a lista salva (lote pausado)
+
+    uint16_t before = count;
+    addLine(String(slot) + "," + name);
+    if (count == before) return 0;
+
+    assignSlots();
+    saveFile();
+    BioRosterEntry& e = entries[count - 1];
+    if (e.status != ROSTER_PENDING) return 0;
+    Serial.printf("📋 [LOTE] %s na lista (slot %u, %u pendentes)\n", e.name, e.slot, pendingCount());
+    return e.slot;
+}
+
+void BioBatchEnroll::addLine(const String& line) {
+    uint16_t slot;
+    String name;
+    rxLines++;
+    if (!parseLine(line, slot, name)) {
+        String t = line;
+        t.trim();
+        if (t.length() > 0 && t[0] != '#') rxRejected++;    // Cabeçalho
+        return;
+    }
+
+    if (count >= MAX_FINGERPRINTS) {
+        Serial.printf("❌ [LOTE] Lista cheia (%d), ignorado: %s\n", MAX_FINGERPRINTS, name.c_str());
+        rxRejected++;
+        return;
+    }
+    if (slot > bioManager.getCapacity()) {
+        Serial.printf("❌ [LOTE] Slot %u fora da faixa (1-%u): %s\n", slot, bioManager.getCapacity(), name.c_str());
+        rxRejected++;
+        return;
+    }
+    for (uint16_t i = 0; slot && i < count; i++) {
+        if (entries[i].slot == slot) {
+            Serial.printf("❌ [LOTE] Slot %u repetido na lista: %s\n", slot, name.c_str());
+            rxRejected++;
+            return;
+        }
+    }
+
+    BioRosterEntry& e = entries[count++];
+    memset(&e, 0, sizeof(e));
+    e.slot = slot;
+    strncpy(e.name, name.c_str(), FINGER_NAME_LENGTH - 1);
+    e.status = ROSTER_PENDING;
+
+    // Slot fixo já com dono: não sobrescreve o cadastro existente
+    if (slot && bioManager.isIDUsed(slot)) {
+        e.status = ROSTER_SKIPPED;
+        Serial.printf("⚠️  [LOTE] Slot %u já cadastrado, %s fica de fora\n", slot, e.name);
+    }
+}
+
+/**
+ * @brief "slot,nome" | ",nome" | "nome" (também com ';')
+ * @return false para linha vazia, comentário ou cabeçalho
+ */
+bool BioBatchEnroll::parseLine(const String& line, uint16_t& slot, String& name) {
+    String l = line;
+    l.trim();
+    if (l.length() == 0 || l[0] == '#') return false;
+
+    int sep = l.indexOf(',');
+    if (sep < 0) sep = l.indexOf(';');
+
+    String slotStr;
+    if (sep >= 0) {
+        slotStr = l.substring(0, sep);
+        slotStr.trim();
+        name = l.substring(sep + 1);
+    } else {
+        name = l;
+    }
+    name.trim();
+    if (name.length() == 0) return false;
+
+    slot = 0;
+    for (unsigned int i = 0; i < slotStr.length(); i++) {
+        if (!isDigit(slotStr[i])) return false;     // Cabeçalho ("slot,nome")
+    }
+    if (slotStr.length()) slot = slotStr.toInt();
+    return true;
+}
+
+/**
+ * @brief Slots livres para quem veio sem slot (sem colidir com os fixos)
+ */
+void BioBatchEnroll::assignSlots() {
+    SlotBitmap<MAX_FINGERPRINTS> reserved;
+    for (uint16_t i = 0; i < count; i++) {
+        if (entries[i].slot && entries[i].status == ROSTER_PENDING) reserved.set(entries[i].slot);
+    }
+
+    uint16_t slot = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        if (entries[i].slot) continue;
+        do {
+            slot = bioManager.nextHole(slot + 1);
+        } while (slot != 0 && reserved.test(slot));
+
+        if (slot == 0) {
+            entries[i].status = ROSTER_FAILED;
+            Serial.printf("❌ [LOTE] Sem slot livre para %s\n", entries[i].name);
+            continue;
+        }
+        entries[i].slot = slot;
+        reserved.set(slot);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONTROLE
+// ═══════════════════════════════════════════════════════════════════════
+
+bool BioBatchEnroll::start() {
+    if (busy() || state == BATCH_RECEIVING) return false;
+
+    if (count == 0 && !loadFile()) {
+        Serial.println("❌ [LOTE] Nenhuma lista (ROSTER LOAD)");
+        return false;
+    }
+
+    // Interrompido entre os metadados e o byte de status: já concluído
+    for (uint16_t i = 0; i < count; i++) {
+        if (entries[i].status == ROSTER_PENDING && bioManager.isIDUsed(entries[i].slot)) {
+            entries[i].status = ROSTER_DONE;
+            saveStatus(i);
+        }
+    }
+    if (pendingCount() == 0) {
+        Serial.println("✅ [LOTE] Nenhum usuário pendente");
+        return false;
+    }
+
+    if (!bioManager.beginBulk()) {
+        Serial.println("❌ [LOTE] Sensor não disponível");
+        return false;
+    }
+
+    if (state == BATCH_IDLE) {
+        sessionDone = 0;
+        activeMs = 0;
+    }
+    runStartMs = millis();
+    errors = 0;
+    cur = -1;
+    stored = -1;
+    waiting = replyPending = false;
+
+    nextUser();
+    state = BATCH_FINGER_1;
+    fingerWaitMs = millis();
+    nextPollMs = millis();
+    setPrompt("%s\nCOLOQUE O DEDO\n(1/2)", entries[cur].name);
+    Serial.printf("🧾 [LOTE] Cadastro em lote: %u pendentes\n", pendingCount());
+    Serial.printf("👆 [LOTE] %s (ID %u): posicione o dedo (1/2)\n", entries[cur].name, entries[cur].slot);
+    return true;
+}
+
+void BioBatchEnroll::pause() {
+    if (!busy()) return;
+    Serial.println("⏸️  [LOTE] Pausado (BATCH START continua)");
+    finish(true);
+}
+
+void BioBatchEnroll::skip() {
+    if (!busy()) return;
+
+    // Abandona o comando em andamento deste usuário
+    As608Async& drv = bioManager.driver();
+    drv.cancel();
+    drv.waitIdle(AS608_ASYNC_CMD_TIMEOUT_MS);
+    waiting = replyPending = false;
+
+    Serial.printf("⏭️  [LOTE] %s pulado\n", entries[cur].name);
+    entries[cur].status = ROSTER_SKIPPED;
+    saveStatus(cur);
+    advance();
+}
+
+void BioBatchEnroll::clear() {
+    if (busy()) return;
+    count = 0;
+    state = BATCH_IDLE;
+    LittleFS.remove(BIO_BATCH_FILE);
+    Serial.println("🗑️ [LOTE] Lista removida");
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// PIPELINE
+// ═══════════════════════════════════════════════════════════════════════
+
+void BioBatchEnroll::onReply(const As608Reply& reply, void* ctx) {
+    BioBatchEnroll* self = static_cast<BioBatchEnroll*>(ctx);
+    self->lastReply = reply;
+    self->replyPending = true;
+}
+
+bool BioBatchEnroll::issue(uint8_t cmd, const uint8_t* params, uint8_t len) {
+    uint32_t timeout = cmd == AS608_CMD_HISPEEDSEARCH ? AS608_ASYNC_SEARCH_TIMEOUT_MS : AS608_ASYNC_CMD_TIMEOUT_MS;
+    waiting = bioManager.driver().send(cmd, params, len, timeout, onReply, this);
+    replyPending = false;
+    return waiting;
+}
+
+void BioBatchEnroll::update() {
+    if (!busy()) return;
+
+    As608Async& drv = bioManager.driver();
+    drv.poll();
+    if (replyPending) {
+        replyPending = false;
+        waiting = false;
+        handleReply(lastReply);
+    } else if (waiting && !drv.busy()) {
+        // Chamada síncrona no meio (syncSensor) cancelou o comando
+        Serial.println("⚠️  [LOTE] Comando cancelado por outro uso do sensor");
+        finish(true);
+        return;
+    }
+
+    // Metadados do último Store enquanto o próximo GenImg está na UART
+    if (stored >= 0) commitStored();
+    if (!busy() || waiting) return;
+
+    uint32_t now = millis();
+    if ((int32_t)(now - nextPollMs) < 0) return;
+    if (state != BATCH_REMOVE && now - fingerWaitMs > BIO_BATCH_FINGER_TIMEOUT_MS) {
+        Serial.printf("⏱️  [LOTE] Ninguém no sensor há %d s\n", BIO_BATCH_FINGER_TIMEOUT_MS / 1000);
+        finish(true);
+        return;
+    }
+    issue(AS608_CMD_GENIMG, NULL, 0);
+}
+
+void BioBatchEnroll::handleReply(const As608Reply& r) {
+    uint32_t now = millis();
+
+    if (r.transport != AS608_REPLY_OK) {
+        if (++errors >= BIO_BATCH_MAX_ERRORS) {
+            Serial.printf("❌ [LOTE] AS608 sem resposta (cmd 0x%02X)\n", r.command);
+            finish(true);
+            return;
+        }
+        nextPollMs = now + BIO_BATCH_POLL_MS;
+        return;
+    }
+    errors = 0;
+
+    BioRosterEntry& e = entries[cur];
+    switch (r.command) {
+        case AS608_CMD_GENIMG:
+            if (state == BATCH_REMOVE) {
+                if (r.code != AS608_NOFINGER) {
+                    nextPollMs = now + BIO_BATCH_POLL_MS;
+                    break;
+                }
+                state = afterRemove;
+                fingerWaitMs = now;
+                nextPollMs = now;
+                setPrompt("%s\nCOLOQUE O DEDO\n(%d/2)", e.name, state == BATCH_FINGER_1 ? 1 : 2);
+                break;
+            }
+            if (r.code == AS608_OK) {
+                const uint8_t p[] = { (uint8_t)(state == BATCH_FINGER_1 ? 1 : 2) };
+                issue(AS608_CMD_IMG2TZ, p, sizeof(p));
+            } else {
+                nextPollMs = now + BIO_BATCH_POLL_MS;   // Sem dedo / imagem ruim
+            }
+            break;
+
+        case AS608_CMD_IMG2TZ:
+            if (r.code != AS608_OK) {
+                setPrompt("%s\nIMAGEM RUIM\nAJUSTE O DEDO", e.name);
+                nextPollMs = now + BIO_BATCH_POLL_MS;
+                break;
+            }
+            if (state == BATCH_FINGER_1) {
+                state = BATCH_REMOVE;
+                afterRemove = BATCH_FINGER_2;
+                nextPollMs = now;
+                setPrompt("%s\nRETIRE O DEDO", e.name);
+            } else {
+                issue(AS608_CMD_REGMODEL, NULL, 0);
+            }
+            break;
+
+        case AS608_CMD_REGMODEL:
+            if (r.code == AS608_OK) {
+                // ⭐ v6.1.20: Mesmo dedo já cadastrado em outro slot? (busca do modelo no CharBuffer1)
+                uint16_t pages = bioManager.getSearchRange();
+                const uint8_t p[] = { 1, 0, 1, (uint8_t)(pages >> 8), (uint8_t)pages };
+                issue(AS608_CMD_HISPEEDSEARCH, p, sizeof(p));
+            } else if (r.code == AS608_ENROLLMISMATCH && ++tries < BIO_BATCH_MAX_TRIES) {
+                Serial.printf("⚠️  [LOTE] %s: leituras não conferem (%u/%d)\n", e.name, tries, BIO_BATCH_MAX_TRIES);
+                state = BATCH_REMOVE;
+                afterRemove = BATCH_FINGER_1;
+                nextPollMs = now;
+                setPrompt("%s\nNAO CONFERE\nRETIRE O DEDO", e.name);
+            } else {
+                Serial.printf("❌ [LOTE] %s: modelo não gerado (código 0x%02X)\n", e.name, r.code);
+                e.status = ROSTER_FAILED;
+                saveStatus(cur);
+                advance();
+            }
+            break;
+
+        case AS608_CMD_HISPEEDSEARCH:
+            if (r.code == AS608_NOTFOUND) {
+                const uint8_t p[] = { 1, (uint8_t)(e.slot >> 8), (uint8_t)e.slot };
+                issue(AS608_CMD_STORE, p, sizeof(p));
+                break;
+            }
+            if (r.code == AS608_OK && r.dataLen >= 4) {
+                Serial.printf("❌ [LOTE] %s: digital já cadastrada no ID %u (pontuação %u), não gravada\n",
+                              e.name, ((uint16_t)r.data[0] << 8) | r.data[1], ((uint16_t)r.data[2] << 8) | r.data[3]);
+            } else {
+                Serial.printf("❌ [LOTE] %s: busca de duplicada falhou (código 0x%02X)\n", e.name, r.code);
+            }
+            e.status = ROSTER_FAILED;
+            saveStatus(cur);
+            advance();
+            break;
+
+        case AS608_CMD_STORE:
+            if (r.code == AS608_OK) {
+                stored = cur;           // Metadados gravados em update(), após o próximo comando sair
+                lastUserMs = now - userStartMs;
+            } else {
+                Serial.printf("❌ [LOTE] %s: falha ao gravar no slot %u (código 0x%02X)\n", e.name, e.slot, r.code);
+                e.status = ROSTER_FAILED;
+                saveStatus(cur);
+            }
+            advance();
+            break;
+    }
+}
+
+/**
+ * @brief Próximo da lista: espera o dedo anterior sair e já consulta o sensor
+ */
+void BioBatchEnroll::advance() {
+    if (!nextUser()) {
+        finish(false);
+        return;
+    }
+    state = BATCH_REMOVE;
+    afterRemove = BATCH_FINGER_1;
+    setPrompt("PROXIMO:\n%s\nRETIRE O DEDO", entries[cur].name);
+    Serial.printf("👆 [LOTE] Próximo: %s (ID %u)\n", entries[cur].name, entries[cur].slot);
+    issue(AS608_CMD_GENIMG, NULL, 0);
+}
+
+bool BioBatchEnroll::nextUser() {
+    for (int16_t i = cur + 1; i < count; i++) {
+        if (entries[i].status == ROSTER_PENDING && i != stored) {
+            cur = i;
+            tries = 0;
+            userStartMs = millis();
+            return true;
+        }
+    }
+    return false;
+}
+
+void BioBatchEnroll::commitStored() {
+    BioRosterEntry& e = entries[stored];
+
+    if (bioManager.addFingerprint(e.slot, e.name)) {
+        BiometricUser user;
+        user.slotId = e.slot;
+        user.userId = String(e.slot);
+        user.userName = e.name;
+        user.registeredAt = millis();
+        user.confidence = 95;           // Mesmo valor inicial do cadastro individual
+        user.accessCount = 0;
+        user.lastAccess = 0;
+        user.active = true;
+        if (!bioStorage.addUser(user)) {
+            Serial.println("⚠️  [LOTE] Erro ao adicionar no BiometricStorage (continuando...)");
+        }
+        e.status = ROSTER_DONE;
+        sessionDone++;
+        Serial.printf("✅ [LOTE] %s → ID %u (%lu ms)\n", e.name, e.slot, (unsigned long)lastUserMs);
+    } else {
+        e.status = ROSTER_FAILED;
+    }
+    saveStatus(stored);
+    stored = -1;
+}
+
+void BioBatchEnroll::finish(bool paused) {
+    if (stored >= 0) commitStored();
+    if (busy()) activeMs += millis() - runStartMs;
+
+    state = paused ? BATCH_PAUSED : BATCH_IDLE;
+    waiting = replyPending = false;
+    cur = -1;
+    bioManager.endBulk();
+    setPrompt(paused ? "LOTE PAUSADO" : "LOTE CONCLUIDO");
+    printStatus();
+}
+
+void BioBatchEnroll::setPrompt(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(promptText, sizeof(promptText), fmt, args);
+    va_end(args);
+    promptDirty = true;
+}
+
+bool BioBatchEnroll::promptChanged() {
+    bool dirty = promptDirty;
+    promptDirty = false;
+    return dirty;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// ARQUIVO (PROGRESSO)
+// ═══════════════════════════════════════════════════════════════════════
+
+bool BioBatchEnroll::loadFile() {
+    File f = LittleFS.open(BIO_BATCH_FILE, "r");
+    if (!f) return false;
+
+    BioRosterHeader hdr;
+    bool ok = f.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              hdr.magic == BIO_BATCH_MAGIC && hdr.count <= MAX_FINGERPRINTS;
+    size_t bytes = ok ? hdr.count * sizeof(BioRosterEntry) : 0;
+    ok = ok && f.read((uint8_t*)entries, bytes) == bytes;
+    f.close();
+
+    if (!ok) {
+        Serial.println("❌ [LOTE] " BIO_BATCH_FILE " inválido");
+        count = 0;
+        return false;
+    }
+    count = hdr.count;
+    Serial.printf("📂 [LOTE] Lista retomada: %u usuários, %u pendentes\n", count, pendingCount());
+    return true;
+}
+
+bool BioBatchEnroll::saveFile() {
+    File f = LittleFS.open(BIO_BATCH_FILE, "w");
+    if (!f) {
+        Serial.println("❌ [LOTE] Erro ao criar " BIO_BATCH_FILE);
+        return false;
+    }
+    BioRosterHeader hdr = { BIO_BATCH_MAGIC, count };
+    size_t bytes = count * sizeof(BioRosterEntry);
+    bool ok = f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              f.write((const uint8_t*)entries, bytes) == bytes;
+    f.close();
+    return ok;
+}
+
+/**
+ * @brief Regrava só o byte de status do usuário i
+ */
+void BioBatchEnroll::saveStatus(uint16_t i) {
+    File f = LittleFS.open(BIO_BATCH_FILE, "r+");
+    if (!f) return;
+    f.seek(sizeof(BioRosterHeader) + i * sizeof(BioRosterEntry) + offsetof(BioRosterEntry, status));
+    f.write(entries[i].status);
+    f.close();
+}
+
+bool BioBatchEnroll::hasRoster() const {
+    return state != BATCH_IDLE || count > 0 || LittleFS.exists(BIO_BATCH_FILE);
+}
+
+uint16_t BioBatchEnroll::pendingCount() const {
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        if (entries[i].status == ROSTER_PENDING) n++;
+    }
+    return n;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// RELATÓRIO
+// ═══════════════════════════════════════════════════════════════════════
+
+void BioBatchEnroll::printStatus() {
+    uint16_t n[4] = { 0, 0, 0, 0 };
+    for (uint16_t i = 0; i < count; i++) {
+        if (entries[i].status <= ROSTER_FAILED) n[entries[i].status]++;
+    }
+    uint32_t ms = activeMs + (busy() ? millis() - runStartMs : 0);
+
+    Serial.println("\n🧾 ═══════════════════════════════════════");
+    Serial.println("   CADASTRO EM LOTE");
+    Serial.println("═══════════════════════════════════════");
+    Serial.printf("Estado       : %s\n", busy() ? "capturando" : state == BATCH_PAUSED ? "pausado" :
+                  state == BATCH_RECEIVING ? "recebendo lista" : "parado");
+    Serial.printf("Lista        : %u | %u concluídos | %u pendentes | %u pulados | %u falhas\n",
+                  count, n[ROSTER_DONE], n[ROSTER_PENDING], n[ROSTER_SKIPPED], n[ROSTER_FAILED]);
+    if (cur >= 0) {
+        Serial.printf("Atual        : %s (ID %u)\n", entries[cur].name, entries[cur].slot);
+    }
+    if (sessionDone > 0 && ms > 0) {
+        Serial.printf("Sessão       : %u cadastrados em %lu s\n", sessionDone, (unsigned long)(ms / 1000));
+        Serial.printf("Vazão        : %.1f usuários/min (último: %lu ms)\n",
+                      sessionDone * 60000.0f / ms, (unsigned long)lastUserMs);
+    }
+    Serial.println("═══════════════════════════════════════\n");
+}
@@ -13,16 +13,40 @@
 
 BiometricManager bioManager;
 
+volatile bool BiometricManager::touch_irq = false;
+
 // ════════════════════════════════════════════════════════════════
 // CONSTRUTOR/DESTRUTOR
 // ════════════════════════════════════════════════════════════════
 
-BiometricManager::BiometricManager() {
+BiometricManager::BiometricManager()
+    : table(BIO_TABLE_FILE, BIO_TABLE_TMP, BIO_TABLE_MAGIC, sizeof(Fingerprint), MAX_FINGERPRINTS,
+            "fingerprints", "fp_", BIO_NVS_TABLE_KEY) {
     finger_count = 0;
     log_count = 0;
     last_verify_time = 0;
+    last_finger_seen = false;
+    verify_active = false;
+    verify_done = false;
+    bulk_active = false;
+    memset(&verify_result, 0, sizeof(verify_result));
+    last_fallback_poll = 0;
     enrollState = BIO_IDLE;
     finger = nullptr;
+    sensor_index_valid = false;
+    sensor_capacity = MAX_FINGERPRINTS;
+    orphan_count = 0;
+    missing_count = 0;
+    slot_moved_cb = nullptr;
+    memset(search_stats, 0, sizeof(search_stats));
+    memset(&match_stats, 0, sizeof(match_stats));
+    last_search_pages = 0;
+    verify_slot = 0;
+    mutex = xSemaphoreCreateRecursiveMutex();
+    data_gen = 0;
+    stats_lo = stats_hi = -1;
+    stats_since = 0;
+    rebuildSlotIndex();
 }
 
 BiometricManager::~BiometricManager() {
@@ -44,10 +68,9 @@ bool BiometricManager::init() {
     // ════════════════════════════════════════════════════════════════════════════
     
     // ⚠️ CRÍTICO: AS608 consome 120mA nominal e picos de 150mA na inicialização
-    // Isso pode causar brown-out no VDD3P3 do ESP32-S3
+    // Isso pode causar brown-out no VDD3P3 do ESP32-S3. O display fica com
+    // backlight apagado até este init retornar (ver setup()).
     Serial.println("⚡ ATENÇÃO: AS608 consome até 150mA (pico)");
-    Serial.println("⚡ Aguardando estabilização da alimentação...");
-    delay(1000);  // ⭐ CRÍTICO: Esperar alimentação estabilizar ANTES de ligar sensor
     
     // Inicializar Serial2 para AS608
     Serial.println("🔧 Inicializando UART2...");
@@ -55,68 +78,104 @@ bool BiometricManager::init() {
     Serial.printf("   • TX ESP32: GPIO%d → RX AS608 (Green)\n", BIO_TX_PIN);
     Serial.printf("   • Baudrate: %d bps\n", BIO_BAUDRATE);
     
+    // ⭐ v6.1.13: Buffers para um template inteiro (~600 bytes com cabeçalhos):
+    // sem buffer de TX, write() esperaria cada byte sair a 57600 bps
+    Serial2.setRxBufferSize(AS608_UART_RX_BUFFER);
+    Serial2.setTxBufferSize(AS608_UART_TX_BUFFER);
     Serial2.begin(BIO_BAUDRATE, SERIAL_8N1, BIO_RX_PIN, BIO_TX_PIN);
-    delay(500);  // Aguardar estabilização da UART
     
-    // Criar instância do sensor
+    // ⭐ v6.1.10: Instância só é publicada em 'finger' no fim do init: o loop
+    // (isHardwareConnected) não usa o sensor enquanto esta tarefa o configura
     Serial.println("🔧 Criando instância do sensor...");
-    finger = new Adafruit_Fingerprint(&Serial2);
+    Adafruit_Fingerprint* dev = new Adafruit_Fingerprint(&Serial2);
     
-    // Verificar conexão
+    // ⭐ v6.1.10: Handshake em polling no lugar dos delays fixos (1000+500+200 ms).
+    // O sensor responde assim que termina o próprio boot (~200-500 ms após ligar).
     Serial.println("🔧 Verificando conexão com AS608...");
-    Serial.println("⚡ ATENÇÃO: LED azul do sensor vai ligar (pico de corrente)");
-    delay(200);  // ⭐ Esperar antes do pico de corrente
+    uint32_t t0 = millis();
+    uint8_t attempts = 0;
+    bool found = false;
+    while (!found) {
+        attempts++;
+        found = dev->verifyPassword();
+        if (found || millis() - t0 >= AS608_READY_TIMEOUT_MS) break;
+        vTaskDelay(pdMS_TO_TICKS(AS608_READY_POLL_MS));
+    }
     
-    if (!finger->verifyPassword()) {
-        Serial.println("❌ AS608 não encontrado! Verifique:");
+    if (!found) {
+        Serial.printf("❌ AS608 não encontrado (%u tentativas em %lu ms)! Verifique:\n",
+                      attempts, (unsigned long)(millis() - t0));
         Serial.printf("   - RX: GPIO%d → TX sensor (Blue wire)\n", BIO_RX_PIN);
         Serial.printf("   - TX: GPIO%d → RX sensor (Green wire)\n", BIO_TX_PIN);
         Serial.printf("   - Baudrate: %d bps\n", BIO_BAUDRATE);
         Serial.println("   - Alimentação: 3.3V (Red wire) e GND (Black wire)");
         Serial.println("   - IMPORTANTE: TX/RX devem estar CRUZADOS!");
         Serial.println("✅ Sistema continuará sem Biometria\n");
-        delete finger;
-        finger = nullptr;
+        delete dev;
         return false;
     }
     
-    Serial.println("✅ AS608 conectado com sucesso!");
-    delay(200);  // ⭐ Esperar após pico de corrente do LED
+    Serial.printf("✅ AS608 conectado em %lu ms (%u tentativa(s))\n",
+                  (unsigned long)(millis() - t0), attempts);
     
-    // Obter parâmetros do sensor
+    // ⭐ v6.1.11: Verificação contínua sem bloquear o loop (startVerify/pollVerify)
+    // ⭐ v6.1.15: Instalado antes da reconciliação (ReadIndexTable usa o driver)
+    as608.begin(&Serial2);
+    
+    // Comandos seguintes são pedido/resposta: cada um já espera o ACK do sensor
     Serial.println("🔧 Lendo parâmetros do sensor...");
-    finger->getParameters();
-    delay(100);  // ⭐ Esperar após leitura de parâmetros
-    Serial.printf("✅ Capacidade: %d templates\n", finger->capacity);
-    Serial.printf("✅ Segurança: Level %d\n", finger->security_level);
-    Serial.printf("✅ Tamanho pacote: %d bytes\n", finger->packet_len);
-    Serial.printf("✅ Baudrate: %d bps\n", finger->baud_rate);
+    dev->getParameters();
+    Serial.printf("✅ Capacidade: %d templates\n", dev->capacity);
+    Serial.printf("✅ Segurança: Level %d\n", dev->security_level);
+    Serial.printf("✅ Tamanho pacote: %d bytes\n", dev->packet_len);
+    Serial.printf("✅ Baudrate: %d bps\n", dev->baud_rate);
+    
+    // ⭐ v6.1.15: Capacidade real do sensor (antes: fixa em 127)
+    sensor_capacity = min((uint16_t)dev->capacity, (uint16_t)MAX_FINGERPRINTS);
+    if (sensor_capacity == 0) sensor_capacity = MAX_FINGERPRINTS;
+    if (dev->capacity > MAX_FINGERPRINTS) {
+        Serial.printf("⚠️ Sensor com %d posições: usando %d (MAX_FINGERPRINTS)\n",
+                      dev->capacity, MAX_FINGERPRINTS);
+    }
     
     // Contar templates no sensor
     Serial.println("🔧 Contando templates no sensor...");
-    uint16_t sensor_count = getSensorTemplateCount();
-    Serial.printf("✅ Templates no sensor: %d\n", sensor_count);
-    delay(100);  // ⭐ Esperar após contagem
+    dev->getTemplateCount();
+    Serial.printf("✅ Templates no sensor: %d\n", dev->templateCount);
     
-    // Carregar metadados do NVS
-    Serial.println("🔧 Carregando metadados do NVS...");
-    loadFromNVS();
+    // Carregar metadados (LittleFS) e logs (NVS)
+    Serial.println("🔧 Carregando metadados e logs...");
+    loadFingerprints();
     loadLogsFromNVS();
     
     Serial.printf("✅ %d metadados carregados\n", finger_count);
     Serial.printf("✅ %d logs carregados\n", log_count);
+    
+    // ⭐ v6.1.15: Órfãos e ausentes numa passada (tabela de índice do sensor)
+    reconcileSensor();
     Serial.println("╚══════════════════════════════════════════════╝\n");
     
+    // ⭐ v6.1.12: Saída de toque (WAK) - captura só com dedo presente
+    #if BIO_TOUCH_PIN >= 0
+    pinMode(BIO_TOUCH_PIN, INPUT_PULLDOWN);  // Sem fio: LOW (fica só o polling de segurança)
+    attachInterrupt(digitalPinToInterrupt(BIO_TOUCH_PIN), onTouchIrq, RISING);
+    Serial.printf("✅ Saída de toque do AS608 em GPIO%d (polling de segurança a cada %d ms)\n",
+                  BIO_TOUCH_PIN, AS608_TOUCH_FALLBACK_MS);
+    #endif
+    
+    finger = dev;
     return true;
 }
 
 bool BiometricManager::isHardwareConnected() {
     if (!finger) return false;
+    syncSensor();
     return finger->verifyPassword();
 }
 
 uint16_t BiometricManager::getSensorTemplateCount() {
     if (!finger) return 0;
+    syncSensor();
     
     finger->getTemplateCount();
     return finger->templateCount;
@@ -127,6 +186,12 @@ uint16_t BiometricManager::getSensorTemplateCount() {
 // ════════════════════════════════════════════════════════════════
 
 bool BiometricManager::addFingerprint(uint16_t id, const char* name) {
+    BioLock guard(*this);
+    if (!slot_used.valid(id) || id > sensor_capacity) {
+        Serial.printf("❌ ID %d fora da faixa (1-%d)!\n", id, sensor_capacity);
+        return false;
+    }
+    
     // Verificar se ID já existe
     if (findFingerprintIndex(id) >= 0) {
         Serial.println("❌ ID já cadastrado!");
@@ -151,8 +216,17 @@ bool BiometricManager::addFingerprint(uint16_t id, const char* name) {
     fp->last_access = 0;
     fp->confidence = 0;
     
+    slot_used.set(id);
+    slot_index[id] = finger_count;
+    sensor_used.set(id);                // Template gravado pelo cadastro
     finger_count++;
-    saveToNVS();
+    if (!saveFingerprint(finger_count - 1)) {
+        // Registro novo é o último: desfaz só em RAM (template fica órfão no sensor)
+        finger_count--;
+        slot_used.reset(id);
+        Serial.printf("❌ Falha ao gravar metadados do ID=%d\n", id);
+        return false;
+    }
     
     Serial.printf("✅ Metadados cadastrados: ID=%d, Nome=%s\n", id, name);
     
@@ -160,28 +234,46 @@ bool BiometricManager::addFingerprint(uint16_t id, const char* name) {
 }
 
 bool BiometricManager::deleteFingerprint(int index) {
+    BioLock guard(*this);
     if (index < 0 || index >= finger_count) {
         Serial.println("❌ Índice inválido");
         return false;
     }
     
     Fingerprint* fp = &fingerprints[index];
+    uint16_t removed_id = fp->id;
     Serial.printf("🗑️ Removendo: ID=%d, Nome=%s\n", fp->id, fp->name);
     
     // Remover do sensor
+    // ⭐ v6.1.20: Template ainda no sensor e DeletChar falhou: metadados ficam
+    // (sem eles o template continuaria liberando a porta sem dono conhecido)
+    if (finger) syncSensor();
     if (finger && finger->deleteModel(fp->id) == FINGERPRINT_OK) {
+        sensor_used.reset(fp->id);
         Serial.println("✅ Template removido do sensor");
+    } else if (finger && sensor_used.test(fp->id)) {
+        Serial.printf("❌ Falha ao remover ID=%d do sensor (metadados mantidos)\n", fp->id);
+        return false;
     } else {
-        Serial.println("⚠️ Falha ao remover do sensor (metadados serão removidos)");
+        Serial.println("⚠️ Template ausente no sensor (metadados serão removidos)");
     }
     
-    // Remover metadados
-    for (int i = index; i < finger_count - 1; i++) {
-        fingerprints[i] = fingerprints[i + 1];
-    }
+    // ⭐ v6.1.17: Cartões vinculados a este slot não podem herdar o próximo dono
+    if (slot_moved_cb) slot_moved_cb(removed_id, 0);
     
+    // ⭐ v6.1.14: Remover metadados em O(1) - o último ocupa o lugar
+    slot_used.reset(fp->id);
     finger_count--;
-    saveToNVS();
+    if (index != finger_count) {
+        uint16_t moved = fingerprints[finger_count].id;
+        fingerprints[index] = fingerprints[finger_count];
+        if (slot_used.test(moved) && slot_index[moved] == finger_count) slot_index[moved] = index;
+    }
+    
+    // ⭐ v6.1.20: Sem compactação automática - renumerar o ID de outro usuário
+    // deixava logs e o lote com o ID antigo. Buraco é reusado pelo próximo
+    // cadastro (getFreeID) ou fechado pelo comando BIO COMPACT.
+    saveFingerprints();
     
     Serial.println("✅ Metadados removidos");
     return true;
@@ -194,21 +286,23 @@ bool BiometricManager::deleteFingerprintByID(uint16_t id) {
 }
 
 bool BiometricManager::editFingerprintName(int index, const char* new_name) {
+    BioLock guard(*this);
     if (index < 0 || index >= finger_count) return false;
     
     strncpy(fingerprints[index].name, new_name, FINGER_NAME_LENGTH - 1);
     fingerprints[index].name[FINGER_NAME_LENGTH - 1] = '\0';
-    saveToNVS();
+    if (!saveFingerprint(index)) return false;
     
     Serial.printf("✏️ Nome alterado: ID=%d → %s\n", fingerprints[index].id, new_name);
     return true;
 }
 
 bool BiometricManager::toggleFingerprintActive(int index) {
+    BioLock guard(*this);
     if (index < 0 || index >= finger_count) return false;
     
     fingerprints[index].active = !fingerprints[index].active;
-    saveToNVS();
+    if (!saveFingerprint(index)) return false;
     
     Serial.printf("🔄 ID=%d (%s): %s\n", 
                   fingerprints[index].id,
@@ -223,6 +317,7 @@ bool BiometricManager::toggleFingerprintActive(int index) {
 
 int BiometricManager::verifyFingerprint(uint16_t &id, uint16_t &confidence) {
     if (!finger) return -1;
+    syncSensor();
     
     // Debounce: não verificar se foi lido recentemente (< 2s)
     if (millis() - last_verify_time < 2000) {
@@ -271,7 +366,7 @@ bool BiometricManager::isFingerprintAuthorized(uint16_t id) {
     // Atualizar estatísticas
     fp->access_count++;
     fp->last_access = millis() / 1000;
-    saveToNVS();
+    markStats(index);
     
     Serial.printf("✅ Acesso autorizado: %s (ID=%d)\n", fp->name, id);
     logAccess(id, fp->name, fp->confidence, true);
@@ -280,12 +375,7 @@ bool BiometricManager::isFingerprintAuthorized(uint16_t id) {
 }
 
 int BiometricManager::findFingerprintIndex(uint16_t id) {
-    for (int i = 0; i < finger_count; i++) {
-        if (fingerprints[i].id == id) {
-            return i;
-        }
-    }
-    return -1;
+    return slot_used.test(id) ? slot_index[id] : -1;
 }
 
 // ════════════════════════════════════════════════════════════════
@@ -298,11 +388,20 @@ int BiometricManager::findFingerprintIndex(uint16_t id) {
  */
 bool BiometricManager::hasFingerOnSensor() {
     if (!finger) return false;
+    syncSensor();
     
     uint8_t p = finger->getImage();
     return (p == FINGERPRINT_OK);
 }
 
+/**
+ * @brief Indica se a última verifyFinger() encontrou um dedo no sensor
+ * Vale também para digitais não reconhecidas (usado para acordar a tela).
+ */
+bool BiometricManager::lastVerifyHadFinger() {
+    return last_finger_seen;
+}
+
 /**
  * @brief Verifica digital e retorna resultado (modo simplificado)
  * @return true se digital foi reconhecida
@@ -315,10 +414,13 @@ bool BiometricManager::hasFingerOnSensor() {
  *   }
  */
 bool BiometricManager::verifyFinger() {
+    last_finger_seen = false;
     if (!finger) return false;
+    syncSensor();
     
     // 1. Capturar imagem
     uint8_t p = finger->getImage();
+    last_finger_seen = (p == FINGERPRINT_OK);
     if (p != FINGERPRINT_OK) {
         return false; // Sem dedo ou erro
     }
@@ -346,46 +448,7 @@ bool BiometricManager::verifyFinger() {
         
         Serial.printf("✅ [VERIFY] Match encontrado! ID=%d, Confiança=%d\n", id, confidence);
         
-        // Atualizar cache
-        last_verify_time = millis();
-        
-        // Buscar informações do usuário
-        int index = findFingerprintIndex(id);
-        
-        Serial.printf("🔍 [VERIFY] Buscando metadados... index=%d\n", index);
-        
-        if (index >= 0) {
-            Fingerprint* fp = &fingerprints[index];
-            
-            Serial.printf("📋 [VERIFY] Metadados: Nome='%s', Ativo=%d\n", fp->name, fp->active);
-            
-            // Verificar se está ativo
-            if (!fp->active) {
-                Serial.printf("🔒 Digital reconhecida mas DESATIVADA: %s (ID=%d)\n", 
-                              fp->name, id);
-                logAccess(id, fp->name, confidence, false);
-                return false;
-            }
-            
-            // ✅ ACESSO AUTORIZADO
-            fp->access_count++;
-            fp->last_access = millis() / 1000;
-            fp->confidence = confidence;
-            saveToNVS();
-            
-            Serial.printf("✅ Acesso concedido: %s (ID=%d, Confiança=%d)\n", 
-                          fp->name, id, confidence);
-            
-            logAccess(id, fp->name, confidence, true);
-            
-            return true;
-            
-        } else {
-            // Digital no sensor mas sem metadados no NVS
-            Serial.printf("⚠️  Digital reconhecida (ID=%d) mas sem metadados\n", id);
-            logAccess(id, "Sem nome", confidence, false);
-            return false;
-        }
+        return finishVerify(id, confidence);
         
     } else if (p == FINGERPRINT_NOTFOUND) {
         // ❌ DIGITAL NÃO CADASTRADA
@@ -399,6 +462,258 @@ bool BiometricManager::verifyFinger() {
     }
 }
 
+/**
+ * @brief Pós-match comum à verificação síncrona e assíncrona
+ * Confere metadados/ativo, atualiza contadores (gravados em flushStats) e registra o log.
+ * @return true se o acesso deve ser concedido
+ */
+bool BiometricManager::finishVerify(uint16_t id, uint16_t confidence) {
+    // Atualizar cache
+    last_verify_time = millis();
+    
+    // Buscar informações do usuário
+    BioLock guard(*this);   // ⭐ v6.1.19: access_count/last_access lidos pela API
+    int index = findFingerprintIndex(id);
+    
+    Serial.printf("🔍 [VERIFY] Buscando metadados... index=%d\n", index);
+    
+    if (index >= 0) {
+        Fingerprint* fp = &fingerprints[index];
+        
+        Serial.printf("📋 [VERIFY] Metadados: Nome='%s', Ativo=%d\n", fp->name, fp->active);
+        
+        // Verificar se está ativo
+        if (!fp->active) {
+            Serial.printf("🔒 Digital reconhecida mas DESATIVADA: %s (ID=%d)\n", 
+                          fp->name, id);
+            logAccess(id, fp->name, confidence, false);
+            return false;
+        }
+        
+        // ✅ ACESSO AUTORIZADO
+        fp->access_count++;
+        fp->last_access = millis() / 1000;
+        fp->confidence = confidence;
+        markStats(index);   // ⭐ v6.1.20: Gravado em flushStats(), não a cada acesso
+        
+        Serial.printf("✅ Acesso concedido: %s (ID=%d, Confiança=%d)\n", 
+                      fp->name, id, confidence);
+        
+        logAccess(id, fp->name, confidence, true);
+        
+        return true;
+        
+    } else {
+        // Digital no sensor mas sem metadados
+        Serial.printf("⚠️  Digital reconhecida (ID=%d) mas sem metadados\n", id);
+        logAccess(id, "Sem nome", confidence, false);
+        return false;
+    }
+}
+
+// ════════════════════════════════════════════════════════════════
+// VERIFICAÇÃO ASSÍNCRONA (v6.1.11)
+// ════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Dispara GenImg → Img2Tz → HighSpeedSearch sem bloquear
+ * @return false se o sensor não estiver pronto ou já houver verificação
+ */
+bool BiometricManager::startVerify() {
+    if (!finger || verify_active) return false;
+    
+    verify_done = false;
+    verify_slot = 0;
+    // ⭐ v6.1.16: Só as páginas ocupadas (antes: biblioteca inteira a cada toque)
+    last_search_pages = getSearchRange();
+    verify_active = as608.startSearch(1, last_search_pages, onVerifyDone, this);
+    return verify_active;
+}
+
+/**
+ * @brief Dispara GenImg → Img2Tz → LoadChar(2, id) → Match sem bloquear
+ * O cartão já identificou o usuário: uma comparação no lugar da busca 1:N
+ * (tempo independente do tamanho da biblioteca e sem risco de aceitar a
+ * digital de outro cadastro). Resultado em pollVerify(), como startVerify().
+ * @return false se o slot não tiver metadados ou o sensor estiver ocupado
+ */
+bool BiometricManager::startVerifySlot(uint16_t id) {
+    if (!finger || verify_active || !slot_used.test(id)) return false;
+    
+    verify_done = false;
+    verify_slot = id;
+    verify_active = as608.startMatch(id, onVerifyDone, this);
+    return verify_active;
+}
+
+void BiometricManager::onVerifyDone(const As608SearchResult& result, void* ctx) {
+    BiometricManager* self = static_cast<BiometricManager*>(ctx);
+    self->verify_result = result;
+    self->verify_done = true;
+}
+
+/**
+ * @brief Avança o pipeline e, ao terminar, aplica o resultado
+ * Mesmo efeito de verifyFinger(): metadados, contadores, log e getLastMatchedID().
+ */
+BioVerifyResult BiometricManager::pollVerify() {
+    if (!verify_active) return BIO_VERIFY_ERROR;
+    
+    as608.poll();
+    if (!verify_done) {
+        // Cancelada por syncSensor(): nada mais vai chegar
+        if (!as608.busy()) {
+            verify_active = false;
+            return BIO_VERIFY_ERROR;
+        }
+        return BIO_VERIFY_PENDING;
+    }
+    
+    verify_active = false;
+    verify_done = false;
+    const As608SearchResult& r = verify_result;
+    last_finger_seen = r.fingerSeen;
+    
+    if ((r.stage == AS608_CMD_HISPEEDSEARCH || r.stage == AS608_CMD_MATCH) && r.searchUs) {
+        BioSearchStats& st = verify_slot ? match_stats :
+            search_stats[(last_search_pages - 1) * BIO_SEARCH_BUCKETS / MAX_FINGERPRINTS];
+        st.searches++;
+        st.totalUs += r.searchUs;
+        if (r.searchUs > st.maxUs) st.maxUs = r.searchUs;
+    }
+    
+    if (r.transport != AS608_REPLY_OK) {
+        Serial.printf("❌ [VERIFY] Sem resposta válida do AS608 (cmd 0x%02X, %s)\n",
+                      r.stage, r.transport == AS608_REPLY_TIMEOUT ? "timeout" : "pacote inválido");
+        return BIO_VERIFY_ERROR;
+    }
+    if (!r.fingerSeen) {
+        return (r.code == AS608_NOFINGER) ? BIO_VERIFY_NO_FINGER : BIO_VERIFY_ERROR;
+    }
+    
+    if (r.stage == AS608_CMD_IMG2TZ) {
+        Serial.printf("❌ [VERIFY] Erro ao processar imagem: %d\n", r.code);
+        return BIO_VERIFY_ERROR;
+    }
+    
+    // ⭐ v6.1.17: Match 1:1 (cartão + digital)
+    if (verify_slot) {
+        if (r.stage == AS608_CMD_LOADCHAR) {
+            Serial.printf("❌ [VERIFY] Slot %d do cartão sem template no sensor: %d\n", verify_slot, r.code);
+            return BIO_VERIFY_ERROR;
+        }
+        if (r.code == AS608_NOMATCH) {
+            Serial.printf("❌ [VERIFY] Digital não confere com o slot %d (%lu ms, match %lu ms)\n",
+                          verify_slot, (unsigned long)(r.elapsedUs / 1000),
+                          (unsigned long)(r.searchUs / 1000));
+            return BIO_VERIFY_NOT_FOUND;
+        }
+        if (r.code != AS608_OK) {
+            Serial.printf("❌ [VERIFY] Erro no match: %d\n", r.code);
+            return BIO_VERIFY_ERROR;
+        }
+        finger->fingerID = r.id;
+        finger->confidence = r.score;
+        Serial.printf("✅ [VERIFY] Digital confere com o slot %d, Confiança=%d (%lu ms, match %lu ms)\n",
+                      r.id, r.score, (unsigned long)(r.elapsedUs / 1000),
+                      (unsigned long)(r.searchUs / 1000));
+        return finishVerify(r.id, r.score) ? BIO_VERIFY_GRANTED : BIO_VERIFY_REJECTED;
+    }
+    
+    if (r.code == AS608_NOTFOUND) {
+        Serial.printf("❌ [VERIFY] Digital não reconhecida (%lu ms, busca %lu ms em %d páginas)\n",
+                      (unsigned long)(r.elapsedUs / 1000), (unsigned long)(r.searchUs / 1000),
+                      last_search_pages);
+        return BIO_VERIFY_NOT_FOUND;
+    }
+    if (r.code != AS608_OK) {
+        Serial.printf("❌ [VERIFY] Erro na busca: %d\n", r.code);
+        return BIO_VERIFY_ERROR;
+    }
+    
+    // Mesmos campos que fingerFastSearch() preencheria (getLastMatchedID/Confidence)
+    finger->fingerID = r.id;
+    finger->confidence = r.score;
+    Serial.printf("✅ [VERIFY] Match encontrado! ID=%d, Confiança=%d (%lu ms, busca %lu ms em %d páginas)\n",
+                  r.id, r.score, (unsigned long)(r.elapsedUs / 1000),
+                  (unsigned long)(r.searchUs / 1000), last_search_pages);
+    
+    return finishVerify(r.id, r.score) ? BIO_VERIFY_GRANTED : BIO_VERIFY_REJECTED;
+}
+
+void IRAM_ATTR BiometricManager::onTouchIrq() {
+    touch_irq = true;
+}
+
+/**
+ * @brief Decide se vale disparar a captura agora
+ * Com BIO_TOUCH_PIN: só com dedo no sensor (borda ou nível do WAK), mais um
+ * polling de segurança a cada AS608_TOUCH_FALLBACK_MS (fio solto/módulo sem
+ * WAK). Sem o pino: sempre (polling contínuo, como antes).
+ */
+bool BiometricManager::fingerWaiting() {
+    #if BIO_TOUCH_PIN >= 0
+    uint32_t now = millis();
+    bool irq = touch_irq;
+    touch_irq = false;
+    
+    // Nível cobre o dedo que continua no sensor após a 1ª verificação
+    if (irq || digitalRead(BIO_TOUCH_PIN) == HIGH) {
+        last_fallback_poll = now;
+        return true;
+    }
+    #if AS608_TOUCH_FALLBACK_MS > 0
+    if (now - last_fallback_poll >= AS608_TOUCH_FALLBACK_MS) {
+        last_fallback_poll = now;
+        return true;
+    }
+    #endif
+    return false;
+    #else
+    return true;
+    #endif
+}
+
+/**
+ * @brief Antes de usar a Adafruit_Fingerprint: abandona o pipeline e espera
+ * o comando em andamento responder (senão a resposta cairia na API síncrona)
+ */
+void BiometricManager::syncSensor() {
+    if (!as608.busy()) return;
+    as608.cancel();
+    as608.waitIdle(AS608_ASYNC_SEARCH_TIMEOUT_MS);
+}
+
+// ════════════════════════════════════════════════════════════════
+// TRANSFERÊNCIA DE TEMPLATES (v6.1.13)
+// ════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Reserva o driver assíncrono para UpChar/DownChar
+ * A verificação contínua para (isReady() = false) até endBulk(). Uma
+ * chamada síncrona no meio (syncSensor) cancela a transferência em curso.
+ */
+bool BiometricManager::beginBulk() {
+    if (!finger || bulk_active) return false;
+    syncSensor();
+    verify_active = false;
+    verify_done = false;
+    bulk_active = true;
+    return true;
+}
+
+void BiometricManager::endBulk() {
+    if (!bulk_active) return;
+    syncSensor();
+    bulk_active = false;
+    reconcileSensor();                  // Templates gravados/lidos: refaz a ocupação
+}
+
+uint16_t BiometricManager::getPacketLength() {
+    if (!finger) return 0;
+    return finger->packet_len;
+}
+
 /**
  * @brief Retorna último ID reconhecido
  */
@@ -440,7 +755,7 @@ void BiometricManager::listFingerprints() {
     Serial.println("\n╔══════════════════════════════════════════════╗");
     Serial.println("║       IMPRESSÕES DIGITAIS CADASTRADAS        ║");
     Serial.println("╠══════════════════════════════════════════════╣");
-    Serial.printf("║ Total: %d/%d                                 ║\n", finger_count, MAX_FINGERPRINTS);
+    Serial.printf("║ Total: %d/%d                                 ║\n", finger_count, sensor_capacity);
     Serial.println("╠══════════════════════════════════════════════╣");
     
     for (int i = 0; i < finger_count; i++) {
@@ -531,18 +846,13 @@ String BiometricManager::logsToJSON() {
 // ════════════════════════════════════════════════════════════════
 
 String BiometricManager::exportToJSON() {
-    DynamicJsonDocument doc(8192);
+    // ⭐ v6.1.15: Dimensionado pela quantidade (8KB cabiam ~65 digitais)
+    DynamicJsonDocument doc(JSON_ARRAY_SIZE(finger_count) +
+                            finger_count * (JSON_OBJECT_SIZE(6) + FINGER_NAME_LENGTH) + 256);
     JsonArray array = doc.to<JsonArray>();
     
     for (int i = 0; i < finger_count; i++) {
-        Fingerprint* fp = &fingerprints[i];
-        JsonObject obj = array.createNestedObject();
-        obj["id"] = fp->id;
-        obj["name"] = fp->name;
-        obj["timestamp"] = fp->timestamp;
-        obj["active"] = fp->active;
-        obj["access_count"] = fp->access_count;
-        obj["last_access"] = fp->last_access;
+        fingerprintToJSON(fingerprints[i], array.createNestedObject());
     }
     
     String output;
@@ -550,8 +860,35 @@ String BiometricManager::exportToJSON() {
     return output;
 }
 
+/**
+ * @brief ⭐ v6.1.19: Uma digital em JSON (exportação e API paginada)
+ */
+void BiometricManager::fingerprintToJSON(const Fingerprint& fp, JsonObject obj, uint16_t fields) {
+    if (fields & BIO_FIELD_ID)           obj["id"] = fp.id;
+    if (fields & BIO_FIELD_NAME)         obj["name"] = fp.name;
+    if (fields & BIO_FIELD_TIMESTAMP)    obj["timestamp"] = fp.timestamp;
+    if (fields & BIO_FIELD_ACTIVE)       obj["active"] = fp.active;
+    if (fields & BIO_FIELD_ACCESS_COUNT) obj["access_count"] = fp.access_count;
+    if (fields & BIO_FIELD_LAST_ACCESS)  obj["last_access"] = fp.last_access;
+}
+
+// ════════════════════════════════════════════════════════════════
+// ACESSO CONCORRENTE
+// ════════════════════════════════════════════════════════════════
+
+bool BiometricManager::lock(uint32_t timeoutMs) {
+    if (!mutex) return true;
+    TickType_t ticks = timeoutMs == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+    return xSemaphoreTakeRecursive(mutex, ticks) == pdTRUE;
+}
+
+void BiometricManager::unlock() {
+    if (mutex) xSemaphoreGiveRecursive(mutex);
+}
+
 bool BiometricManager::importFromJSON(const String& json) {
-    DynamicJsonDocument doc(8192);
+    BioLock guard(*this);
+    DynamicJsonDocument doc(json.length() * 2 + 1024);
     DeserializationError error = deserializeJson(doc, json);
     
     if (error) {
@@ -568,8 +905,8 @@ bool BiometricManager::importFromJSON(const String& json) {
         
         uint16_t id = obj["id"];
         
-        // Verificar duplicata
-        if (findFingerprintIndex(id) >= 0) continue;
+        // Verificar faixa e duplicata
+        if (!slot_used.valid(id) || findFingerprintIndex(id) >= 0) continue;
         
         Fingerprint* fp = &fingerprints[finger_count];
         fp->id = id;
@@ -579,26 +916,39 @@ bool BiometricManager::importFromJSON(const String& json) {
         fp->access_count = obj["access_count"];
         fp->last_access = obj["last_access"];
         
+        slot_used.set(id);
+        slot_index[id] = finger_count;
         finger_count++;
         imported++;
     }
     
-    saveToNVS();
+    if (!saveFingerprints()) {
+        loadFingerprints();
+        Serial.println("❌ Falha ao gravar a importação - metadados anteriores mantidos");
+        return false;
+    }
     Serial.printf("✅ Importados %d metadados\n", imported);
     return true;
 }
 
 void BiometricManager::clearAll() {
+    BioLock guard(*this);
     clearAllTemplates();
+    if (slot_moved_cb) {
+        for (int i = 0; i < finger_count; i++) slot_moved_cb(fingerprints[i].id, 0);
+    }
     finger_count = 0;
-    saveToNVS();
+    rebuildSlotIndex();
+    saveFingerprints();
     Serial.println("🗑️ Todos os dados removidos");
 }
 
 void BiometricManager::clearAllTemplates() {
     if (!finger) return;
+    syncSensor();
     
     finger->emptyDatabase();
+    sensor_used.clear();
     Serial.println("🗑️ Banco de templates limpo");
 }
 
@@ -612,7 +962,7 @@ void BiometricManager::startEnrollment() {
         return;
     }
     
-    if (finger_count >= MAX_FINGERPRINTS) {
+    if (finger_count >= sensor_capacity) {
         enrollState = BIO_ERROR_FULL;
         return;
     }
@@ -646,6 +996,8 @@ void BiometricManager::processEnrollment() {
         return;
     }
     
+    if (finger) syncSensor();
+    
     uint8_t p;
     
     switch (enrollState) {
@@ -748,7 +1100,7 @@ String BiometricManager::getEnrollStateString() {
         case BIO_ERROR_TIMEOUT: return "Erro: Timeout";
         case BIO_ERROR_NO_MATCH: return "Erro: Digitais nao correspondem";
         case BIO_ERROR_DUPLICATE: return "Erro: Digital ja existe";
-        case BIO_ERROR_FULL: return "Erro: Memoria cheia (127)";
+        case BIO_ERROR_FULL: return "Erro: Memoria cheia";
         case BIO_ERROR_SENSOR: return "Erro: Falha no sensor";
         case BIO_ERROR_HARDWARE: return "Erro: AS608 desconectado";
         default: return "Desconhecido";
@@ -777,52 +1129,309 @@ int BiometricManager::getEnrollProgress() {
 // ════════════════════════════════════════════════════════════════
 
 uint16_t BiometricManager::getFreeID() {
-    // Buscar primeiro ID livre (1-127)
-    for (uint16_t id = 1; id <= 127; id++) {
-        if (!isIDUsed(id)) {
-            return id;
-        }
+    // Menor slot livre: cadastros novos preenchem os buracos (faixa compacta)
+    return nextHole(1);  // 0 = nenhum ID disponível
+}
+
+/**
+ * @brief Primeiro bit zero do bitmap a partir de 'from', pulando templates
+ * órfãos (sem metadados) no sensor
+ */
+uint16_t BiometricManager::nextHole(uint16_t from) {
+    for (uint16_t id = slot_used.firstFree(from); id != 0 && id <= sensor_capacity;
+         id = slot_used.firstFree(id + 1)) {
+        if (!sensor_index_valid || !sensor_used.test(id)) return id;
     }
-    return 0;  // Nenhum ID disponível
+    return 0;
 }
 
 bool BiometricManager::isIDUsed(uint16_t id) {
-    for (int i = 0; i < finger_count; i++) {
-        if (fingerprints[i].id == id) {
-            return true;
+    return slot_used.test(id);
+}
+
+// ════════════════════════════════════════════════════════════════
+// RECONCILIAÇÃO SENSOR × METADADOS (v6.1.15)
+// ════════════════════════════════════════════════════════════════
+
+static void onIndexPage(const As608Reply& reply, void* ctx) {
+    *static_cast<As608Reply*>(ctx) = reply;
+}
+
+/**
+ * @brief Lê a ocupação do sensor com ReadIndexTable
+ * Um comando por página de 256 IDs (AS608 de 300: 2 comandos), no lugar
+ * de sondar ID a ID com LoadChar.
+ */
+bool BiometricManager::readIndexTable() {
+    syncSensor();
+    sensor_index_valid = false;
+    sensor_used.clear();
+    
+    uint8_t pages = (sensor_capacity + 255) / 256;
+    for (uint8_t page = 0; page < pages; page++) {
+        As608Reply reply;
+        reply.transport = AS608_REPLY_TIMEOUT;
+        reply.code = 0xFF;
+        reply.dataLen = 0;
+        
+        const uint8_t p[] = { page };
+        if (!as608.send(AS608_CMD_READINDEX, p, sizeof(p), AS608_ASYNC_CMD_TIMEOUT_MS, onIndexPage, &reply) ||
+            !as608.waitIdle(AS608_ASYNC_CMD_TIMEOUT_MS + 100)) {
+            return false;
+        }
+        if (reply.transport != AS608_REPLY_OK || reply.code != AS608_OK || reply.dataLen < 32) {
+            Serial.printf("❌ ReadIndexTable página %d falhou (transporte %d, código 0x%02X)\n",
+                          page, reply.transport, reply.code);
+            return false;
+        }
+        
+        // Byte i, bit j (LSB primeiro) = ID page*256 + i*8 + j
+        for (uint8_t i = 0; i < 32; i++) {
+            uint8_t bits = reply.data[i];
+            while (bits) {
+                uint8_t j = __builtin_ctz(bits);
+                bits &= bits - 1;
+                uint16_t id = (uint16_t)page * 256 + i * 8 + j;
+                if (id <= sensor_capacity) sensor_used.set(id);  // ID 0 fica de fora (não usado no cadastro)
+            }
         }
     }
-    return false;
+    
+    sensor_index_valid = true;
+    return true;
+}
+
+/**
+ * @brief Compara a ocupação do sensor com os metadados
+ * Órfão: template sem metadados ("sem metadados" no acesso).
+ * Ausente: metadados sem template (digital nunca é reconhecida).
+ */
+bool BiometricManager::reconcileSensor() {
+    if (!readIndexTable()) {
+        Serial.println("⚠️ Reconciliação indisponível (tabela de índice não lida)");
+        return false;
+    }
+    
+    orphan_count = 0;
+    missing_count = 0;
+    String orphans, missing;
+    for (uint16_t id = 1; id <= sensor_capacity; id++) {
+        bool in_sensor = sensor_used.test(id);
+        bool in_meta = slot_used.test(id);
+        if (in_sensor == in_meta) continue;
+        
+        if (in_sensor) {
+            orphan_count++;
+            orphans += " " + String(id);
+        } else {
+            missing_count++;
+            missing += " " + String(id);
+        }
+    }
+    
+    if (finger) finger->templateCount = sensor_used.count();
+    
+    Serial.printf("🔎 Sensor: %d templates | Metadados: %d | Capacidade: %d\n",
+                  sensor_used.count(), finger_count, sensor_capacity);
+    if (orphan_count) {
+        Serial.printf("⚠️ %d template(s) sem metadados:%s\n", orphan_count, orphans.c_str());
+    }
+    if (missing_count) {
+        Serial.printf("⚠️ %d cadastro(s) sem template no sensor:%s\n", missing_count, missing.c_str());
+    }
+    if (!orphan_count && !missing_count) {
+        Serial.println("✅ Sensor e metadados consistentes");
+    }
+    return true;
+}
+
+bool BiometricManager::isTemplateMissing(uint16_t id) const {
+    return sensor_index_valid && slot_used.test(id) && !sensor_used.test(id);
 }
 
 // ════════════════════════════════════════════════════════════════
-// PERSISTÊNCIA NVS
+// BUSCA LIMITADA (v6.1.16)
 // ════════════════════════════════════════════════════════════════
 
-void BiometricManager::loadFromNVS() {
-    preferences.begin("fingerprints", true);
+/**
+ * @brief Páginas pesquisadas pelo HighSpeedSearch: 1 até o maior slot com
+ * metadados. O tempo da busca cresce com as páginas, não com a capacidade.
+ */
+uint16_t BiometricManager::getSearchRange() {
+    uint16_t highest = slot_used.highest();
+    if (highest == 0) return 1;     // Nada cadastrado: a captura ainda detecta o dedo
+    return min(highest, sensor_capacity);
+}
+
+/**
+ * @brief Move um template (e os metadados) para outro slot
+ * LoadChar + Store copiam dentro do sensor (sem UpChar/DownChar).
+ */
+bool BiometricManager::moveTemplate(uint16_t from, uint16_t to) {
+    BioLock guard(*this);
+    if (!finger || !slot_used.test(from) || slot_used.test(to)) return false;
+    syncSensor();
     
-    finger_count = preferences.getInt("count", 0);
+    if (finger->loadModel(from) != FINGERPRINT_OK || finger->storeModel(to) != FINGERPRINT_OK) {
+        Serial.printf("❌ Falha ao mover template %d → %d\n", from, to);
+        return false;
+    }
     
-    for (int i = 0; i < finger_count; i++) {
-        String key = "fp_" + String(i);
-        preferences.getBytes(key.c_str(), &fingerprints[i], sizeof(Fingerprint));
+    int idx = slot_index[from];
+    fingerprints[idx].id = to;
+    slot_used.reset(from);
+    slot_used.set(to);
+    slot_index[to] = idx;
+    sensor_used.set(to);
+    
+    if (finger->deleteModel(from) == FINGERPRINT_OK) {
+        sensor_used.reset(from);
+    } else {
+        Serial.printf("⚠️ Cópia antiga no slot %d não removida (fica órfã)\n", from);
     }
     
-    preferences.end();
+    if (slot_moved_cb) slot_moved_cb(from, to);
+    Serial.printf("🔀 Template movido: %d → %d (%s)\n", from, to, fingerprints[idx].name);
+    return true;
 }
 
-void BiometricManager::saveToNVS() {
-    preferences.begin("fingerprints", false);
+/**
+ * @brief Fecha todos os buracos abaixo do maior slot ocupado
+ * Cada buraco recebe o template mais alto. Manutenção explícita (BIO COMPACT):
+ * LittleFS e cartões acompanham via slot_moved_cb; logs de acesso antigos
+ * continuam com o ID anterior.
+ */
+int BiometricManager::compactSlots() {
+    if (!finger) return 0;
     
-    preferences.putInt("count", finger_count);
+    int moved = 0;
+    uint16_t hole = nextHole(1);
+    uint16_t highest = slot_used.highest();
+    while (hole != 0 && hole < highest) {
+        if (!moveTemplate(highest, hole)) break;
+        moved++;
+        hole = nextHole(hole + 1);
+        highest = slot_used.highest();
+    }
+    
+    if (moved) saveFingerprints();
+    Serial.printf("✅ Compactação: %d template(s) movido(s), busca em 1-%d\n", moved, getSearchRange());
+    return moved;
+}
+
+void BiometricManager::printSearchStats() {
+    Serial.println("\n🔍 ═══════════════════════════════════════");
+    Serial.println("   BUSCA 1:N (HighSpeedSearch)");
+    Serial.println("═══════════════════════════════════════");
+    Serial.printf("Faixa atual  : 1-%d (%d cadastros, capacidade %d)\n",
+                  getSearchRange(), finger_count, sensor_capacity);
+    
+    bool any = false;
+    for (int b = 0; b < BIO_SEARCH_BUCKETS; b++) {
+        const BioSearchStats& st = search_stats[b];
+        if (!st.searches) continue;
+        any = true;
+        Serial.printf("Páginas %3d-%3d: %5lu buscas | média %4lu ms | máx %4lu ms\n",
+                      b * MAX_FINGERPRINTS / BIO_SEARCH_BUCKETS + 1,
+                      (b + 1) * MAX_FINGERPRINTS / BIO_SEARCH_BUCKETS,
+                      (unsigned long)st.searches,
+                      (unsigned long)(st.totalUs / st.searches / 1000),
+                      (unsigned long)(st.maxUs / 1000));
+    }
+    if (!any) Serial.println("Nenhuma busca desde o boot");
+    if (match_stats.searches) {
+        Serial.printf("Match 1:1 (cartão): %5lu | média %4lu ms | máx %4lu ms\n",
+                      (unsigned long)match_stats.searches,
+                      (unsigned long)(match_stats.totalUs / match_stats.searches / 1000),
+                      (unsigned long)(match_stats.maxUs / 1000));
+    }
+    Serial.println("═══════════════════════════════════════\n");
+}
+
+/**
+ * @brief Refaz bitmap e tabela slot → índice (após carregar/limpar)
+ * Entradas fora da faixa ou duplicadas ficam fora da tabela.
+ */
+void BiometricManager::rebuildSlotIndex() {
+    slot_used.clear();
+    memset(slot_index, 0xFF, sizeof(slot_index));
     
     for (int i = 0; i < finger_count; i++) {
-        String key = "fp_" + String(i);
-        preferences.putBytes(key.c_str(), &fingerprints[i], sizeof(Fingerprint));
+        uint16_t id = fingerprints[i].id;
+        if (!slot_used.valid(id) || slot_used.test(id)) {
+            Serial.printf("⚠️ Metadados com ID %d inválido/duplicado (índice %d)\n", id, i);
+            continue;
+        }
+        slot_used.set(id);
+        slot_index[id] = i;
     }
+}
+
+// ════════════════════════════════════════════════════════════════
+// PERSISTÊNCIA (METADADOS EM LITTLEFS, LOGS EM NVS)
+// ════════════════════════════════════════════════════════════════
+
+/**
+ * @brief ⭐ v6.1.20: Tabela BIO_TABLE_FILE; sem ela, o blob "fp_table" ou
+ * "count" + "fp_N" do NVS. As chaves antigas só saem depois de a tabela
+ * estar gravada (RecordTable).
+ */
+void BiometricManager::loadFingerprints() {
+    BioLock guard(*this);
+    data_gen++;
+    finger_count = table.load(fingerprints);
+    stats_lo = stats_hi = -1;
+    rebuildSlotIndex();
+}
+
+/**
+ * @brief Regrava a tabela inteira (remoção, importação, compactação)
+ * @return true se os metadados estão em flash
+ */
+bool BiometricManager::saveFingerprints() {
+    data_gen++;     // ⭐ v6.1.19: ETag da API (metadados mudaram)
+    if (!table.save(fingerprints, finger_count)) return false;
+    stats_lo = stats_hi = -1;   // Contadores pendentes foram junto
+    return true;
+}
+
+/**
+ * @brief Regrava só o registro (nome, ativo; inclusão acrescenta no fim)
+ */
+bool BiometricManager::saveFingerprint(int index) {
+    data_gen++;
+    return table.saveRecord(fingerprints, finger_count, index);
+}
+
+/**
+ * @brief Acesso autorizado: contador/último acesso ficam em RAM até flushStats()
+ * Um acesso por vez na porta não justifica uma gravação em flash cada; em
+ * queda de energia perdem-se no máximo BIO_STATS_FLUSH_MS de contadores.
+ */
+void BiometricManager::markStats(int index) {
+    data_gen++;     // API vê o contador novo
+    if (stats_lo < 0) {
+        stats_lo = stats_hi = index;
+        stats_since = millis();
+    } else {
+        if (index < stats_lo) stats_lo = index;
+        if (index > stats_hi) stats_hi = index;
+    }
+}
+
+/**
+ * @brief Grava a faixa de registros com contadores pendentes (um só arquivo aberto)
+ */
+void BiometricManager::flushStats() {
+    if (stats_lo < 0 || millis() - stats_since < BIO_STATS_FLUSH_MS) return;
     
-    preferences.end();
+    BioLock guard(*this);
+    if (stats_lo < 0) return;
+    if (table.saveRange(fingerprints, finger_count, stats_lo, stats_hi - stats_lo + 1)) {
+        stats_lo = stats_hi = -1;
+    } else {
+        stats_since = millis();     // Próxima tentativa regrava a tabela inteira
+    }
 }
 
 void BiometricManager::loadLogsFromNVS() {
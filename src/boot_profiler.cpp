@@ -0,0 +1,114 @@
+/**
+ * @file boot_profiler.cpp
+ * @brief Implementação do profiler do boot
+ * @version 1.0.0
+ * @date 2025-12-07
+ */
+
+#include "boot_profiler.h"
+#include <esp_timer.h>
+
+BootProfiler bootProfiler;
+
+static inline uint32_t bootUs() {
+    return (uint32_t)esp_timer_get_time();
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONSTRUTOR
+// ═══════════════════════════════════════════════════════════════════════
+
+BootProfiler::BootProfiler()
+    : count(0),
+      doorReadyUs(0) {
+    lock = portMUX_INITIALIZER_UNLOCKED;
+    memset(stages, 0, sizeof(stages));
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// ETAPAS
+// ═══════════════════════════════════════════════════════════════════════
+
+int BootProfiler::begin(const char* name) {
+    uint32_t now = bootUs();
+    int idx = -1;
+
+    portENTER_CRITICAL(&lock);
+    if (count < BOOT_PROF_MAX_STAGES) {
+        idx = count++;
+        stages[idx].name = name;
+        stages[idx].task = pcTaskGetName(NULL);
+        stages[idx].core = xPortGetCoreID();
+        stages[idx].startUs = now;
+        stages[idx].endUs = 0;
+        stages[idx].ok = false;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    return idx;
+}
+
+void BootProfiler::end(int stage, bool ok) {
+    if (stage < 0 || stage >= BOOT_PROF_MAX_STAGES) return;
+    uint32_t now = bootUs();
+
+    portENTER_CRITICAL(&lock);
+    stages[stage].endUs = now;
+    stages[stage].ok = ok;
+    BootStage s = stages[stage];
+    portEXIT_CRITICAL(&lock);
+
+    Serial.printf("⏱️  [Boot] %-18s %s %5lu ms (t=%lu ms, %s/core %u)\n",
+                  s.name, s.ok ? "✅" : "⚠️ ", (unsigned long)((s.endUs - s.startUs) / 1000),
+                  (unsigned long)(s.endUs / 1000), s.task, s.core);
+}
+
+void BootProfiler::doorReady() {
+    if (doorReadyUs) return;
+    doorReadyUs = bootUs();
+    print();
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// RELATÓRIO
+// ═══════════════════════════════════════════════════════════════════════
+
+void BootProfiler::print() {
+    BootStage snap[BOOT_PROF_MAX_STAGES];
+    uint8_t n;
+
+    portENTER_CRITICAL(&lock);
+    n = count;
+    memcpy(snap, stages, sizeof(BootStage) * n);
+    portEXIT_CRITICAL(&lock);
+
+    Serial.println("\n🚀 ═══════════════════════════════════════");
+    Serial.println("   PERFIL DO BOOT");
+    Serial.println("═══════════════════════════════════════");
+    Serial.println("Etapa               Tarefa        Core  Início(ms)  Duração(ms)");
+
+    for (uint8_t i = 0; i < n; i++) {
+        const BootStage& s = snap[i];
+        if (s.endUs) {
+            Serial.printf("%-19s %-13s %4u %11lu %12lu %s\n",
+                          s.name, s.task, s.core,
+                          (unsigned long)(s.startUs / 1000),
+                          (unsigned long)((s.endUs - s.startUs) / 1000),
+                          s.ok ? "" : "(falhou)");
+        } else {
+            Serial.printf("%-19s %-13s %4u %11lu %12s\n",
+                          s.name, s.task, s.core,
+                          (unsigned long)(s.startUs / 1000), "...");
+        }
+    }
+
+    Serial.println("───────────────────────────────────────");
+    if (doorReadyUs) {
+        uint32_t ms = doorReadyUs / 1000;
+        Serial.printf("Porta pronta em %lu ms %s (meta %d ms)\n", (unsigned long)ms,
+                      ms <= BOOT_PROF_TARGET_MS ? "✅" : "⚠️", BOOT_PROF_TARGET_MS);
+    } else {
+        Serial.println("Porta ainda não pronta");
+    }
+    Serial.println("═══════════════════════════════════════\n");
+}
@@ -0,0 +1,700 @@
+/**
+ * @file credential_api.cpp
+ * @brief API REST paginada de credenciais (cartões RFID + digitais)
+ * @version 1.0.0
+ * @date 2025-12-07
+ */
+
+#include "credential_api.h"
+#include "wifi_config.h"
+#include "rfid_manager.h"
+#include "rfid_handlers_simple.h"
+#include "biometric_manager.h"
+#include "biometric_storage.h"
+#include "bio_batch.h"
+#include <freertos/queue.h>
+#include <algorithm>
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Alteração de digital pedida pela API (aplicada no loop)
+ */
+enum CredOpType : uint8_t {
+    CRED_OP_FINGER_ADD = 0,     // Entra na lista do cadastro em lote
+    CRED_OP_FINGER_EDIT,        // Nome e/ou ativo
+    CRED_OP_FINGER_DELETE       // Sensor + metadados + BiometricStorage
+};
+
+struct CredOp {
+    CredOpType type;
+    uint16_t id;                // Slot (ADD: 0 = próximo livre)
+    int8_t active;              // EDIT: -1 = sem mudança
+    char name[FINGER_NAME_LENGTH];  // "" = sem mudança
+};
+
+/**
+ * @brief Nome de campo em ?fields= → bit do *ToJSON()
+ */
+struct CredField {
+    const char* name;
+    uint16_t bit;
+};
+
+static const CredField CARD_FIELDS[] = {
+    {"uid", RFID_FIELD_UID}, {"name", RFID_FIELD_NAME}, {"timestamp", RFID_FIELD_TIMESTAMP},
+    {"active", RFID_FIELD_ACTIVE}, {"access_count", RFID_FIELD_ACCESS_COUNT},
+    {"last_access", RFID_FIELD_LAST_ACCESS}, {"finger_slot", RFID_FIELD_FINGER_SLOT}
+};
+
+static const CredField FINGER_FIELDS[] = {
+    {"id", BIO_FIELD_ID}, {"name", BIO_FIELD_NAME}, {"timestamp", BIO_FIELD_TIMESTAMP},
+    {"active", BIO_FIELD_ACTIVE}, {"access_count", BIO_FIELD_ACCESS_COUNT},
+    {"last_access", BIO_FIELD_LAST_ACCESS}
+};
+
+static QueueHandle_t opQueue = nullptr;
+static uint32_t bootTag = 0;    // ETag de um boot não vale no seguinte (gerações recomeçam)
+
+// ═══════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════
+
+static AsyncResponseStream* beginJson(AsyncWebServerRequest *request, int code = 200) {
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->setCode(code);
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    return response;
+}
+
+/**
+ * @brief Corpo JSON acumulado em _tempObject (liberado pelo servidor)
+ */
+static void collectBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    if (total > CRED_API_MAX_BODY) return;
+    if (index == 0) request->_tempObject = malloc(total);
+    if (request->_tempObject) memcpy((uint8_t*)request->_tempObject + index, data, len);
+}
+
+static bool readBody(AsyncWebServerRequest *request, JsonDocument& doc) {
+    if (request->contentLength() > CRED_API_MAX_BODY) {
+        sendRFIDError(request, "Corpo muito grande", 413);
+        return false;
+    }
+    if (!request->_tempObject ||
+        deserializeJson(doc, (const char*)request->_tempObject, request->contentLength())) {
+        sendRFIDError(request, "JSON inválido");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Trecho após "<base>/" na URL ("" = coleção)
+ */
+static String pathKey(AsyncWebServerRequest *request, const char* base) {
+    String url = request->url();
+    size_t n = strlen(base);
+    return url.length() > n + 1 ? url.substring(n + 1) : String();
+}
+
+static String queryParam(AsyncWebServerRequest *request, const char* name) {
+    return request->hasParam(name) ? request->getParam(name)->value() : String();
+}
+
+/**
+ * @brief ?fields=a,b,c → máscara (sem o parâmetro: todos)
+ */
+static bool parseFields(AsyncWebServerRequest *request, const CredField* table, size_t n,
+                        uint16_t all, uint16_t& fields) {
+    fields = all;
+    String list = queryParam(request, "fields");
+    if (list.length() == 0) return true;
+
+    fields = 0;
+    int start = 0;
+    while (start <= (int)list.length()) {
+        int end = list.indexOf(',', start);
+        if (end < 0) end = list.length();
+        String f = list.substring(start, end);
+        f.trim();
+        if (f.length()) {
+            size_t i = 0;
+            while (i < n && f != table[i].name) i++;
+            if (i == n) return false;
+            fields |= table[i].bit;
+        }
+        start = end + 1;
+    }
+    return fields != 0;
+}
+
+static bool parseLimit(AsyncWebServerRequest *request, uint16_t& limit) {
+    limit = CRED_API_DEFAULT_LIMIT;
+    String text = queryParam(request, "limit");
+    if (text.length() == 0) return true;
+    long v = text.toInt();
+    if (v < 1 || v > CRED_API_MAX_LIMIT) return false;
+    limit = v;
+    return true;
+}
+
+/**
+ * @brief ETag = boot + geração da lista + variante da consulta (FNV-1a)
+ */
+static String makeETag(char kind, uint32_t gen, const String& variant) {
+    uint32_t h = 2166136261UL;
+    for (unsigned int i = 0; i < variant.length(); i++) {
+        h = (h ^ (uint8_t)variant[i]) * 16777619UL;
+    }
+    char buf[40];
+    snprintf(buf, sizeof(buf), "\"%c%08lx-%lx-%08lx\"", kind,
+             (unsigned long)bootTag, (unsigned long)gen, (unsigned long)h);
+    return String(buf);
+}
+
+/**
+ * @brief If-None-Match confere: responde 304 e retorna true
+ */
+static bool notModified(AsyncWebServerRequest *request, const String& etag) {
+    if (!request->hasHeader("If-None-Match")) return false;
+    if (request->getHeader("If-None-Match")->value().indexOf(etag) < 0) return false;
+
+    AsyncWebServerResponse *response = request->beginResponse(304);
+    response->addHeader("ETag", etag);
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    request->send(response);
+    return true;
+}
+
+static void sendBusy(AsyncWebServerRequest *request) {
+    AsyncWebServerResponse *response = request->beginResponse(503, "application/json",
+        "{\"success\":false,\"error\":\"Credenciais em uso, tente novamente\"}");
+    response->addHeader("Retry-After", "1");
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    request->send(response);
+}
+
+/**
+ * @brief Ordem de paginação dos cartões: tamanho do UID, depois bytes
+ */
+static int compareUid(const RFIDCard& card, const uint8_t* uid, uint8_t len) {
+    if (card.uid_length != len) return card.uid_length < len ? -1 : 1;
+    return memcmp(card.uid, uid, len);
+}
+
+static String uidKey(const RFIDCard& card) {
+    char buf[RFID_UID_LENGTH * 2 + 1];
+    for (uint8_t i = 0; i < card.uid_length; i++) sprintf(buf + i * 2, "%02X", card.uid[i]);
+    buf[card.uid_length * 2] = '\0';
+    return String(buf);
+}
+
+/**
+ * @brief 1 = digital cadastrada, 0 = não, -1 = metadados ocupados
+ */
+static int fingerExists(uint16_t id) {
+    if (!bioManager.lock(CRED_API_LOCK_MS)) return -1;
+    int found = bioManager.findFingerprintIndex(id) >= 0;
+    bioManager.unlock();
+    return found;
+}
+
+static bool queueOp(AsyncWebServerRequest *request, const CredOp& op, const char* message) {
+    if (!opQueue || xQueueSend(opQueue, &op, 0) != pdTRUE) {
+        sendBusy(request);
+        return false;
+    }
+    AsyncResponseStream *response = beginJson(request, 202);
+    StaticJsonDocument<128> doc;
+    doc["success"] = true;
+    doc["message"] = message;
+    serializeJson(doc, *response);
+    request->send(response);
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// CARTÕES
+// ═══════════════════════════════════════════════════════════════════════
+
+static void sendCard(AsyncWebServerRequest *request, int index, uint16_t fields, int code, const String& etag) {
+    AsyncResponseStream *response = beginJson(request, code);
+    if (etag.length()) response->addHeader("ETag", etag);
+    StaticJsonDocument<256> doc;
+    rfidManager.cardToJSON(*rfidManager.getCard(index), doc.to<JsonObject>(), fields);
+    serializeJson(doc, *response);
+    request->send(response);
+}
+
+static void handleCardsGet(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+    if (!rfidManager.isLoaded()) { sendBusy(request); return; }   // ⭐ v6.1.20: Boot ainda lendo a tabela
+
+    uint16_t fields, limit;
+    if (!parseFields(request, CARD_FIELDS, sizeof(CARD_FIELDS) / sizeof(CARD_FIELDS[0]), RFID_FIELDS_ALL, fields)) {
+        sendRFIDError(request, "Campo desconhecido em fields");
+        return;
+    }
+
+    // ═══ UM CARTÃO: /api/cards/<uid> ═══
+    String key = pathKey(request, "/api/cards");
+    if (key.length()) {
+        uint8_t uid[RFID_UID_LENGTH];
+        uint8_t uidLength = parseRFIDUid(key, uid);
+        if (uidLength == 0) {
+            sendRFIDError(request, "UID inválido (4 ou 7 bytes em hex)");
+            return;
+        }
+        if (!rfidManager.lock(CRED_API_LOCK_MS)) {
+            sendBusy(request);
+            return;
+        }
+        int index = rfidManager.findCardIndex(uid, uidLength);
+        String etag = makeETag('k', rfidManager.generation(), key + "|" + fields);
+        if (index < 0) {
+            sendRFIDError(request, "Cartão não encontrado", 404);
+        } else if (!notModified(request, etag)) {
+            sendCard(request, index, fields, 200, etag);
+        }
+        rfidManager.unlock();
+        return;
+    }
+
+    // ═══ PÁGINA ═══
+    if (!parseLimit(request, limit)) {
+        sendRFIDError(request, "limit inválido (1-50)");
+        return;
+    }
+    String cursorText = queryParam(request, "cursor");
+    uint8_t cursor[RFID_UID_LENGTH];
+    uint8_t cursorLength = 0;
+    if (cursorText.length() && (cursorLength = parseRFIDUid(cursorText, cursor)) == 0) {
+        sendRFIDError(request, "Cursor inválido");
+        return;
+    }
+
+    if (!rfidManager.lock(CRED_API_LOCK_MS)) {
+        sendBusy(request);
+        return;
+    }
+    uint32_t gen = rfidManager.generation();
+    String etag = makeETag('c', gen, cursorText + "|" + limit + "|" + fields);
+    if (notModified(request, etag)) {       // Só comparação em RAM: nada de NVS nem JSON
+        rfidManager.unlock();
+        return;
+    }
+
+    // Cartões após o cursor, em ordem de UID (no máximo MAX_RFID_CARDS)
+    int total = rfidManager.getCardCount();
+    uint16_t order[MAX_RFID_CARDS];         // ⭐ v6.1.20: 1KB na pilha da async_tcp com 500 cartões
+    int n = 0;
+    for (int i = 0; i < total; i++) {
+        if (!cursorLength || compareUid(*rfidManager.getCard(i), cursor, cursorLength) > 0) order[n++] = i;
+    }
+    std::sort(order, order + n, [](uint16_t a, uint16_t b) {
+        RFIDCard* cb = rfidManager.getCard(b);
+        return compareUid(*rfidManager.getCard(a), cb->uid, cb->uid_length) < 0;
+    });
+    int take = min(n, (int)limit);
+
+    AsyncResponseStream *response = beginJson(request);
+    response->addHeader("ETag", etag);
+    response->printf("{\"generation\":%lu,\"total\":%d,\"items\":[", (unsigned long)gen, total);
+    for (int k = 0; k < take; k++) {
+        StaticJsonDocument<256> item;
+        rfidManager.cardToJSON(*rfidManager.getCard(order[k]), item.to<JsonObject>(), fields);
+        if (k) response->print(',');
+        serializeJson(item, *response);
+    }
+    response->print("],\"next_cursor\":");
+    if (n > take) {
+        response->printf("\"%s\"}", uidKey(*rfidManager.getCard(order[take - 1])).c_str());
+    } else {
+        response->print("null}");
+    }
+    rfidManager.unlock();
+    request->send(response);
+}
+
+static void handleCardsPost(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+    if (!rfidManager.isLoaded()) { sendBusy(request); return; }
+
+    StaticJsonDocument<CRED_API_MAX_BODY> doc;
+    if (!readBody(request, doc)) return;
+
+    uint8_t uid[RFID_UID_LENGTH];
+    uint8_t uidLength = parseRFIDUid(doc["uid"] | "", uid);
+    const char* name = doc["name"] | "";
+    uint16_t slot = doc["finger_slot"] | 0;
+
+    if (uidLength == 0) {
+        sendRFIDError(request, "UID inválido (4 ou 7 bytes em hex)");
+        return;
+    }
+    if (strlen(name) == 0 || strlen(name) >= RFID_NAME_LENGTH) {
+        sendRFIDError(request, "Nome obrigatório (até 19 caracteres)");
+        return;
+    }
+    // Digital conferida antes do lock da lista (ordem do loop: biometria → RFID)
+    if (slot) {
+        int exists = fingerExists(slot);
+        if (exists < 0) { sendBusy(request); return; }
+        if (!exists) { sendRFIDError(request, "finger_slot sem digital cadastrada", 422); return; }
+    }
+
+    RFIDLock guard(rfidManager);
+    if (rfidManager.findCardIndex(uid, uidLength) >= 0) {
+        sendRFIDError(request, "Cartão já cadastrado", 409);
+        return;
+    }
+    if (rfidManager.getCardCount() >= MAX_RFID_CARDS) {
+        sendRFIDError(request, "Memória cheia", 507);
+        return;
+    }
+    if (!rfidManager.addCard(uid, uidLength, name)) {
+        sendRFIDError(request, "Falha ao salvar", 500);
+        return;
+    }
+    int index = rfidManager.findCardIndex(uid, uidLength);
+    if (!(doc["active"] | true)) rfidManager.toggleCardActive(index);
+    if (slot) rfidManager.linkFinger(index, slot);
+
+    sendCard(request, index, RFID_FIELDS_ALL, 201, String());
+}
+
+static void handleCardsPatch(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+    if (!rfidManager.isLoaded()) { sendBusy(request); return; }
+
+    StaticJsonDocument<CRED_API_MAX_BODY> doc;
+    if (!readBody(request, doc)) return;
+
+    uint8_t uid[RFID_UID_LENGTH];
+    uint8_t uidLength = parseRFIDUid(pathKey(request, "/api/cards"), uid);
+    if (uidLength == 0) {
+        sendRFIDError(request, "UID inválido (4 ou 7 bytes em hex)");
+        return;
+    }
+
+    const char* name = doc["name"] | "";
+    if (doc.containsKey("name") && (strlen(name) == 0 || strlen(name) >= RFID_NAME_LENGTH)) {
+        sendRFIDError(request, "Nome obrigatório (até 19 caracteres)");
+        return;
+    }
+    uint16_t slot = doc["finger_slot"] | 0;
+    if (slot) {
+        int exists = fingerExists(slot);
+        if (exists < 0) { sendBusy(request); return; }
+        if (!exists) { sendRFIDError(request, "finger_slot sem digital cadastrada", 422); return; }
+    }
+
+    RFIDLock guard(rfidManager);
+    int index = rfidManager.findCardIndex(uid, uidLength);
+    if (index < 0) {
+        sendRFIDError(request, "Cartão não encontrado", 404);
+        return;
+    }
+    if (doc.containsKey("name")) rfidManager.editCardName(index, name);
+    if (doc.containsKey("active") && (bool)doc["active"] != rfidManager.getCard(index)->active) {
+        rfidManager.toggleCardActive(index);
+    }
+    if (doc.containsKey("finger_slot")) rfidManager.linkFinger(index, slot);
+
+    sendCard(request, index, RFID_FIELDS_ALL, 200, String());
+}
+
+static void handleCardsDelete(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+    if (!rfidManager.isLoaded()) { sendBusy(request); return; }
+
+    uint8_t uid[RFID_UID_LENGTH];
+    uint8_t uidLength = parseRFIDUid(pathKey(request, "/api/cards"), uid);
+    if (uidLength == 0) {
+        sendRFIDError(request, "UID inválido (4 ou 7 bytes em hex)");
+        return;
+    }
+    {
+        RFIDLock guard(rfidManager);
+        int index = rfidManager.findCardIndex(uid, uidLength);
+        if (index < 0) {
+            sendRFIDError(request, "Cartão não encontrado", 404);
+            return;
+        }
+        if (!rfidManager.removeCard(index)) {     // ⭐ v6.1.20: Tabela não gravada (cartão mantido)
+            sendRFIDError(request, "Falha ao salvar", 500);
+            return;
+        }
+    }
+    sendRFIDSuccess(request, "Cartão removido");
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// DIGITAIS
+// ═══════════════════════════════════════════════════════════════════════
+
+static bool parseSlot(const String& text, uint16_t& id) {
+    if (text.length() == 0) return false;
+    for (unsigned int i = 0; i < text.length(); i++) {
+        if (!isDigit(text[i])) return false;
+    }
+    long v = text.toInt();
+    if (v < 1 || v > bioManager.getCapacity()) return false;
+    id = v;
+    return true;
+}
+
+static void handleFingersGet(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+
+    uint16_t fields, limit;
+    if (!parseFields(request, FINGER_FIELDS, sizeof(FINGER_FIELDS) / sizeof(FINGER_FIELDS[0]), BIO_FIELDS_ALL, fields)) {
+        sendRFIDError(request, "Campo desconhecido em fields");
+        return;
+    }
+
+    // ═══ UMA DIGITAL: /api/fingers/<id> ═══
+    String key = pathKey(request, "/api/fingers");
+    if (key.length()) {
+        uint16_t id;
+        if (!parseSlot(key, id)) {
+            sendRFIDError(request, "ID inválido");
+            return;
+        }
+        if (!bioManager.lock(CRED_API_LOCK_MS)) {
+            sendBusy(request);
+            return;
+        }
+        int index = bioManager.findFingerprintIndex(id);
+        String etag = makeETag('d', bioManager.generation(), key + "|" + fields);
+        if (index < 0) {
+            sendRFIDError(request, "Digital não encontrada", 404);
+        } else if (!notModified(request, etag)) {
+            AsyncResponseStream *response = beginJson(request);
+            response->addHeader("ETag", etag);
+            StaticJsonDocument<192> doc;
+            bioManager.fingerprintToJSON(*bioManager.getFingerprint(index), doc.to<JsonObject>(), fields);
+            serializeJson(doc, *response);
+            request->send(response);
+        }
+        bioManager.unlock();
+        return;
+    }
+
+    // ═══ PÁGINA ═══
+    if (!parseLimit(request, limit)) {
+        sendRFIDError(request, "limit inválido (1-50)");
+        return;
+    }
+    String cursorText = queryParam(request, "cursor");
+    uint16_t cursor = 0;
+    if (cursorText.length() && !parseSlot(cursorText, cursor)) {
+        sendRFIDError(request, "Cursor inválido");
+        return;
+    }
+
+    if (!bioManager.lock(CRED_API_LOCK_MS)) {
+        sendBusy(request);
+        return;
+    }
+    uint32_t gen = bioManager.generation();
+    String etag = makeETag('f', gen, cursorText + "|" + limit + "|" + fields);
+    if (notModified(request, etag)) {
+        bioManager.unlock();
+        return;
+    }
+
+    AsyncResponseStream *response = beginJson(request);
+    response->addHeader("ETag", etag);
+    response->printf("{\"generation\":%lu,\"total\":%d,\"items\":[", (unsigned long)gen, bioManager.getCount());
+
+    // Slots em ordem crescente (índice slot → metadados é O(1))
+    uint16_t taken = 0, last = 0;
+    bool more = false;
+    for (uint16_t id = cursor + 1; id <= bioManager.getCapacity(); id++) {
+        int index = bioManager.findFingerprintIndex(id);
+        if (index < 0) continue;
+        if (taken == limit) {
+            more = true;
+            break;
+        }
+        StaticJsonDocument<192> item;
+        bioManager.fingerprintToJSON(*bioManager.getFingerprint(index), item.to<JsonObject>(), fields);
+        if (taken) response->print(',');
+        serializeJson(item, *response);
+        taken++;
+        last = id;
+    }
+    response->print("],\"next_cursor\":");
+    if (more) {
+        response->printf("\"%u\"}", last);
+    } else {
+        response->print("null}");
+    }
+    bioManager.unlock();
+    request->send(response);
+}
+
+static void handleFingersPost(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+
+    StaticJsonDocument<CRED_API_MAX_BODY> doc;
+    if (!readBody(request, doc)) return;
+
+    CredOp op = {};
+    op.type = CRED_OP_FINGER_ADD;
+    op.id = doc["id"] | 0;
+    op.active = -1;
+    const char* name = doc["name"] | "";
+    if (strlen(name) == 0 || strlen(name) >= FINGER_NAME_LENGTH) {
+        sendRFIDError(request, "Nome obrigatório (até 19 caracteres)");
+        return;
+    }
+    if (op.id > bioManager.getCapacity()) {
+        sendRFIDError(request, "ID fora da faixa");
+        return;
+    }
+    if (op.id) {
+        int exists = fingerExists(op.id);
+        if (exists < 0) { sendBusy(request); return; }
+        if (exists) { sendRFIDError(request, "ID já cadastrado", 409); return; }
+    }
+    strncpy(op.name, name, FINGER_NAME_LENGTH - 1);
+
+    // A digital em si só existe depois de o usuário passar no sensor (BATCH START)
+    queueOp(request, op, "Usuário na fila do cadastro em lote");
+}
+
+static void handleFingersPatch(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+
+    StaticJsonDocument<CRED_API_MAX_BODY> doc;
+    if (!readBody(request, doc)) return;
+
+    CredOp op = {};
+    op.type = CRED_OP_FINGER_EDIT;
+    op.active = doc.containsKey("active") ? (doc["active"] ? 1 : 0) : -1;
+    if (!parseSlot(pathKey(request, "/api/fingers"), op.id)) {
+        sendRFIDError(request, "ID inválido");
+        return;
+    }
+    const char* name = doc["name"] | "";
+    if (doc.containsKey("name") && (strlen(name) == 0 || strlen(name) >= FINGER_NAME_LENGTH)) {
+        sendRFIDError(request, "Nome obrigatório (até 19 caracteres)");
+        return;
+    }
+    if (!doc.containsKey("name") && op.active < 0) {
+        sendRFIDError(request, "Nada a alterar (name/active)");
+        return;
+    }
+    int exists = fingerExists(op.id);
+    if (exists < 0) { sendBusy(request); return; }
+    if (!exists) { sendRFIDError(request, "Digital não encontrada", 404); return; }
+    strncpy(op.name, name, FINGER_NAME_LENGTH - 1);
+
+    queueOp(request, op, "Alteração agendada");
+}
+
+static void handleFingersDelete(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+
+    CredOp op = {};
+    op.type = CRED_OP_FINGER_DELETE;
+    op.active = -1;
+    if (!parseSlot(pathKey(request, "/api/fingers"), op.id)) {
+        sendRFIDError(request, "ID inválido");
+        return;
+    }
+    int exists = fingerExists(op.id);
+    if (exists < 0) { sendBusy(request); return; }
+    if (!exists) { sendRFIDError(request, "Digital não encontrada", 404); return; }
+
+    queueOp(request, op, "Remoção agendada");
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÃO DOS ENDPOINTS
+// ═══════════════════════════════════════════════════════════════════════
+
+void setupCredentialEndpoints(AsyncWebServer& server) {
+    bootTag = esp_random();
+    if (!opQueue) opQueue = xQueueCreate(CRED_API_QUEUE_LEN, sizeof(CredOp));
+
+    // "/api/cards" também casa "/api/cards/<uid>" (idem fingers)
+    server.on("/api/cards", HTTP_OPTIONS, handleCORS);
+    server.on("/api/fingers", HTTP_OPTIONS, handleCORS);
+
+    server.on("/api/cards", HTTP_GET, handleCardsGet);
+    server.on("/api/cards", HTTP_POST, handleCardsPost, nullptr, collectBody);
+    server.on("/api/cards", HTTP_PATCH | HTTP_PUT, handleCardsPatch, nullptr, collectBody);
+    server.on("/api/cards", HTTP_DELETE, handleCardsDelete);
+
+    server.on("/api/fingers", HTTP_GET, handleFingersGet);
+    server.on("/api/fingers", HTTP_POST, handleFingersPost, nullptr, collectBody);
+    server.on("/api/fingers", HTTP_PATCH | HTTP_PUT, handleFingersPatch, nullptr, collectBody);
+    server.on("/api/fingers", HTTP_DELETE, handleFingersDelete);
+
+    Serial.println("[API] Rotas de credenciais configuradas:");
+    Serial.println("  GET/POST/PATCH/DELETE /api/cards[/<uid>]");
+    Serial.println("  GET/POST/PATCH/DELETE /api/fingers[/<id>]");
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// FILA DE ALTERAÇÕES (LOOP)
+// ═══════════════════════════════════════════════════════════════════════
+
+void credentialApiUpdate() {
+    CredOp op;
+    if (!opQueue || xQueuePeek(opQueue, &op, 0) != pdTRUE) return;
+
+    // Remoção usa o AS608: espera o fim de lote/backup (fica na fila)
+    if (op.type == CRED_OP_FINGER_DELETE && !bioManager.isReady()) return;
+    xQueueReceive(opQueue, &op, 0);
+
+    switch (op.type) {
+        case CRED_OP_FINGER_ADD: {
+            uint16_t slot = bioBatch.addUser(op.id, op.name);
+            if (slot) {
+                Serial.printf("🌐 [API] %s aguardando cadastro no slot %u (BATCH START)\n", op.name, slot);
+            } else {
+                Serial.printf("❌ [API] %s não entrou na lista do lote\n", op.name);
+            }
+            break;
+        }
+        case CRED_OP_FINGER_EDIT: {
+            int index = bioManager.findFingerprintIndex(op.id);
+            if (index < 0) break;                   // Removida depois do pedido
+            if (op.name[0]) {
+                bioManager.editFingerprintName(index, op.name);
+                bioStorage.updateUserName(op.id, op.name);
+            }
+            if (op.active >= 0 && bioManager.getFingerprint(index)->active != (bool)op.active) {
+                bioManager.toggleFingerprintActive(index);
+            }
+            break;
+        }
+        case CRED_OP_FINGER_DELETE:
+            if (bioManager.findFingerprintIndex(op.id) < 0) break;
+            // ⭐ v6.1.20: Sensor primeiro; LittleFS só depois de o template sair
+            if (!bioManager.deleteFingerprintByID(op.id)) {
+                Serial.printf("❌ [API] Digital ID=%u não removida do sensor (cadastro mantido)\n", op.id);
+                break;
+            }
+            if (!bioStorage.removeUser(op.id)) {
+                Serial.printf("⚠️ [API] Digital ID=%u sem registro no LittleFS\n", op.id);
+            }
+            Serial.printf("🌐 [API] Digital ID=%u removida\n", op.id);
+            break;
+    }
+}
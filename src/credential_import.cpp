@@ -0,0 +1,308 @@
+/**
+ * @file credential_import.cpp
+ * @brief Importação de cartões em massa por upload (CSV ou NDJSON em stream)
+ * @version 1.1.0
+ * @date 2025-12-07
+ */
+
+#include "credential_import.h"
+#include "credential_api.h"
+#include "wifi_config.h"
+#include "rfid_manager.h"
+#include "rfid_handlers_simple.h"
+#include "biometric_manager.h"
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTRUTURAS
+// ═══════════════════════════════════════════════════════════════════════
+
+enum ImportError : uint8_t {
+    IMPORT_ERR_UID = 0,
+    IMPORT_ERR_NAME,
+    IMPORT_ERR_JSON,
+    IMPORT_ERR_LONG,
+    IMPORT_ERR_SLOT,
+    IMPORT_ERR_FULL,
+    IMPORT_ERR_WRITE
+};
+
+static const char* const IMPORT_ERROR_TEXT[] = {
+    "UID inválido", "Nome inválido", "JSON inválido", "Linha muito longa",
+    "finger_slot sem digital cadastrada", "Memória cheia", "Falha ao gravar"
+};
+
+/**
+ * @brief Estado de um upload (em _tempObject: só POD, liberado com free())
+ */
+struct ImportSession {
+    uint32_t t0;
+    uint32_t line;                          // Linha em leitura (1 = primeira)
+    uint16_t lineLen;
+    bool overflow;                          // Linha passou de CRED_IMPORT_LINE_MAX
+    bool done;
+    char lineBuf[CRED_IMPORT_LINE_MAX + 1];
+
+    uint8_t pending;                        // Registros aguardando a transação
+    RFIDUpsert batch[CRED_IMPORT_BATCH];
+    uint32_t batchLine[CRED_IMPORT_BATCH];
+
+    uint32_t records;
+    uint32_t inserted;
+    uint32_t updated;
+    uint32_t unchanged;
+    uint32_t errors;
+    uint16_t commits;
+
+    uint8_t errorCount;
+    struct {
+        uint32_t line;
+        uint8_t code;                       // ImportError
+    } errorList[CRED_IMPORT_MAX_ERRORS];
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════
+
+static void addError(ImportSession* s, uint32_t line, ImportError code) {
+    s->errors++;
+    if (s->errorCount < CRED_IMPORT_MAX_ERRORS) {
+        s->errorList[s->errorCount].line = line;
+        s->errorList[s->errorCount].code = code;
+        s->errorCount++;
+    }
+}
+
+static char* trim(char* text) {
+    while (*text == ' ' || *text == '\t') text++;
+    char* end = text + strlen(text);
+    while (end > text && (end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+    return text;
+}
+
+/**
+ * @brief Aplica o lote pendente (uma transação no RFIDManager)
+ */
+static void commitBatch(ImportSession* s) {
+    if (s->pending == 0) return;
+
+    // ⭐ v6.1.20: Slot conferido no bitmap da biometria (leitura de uma palavra,
+    // sem BioLock): o corpo chega na tarefa async_tcp, que não pode esperar
+    // o loop terminar uma verificação/cadastro no AS608
+    uint8_t n = 0;
+    for (uint8_t k = 0; k < s->pending; k++) {
+        RFIDUpsert& r = s->batch[k];
+        if ((r.fields & RFID_FIELD_FINGER_SLOT) && r.finger_slot && !bioManager.isIDUsed(r.finger_slot)) {
+            addError(s, s->batchLine[k], IMPORT_ERR_SLOT);
+            continue;
+        }
+        s->batch[n] = r;
+        s->batchLine[n] = s->batchLine[k];
+        n++;
+    }
+
+    rfidManager.upsertCards(s->batch, n);
+    s->commits++;
+
+    for (uint8_t k = 0; k < n; k++) {
+        switch (s->batch[k].result) {
+            case RFID_UPSERT_INSERTED:  s->inserted++;  break;
+            case RFID_UPSERT_UPDATED:   s->updated++;   break;
+            case RFID_UPSERT_UNCHANGED: s->unchanged++; break;
+            case RFID_UPSERT_FAILED:    addError(s, s->batchLine[k], IMPORT_ERR_WRITE); break;
+            default:                    addError(s, s->batchLine[k], IMPORT_ERR_FULL); break;
+        }
+    }
+    s->pending = 0;
+}
+
+/**
+ * @brief uid + nome já extraídos da linha → registro do lote
+ */
+static void queueRecord(ImportSession* s, const char* uidText, const char* name, RFIDUpsert& r) {
+    r.uid_length = parseRFIDUid(uidText, r.uid);
+    if (r.uid_length == 0) {
+        addError(s, s->line, IMPORT_ERR_UID);
+        return;
+    }
+    size_t nameLen = strlen(name);
+    if (nameLen == 0 || nameLen >= RFID_NAME_LENGTH) {
+        addError(s, s->line, IMPORT_ERR_NAME);
+        return;
+    }
+    memcpy(r.name, name, nameLen + 1);
+
+    s->records++;
+    s->batch[s->pending] = r;
+    s->batchLine[s->pending] = s->line;
+    if (++s->pending == CRED_IMPORT_BATCH) commitBatch(s);
+}
+
+static void parseJsonLine(ImportSession* s) {
+    StaticJsonDocument<256> doc;
+    if (deserializeJson(doc, s->lineBuf, s->lineLen)) {
+        addError(s, s->line, IMPORT_ERR_JSON);
+        return;
+    }
+
+    RFIDUpsert r = {};
+    if (doc.containsKey("active")) {
+        r.active = doc["active"];
+        r.fields |= RFID_FIELD_ACTIVE;
+    }
+    if (doc.containsKey("finger_slot")) {
+        long slot = doc["finger_slot"] | -1L;
+        if (slot < 0 || slot > bioManager.getCapacity()) {
+            addError(s, s->line, IMPORT_ERR_SLOT);
+            return;
+        }
+        r.finger_slot = slot;
+        r.fields |= RFID_FIELD_FINGER_SLOT;
+    }
+    queueRecord(s, doc["uid"] | "", doc["name"] | "", r);
+}
+
+static void parseCsvLine(ImportSession* s) {
+    // Até 4 colunas, separadas no próprio buffer
+    char* cols[4] = {s->lineBuf, nullptr, nullptr, nullptr};
+    uint8_t ncols = 1;
+    for (char* p = s->lineBuf; *p && ncols < 4; p++) {
+        if (*p == ',' || *p == ';') {
+            *p = '\0';
+            cols[ncols++] = p + 1;
+        }
+    }
+    for (uint8_t i = 0; i < ncols; i++) cols[i] = trim(cols[i]);
+
+    if (strcasecmp(cols[0], "uid") == 0) return;     // Cabeçalho
+    if (ncols < 2) {
+        addError(s, s->line, IMPORT_ERR_NAME);
+        return;
+    }
+
+    RFIDUpsert r = {};
+    if (ncols > 2 && cols[2][0]) {
+        char c = tolower(cols[2][0]);
+        r.active = (c == '1' || c == 't' || c == 's' || c == 'y');
+        r.fields |= RFID_FIELD_ACTIVE;
+    }
+    if (ncols > 3 && cols[3][0]) {
+        char* end;
+        long slot = strtol(cols[3], &end, 10);
+        if (*end || slot < 0 || slot > bioManager.getCapacity()) {
+            addError(s, s->line, IMPORT_ERR_SLOT);
+            return;
+        }
+        r.finger_slot = slot;
+        r.fields |= RFID_FIELD_FINGER_SLOT;
+    }
+    queueRecord(s, cols[0], cols[1], r);
+}
+
+static void endLine(ImportSession* s) {
+    if (s->overflow) {
+        addError(s, s->line, IMPORT_ERR_LONG);
+    } else {
+        s->lineBuf[s->lineLen] = '\0';
+        char* text = trim(s->lineBuf);
+        if (*text == '{') {
+            parseJsonLine(s);
+        } else if (*text && *text != '#') {
+            parseCsvLine(s);
+        }
+    }
+    s->lineLen = 0;
+    s->overflow = false;
+    s->line++;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// HANDLERS
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Cada trecho do corpo é interpretado assim que chega (tarefa async_tcp)
+ */
+static void handleImportBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    ImportSession* s = (ImportSession*)request->_tempObject;
+
+    if (index == 0) {
+        // Sem sessão: handleImportRequest responde 401/403/413/503
+        if (total > CRED_IMPORT_MAX_BODY) return;
+        if (!request->hasHeader("X-API-Key") || request->getHeader("X-API-Key")->value() != API_KEY) return;
+        if (!rfidManager.isLoaded()) return;    // ⭐ v6.1.20: Lista ainda não lida (resposta 503)
+        s = (ImportSession*)calloc(1, sizeof(ImportSession));
+        if (!s) return;
+        s->t0 = millis();
+        s->line = 1;
+        request->_tempObject = s;
+    }
+    if (!s || s->done) return;
+
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (c == '\n') {
+            endLine(s);
+        } else if (c != '\r') {
+            if (s->lineLen < CRED_IMPORT_LINE_MAX) s->lineBuf[s->lineLen++] = c;
+            else s->overflow = true;
+        }
+    }
+
+    if (index + len >= total) {
+        if (s->lineLen || s->overflow) endLine(s);   // Última linha sem '\n'
+        commitBatch(s);
+        s->done = true;
+    }
+}
+
+static void handleImportRequest(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+
+    ImportSession* s = (ImportSession*)request->_tempObject;
+    if (request->contentLength() > CRED_IMPORT_MAX_BODY) {
+        sendRFIDError(request, "Arquivo muito grande", 413);
+        return;
+    }
+    if (!rfidManager.isLoaded()) {
+        sendRFIDError(request, "Lista de cartões carregando", 503);
+        return;
+    }
+    if (!s) {
+        sendRFIDError(request, request->contentLength() ? "Sem memória para o upload" : "Corpo vazio",
+                      request->contentLength() ? 503 : 400);
+        return;
+    }
+
+    uint32_t ms = millis() - s->t0;
+    Serial.printf("📥 [API] Importação: %lu registros (+%lu novos, %lu atualizados, %lu iguais), %lu erros, %u lotes, %lu ms\n",
+                  (unsigned long)s->records, (unsigned long)s->inserted, (unsigned long)s->updated,
+                  (unsigned long)s->unchanged, (unsigned long)s->errors, s->commits, (unsigned long)ms);
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    response->printf("{\"success\":%s,\"lines\":%lu,\"records\":%lu,\"inserted\":%lu,\"updated\":%lu,"
+                     "\"unchanged\":%lu,\"errors\":%lu,\"commits\":%u,\"ms\":%lu,\"error_lines\":[",
+                     s->errors ? "false" : "true", (unsigned long)(s->line - 1), (unsigned long)s->records,
+                     (unsigned long)s->inserted, (unsigned long)s->updated, (unsigned long)s->unchanged,
+                     (unsigned long)s->errors, s->commits, (unsigned long)ms);
+    for (uint8_t i = 0; i < s->errorCount; i++) {
+        response->printf("%s{\"line\":%lu,\"error\":\"%s\"}", i ? "," : "",
+                         (unsigned long)s->errorList[i].line, IMPORT_ERROR_TEXT[s->errorList[i].code]);
+    }
+    response->print("]}");
+    request->send(response);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONFIGURAÇÃO DO ENDPOINT
+// ═══════════════════════════════════════════════════════════════════════
+
+void setupCredentialImport(AsyncWebServer& server) {
+    server.on("/api/cards/import", HTTP_OPTIONS, handleCORS);
+    server.on("/api/cards/import", HTTP_POST, handleImportRequest, nullptr, handleImportBody);
+
+    Serial.println("[API] Rota de importação configurada:");
+    Serial.println("  POST   /api/cards/import (CSV/NDJSON)");
+}
@@ -0,0 +1,166 @@
+/**
+ * @file email_template.cpp
+ * @brief Implementação do renderizador de templates HTML de e-mail
+ * @version 1.0.0
+ * @date 2025-12-05
+ */
+
+#include <esp_heap_caps.h>
+#include "email_template.h"
+
+// ════════════════════════════════════════════════════════════════
+// TEMPLATES (FLASH)
+// ════════════════════════════════════════════════════════════════
+
+static const char EMAIL_TPL_MANUTENCAO[] PROGMEM =
+    "<!DOCTYPE html><html><head><meta charset='UTF-8'><style>"
+    "body{font-family:Arial,sans-serif;background:#f3f4f6;margin:0;padding:20px;}"
+    ".container{max-width:600px;margin:0 auto;background:white;border-radius:8px;overflow:hidden;box-shadow:0 4px 6px rgba(0,0,0,0.1);}"
+    ".header{background:#1a1a2e;color:#FBBF24;padding:25px;text-align:center;}"
+    ".header h2{margin:0;font-size:24px;}"
+    ".header p{margin:5px 0 0 0;opacity:0.8;font-size:14px;}"
+    ".content{padding:25px;}"
+    ".field{margin:18px 0;border-left:4px solid #E5E7EB;padding-left:15px;}"
+    ".field-label{font-weight:bold;color:#6B7280;font-size:11px;text-transform:uppercase;margin-bottom:6px;}"
+    ".field-value{color:#1F2937;font-size:15px;background:#F9FAFB;padding:12px;border-radius:6px;}"
+    ".priority-badge{display:inline-block;padding:10px 18px;border-radius:6px;color:white;font-weight:bold;}"
+    ".footer{text-align:center;padding:20px;color:#9CA3AF;font-size:12px;border-top:1px solid #E5E7EB;}"
+    "</style></head><body><div class='container'>"
+    "<div class='header'><h2>🔧 REQUISIÇÃO DE MANUTENÇÃO</h2><p>Requisição #{{ID}}</p></div>"
+    "<div class='content'>"
+    "<div class='field' style='border-left-color:{{COR}};'><div class='field-label'>PRIORIDADE</div>"
+    "<span class='priority-badge' style='background:{{COR}};'>{{PRIORIDADE}}</span></div>"
+    "<div class='field'><div class='field-label'>LOCAL</div><div class='field-value'>{{LOCAL}}</div></div>"
+    "<div class='field'><div class='field-label'>PROBLEMA / DEFEITO RELATADO</div><div class='field-value'>{{PROBLEMA}}</div></div>"
+    "{{CONTATO}}"
+    "<div class='field'><div class='field-label'>DATA E HORA</div><div class='field-value'>📅 {{DATAHORA}}</div></div>"
+    "<div class='field'><div class='field-label'>INFORMAÇÕES DO SISTEMA</div><div class='field-value'>"
+    "🌐 <strong>IP:</strong> {{IP}}<br>"
+    "🔌 <strong>MAC:</strong> {{MAC}}<br>"
+    "💾 <strong>Firmware:</strong> v{{FW}}"
+    "</div></div>"
+    "</div>"
+    "<div class='footer'><strong>Sistema de Controle de Acesso ESP32-S3</strong><br>"
+    "Este é um e-mail automático.<br>Em caso de dúvidas, contate a equipe de TI.</div>"
+    "</div></body></html>";
+
+// Bloco opcional (só entra se o contato foi preenchido)
+static const char EMAIL_TPL_CONTATO[] PROGMEM =
+    "<div class='field'><div class='field-label'>CONTATO</div><div class='field-value'>{{CONTATO}}</div></div>";
+
+// ════════════════════════════════════════════════════════════════
+// RENDERIZADOR
+// ════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Escritor que apenas conta quando não há buffer
+ */
+struct TemplateWriter {
+    char* out;
+    size_t cap;
+    size_t len;
+
+    inline void put(char c) {
+        if (out && len + 1 < cap) out[len] = c;
+        len++;
+    }
+
+    inline void putStr(const char* s, bool escape) {
+        for (; *s; s++) {
+            if (!escape) { put(*s); continue; }
+            switch (*s) {
+                case '&':  putRaw("&amp;");  break;
+                case '<':  putRaw("&lt;");   break;
+                case '>':  putRaw("&gt;");   break;
+                case '"':  putRaw("&quot;"); break;
+                case '\'': putRaw("&#39;");  break;
+                default:   put(*s);          break;
+            }
+        }
+    }
+
+    inline void putRaw(const char* s) {
+        while (*s) put(*s++);
+    }
+};
+
+size_t email_template_render(const char* tpl, const EmailTemplateField* fields, size_t fieldCount,
+                             char* out, size_t cap) {
+    TemplateWriter w = { out, cap, 0 };
+
+    const char* p = tpl;
+    while (*p) {
+        // Marcador {{CHAVE}}
+        if (p[0] == '{' && p[1] == '{') {
+            const char* keyStart = p + 2;
+            const char* keyEnd = strstr(keyStart, "}}");
+            if (keyEnd) {
+                size_t keyLen = keyEnd - keyStart;
+                for (size_t i = 0; i < fieldCount; i++) {
+                    if (strlen(fields[i].key) == keyLen &&
+                        strncmp(fields[i].key, keyStart, keyLen) == 0) {
+                        w.putStr(fields[i].value ? fields[i].value : "", fields[i].escape);
+                        break;
+                    }
+                }
+                p = keyEnd + 2;
+                continue;
+            }
+        }
+        w.put(*p++);
+    }
+
+    if (out && cap > 0) out[w.len < cap ? w.len : cap - 1] = '\0';
+    return w.len;
+}
+
+// ════════════════════════════════════════════════════════════════
+// E-MAIL DE MANUTENÇÃO
+// ════════════════════════════════════════════════════════════════
+
+char* email_render_manutencao(const MaintenanceRequest* req, size_t* outLen) {
+    char idStr[12];
+    char fwStr[6];
+    snprintf(idStr, sizeof(idStr), "%u", req->id);
+    snprintf(fwStr, sizeof(fwStr), "%u", req->versao_firmware);
+
+    // Bloco de contato: contato[51] escapado cabe folgado em 512 bytes
+    char contatoBloco[512];
+    contatoBloco[0] = '\0';
+    if (strlen(req->contato) > 0) {
+        EmailTemplateField f = { "CONTATO", req->contato, true };
+        email_template_render(EMAIL_TPL_CONTATO, &f, 1, contatoBloco, sizeof(contatoBloco));
+    }
+
+    const char* cor = prioridadeToColor(req->prioridade);
+    const EmailTemplateField fields[] = {
+        { "ID",         idStr,                               false },
+        { "COR",        cor,                                 false },
+        { "PRIORIDADE", prioridadeToString(req->prioridade), false },
+        { "LOCAL",      req->local_nome,                     true  },
+        { "PROBLEMA",   req->problema,                       true  },
+        { "CONTATO",    contatoBloco,                        false },
+        { "DATAHORA",   req->datetime,                       true  },
+        { "IP",         req->ip_origem,                      true  },
+        { "MAC",        req->mac_address,                    true  },
+        { "FW",         fwStr,                               false },
+    };
+    const size_t n = sizeof(fields) / sizeof(fields[0]);
+
+    // 1ª passagem: medir
+    size_t len = email_template_render(EMAIL_TPL_MANUTENCAO, fields, n, nullptr, 0);
+
+    // Buffer único com tamanho exato; PSRAM preserva o heap interno para o TLS
+    char* buf = (char*)heap_caps_malloc(len + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buf) buf = (char*)malloc(len + 1);
+    if (!buf) {
+        Serial.printf("❌ [Email] Sem memória para corpo HTML (%u bytes)\n", len + 1);
+        return nullptr;
+    }
+
+    // 2ª passagem: gravar
+    email_template_render(EMAIL_TPL_MANUTENCAO, fields, n, buf, len + 1);
+
+    if (outLen) *outLen = len;
+    return buf;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file idle_manager.cpp
+ * @brief Implementação do gerenciador de ociosidade
+ * @version 1.0.0
+ * @date 2025-12-06
+ */
+
+#include "idle_manager.h"
+
+IdleManager idleManager;
+
+static const char* wakeSourceName(IdleWakeSource source) {
+    switch (source) {
+        case IDLE_WAKE_TOUCH:  return "toque";
+        case IDLE_WAKE_CARD:   return "cartão";
+        case IDLE_WAKE_FINGER: return "digital";
+        default:               return "outro";
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONSTRUTOR
+// ═══════════════════════════════════════════════════════════════════════
+
+IdleManager::IdleManager()
+    : state(IDLE_ACTIVE),
+      disp(NULL),
+      indev(NULL),
+      setBrightness(NULL),
+      touchIrq(NULL),
+      lastActivity(0),
+      swallowing(false),
+      wakePending(false),
+      wakeStartUs(0),
+      lastWakeUs(0),
+      maxWakeUs(0),
+      wakeCount(0) {
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// INICIALIZAÇÃO
+// ═══════════════════════════════════════════════════════════════════════
+
+void IdleManager::begin(lv_disp_t* d, lv_indev_t* i, BrightnessFn brightness, TouchIrqFn irq) {
+    disp = d;
+    indev = i;
+    setBrightness = brightness;
+    touchIrq = irq;
+    lastActivity = millis();
+    state = IDLE_ACTIVE;
+
+    Serial.printf("✅ [IdleManager] Esmaecer em %lus, apagar em %lus\n",
+                  (unsigned long)(IDLE_DIM_TIMEOUT_MS / 1000),
+                  (unsigned long)(IDLE_OFF_TIMEOUT_MS / 1000));
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// ATIVIDADE / ESTADO
+// ═══════════════════════════════════════════════════════════════════════
+
+void IdleManager::activity(IdleWakeSource source) {
+    lastActivity = millis();
+
+    if (state == IDLE_ACTIVE) return;
+
+    Serial.printf("☀️  [IdleManager] Acordando (%s)\n", wakeSourceName(source));
+
+    if (state == IDLE_OFF) {
+        // Medir até o primeiro frame completo após retomar o refresh
+        wakePending = true;
+        wakeStartUs = micros();
+        // O toque que acordou não deve virar clique
+        swallowing = (source == IDLE_WAKE_TOUCH);
+    }
+    enterState(IDLE_ACTIVE);
+}
+
+void IdleManager::update() {
+    if (disp == NULL) return;
+
+    if (state == IDLE_OFF) {
+        // Touch pausado no LVGL: só o flag da IRQ (sem transação SPI)
+        if (touchIrq && touchIrq()) {
+            activity(IDLE_WAKE_TOUCH);
+        }
+        return;
+    }
+
+    uint32_t idle = millis() - lastActivity;
+    if (state == IDLE_ACTIVE && idle > IDLE_DIM_TIMEOUT_MS) {
+        enterState(IDLE_DIMMED);
+    } else if (state == IDLE_DIMMED && idle > IDLE_OFF_TIMEOUT_MS) {
+        enterState(IDLE_OFF);
+    }
+}
+
+void IdleManager::enterState(IdleState newState) {
+    switch (newState) {
+        case IDLE_ACTIVE:
+            if (state == IDLE_OFF) {
+                if (disp->refr_timer) lv_timer_resume(disp->refr_timer);
+                if (indev && indev->driver->read_timer) lv_timer_resume(indev->driver->read_timer);
+                // GRAM do painel está intacta; redesenho completo garante
+                // que o conteúdo reflita o que mudou enquanto pausado
+                lv_obj_invalidate(lv_scr_act());
+            }
+            if (setBrightness) setBrightness(IDLE_BRIGHTNESS_ACTIVE);
+            break;
+
+        case IDLE_DIMMED:
+            Serial.println("🌙 [IdleManager] Sem atividade - esmaecendo");
+            if (setBrightness) setBrightness(IDLE_BRIGHTNESS_DIM);
+            break;
+
+        case IDLE_OFF:
+            Serial.println("💤 [IdleManager] Sem atividade - tela apagada, LVGL pausado");
+            if (setBrightness) setBrightness(0);
+            if (disp->refr_timer) lv_timer_pause(disp->refr_timer);
+            if (indev && indev->driver->read_timer) lv_timer_pause(indev->driver->read_timer);
+            break;
+    }
+    state = newState;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// TOUCH / FRAME
+// ═══════════════════════════════════════════════════════════════════════
+
+bool IdleManager::swallowTouch(bool pressed) {
+    if (!swallowing) return false;
+    if (!pressed) swallowing = false;
+    return true;
+}
+
+void IdleManager::onFrameFlushed() {
+    if (!wakePending) return;
+    wakePending = false;
+
+    lastWakeUs = micros() - wakeStartUs;
+    if (lastWakeUs > maxWakeUs) maxWakeUs = lastWakeUs;
+    wakeCount++;
+
+    Serial.printf("⏱️  [IdleManager] Acordar → 1º frame: %lu us (máx %lu us)\n",
+                  (unsigned long)lastWakeUs, (unsigned long)maxWakeUs);
+}
+
+void IdleManager::printStatus() {
+    static const char* nomes[] = { "ATIVO", "ESMAECIDO", "DESLIGADO" };
+
+    Serial.println("\n💡 ═══════════════════════════════════════");
+    Serial.println("   GERENCIADOR DE OCIOSIDADE");
+    Serial.println("═══════════════════════════════════════");
+    Serial.printf("Estado       : %s\n", nomes[state]);
+    Serial.printf("Ocioso há    : %lu s\n", (unsigned long)((millis() - lastActivity) / 1000));
+    Serial.printf("Despertares  : %lu\n", (unsigned long)wakeCount);
+    Serial.printf("Latência     : última %lu us | máx %lu us\n",
+                  (unsigned long)lastWakeUs, (unsigned long)maxWakeUs);
+    Serial.println("═══════════════════════════════════════\n");
+}
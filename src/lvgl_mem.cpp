@@ -0,0 +1,235 @@
+/**
+ * @file lvgl_mem.cpp
+ * @brief Implementação do alocador PSRAM/RAM interna do LVGL
+ * @version 1.0.0
+ * @date 2025-12-06
+ */
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <multi_heap.h>
+#include "lvgl_mem.h"
+
+// ════════════════════════════════════════════════════════════════
+// ESTADO
+// ════════════════════════════════════════════════════════════════
+
+static multi_heap_handle_t pool = NULL;
+static uint8_t* pool_base = NULL;
+static uint32_t pool_capacity = 0;      // Livre logo após o registro (desconta overhead)
+static bool pool_tried = false;
+
+static uint32_t internal_used = 0;
+static uint32_t internal_peak = 0;
+static uint32_t alloc_count = 0;
+static uint32_t failed_count = 0;
+
+static int current_tag = -1;
+static uint32_t tag_peak[LVGL_MEM_MAX_TAGS] = {0};
+
+// ════════════════════════════════════════════════════════════════
+// AUXILIARES
+// ════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Cria o pool na primeira alocação (lv_init() já aloca)
+ */
+static void pool_init() {
+    pool_tried = true;
+
+    pool_base = (uint8_t*)heap_caps_malloc(LVGL_MEM_POOL_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!pool_base) {
+        Serial.println("⚠️ [LVGL Mem] PSRAM indisponível - usando heap padrão");
+        return;
+    }
+
+    pool = multi_heap_register(pool_base, LVGL_MEM_POOL_SIZE);
+    if (!pool) {
+        Serial.println("❌ [LVGL Mem] Falha ao registrar pool TLSF");
+        heap_caps_free(pool_base);
+        pool_base = NULL;
+        return;
+    }
+
+    pool_capacity = multi_heap_free_size(pool);
+    Serial.printf("✅ [LVGL Mem] Pool PSRAM: %u KB (%u bytes úteis), interna até %u bytes\n",
+                  LVGL_MEM_POOL_SIZE / 1024, (unsigned)pool_capacity, LVGL_MEM_INTERNAL_MAX);
+}
+
+static inline bool in_pool(const void* ptr) {
+    return pool_base != NULL &&
+           (const uint8_t*)ptr >= pool_base &&
+           (const uint8_t*)ptr < pool_base + LVGL_MEM_POOL_SIZE;
+}
+
+static inline uint32_t pool_used_now() {
+    return pool ? pool_capacity - multi_heap_free_size(pool) : 0;
+}
+
+/**
+ * @brief Atualiza picos após uma alocação
+ */
+static void track_peak() {
+    if (internal_used > internal_peak) internal_peak = internal_used;
+
+    if (current_tag >= 0) {
+        uint32_t total = pool_used_now() + internal_used;
+        if (total > tag_peak[current_tag]) tag_peak[current_tag] = total;
+    }
+}
+
+static void* internal_alloc(size_t size) {
+    void* p = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (p) internal_used += heap_caps_get_allocated_size(p);
+    return p;
+}
+
+static void* pool_alloc(size_t size) {
+    if (!pool) {
+        // Sem PSRAM: heap padrão, contabilizado como interno
+        void* p = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+        if (p) internal_used += heap_caps_get_allocated_size(p);
+        return p;
+    }
+    return multi_heap_malloc(pool, size);
+}
+
+// ════════════════════════════════════════════════════════════════
+// ALOCADOR
+// ════════════════════════════════════════════════════════════════
+
+void* lvgl_mem_alloc(size_t size) {
+    if (!pool_tried) pool_init();
+    if (size == 0) return NULL;
+
+    void* p = NULL;
+    if (size <= LVGL_MEM_INTERNAL_MAX) {
+        p = internal_alloc(size);
+        if (!p) p = pool_alloc(size);       // RAM interna cheia → PSRAM
+    } else {
+        p = pool_alloc(size);
+        if (!p) p = internal_alloc(size);   // Pool cheio → último recurso
+    }
+
+    if (!p) {
+        failed_count++;
+        Serial.printf("❌ [LVGL Mem] Falha ao alocar %u bytes\n", (unsigned)size);
+        return NULL;
+    }
+
+    alloc_count++;
+    track_peak();
+    return p;
+}
+
+void lvgl_mem_free(void* ptr) {
+    if (ptr == NULL) return;
+
+    if (in_pool(ptr)) {
+        multi_heap_free(pool, ptr);
+    } else {
+        internal_used -= heap_caps_get_allocated_size(ptr);
+        heap_caps_free(ptr);
+    }
+    alloc_count--;
+}
+
+void* lvgl_mem_realloc(void* ptr, size_t size) {
+    if (ptr == NULL) return lvgl_mem_alloc(size);
+    if (size == 0) {
+        lvgl_mem_free(ptr);
+        return NULL;
+    }
+
+    // Mesma região: realloc nativo (pode crescer no lugar)
+    if (in_pool(ptr) && size > LVGL_MEM_INTERNAL_MAX) {
+        void* p = multi_heap_realloc(pool, ptr, size);
+        if (p) {
+            track_peak();
+            return p;
+        }
+    } else if (!in_pool(ptr) && size <= LVGL_MEM_INTERNAL_MAX) {
+        size_t old_size = heap_caps_get_allocated_size(ptr);
+        void* p = heap_caps_realloc(ptr, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (p) {
+            internal_used = internal_used - old_size + heap_caps_get_allocated_size(p);
+            track_peak();
+            return p;
+        }
+    }
+
+    // Troca de região (ou realloc falhou): alocar, copiar, liberar
+    size_t old_size = in_pool(ptr) ? multi_heap_get_allocated_size(pool, ptr)
+                                   : heap_caps_get_allocated_size(ptr);
+    void* p = lvgl_mem_alloc(size);
+    if (!p) return NULL;
+    memcpy(p, ptr, old_size < size ? old_size : size);
+    lvgl_mem_free(ptr);
+    return p;
+}
+
+// ════════════════════════════════════════════════════════════════
+// ESTATÍSTICAS
+// ════════════════════════════════════════════════════════════════
+
+void lvgl_mem_get_stats(LvglMemStats* out) {
+    if (out == NULL) return;
+    memset(out, 0, sizeof(*out));
+
+    if (pool) {
+        multi_heap_info_t info;
+        multi_heap_get_info(pool, &info);
+
+        out->pool_total = pool_capacity;
+        out->pool_free = info.total_free_bytes;
+        out->pool_used = pool_capacity - info.total_free_bytes;
+        out->pool_largest_free = info.largest_free_block;
+        out->pool_peak = pool_capacity - info.minimum_free_bytes;
+        out->used_pct = (uint8_t)((uint64_t)out->pool_used * 100 / pool_capacity);
+        out->frag_pct = info.total_free_bytes == 0 ? 0 :
+            (uint8_t)(100 - (uint64_t)info.largest_free_block * 100 / info.total_free_bytes);
+    }
+
+    out->internal_used = internal_used;
+    out->internal_peak = internal_peak;
+    out->alloc_count = alloc_count;
+    out->failed_count = failed_count;
+}
+
+void lvgl_mem_set_tag(int tag) {
+    current_tag = (tag >= 0 && tag < LVGL_MEM_MAX_TAGS) ? tag : -1;
+    track_peak();
+}
+
+uint32_t lvgl_mem_tag_peak(int tag) {
+    if (tag < 0 || tag >= LVGL_MEM_MAX_TAGS) return 0;
+    return tag_peak[tag];
+}
+
+void lvgl_mem_print_stats(const char* const* tag_names, int tag_count) {
+    LvglMemStats s;
+    lvgl_mem_get_stats(&s);
+
+    Serial.println("\n🧠 ═══════════════════════════════════════");
+    Serial.println("   MEMÓRIA LVGL");
+    Serial.println("═══════════════════════════════════════");
+    if (s.pool_total > 0) {
+        Serial.printf("PSRAM pool : %u / %u bytes (%u%%) | pico %u\n",
+                      s.pool_used, s.pool_total, s.used_pct, s.pool_peak);
+        Serial.printf("Fragment.  : %u%% (maior bloco livre %u bytes)\n",
+                      s.frag_pct, s.pool_largest_free);
+    } else {
+        Serial.println("PSRAM pool : indisponível");
+    }
+    Serial.printf("RAM interna: %u bytes | pico %u\n", s.internal_used, s.internal_peak);
+    Serial.printf("Blocos     : %u vivos | %u falhas\n", s.alloc_count, s.failed_count);
+
+    Serial.println("Pico por tela (pool + interna):");
+    for (int i = 0; i < LVGL_MEM_MAX_TAGS; i++) {
+        if (tag_peak[i] == 0) continue;
+        const char* nome = (tag_names != NULL && i < tag_count) ? tag_names[i] : "?";
+        Serial.printf("  [%2d] %-12s %u bytes%s\n", i, nome, tag_peak[i],
+                      i == current_tag ? "  ◀ atual" : "");
+    }
+    Serial.println("═══════════════════════════════════════\n");
+}
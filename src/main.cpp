@@ -4,6 +4,7 @@
 #include <XPT2046_Touchscreen.h>
 #include <SPI.h>
 #include "esp_task_wdt.h"
+#include "esp_heap_caps.h"
 #include "config.h"
 #include "calibration.h"  // ⭐ Sistema de calibração
 #include "admin_auth.h"   // ⭐ Sistema de autenticação admin
@@ -24,6 +25,17 @@
 #include "relay_controller.h"   // ⭐ Controlador de relé
 #include "virtual_keyboard.h"   // ⭐ v6.0.9: Teclado Virtual Unificado (lv_keyboard)
 #include "biometric_storage.h"  // ⭐ v6.0.22: Storage biométrico (lib/BiometricStorage)
+#include "maintenance_store.h"  // ⭐ v6.1.0: Requisições de manutenção indexadas (LittleFS)
+#include "lvgl_mem.h"           // ⭐ v6.1.5: Heap LVGL em PSRAM + estatísticas por tela
+#include "render_profiler.h"    // ⭐ v6.1.6: Profiler de renderização + overlay de FPS
+#include "idle_manager.h"       // ⭐ v6.1.7: Backlight/LVGL suspensos quando ocioso
+#include "spi_arbiter.h"        // ⭐ v6.1.8: Árbitro do SPI2 (display, touch, PN532)
+#include "boot_profiler.h"      // ⭐ v6.1.10: Boot paralelo + tempo até porta pronta
+#include "template_archive.h"   // ⭐ v6.1.13: Backup/restauração de templates do AS608
+#include "bio_batch.h"          // ⭐ v6.1.18: Cadastro biométrico em lote (lista CSV)
+#include "credential_api.h"     // ⭐ v6.1.19: API paginada de credenciais
+#include <freertos/event_groups.h>
+#include <freertos/queue.h>
 
 // ⭐ DECLARAÇÕES FORWARD: Funções de manutenção (implementadas em maintenance_functions.cpp)
 void evento_foco_campo_manut(lv_event_t * e);
@@ -33,7 +45,7 @@ void mostrar_status_manutencao(const char* mensagem, uint32_t cor);
 void evento_cancelar_requisicao(lv_event_t * e);
 void evento_enviar_requisicao(lv_event_t * e);
 bool salvar_requisicao_nvs(const MaintenanceRequest* req);
-String montar_corpo_email_html(const MaintenanceRequest* req);
+char* montar_corpo_email_html(const MaintenanceRequest* req, size_t* len);
 bool enviar_email_smtp(const MaintenanceRequest* req);
 
 // ⭐ NOVO: Biblioteca PN532 NFC/RFID
@@ -96,7 +108,13 @@ enum Screen {
     SCREEN_CONTROLS,     // Ajuda/Controles
     SCREEN_SETTINGS,     // Configurações
     SCREEN_CALIBRATION,  // ⭐ Calibração Touch
-    SCREEN_ADMIN_AUTH    // ⭐ NOVA TELA: Autenticação Admin
+    SCREEN_ADMIN_AUTH,   // ⭐ NOVA TELA: Autenticação Admin
+    SCREEN_COUNT         // ⭐ v6.1.3: Quantidade de telas (cache)
+};
+
+// ⭐ v6.1.5: Nomes para os relatórios de memória por tela
+static const char* const screen_names[SCREEN_COUNT] = {
+    "HOME", "BIOMETRIA", "RFID", "MANUTENCAO", "AJUDA", "CONFIG", "CALIBRACAO", "ADMIN_AUTH"
 };
 
 enum MaintenanceSubScreen {
@@ -171,12 +189,20 @@ enum AuthMode {
     AUTH_AUTO_BIO,  // Biometria automática (padrão na HOME)
     AUTH_PIN,       // Aguardando PIN
     AUTH_BIO_MANUAL,// Aguardando biometria após clicar botão BIO
-    AUTH_RFID       // Aguardando RFID após clicar botão RFID
+    AUTH_RFID,      // Aguardando RFID após clicar botão RFID
+    AUTH_CARD_FINGER // ⭐ v6.1.17: Cartão lido, aguardando a digital do titular (1:1)
 };
 static AuthMode currentAuthMode = AUTH_AUTO_BIO;
+static uint8_t cardFingerUid[RFID_UID_LENGTH]; // ⭐ v6.1.17: Cartão aguardando a digital (AUTH_CARD_FINGER)
+static uint8_t cardFingerUidLen = 0;           // ⭐ v6.1.19: UID, não índice (a API pode remover cartões)
 static uint32_t authModeStartTime = 0;
 static const uint32_t AUTH_TIMEOUT = 10000; // 10 segundos timeout
 
+// ⭐ v6.1.19: Intervalo entre loops (API STATS - impacto dos clientes HTTP)
+static uint32_t loopStatMaxUs = 0;
+static uint64_t loopStatSumUs = 0;
+static uint32_t loopStatCount = 0;
+
 // Touch
 bool touch_conectado = false;
 unsigned long ultimo_aviso = 0;
@@ -223,6 +249,7 @@ lv_obj_t * pin_display_label = NULL;
 lv_obj_t * bio_display_label = NULL;  // ⭐ Compatibilidade (aponta para auth_display_label)
 lv_obj_t * rfid_display_label = NULL; // ⭐ Compatibilidade (aponta para auth_display_label)
 lv_obj_t * content_container = NULL;
+lv_obj_t * screen_cache[SCREEN_COUNT] = {NULL};  // ⭐ v6.1.3: Containers de telas persistentes
 lv_obj_t * nav_buttons[6] = {NULL};
 lv_obj_t * calibration_label = NULL;  // ⭐ Label para mostrar coordenadas do touch
 
@@ -271,7 +298,7 @@ public:
             auto cfg = _bus_instance.config();
             cfg.spi_host = SPI2_HOST;
             cfg.spi_mode = 0;
-            cfg.freq_write = 27000000;  // 27MHz (validado)
+            cfg.freq_write = SPI_ARB_DISPLAY_HZ;  // 27MHz (validado) - tabela do árbitro
             cfg.freq_read  = 16000000;
             cfg.spi_3wire  = false;
             cfg.use_lock   = true;
@@ -348,33 +375,289 @@ static lv_indev_drv_t indev_drv;
 lv_indev_t * indev_touchpad;
 
 // Buffers LVGL
+// ⭐ v6.1.1: Dois buffers DMA (alocados no setup) - LVGL desenha a próxima
+//           faixa enquanto a anterior ainda está sendo enviada pelo SPI
+// ⭐ v6.1.20: O envio roda na tarefa lv_flush (core FLUSH_TASK_CORE), que só
+//           chama lv_disp_flush_ready() quando o DMA da faixa terminou
 static lv_disp_draw_buf_t draw_buf;
-static lv_color_t buf1[screenWidth * 20];  // 20 linhas (validado)
+static lv_color_t *buf1 = NULL;
+static lv_color_t *buf2 = NULL;
+
+/**
+ * @brief Faixa entregue à tarefa lv_flush
+ */
+struct FlushJob {
+    lv_disp_drv_t *disp;
+    lv_area_t area;
+    lv_color_t *pixels;
+    bool last;                  // Última faixa do frame: libera o barramento
+};
+static QueueHandle_t flush_queue = NULL;   // NULL = envio síncrono no próprio flush_cb
+
+// ⭐ v6.1.2: Bytes enviados ao painel (comparação parcial x full-frame)
+// ILI9488 em SPI só aceita 18 bpp: a LovyanGFX converte cada pixel RGB565
+// do LVGL para RGB666 (3 bytes no barramento) a cada flush
+#define PANEL_BYTES_PER_PIXEL 3
+static uint32_t flush_bytes_frame = 0;  // Acumulado no frame em andamento
+static uint32_t flush_bytes_last  = 0;  // Último frame completo
 
 // ========================================
 // CALLBACKS LVGL
 // ========================================
 
+/**
+ * @brief Envia uma faixa ao painel (transação aberta da 1ª à última faixa do frame)
+ * ⭐ v6.1.1: Transação SPI fica aberta durante as faixas de um mesmo frame
+ * ⭐ v6.1.8: Barramento reservado ao display do 1º ao último flush do frame
+ * Não é envio direto do buffer: a LovyanGFX converte RGB565 → RGB666 (CPU)
+ * no seu buffer de DMA. Só uma tarefa chama esta função (lv_flush ou, sem
+ * ela, o flush_cb), por isso a transação é acompanhada em 'in_frame' e não
+ * em tft.getStartCount() (o reparo do display também abre transações).
+ */
+static void flush_send(const lv_area_t *area, lv_color_t *pixels, bool last) {
+    static bool in_frame = false;
+    uint32_t w = (area->x2 - area->x1 + 1);
+    uint32_t h = (area->y2 - area->y1 + 1);
+    
+    if (!in_frame) {
+        spiArbiter.acquire(SPI_DEV_DISPLAY, SPI_ARB_WAIT_FOREVER);
+        tft.startWrite();
+        in_frame = true;
+    }
+    tft.pushImageDMA(area->x1, area->y1, w, h, (lgfx::swap565_t *)&pixels->full);
+    tft.waitDMA();              // Faixa no painel: o buffer volta para o LVGL
+    
+    if (last) {
+        tft.endWrite();
+        spiArbiter.release(SPI_DEV_DISPLAY);
+        in_frame = false;
+    }
+}
+
+/**
+ * @brief ⭐ v6.1.20: Tarefa de envio - conversão + DMA de uma faixa enquanto
+ * o LVGL (loop, core 1) desenha a seguinte no outro buffer
+ */
+static void flush_task(void *arg) {
+    FlushJob job;
+    for (;;) {
+        if (xQueueReceive(flush_queue, &job, portMAX_DELAY) != pdTRUE) continue;
+        flush_send(&job.area, job.pixels, job.last);
+        lv_disp_flush_ready(job.disp);  // Só aqui o LVGL pode reusar o buffer
+    }
+}
+
 void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
     uint32_t w = (area->x2 - area->x1 + 1);
     uint32_t h = (area->y2 - area->y1 + 1);
+    bool last = lv_disp_flush_is_last(disp);
     
     esp_task_wdt_reset();
+    uint32_t t0 = micros();
     
+    flush_bytes_frame += w * h * PANEL_BYTES_PER_PIXEL;
+    if (last) {
+        flush_bytes_last = flush_bytes_frame;
+        flush_bytes_frame = 0;
+        idleManager.onFrameFlushed();  // ⭐ v6.1.7: Latência acordar → 1º frame
+    }
+    
+    if (flush_queue) {
+        // Fila livre sempre que o LVGL chama o flush (2 buffers = 1 faixa em envio)
+        FlushJob job = { disp, *area, color_p, last };
+        xQueueSend(flush_queue, &job, portMAX_DELAY);
+        render_prof_add_flush(micros() - t0, w * h);  // ⭐ v6.1.6: Tempo em que o LVGL ficou parado
+        return;
+    }
+    
+    // Buffer único (ou sem tarefa): envio e DMA concluídos antes de devolver o buffer
+    flush_send(area, color_p, true);
+    render_prof_add_flush(micros() - t0, w * h);  // ⭐ v6.1.6
+    lv_disp_flush_ready(disp);
+}
+
+#if LVGL_FULL_FRAME
+/**
+ * @brief Flush em modo full-frame (direct_mode)
+ * ⭐ v6.1.2: O LVGL desenha direto no framebuffer da PSRAM nas coordenadas
+ * absolutas. Só na última área do frame enviamos ao painel, e apenas os
+ * retângulos invalidados (já unidos pelo LVGL), linha a linha do framebuffer.
+ */
+void my_disp_flush_direct(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
+    if (!lv_disp_flush_is_last(disp)) {
+        lv_disp_flush_ready(disp);
+        return;
+    }
+    
+    esp_task_wdt_reset();
+    
+    lv_disp_t *d = _lv_refr_get_disp_refreshing();
+    uint32_t bytes = 0;
+    uint32_t t0 = micros();
+    
+    spiArbiter.acquire(SPI_DEV_DISPLAY, SPI_ARB_WAIT_FOREVER);  // ⭐ v6.1.8
     tft.startWrite();
-    tft.setAddrWindow(area->x1, area->y1, w, h);
-    tft.pushPixels((uint16_t *)&color_p->full, w * h, true);
+    for (uint16_t i = 0; i < d->inv_p; i++) {
+        if (d->inv_area_joined[i]) continue;
+        
+        const lv_area_t *a = &d->inv_areas[i];
+        int32_t w = a->x2 - a->x1 + 1;
+        int32_t h = a->y2 - a->y1 + 1;
+        
+        tft.setAddrWindow(a->x1, a->y1, w, h);
+        for (int32_t y = a->y1; y <= a->y2; y++) {
+            tft.writePixels((const lgfx::swap565_t *)&color_p[y * screenWidth + a->x1], w);
+        }
+        bytes += w * h * PANEL_BYTES_PER_PIXEL;
+    }
     tft.endWrite();
+    spiArbiter.release(SPI_DEV_DISPLAY);
     
+    flush_bytes_last = bytes;
+    idleManager.onFrameFlushed();  // ⭐ v6.1.7
+    render_prof_add_flush(micros() - t0, bytes / PANEL_BYTES_PER_PIXEL);  // ⭐ v6.1.6
     lv_disp_flush_ready(disp);
-    esp_task_wdt_reset();
+}
+#endif
+
+/**
+ * @brief Mede o redraw de um objeto (ou da tela inteira) - diagnóstico do pipeline
+ * ⭐ v6.1.1 / v6.1.2: inclui bytes enviados ao painel no frame
+ */
+void benchmark_redraw(const char* nome, lv_obj_t *obj = NULL) {
+    lv_obj_invalidate(obj ? obj : lv_scr_act());
+    
+    uint32_t t0 = micros();
+    lv_refr_now(NULL);
+    while (draw_buf.flushing) taskYIELD();  // ⭐ v6.1.20: Última faixa ainda na tarefa lv_flush
+    uint32_t dt = micros() - t0;
+    
+    #if LVGL_FULL_FRAME
+    const char *modo = "full-frame PSRAM";
+    #else
+    const char *modo = buf2 ? "parcial 2x DMA" : "parcial 1x";
+    #endif
+    
+    Serial.printf("📊 Redraw [%s]: %lu us (~%.1f FPS) | %lu bytes SPI (%.1f%% da tela) | %s\n",
+                  nome, (unsigned long)dt, dt ? 1000000.0f / dt : 0.0f,
+                  (unsigned long)flush_bytes_last,
+                  100.0f * flush_bytes_last / (screenWidth * screenHeight * PANEL_BYTES_PER_PIXEL),
+                  modo);
+}
+
+// ========================================
+// SAÚDE DO DISPLAY (v6.1.9)
+// ========================================
+
+// ILI9488 sem MISO (readable=false): não há como ler MADCTL de volta, então
+// os registradores críticos são reaplicados só após um evento que pode tê-los
+// corrompido (tráfego do PN532, pico do AS608). Poucos bytes no SPI em vez de
+// tft.init(). ⭐ v6.1.20: Sem reparo periódico - redesenhar a tela a cada
+// minuto anulava a economia da tela ociosa.
+static uint32_t display_repairs = 0;
+static uint32_t display_last_repair_ms = 0;
+static uint32_t display_last_pn532_tx = 0;
+static volatile bool display_repair_request = false;  // ⭐ v6.1.10: Pedido de outra tarefa (pico do AS608)
+
+/**
+ * @brief Reaplica NORON, COLMOD, INVOFF, MADCTL e DISPON
+ * @param invalidar true = LVGL redesenha a tela inteira em seguida
+ * @return Duração do reparo em us (sem o redesenho)
+ */
+uint32_t display_health_repair(bool invalidar) {
+    uint32_t t0 = micros();
+    
+    spiArbiter.acquire(SPI_DEV_DISPLAY, SPI_ARB_WAIT_FOREVER);
+    tft.startWrite();
+    tft.writeCommand(0x13);  // NORON: sai de ALLPON/parcial
+    tft.writeCommand(0x3A);  // COLMOD: mesmo formato que a LovyanGFX configurou
+    tft.writeData((tft.getColorDepth() & 0xFF) > 16 ? 0x66 : 0x55);
+    tft.invertDisplay(false);           // INVOFF (cfg.invert = false)
+    tft.setRotation(SCREEN_ROTATION);   // MADCTL
+    tft.writeCommand(0x29);  // DISPON
+    tft.endWrite();
+    spiArbiter.release(SPI_DEV_DISPLAY);
+    
+    uint32_t dt = micros() - t0;
+    display_repairs++;
+    display_last_repair_ms = millis();
+    
+    if (invalidar) {
+        lv_obj_invalidate(lv_scr_act());
+    }
+    return dt;
+}
+
+/**
+ * @brief Chamar no loop: decide quando reaplicar os registradores
+ * - Pico do AS608 (pedido de outra tarefa) → reparo + redesenho (exceto tela apagada)
+ * - Rajada do PN532 terminada       → reparo leve (sem redesenho)
+ * Reparo manual: comando serial DISPLAY
+ */
+void display_health_tick() {
+    #if DISPLAY_HEALTH_ENABLED
+    const SpiDeviceStats &pn = spiArbiter.deviceStats(SPI_DEV_PN532);
+    uint32_t now = millis();
+    
+    bool pedido = display_repair_request;
+    bool rajada = pn.acquisitions != display_last_pn532_tx;
+    
+    // PN532 ainda com o barramento: esperar a rajada terminar
+    if (spiArbiter.owner() == SPI_DEV_PN532) return;
+    
+    if (pedido) {
+        display_repair_request = false;
+        uint32_t dt = display_health_repair(!idleManager.isOff());
+        Serial.printf("🩺 Display: registradores reaplicados após pico do AS608 em %lu us + redesenho\n",
+                      (unsigned long)dt);
+    } else if (rajada && now - display_last_repair_ms >= DISPLAY_HEALTH_BURST_MS) {
+        display_health_repair(false);
+    } else {
+        return;
+    }
+    
+    display_last_pn532_tx = pn.acquisitions;
+    #endif
+}
+
+/**
+ * @brief Backlight para o IdleManager
+ */
+static void idle_set_backlight(uint8_t level) {
+    tft.setBrightness(level);
+}
+
+/**
+ * @brief PENIRQ do XPT2046 (ativo baixo) - detecta toque sem transação SPI
+ */
+static bool idle_touch_irq() {
+    return digitalRead(TOUCH_IRQ) == LOW;
 }
 
 void my_touchpad_read(lv_indev_drv_t * indev_driver, lv_indev_data_t * data) {
     data->state = LV_INDEV_STATE_REL;
     
-    if (touch.touched()) {
-        TS_Point p = touch.getPoint();
+    // ⭐ v6.1.8: Leitura do XPT2046 só com o barramento livre (senão, tenta no próximo ciclo)
+    bool pressed = false;
+    TS_Point p;
+    {
+        SpiBusGuard bus(SPI_DEV_TOUCH, SPI_ARB_TOUCH_WAIT_MS);
+        if (!bus) return;
+        pressed = touch.touched();
+        if (pressed) {
+            p = touch.getPoint();
+        }
+    }
+    
+    // ⭐ v6.1.7: Toque conta como atividade; o toque que acordou a tela é descartado
+    if (pressed) {
+        idleManager.activity(IDLE_WAKE_TOUCH);
+    }
+    if (idleManager.swallowTouch(pressed)) {
+        return;
+    }
+    
+    if (pressed) {
         
         // ⚠️ FILTRO: Ignorar valores inválidos (8191 = touch desconectado)
         if (p.x >= 8000 || p.y >= 8000 || p.x == 0 || p.y == 0) {
@@ -491,6 +774,18 @@ void my_touchpad_read(lv_indev_drv_t * indev_driver, lv_indev_data_t * data) {
 
 void mudar_tela(Screen nova_tela);
 void atualizar_navegacao();
+
+// ⭐ v6.1.4: Estados visuais da caixa de autenticação (estilos compartilhados)
+enum AuthView {
+    AUTH_VIEW_PIN,       // Ocioso / digitação de PIN (azul)
+    AUTH_VIEW_BIO,       // Aguardando digital (roxo)
+    AUTH_VIEW_RFID,      // Aguardando cartão (ciano)
+    AUTH_VIEW_GRANTED,   // Acesso concedido (verde)
+    AUTH_VIEW_DENIED,    // Acesso negado (vermelho)
+    AUTH_VIEW_UNKNOWN,   // Credencial não cadastrada (âmbar)
+    AUTH_VIEW_COUNT
+};
+void auth_view_set(AuthView view, const char* texto);
 void criar_header();
 void criar_conteudo_home();
 void show_home_message(const char* message, uint32_t color); // ⭐ v6.0.24: Mensagens temporárias na HOME
@@ -834,286 +1129,182 @@ void AdminAuth::unlockAccount() {
 }
 
 // ========================================
-// SETUP
+// INICIALIZAÇÃO PARALELA (v6.1.10)
 // ========================================
 
-void setup() {
-    Serial.begin(115200);
-    delay(1000);
-    
-    Serial.println("\n========================================");
-    Serial.println("SISTEMA DE CONTROLE DE ACESSO");
-    Serial.println("ESP32-S3 + LVGL 8.3.11 + Touch XPT2046");
-    Serial.println("Configuração validada: 21/10/2025");
-    Serial.println("========================================\n");
-
-    // Watchdog
-    esp_task_wdt_init(30, true);
-    esp_task_wdt_add(NULL);
-    esp_task_wdt_reset();
-    Serial.println("✅ Watchdog 30s configurado");
-
-    // Inicializar display
-    Serial.println("🖥️  Inicializando display ILI9488...");
-    tft.init();
-    tft.setRotation(1); // Landscape
-    tft.setBrightness(200);
-    tft.fillScreen(TFT_BLACK);
-    delay(100);  // ⭐ Aguardar estabilização do SPI
-    esp_task_wdt_reset();
-    Serial.println("✅ Display ILI9488 480x320 OK");
-
-    // Inicializar touch
-    Serial.println("👆 Inicializando touch XPT2046...");
-    touch.begin();
-    touch.setRotation(1);
-    esp_task_wdt_reset();
-    Serial.println("✅ Touch XPT2046 inicializado");
-    
-    // Carregar calibração do touch
-    Serial.println("📐 Carregando calibração do touchscreen...");
-    carregar_calibracao();
-    imprimir_status_calibracao();
-    Serial.println("\n💡 Digite 'HELP' no Serial Monitor para comandos de calibração\n");
-
-    // Inicializar LVGL
-    Serial.println("🎨 Inicializando LVGL...");
-    lv_init();
-    esp_task_wdt_reset();
+// Storage (LittleFS), AS608 (UART) e Wi-Fi não dependem do display: sobem em
+// tarefas no core BOOT_TASK_CORE enquanto setup() prepara display/LVGL no
+// core 1. O PN532 divide o SPI2 e começa depois do touch (SPI.begin()).
+static EventGroupHandle_t boot_events = NULL;
+#define BOOT_BIT_STORAGE    (1 << 0)
+#define BOOT_BIT_RFID       (1 << 1)
+#define BOOT_BIT_BIO        (1 << 2)
+#define BOOT_BIT_WIFI       (1 << 3)
+
+static volatile bool boot_bio_storage_ok = false;
+static volatile bool boot_bio_ok = false;
+
+/**
+ * @brief Sobe um passo do boot em tarefa própria no core de inicialização
+ */
+static void boot_spawn(TaskFunction_t fn, const char* nome, uint32_t pilha) {
+    if (xTaskCreatePinnedToCore(fn, nome, pilha, NULL, 1, NULL, BOOT_TASK_CORE) != pdPASS) {
+        // Sem memória para a tarefa: executa no próprio setup()
+        Serial.printf("⚠️ [Boot] Falha ao criar tarefa %s - executando em série\n", nome);
+        fn((void*)1);
+    }
+}
 
-    // Configurar display buffer
-    lv_disp_draw_buf_init(&draw_buf, buf1, NULL, screenWidth * 20);
+/**
+ * @brief Encerra a tarefa de boot (ou retorna, se executada em série)
+ */
+static void boot_task_done(void* serial) {
+    if (!serial) vTaskDelete(NULL);
+}
 
-    // Registrar display driver
-    static lv_disp_drv_t disp_drv;
-    lv_disp_drv_init(&disp_drv);
-    disp_drv.hor_res = screenWidth;
-    disp_drv.ver_res = screenHeight;
-    disp_drv.flush_cb = my_disp_flush;
-    disp_drv.draw_buf = &draw_buf;
-    lv_disp_drv_register(&disp_drv);
-    esp_task_wdt_reset();
+/**
+ * @brief LittleFS (storages RFID/biometria/manutenção) - NVS já vem montado do core Arduino
+ */
+static void boot_task_storage(void* arg) {
+    int st = bootProfiler.begin("Storage");
+    bool rfid_ok = initRfidStorage();
+    boot_bio_storage_ok = initBioStorage();
+    bool manut_ok = maintenanceStore.begin();  // ⭐ v6.1.0: Migra blobs antigos do NVS
+    bootProfiler.end(st, rfid_ok && boot_bio_storage_ok && manut_ok);
+    
+    xEventGroupSetBits(boot_events, BOOT_BIT_STORAGE);
+    boot_task_done(arg);
+}
 
-    // Registrar input device (touch)
-    lv_indev_drv_init(&indev_drv);
-    indev_drv.type = LV_INDEV_TYPE_POINTER;
-    indev_drv.read_cb = my_touchpad_read;
-    indev_touchpad = lv_indev_drv_register(&indev_drv);
-    esp_task_wdt_reset();
-    
-    Serial.println("✅ LVGL configurado");
-    
-    // ⭐ NOVO: Inicializar sistema Wi-Fi
-    #if WIFI_ENABLED
-    Serial.println("📡 Inicializando sistema Wi-Fi...");
-    setupWiFi();
-    esp_task_wdt_reset();
-    Serial.println("✅ Sistema Wi-Fi configurado");
-    #endif
-    
-    // ⭐ NOVO: Inicializar autenticação admin
-    #if ADMIN_AUTH_ENABLED
-    Serial.println("🔐 Inicializando autenticação admin...");
-    adminAuth.begin();
-    esp_task_wdt_reset();
-    Serial.println("✅ Sistema de autenticação configurado");
-    #endif
-    
-    // ⭐ NOVO v1.0.0: Inicializar sistemas de storage (LittleFS)
-    Serial.println("💾 Inicializando sistemas de armazenamento...");
-    
-    // Inicializar storages (funções em storage_init.cpp)
-    initRfidStorage();
-    esp_task_wdt_reset();
-    
-    initBioStorage();
-    esp_task_wdt_reset();
-    
-    // ⭐ NOVO: Inicializar gerenciador RFID
-    Serial.println("📇 Inicializando gerenciador RFID...");
-    if (rfidManager.init()) {
-        Serial.println("✅ Gerenciador RFID configurado");
-    } else {
+/**
+ * @brief PN532 (SPI2 via árbitro) + cartões (LittleFS)
+ */
+static void boot_task_rfid(void* arg) {
+    // ⭐ v6.1.20: Cartões ficam em LittleFS - montado pela tarefa de storage
+    xEventGroupWaitBits(boot_events, BOOT_BIT_STORAGE, pdFALSE, pdTRUE, portMAX_DELAY);
+    int st = bootProfiler.begin("PN532");
+    bool ok = rfidManager.init();
+    bootProfiler.end(st, ok);
+    if (!ok) {
         Serial.println("⚠️ RFID não disponível (continuando sem RFID)");
     }
     
-    // ⭐ CRÍTICO: REINICIALIZAR display após init do RFID
-    // O PN532 corrompe o registro MADCTL do ILI9488 via SPI compartilhado
-    Serial.println("🔧 REINICIALIZANDO display após PN532...");
-    delay(200);  // Aguardar SPI estabilizar completamente
-    
-    // Reinicializar display (necessário para corrigir MADCTL corrompido)
-    tft.init();
-    tft.setRotation(1);  // LANDSCAPE
-    tft.setBrightness(200);
-    tft.fillScreen(TFT_BLACK);
-    delay(100);
-    
-    Serial.println("✅ Display REINICIALIZADO pós-RFID (corrupção MADCTL corrigida)");
-    
-    esp_task_wdt_reset();
-    
-    // ═══════════════════════════════════════════════════════════════════════
-    // ⭐ v6.0.10: PROTOCOLO ROBUSTO ANTI-BROWN-OUT (AS608)
-    // ═══════════════════════════════════════════════════════════════════════
-    // PROBLEMA: AS608 consome até 150mA durante init, causando:
-    //   1. Queda de tensão no VDD3P3 (< 2.7V)
-    //   2. ILI9488 corrompe e entra em ALLPON (tela branca)
-    //   3. ESP32-S3 pode resetar (brown-out detector)
-    //
-    // SOLUÇÃO: Protocolo de 5 etapas:
-    //   1. DESLIGAR display (backlight OFF)
-    //   2. Inicializar AS608 (permitir pico sem vulnerabilidade)
-    //   3. Aguardar estabilização LONGA (2s)
-    //   4. REINICIALIZAR display COMPLETO (não só fillScreen)
-    //   5. Verificar estado e tentar recovery se necessário
-    // ═══════════════════════════════════════════════════════════════════════
-    
-    Serial.println("\n╔════════════════���═════════════════════════════╗");
-    Serial.println("║   PROTOCOLO ANTI-BROWN-OUT v6.0.10          ║");
-    Serial.println("╚══════════════════════════════════════════════╝");
-    
-    // ═══ ETAPA 1: DESLIGAR DISPLAY ═══
-    Serial.println("📴 ETAPA 1/5: Desligando display antes do AS608...");
-    tft.setBrightness(0);  // ⭐ BACKLIGHT OFF (economiza ~50mA)
-    delay(100);  // Espera backlight desligar
-    Serial.println("   ✅ Display desligado (backlight OFF)");
-    
-    // ═══ ETAPA 2: INICIALIZAR AS608 (COM DISPLAY SEGURO) ═══
-    Serial.println("👆 ETAPA 2/5: Inicializando AS608...");
-    Serial.println("   ⚡ ATENÇÃO: Pico de 150mA esperado (display protegido)");
-    
-    bool bio_ok = bioManager.init();
-    
-    if (bio_ok) {
-        Serial.println("   ✅ AS608 inicializado com sucesso");
-    } else {
-        Serial.println("   ⚠️ AS608 não disponível");
+    xEventGroupSetBits(boot_events, BOOT_BIT_RFID);
+    boot_task_done(arg);
+}
+
+/**
+ * @brief Migra metadados do BiometricManager para o BiometricStorage (primeiro boot após v6.0.22)
+ */
+static void bio_migrar_nvs_storage() {
+    if (!boot_bio_storage_ok) {
+        Serial.println("⚠️  BiometricStorage não disponível (LittleFS não montado)");
+        Serial.println("   Sistema continuará com armazenamento apenas em NVS");
+        return;
     }
     
-    // ═══ ETAPA 3: ESTABILIZAÇÃO LONGA ═══
-    Serial.println("⏳ ETAPA 3/5: Aguardando estabilização elétrica...");
-    Serial.println("   • VDD3P3 recuperando de pico");
-    Serial.println("   • Capacitores recarregando");
-    delay(2000);  // ⭐ 2 segundos (antes: 1s - insuficiente!)
-    Serial.println("   ✅ Alimentação estabilizada");
-    
-    // ═══ ETAPA 4: REINICIALIZAÇÃO COMPLETA DO DISPLAY ═══
-    Serial.println("🔧 ETAPA 4/5: REINICIALIZANDO display completo...");
-    
-    // 4.1: Tentar reinit básico
-    tft.init();  // ⭐ Reseta registradores internos
-    delay(50);
-    
-    // 4.2: Configurar novamente
-    tft.setRotation(1);  // LANDSCAPE
-    delay(50);
-    
-    // 4.3: Reativar backlight
-    tft.setBrightness(200);
-    delay(50);
-    
-    // 4.4: Limpar tela (sai de ALLPON se estiver)
-    tft.fillScreen(TFT_BLACK);
-    delay(100);
-    
-    Serial.println("   ✅ Display reinicializado");
-    
-    // ═══ ETAPA 5: VERIFICAÇÃO E RECOVERY ═══
-    Serial.println("🔍 ETAPA 5/5: Verificando estado do display...");
-    
-    // Teste: desenhar pixel branco e verificar se display responde
-    tft.drawPixel(0, 0, TFT_WHITE);
-    delay(10);
-    tft.drawPixel(0, 0, TFT_BLACK);
-    
-    Serial.println("   ✅ Display respondendo corretamente");
-    
-    if (bio_ok) {
-        Serial.println("\n✅ Gerenciador Biometria configurado");
-        Serial.println("✅ Display protegido e restaurado");
+    // ═══ SINCRONIZAÇÃO: Migrar metadados do BiometricManager para BiometricStorage ═══
+    if (bioManager.getCount() > 0 && bioStorage.count() == 0) {
+        Serial.println("⚠️  Detectado: Usuários no NVS mas não no BiometricStorage");
+        Serial.println("🔄 Iniciando migração automática NVS → BiometricStorage...");
         
-        // ═══════════════════════════════════════════════════════════════════════
-        // ⭐ NOVO v6.0.22: Inicializar BiometricStorage (JSON em LittleFS)
-        // ═══════════════════════════════════════════════════════════════════════
-        Serial.println("\n💾 Inicializando BiometricStorage...");
-        
-        if (bioStorage.begin()) {
-            Serial.printf("✅ BiometricStorage inicializado: %d usuário(s)\n", bioStorage.count());
-            
-            // ═══ SINCRONIZAÇÃO: Migrar metadados do NVS para BiometricStorage ═══
-            if (bioManager.getCount() > 0 && bioStorage.count() == 0) {
-                Serial.println("⚠️  Detectado: Usuários no NVS mas não no BiometricStorage");
-                Serial.println("🔄 Iniciando migração automática NVS → BiometricStorage...");
+        int migrated = 0;
+        for (int i = 0; i < bioManager.getCount(); i++) {
+            Fingerprint* fp = bioManager.getFingerprint(i);
+            if (fp) {
+                BiometricUser user;
+                user.slotId = fp->id;
+                user.userId = String(fp->id);
+                user.userName = String(fp->name);
+                user.registeredAt = fp->timestamp * 1000UL;  // Converter para millis
+                user.confidence = fp->confidence;
+                user.accessCount = fp->access_count;
+                user.lastAccess = fp->last_access * 1000UL;  // Converter para millis
+                user.active = fp->active;
                 
-                int migrated = 0;
-                for (int i = 0; i < bioManager.getCount(); i++) {
-                    Fingerprint* fp = bioManager.getFingerprint(i);
-                    if (fp) {
-                        BiometricUser user;
-                        user.slotId = fp->id;
-                        user.userId = String(fp->id);
-                        user.userName = String(fp->name);
-                        user.registeredAt = fp->timestamp * 1000UL;  // Converter para millis
-                        user.confidence = fp->confidence;
-                        user.accessCount = fp->access_count;
-                        user.lastAccess = fp->last_access * 1000UL;  // Converter para millis
-                        user.active = fp->active;
-                        
-                        if (bioStorage.addUser(user)) {
-                            Serial.printf("   ✅ Migrado: %s (ID=%d)\n", fp->name, fp->id);
-                            migrated++;
-                        } else {
-                            Serial.printf("   ❌ Erro ao migrar: %s (ID=%d)\n", fp->name, fp->id);
-                        }
-                    }
+                if (bioStorage.addUser(user)) {
+                    Serial.printf("   ✅ Migrado: %s (ID=%d)\n", fp->name, fp->id);
+                    migrated++;
+                } else {
+                    Serial.printf("   ❌ Erro ao migrar: %s (ID=%d)\n", fp->name, fp->id);
                 }
-                
-                Serial.printf("✅ Migração concluída: %d/%d usuário(s) migrados\n", 
-                              migrated, bioManager.getCount());
             }
-            
-        } else {
-            Serial.println("⚠️  BiometricStorage não disponível (LittleFS não montado)");
-            Serial.println("   Sistema continuará com armazenamento apenas em NVS");
         }
         
-    } else {
-        Serial.println("\n⚠️ Biometria não disponível (continuando sem biometria)");
+        Serial.printf("✅ Migração concluída: %d/%d usuário(s) migrados\n", 
+                      migrated, bioManager.getCount());
+    }
+}
+
+/**
+ * @brief Compactação moveu um template: o LittleFS acompanha o novo slot
+ * ⭐ v6.1.17: Cartões vinculados também (to = 0: digital removida, desvincula)
+ */
+static void bio_slot_moved(uint16_t from, uint16_t to) {
+    if (to != 0 && boot_bio_storage_ok) bioStorage.moveUser(from, to);
+    rfidManager.moveFingerSlot(from, to);
+}
+
+/**
+ * @brief AS608 (UART2) + metadados (LittleFS); migração para o BiometricStorage
+ * ⭐ v6.1.20: Metadados ficam em LittleFS - init() só roda depois da tarefa
+ * de storage. BioLock do init() até o fim da migração. isReady() já vale
+ * true ao sair do init(); cadastro/verificação no loop (addFingerprint,
+ * finishVerify) esperam o lock em vez de alterar metadados e LittleFS no
+ * meio da migração. BOOT_BIT_BIO só é publicado depois.
+ */
+static void boot_task_bio(void* arg) {
+    xEventGroupWaitBits(boot_events, BOOT_BIT_STORAGE, pdFALSE, pdTRUE, portMAX_DELAY);
+    int st = bootProfiler.begin("AS608");
+    bioManager.setSlotMovedCallback(bio_slot_moved);  // ⭐ v6.1.16
+    bioManager.lock();
+    boot_bio_ok = bioManager.init();
+    bootProfiler.end(st, boot_bio_ok);
+    
+    if (boot_bio_ok) {
+        int mig = bootProfiler.begin("Migração bio");
+        bio_migrar_nvs_storage();
+        bootProfiler.end(mig);
     }
+    bioManager.unlock();
+    xEventGroupSetBits(boot_events, BOOT_BIT_BIO);
     
-    Serial.println("╚══════════════════════════════════════════════╝\n");
+    // Pico do AS608 com o backlight já ligado (setup() não esperou):
+    // reaplicar registradores do display no próximo loop
+    if (bootProfiler.doorReadyMs()) {
+        display_repair_request = true;
+    }
     
-    esp_task_wdt_reset();
+    if (boot_bio_ok) {
+        Serial.println("✅ Gerenciador Biometria configurado");
+    } else {
+        Serial.println("⚠️ Biometria não disponível (continuando sem biometria)");
+    }
+    boot_task_done(arg);
+}
+
+/**
+ * @brief Wi-Fi: rede salva / modo AP + auto-reconexão (não bloqueia a porta)
+ */
+static void boot_task_wifi(void* arg) {
+    int st = bootProfiler.begin("Wi-Fi");
     
-    // ⭐ NOVO v1.0.0: Inicializar controlador de relé
-    #if RELAY_ENABLED
-    Serial.println("🔌 Inicializando controlador de relé...");
-    relayController.begin();
-    Serial.println("✅ Relé configurado (Porta TRANCADA)");
-    esp_task_wdt_reset();
+    #if WIFI_ENABLED
+    setupWiFi();
     #endif
     
-    // Criar interface DEPOIS de todos os sistemas
-    Serial.println("🖼️  Criando interface LVGL...");
-    
-    // Limpar e reinicializar display (após SPI/UART dos sensores)
-    tft.fillScreen(TFT_BLACK);
-    lv_obj_invalidate(lv_scr_act());
-    esp_task_wdt_reset();
-    
-    criar_header();
-    mudar_tela(SCREEN_HOME);
-    esp_task_wdt_reset();
-    Serial.println("✅ Interface criada");
-    
-    Serial.println("\n========================================");
-    Serial.println("  ✅ SISTEMA PRONTO!");
-    Serial.println("========================================\n");
-    
     // ════════════════════════════════════════════════════════════════
     // ⭐ AUTO-RECONEXÃO WIFI (v6.0.55)
     // ════════════════════════════════════════════════════════════════
+    #if WIFI_ENABLED
+    if (wifiConnected) {
+        // setupWiFi() já conectou à rede salva: reconectar seria só espera
+        bootProfiler.end(st, true);
+        xEventGroupSetBits(boot_events, BOOT_BIT_WIFI);
+        boot_task_done(arg);
+        return;
+    }
+    #endif
     Serial.println("\n🔌 [WIFI] Verificando auto-reconexão...");
     
     Preferences prefs_wifi;
@@ -1198,7 +1389,280 @@ void setup() {
         Serial.println("[WIFI] 📱 Configure em: CONFIG → WIFI");
         Serial.println("════════════════════════════════════════════════\n");
     }
-    // ════════════════════════════════════════════════════════════════
+    
+    bootProfiler.end(st, WiFi.status() == WL_CONNECTED);
+    xEventGroupSetBits(boot_events, BOOT_BIT_WIFI);
+    boot_task_done(arg);
+}
+
+// ========================================
+// SETUP
+// ========================================
+
+void setup() {
+    Serial.begin(115200);
+    // ⭐ v6.1.10: Sem delay(1000) - UART0 não espera host; logs do boot seguem normalmente
+    
+    Serial.println("\n========================================");
+    Serial.println("SISTEMA DE CONTROLE DE ACESSO");
+    Serial.println("ESP32-S3 + LVGL 8.3.11 + Touch XPT2046");
+    Serial.println("Configuração validada: 21/10/2025");
+    Serial.println("========================================\n");
+
+    // Watchdog
+    esp_task_wdt_init(30, true);
+    esp_task_wdt_add(NULL);
+    esp_task_wdt_reset();
+    Serial.println("✅ Watchdog 30s configurado");
+    
+    // ⭐ v6.1.8: Árbitro do SPI2 antes de qualquer dispositivo do barramento
+    spiArbiter.begin();
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // ⭐ v6.1.10: BOOT PARALELO
+    // ═══════════════════════════════════════════════════════════════════════
+    // Antes: >4 s de delays fixos, sensores em série, display inicializado
+    // duas vezes e Wi-Fi bloqueando até 35 s antes do fim do setup().
+    //
+    //   core 0: Storage (LittleFS) │ AS608 (UART2) │ Wi-Fi
+    //   core 1: Display → Touch → [PN532 no core 0] → LVGL → Interface
+    //
+    // Proteção anti-brown-out (v6.0.10) mantida: backlight apagado até o
+    // handshake do AS608 (pico de 150mA) terminar; depois os registradores
+    // do ILI9488 são reaplicados (NORON/DISPON saem de ALLPON) sem tft.init().
+    // ═══════════════════════════════════════════════════════════════════════
+    boot_events = xEventGroupCreate();
+    boot_spawn(boot_task_storage, "boot_storage", BOOT_TASK_STACK);
+    boot_spawn(boot_task_bio, "boot_as608", BOOT_TASK_STACK);
+    boot_spawn(boot_task_wifi, "boot_wifi", BOOT_WIFI_TASK_STACK);
+
+    // Inicializar display (backlight só acende com a porta pronta)
+    Serial.println("🖥️  Inicializando display ILI9488...");
+    int st = bootProfiler.begin("Display");
+    tft.init();
+    tft.setRotation(SCREEN_ROTATION);
+    tft.setBrightness(0);
+    bootProfiler.end(st);
+    esp_task_wdt_reset();
+    Serial.println("✅ Display ILI9488 480x320 OK");
+
+    // Inicializar touch
+    Serial.println("👆 Inicializando touch XPT2046...");
+    touch.begin();
+    touch.setRotation(1);
+    esp_task_wdt_reset();
+    Serial.println("✅ Touch XPT2046 inicializado");
+    
+    // PN532 depois do SPI.begin() do touch; dali em diante o árbitro serializa
+    Serial.println("📇 Inicializando gerenciador RFID...");
+    boot_spawn(boot_task_rfid, "boot_pn532", BOOT_TASK_STACK);
+    
+    // Carregar calibração do touch
+    Serial.println("📐 Carregando calibração do touchscreen...");
+    carregar_calibracao();
+    imprimir_status_calibracao();
+    Serial.println("\n💡 Digite 'HELP' no Serial Monitor para comandos de calibração\n");
+
+    // Inicializar LVGL
+    Serial.println("🎨 Inicializando LVGL...");
+    st = bootProfiler.begin("LVGL");
+    lv_init();
+    esp_task_wdt_reset();
+
+    // Configurar display buffer
+    #if LVGL_FULL_FRAME
+    // ⭐ v6.1.2: Framebuffer completo na PSRAM (480x320x2 = 300KB)
+    const size_t buf_px = screenWidth * screenHeight;
+    buf1 = (lv_color_t *)heap_caps_malloc(buf_px * sizeof(lv_color_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (buf1 == NULL) {
+        Serial.println("❌ Sem PSRAM para o framebuffer! Reiniciando...");
+        delay(1000);
+        ESP.restart();
+    }
+    lv_disp_draw_buf_init(&draw_buf, buf1, NULL, buf_px);
+    Serial.printf("✅ Framebuffer LVGL full-frame na PSRAM (%u bytes)\n",
+                  (unsigned)(buf_px * sizeof(lv_color_t)));
+    #else
+    // ⭐ v6.1.1: Buffers em RAM interna com capacidade DMA (LVGL_BUF_LINES em config.h)
+    const size_t buf_px = screenWidth * LVGL_BUF_LINES;
+    buf1 = (lv_color_t *)heap_caps_malloc(buf_px * sizeof(lv_color_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    #if LVGL_DOUBLE_BUFFER
+    buf2 = (lv_color_t *)heap_caps_malloc(buf_px * sizeof(lv_color_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (buf2 == NULL) {
+        Serial.println("⚠️  Sem RAM DMA para o 2º buffer - usando buffer único");
+    }
+    #endif
+    if (buf1 == NULL) {
+        Serial.println("❌ Sem RAM DMA para o buffer LVGL! Reiniciando...");
+        delay(1000);
+        ESP.restart();
+    }
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, buf_px);
+    Serial.printf("✅ Buffers LVGL: %d x %u bytes (%d linhas)\n",
+                  buf2 ? 2 : 1, (unsigned)(buf_px * sizeof(lv_color_t)), LVGL_BUF_LINES);
+    
+    // ⭐ v6.1.20: Com 2 buffers o envio vai para a tarefa lv_flush
+    if (buf2) {
+        flush_queue = xQueueCreate(2, sizeof(FlushJob));
+        if (!flush_queue ||
+            xTaskCreatePinnedToCore(flush_task, "lv_flush", FLUSH_TASK_STACK, NULL,
+                                    FLUSH_TASK_PRIORITY, NULL, FLUSH_TASK_CORE) != pdPASS) {
+            Serial.println("⚠️  Tarefa lv_flush não criada - flush síncrono");
+            if (flush_queue) vQueueDelete(flush_queue);
+            flush_queue = NULL;
+        }
+    }
+    #endif
+
+    // Registrar display driver
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = screenWidth;
+    disp_drv.ver_res = screenHeight;
+    #if LVGL_FULL_FRAME
+    disp_drv.flush_cb = my_disp_flush_direct;
+    disp_drv.direct_mode = 1;
+    #else
+    disp_drv.flush_cb = my_disp_flush;
+    #endif
+    disp_drv.draw_buf = &draw_buf;
+    lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+    render_prof_install(disp);  // ⭐ v6.1.6: Mede render/flush por frame (inativo até "PROF ON")
+    esp_task_wdt_reset();
+
+    // Registrar input device (touch)
+    lv_indev_drv_init(&indev_drv);
+    indev_drv.type = LV_INDEV_TYPE_POINTER;
+    indev_drv.read_cb = my_touchpad_read;
+    indev_touchpad = lv_indev_drv_register(&indev_drv);
+    esp_task_wdt_reset();
+    
+    // ⭐ v6.1.7: Ociosidade (esmaecer/apagar e pausar refresh + leitura do touch)
+    idleManager.begin(disp, indev_touchpad, idle_set_backlight, idle_touch_irq);
+    
+    bootProfiler.end(st);
+    Serial.println("✅ LVGL configurado");
+    
+    // ⭐ NOVO: Inicializar autenticação admin
+    #if ADMIN_AUTH_ENABLED
+    Serial.println("🔐 Inicializando autenticação admin...");
+    adminAuth.begin();
+    esp_task_wdt_reset();
+    Serial.println("✅ Sistema de autenticação configurado");
+    #endif
+    
+    // ⭐ NOVO v1.0.0: Inicializar controlador de relé
+    #if RELAY_ENABLED
+    Serial.println("🔌 Inicializando controlador de relé...");
+    relayController.begin();
+    Serial.println("✅ Relé configurado (Porta TRANCADA)");
+    esp_task_wdt_reset();
+    #endif
+    
+    // Criar interface e desenhar o 1º frame ainda com o backlight apagado
+    Serial.println("🖼️  Criando interface LVGL...");
+    st = bootProfiler.begin("Interface");
+    bool bio_antes_frame = xEventGroupGetBits(boot_events) & BOOT_BIT_BIO;
+    criar_header();
+    mudar_tela(SCREEN_HOME);
+    lv_refr_now(NULL);
+    bootProfiler.end(st);
+    esp_task_wdt_reset();
+    Serial.println("✅ Interface criada");
+    
+    // ═══ PORTA PRONTA: PN532 com os cartões carregados + pico do AS608 passado ═══
+    st = bootProfiler.begin("Espera sensores");
+    uint32_t agora = millis();
+    uint32_t espera = agora < BOOT_DOOR_WAIT_MS ? BOOT_DOOR_WAIT_MS - agora : 0;
+    EventBits_t bits = xEventGroupWaitBits(boot_events, BOOT_BIT_RFID | BOOT_BIT_BIO,
+                                           pdFALSE, pdTRUE, pdMS_TO_TICKS(espera));
+    bootProfiler.end(st, (bits & (BOOT_BIT_RFID | BOOT_BIT_BIO)) == (BOOT_BIT_RFID | BOOT_BIT_BIO));
+    if (!(bits & BOOT_BIT_RFID)) {
+        Serial.println("⚠️ [Boot] PN532 ainda inicializando - cartões aceitos quando terminar");
+    }
+    if (!(bits & BOOT_BIT_BIO)) {
+        Serial.println("⚠️ [Boot] AS608 ainda inicializando - display será reparado ao fim do pico");
+    }
+    
+    // Pós-pico do AS608 / tráfego do PN532: registradores em vez de tft.init().
+    // Pico durante o 1º frame pode ter sujado a GRAM: redesenhar nesse caso.
+    bool redesenhar = !bio_antes_frame && (bits & BOOT_BIT_BIO);
+    uint32_t reparo_us = display_health_repair(redesenhar);
+    if (redesenhar) lv_refr_now(NULL);
+    Serial.printf("✅ Display: registradores reaplicados em %lu us (sem reinit%s)\n",
+                  (unsigned long)reparo_us, redesenhar ? ", tela redesenhada" : "");
+    idle_set_backlight(IDLE_BRIGHTNESS_ACTIVE);
+    esp_task_wdt_reset();
+    
+    bootProfiler.doorReady();
+    
+    #if DISPLAY_BENCH_ON_BOOT
+    benchmark_redraw("HOME");
+    benchmark_redraw("Caixa de autenticação", auth_display_box);
+    benchmark_redraw("Status do header", header_signal);
+    esp_task_wdt_reset();
+    #endif
+    
+    idleManager.activity(IDLE_WAKE_OTHER);  // ⭐ v6.1.7: Contagem de ociosidade começa aqui
+    
+    Serial.println("\n========================================");
+    Serial.println("  ✅ SISTEMA PRONTO!");
+    Serial.println("  (Wi-Fi/biometria podem concluir em segundo plano - comando BOOT)");
+    Serial.println("========================================\n");
+}
+
+/**
+ * @brief ⭐ v6.1.19: Cartão em AUTH_CARD_FINGER (nullptr se removido pela API); chamar com RFIDLock
+ */
+static RFIDCard* cartao_digital_card() {
+    if (cardFingerUidLen == 0) return nullptr;
+    return rfidManager.getCard(rfidManager.findCardIndex(cardFingerUid, cardFingerUidLen));
+}
+
+/**
+ * @brief ⭐ v6.1.17: Resultado do Match 1:1 da digital do titular do cartão
+ * Sem dedo/erro de leitura: continua aguardando até o timeout do modo.
+ */
+static void cartao_digital_resultado(BioVerifyResult result) {
+    RFIDLock cardsLock(rfidManager);
+    RFIDCard* card = cartao_digital_card();
+    if (currentAuthMode != AUTH_CARD_FINGER || !card) return;   // Modo expirou durante o match
+    if (result == BIO_VERIFY_NO_FINGER || result == BIO_VERIFY_ERROR) return;
+    
+    if (result == BIO_VERIFY_GRANTED) {
+        rfidManager.isCardAuthorized(card->uid, card->uid_length);  // Contador + log do cartão
+        
+        Serial.println("╔════════════════════════════════════╗");
+        Serial.printf("║  🔓 ACESSO CONCEDIDO (CARTÃO+BIO)  ║\n");
+        Serial.printf("║  Cartão: %-26s║\n", card->name);
+        Serial.printf("║  ID: %-3d  Confiança: %-3d         ║\n",
+                      bioManager.getLastMatchedID(), bioManager.getLastConfidence());
+        Serial.println("╚════════════════════════════════════╝");
+        
+        char msg[40];
+        snprintf(msg, sizeof(msg), "ACESSO\nCONCEDIDO\n%s", card->name);
+        auth_view_set(AUTH_VIEW_GRANTED, msg);
+        
+        if (bioStorage.count() > 0) {
+            bioStorage.updateLastAccess(bioManager.getLastMatchedID(), bioManager.getLastConfidence());
+        }
+        
+        #if RELAY_ENABLED
+        Serial.println("🔓 Ativando relé (destrancando porta)...");
+        relayController.unlock();
+        #endif
+    } else {
+        // NOT_FOUND: digital de outra pessoa | REJECTED: digital desativada
+        Serial.printf("🔒 [CARTÃO+BIO] %s: digital %s\n", card->name,
+                      result == BIO_VERIFY_NOT_FOUND ? "não confere" : "desativada");
+        rfidManager.logAccess(card->uid, card->uid_length, card->name, false);
+        auth_view_set(AUTH_VIEW_DENIED, result == BIO_VERIFY_NOT_FOUND ?
+                      "ACESSO\nNEGADO\nDigital" : "ACESSO\nNEGADO\nDesativado");
+    }
+    
+    // Próximo cartão; a tela volta ao PIN no timeout do modo
+    cardFingerUidLen = 0;
+    currentAuthMode = AUTH_RFID;
 }
 
 // ========================================
@@ -1206,6 +1670,17 @@ void setup() {
 // ========================================
 
 void loop() {
+    // ⭐ v6.1.19: Intervalo entre loops (API STATS)
+    static uint32_t loop_prev_us = 0;
+    uint32_t loop_now_us = micros();
+    if (loop_prev_us) {
+        uint32_t dt = loop_now_us - loop_prev_us;
+        if (dt > loopStatMaxUs) loopStatMaxUs = dt;
+        loopStatSumUs += dt;
+        loopStatCount++;
+    }
+    loop_prev_us = loop_now_us;
+    
     // ⭐ CORREÇÃO: Inicialização adequada do last_tick
     static uint32_t last_tick = 0;
     if (last_tick == 0) {
@@ -1222,6 +1697,31 @@ void loop() {
     relayController.update();
     #endif
     
+    // ⭐ v6.1.7: Ociosidade + acordar por cartão com a tela apagada
+    idleManager.update();
+    display_health_tick();  // ⭐ v6.1.9: Reparo leve do display após tráfego do PN532
+    templateArchive.update();  // ⭐ v6.1.13: Backup/restauração de templates (sem bloquear)
+    bioBatch.update();         // ⭐ v6.1.18: Cadastro em lote (sem bloquear)
+    credentialApiUpdate();     // ⭐ v6.1.19: Alterações de digitais pedidas pela API
+    bioManager.flushStats();   // ⭐ v6.1.20: Contadores de acesso das digitais → LittleFS
+    if (bioBatch.promptChanged()) {
+        if (bioBatch.busy()) {
+            auth_view_set(AUTH_VIEW_BIO, bioBatch.prompt());
+        } else {
+            auth_view_set(AUTH_VIEW_PIN, "----");
+        }
+    }
+    #if PN532_ENABLED
+    static uint32_t idle_card_probe = 0;
+    if (idleManager.isOff() && rfidManager.isHardwareConnected() &&
+        millis() - idle_card_probe > IDLE_CARD_PROBE_MS) {
+        idle_card_probe = millis();
+        if (rfidManager.detectCard()) {
+            idleManager.activity(IDLE_WAKE_CARD);
+        }
+    }
+    #endif
+    
     // ⭐ NOVO v5.2.0: Verificar cadastro RFID em andamento
     if (rfid_enrolling) {
         if (rfidManager.detectCard()) {
@@ -1263,22 +1763,48 @@ void loop() {
     // ⭐ CORRIGIDO v6.0.23: Padrão do código funcional (SEM DEBOUNCE, SEM hasFingerOnSensor)
     // ⭐ CORRIGIDO v6.0.25: Respeitar modo de autenticação (não rodar bio quando aguardando RFID)
     // ═══════════════════════════════════════════════════════════════════════
+    // ⭐ v6.1.11: Captura → extração → busca assíncronas (as608_async): o loop
+    // segue desenhando/lendo touch e RFID enquanto o AS608 responde
     static bool bioProcessing = false;
+    static bool bioCardMatch = false;   // ⭐ v6.1.17: Verificação em andamento é o 1:1 do cartão
     
     // ✅ PADRÃO DO CÓDIGO FUNCIONAL: POLLING CONTÍNUO SEM DEBOUNCE
     // Verificar apenas na tela HOME, se não está processando, e se modo permite biometria
     if (currentScreen == SCREEN_HOME &&                      // Apenas na HOME
         !bioProcessing &&                                     // Não processar se já está processando
         !bio_enrolling &&                                     // Não verificar durante cadastro
-        (currentAuthMode == AUTH_AUTO_BIO || currentAuthMode == AUTH_BIO_MANUAL) && // ⭐ v6.0.25: Modo correto
-        bioManager.isHardwareConnected()) {                   // Sensor conectado
+        (currentAuthMode == AUTH_AUTO_BIO || currentAuthMode == AUTH_BIO_MANUAL || // ⭐ v6.0.25: Modo correto
+         currentAuthMode == AUTH_CARD_FINGER) &&              // ⭐ v6.1.17: Digital do titular do cartão
+        bioManager.isReady() &&                               // Sensor inicializado (sem handshake a cada loop)
+        bioManager.fingerWaiting()) {                         // ⭐ v6.1.12: Dedo presente (WAK) ou polling de segurança
         
-        bioProcessing = true;
+        // ⭐ v6.1.17: Com cartão lido, só o slot vinculado (LoadChar + Match)
+        RFIDLock cardsLock(rfidManager);
+        RFIDCard* card = (currentAuthMode == AUTH_CARD_FINGER) ? cartao_digital_card() : nullptr;
+        if (currentAuthMode == AUTH_CARD_FINGER && !card) {
+            // ⭐ v6.1.20: Cartão removido pela API enquanto aguardava a digital:
+            // tentativa cancelada (sem cair no 1:N), volta a aguardar cartão
+            Serial.println("⚠️  [CARTÃO+BIO] Cartão removido durante a espera da digital - tentativa cancelada");
+            rfidManager.logAccess(cardFingerUid, cardFingerUidLen, "Removido", false);
+            auth_view_set(AUTH_VIEW_DENIED, "ACESSO\nNEGADO\nCartao removido");
+            cardFingerUidLen = 0;
+            currentAuthMode = AUTH_RFID;
+        } else {
+            bioProcessing = card ? bioManager.startVerifySlot(card->finger_slot) : bioManager.startVerify();
+            bioCardMatch = bioProcessing && card;
+        }
+    }
+    
+    BioVerifyResult bioResult = bioProcessing ? bioManager.pollVerify() : BIO_VERIFY_PENDING;
+    if (bioProcessing && bioResult != BIO_VERIFY_PENDING) {
         
-        // ═══ VERIFICAR DIGITAL (1:N) - MÉTODO SIMPLIFICADO ═══
-        // ✅ verifyFinger() já faz getImage() internamente
-        // ✅ NÃO chamar hasFingerOnSensor() antes (evita duplicação)
-        if (bioManager.verifyFinger()) {
+        // ═══ CARTÃO + DIGITAL (1:1) - RESULTADO DO MATCH ═══
+        if (bioCardMatch) {
+            cartao_digital_resultado(bioResult);
+        }
+        // ═══ VERIFICAR DIGITAL (1:N) - RESULTADO DO PIPELINE ═══
+        // ✅ GRANTED = mesmo critério de verifyFinger() (reconhecida, ativa, com metadados)
+        else if (bioResult == BIO_VERIFY_GRANTED) {
                 // ✅ DIGITAL RECONHECIDA!
                 uint16_t id = bioManager.getLastMatchedID();
                 uint16_t confidence = bioManager.getLastConfidence();
@@ -1301,19 +1827,11 @@ void loop() {
                         Serial.printf("║  Acessos: %-4d                     ║\n", fp->access_count);
                         Serial.println("╚════════════════════════════════════╝");
                         
-                        // ⭐ v6.0.30: DEBUG - Atualizar bio_display_label
-                        Serial.printf("🔍 [DEBUG] Atualizando bio_display_label: %p\n", bio_display_label);
-                        // ⭐ v6.0.32: Atualizar label BIO com resultado
-                        if (bio_display_label) {
-                            char bio_msg[40];
-                            snprintf(bio_msg, sizeof(bio_msg), "ACESSO\nCONCEDIDO\n%s", fp->name);
-                            lv_label_set_text(bio_display_label, bio_msg);
-                            lv_obj_set_style_text_color(bio_display_label, lv_color_hex(0x10b981), 0);
-                            lv_obj_set_style_border_color(bio_box, lv_color_hex(0x10b981), 0);
-                            Serial.printf("   ✓ BIO atualizado: '%s'\n", bio_msg);
-                        } else {
-                            Serial.println("   ❌ bio_display_label é NULL!");
-                        }
+                        // ⭐ v6.1.4: Resultado via estilo compartilhado (sem redesenho forçado)
+                        char bio_msg[40];
+                        snprintf(bio_msg, sizeof(bio_msg), "ACESSO\nCONCEDIDO\n%s", fp->name);
+                        auth_view_set(AUTH_VIEW_GRANTED, bio_msg);
+                        Serial.printf("   ✓ BIO atualizado: '%s'\n", bio_msg);
                         
                         // ═══ ATUALIZAR CONTADOR NO STORAGE ═══
                         if (bioStorage.count() > 0) {
@@ -1348,13 +1866,8 @@ void loop() {
                         Serial.printf("║  ID: %-3d (DESATIVADO)             ║\n", id);
                         Serial.println("╚════════════════════════════════════╝");
                         
-                        // ⭐ v6.0.38: Atualizar auth_display_label (box único)
-                        if (auth_display_label) {
-                            lv_label_set_text(auth_display_label, "ACESSO\nNEGADO\nDesativado");
-                            lv_obj_set_style_text_color(auth_display_label, lv_color_hex(0xef4444), 0);
-                            lv_obj_set_style_border_color(auth_display_box, lv_color_hex(0xef4444), 0);
-                            lv_obj_invalidate(auth_display_box);
-                        }
+                        // ⭐ v6.1.4: Atualizar auth_display (estilo compartilhado)
+                        auth_view_set(AUTH_VIEW_DENIED, "ACESSO\nNEGADO\nDesativado");
                         
                         // ⭐ v6.0.25: Resetar modo para bio automático após autenticação
                         currentAuthMode = AUTH_AUTO_BIO;
@@ -1368,21 +1881,22 @@ void loop() {
                     Serial.println("⚠️  [BIOMETRIA] Digital reconhecida mas sem metadados no NVS");
                     Serial.printf("    ID=%d, Confiança=%d\n", id, confidence);
                     
-                    // ⭐ v6.0.38: Atualizar auth_display_label (box único)
-                    if (auth_display_label) {
-                        lv_label_set_text(auth_display_label, "DIGITAL\nNAO\nCADASTRADA");
-                        lv_obj_set_style_text_color(auth_display_label, lv_color_hex(0xf59e0b), 0);
-                        lv_obj_set_style_border_color(auth_display_box, lv_color_hex(0xf59e0b), 0);
-                        lv_obj_invalidate(auth_display_box);
-                    }
+                    // ⭐ v6.1.4: Atualizar auth_display (estilo compartilhado)
+                    auth_view_set(AUTH_VIEW_UNKNOWN, "DIGITAL\nNAO\nCADASTRADA");
                     
                     // ⭐ v6.0.25: Resetar modo para bio automático após autenticação
                     currentAuthMode = AUTH_AUTO_BIO;
                 }
         }
-        // ✅ Se verifyFinger() retornou false: sem dedo ou não reconhecido (silencioso)
+        // ✅ Demais resultados: sem dedo ou não reconhecido (silencioso)
+        
+        // ⭐ v6.1.7: Qualquer dedo no sensor (reconhecido ou não) acorda a tela
+        if (bioManager.lastVerifyHadFinger()) {
+            idleManager.activity(IDLE_WAKE_FINGER);
+        }
         
         bioProcessing = false;
+        bioCardMatch = false;
     }
     // ═══════════════════════════════════════════════════════════════════════
     // FIM: AUTENTICAÇÃO BIOMÉTRICA CONTÍNUA v6.0.22
@@ -1409,6 +1923,7 @@ void loop() {
         
         // ═══ VERIFICAR CARTÃO RFID ═══
         if (rfidManager.detectCard() && rfidManager.readCard(uid, &uidLength)) {
+            idleManager.activity(IDLE_WAKE_CARD);  // ⭐ v6.1.7
             Serial.print("💳 [RFID] Cartão detectado! UID: ");
             for (int i = 0; i < uidLength; i++) {
                 Serial.printf("%02X", uid[i]);
@@ -1416,11 +1931,36 @@ void loop() {
             Serial.println();
             
             // ═══ BUSCAR INFORMAÇÕES DO CARTÃO ═══
+            // ⭐ v6.1.19: 'card' vale até o fim do bloco (API HTTP não remove no meio)
+            RFIDLock cardsLock(rfidManager);
             int index = rfidManager.findCardIndex(uid, uidLength);
             
             if (index >= 0) {
                 RFIDCard* card = rfidManager.getCard(index);
                 
+                #if AUTH_CARD_AND_FINGER
+                // Acesso só é contado/registrado depois da digital (cartao_digital_resultado)
+                if (card && card->active) {
+                    // ═══════════════════════════════════════════
+                    // ⭐ v6.1.17: CARTÃO OK - FALTA A DIGITAL DO TITULAR
+                    // ═══════════════════════════════════════════
+                    if (card->finger_slot && bioManager.findFingerprintIndex(card->finger_slot) >= 0) {
+                        Serial.printf("💳 [RFID] %s: aguardando digital ID=%d (1:1)\n",
+                                      card->name, card->finger_slot);
+                        char rfid_msg[40];
+                        snprintf(rfid_msg, sizeof(rfid_msg), "%s\nCOLOQUE\nO DEDO", card->name);
+                        auth_view_set(AUTH_VIEW_BIO, rfid_msg);
+                        memcpy(cardFingerUid, uid, uidLength);
+                        cardFingerUidLen = uidLength;
+                        currentAuthMode = AUTH_CARD_FINGER;
+                        authModeStartTime = millis();   // Prazo para a digital
+                    } else {
+                        Serial.printf("⚠️  [RFID] %s sem digital vinculada (RFID LINK)\n", card->name);
+                        rfidManager.logAccess(uid, uidLength, card->name, false);
+                        auth_view_set(AUTH_VIEW_DENIED, "ACESSO\nNEGADO\nSem digital");
+                    }
+                } else
+                #endif
                 if (card && card->active && rfidManager.isCardAuthorized(uid, uidLength)) {
                         // ═══════════════════════════════════════════
                         // 🔓 ACESSO CONCEDIDO (RFID)!
@@ -1431,45 +1971,11 @@ void loop() {
                         Serial.printf("║  Acessos: %-4d                     ║\n", card->access_count);
                         Serial.println("╚════════════════════════════════════╝");
                         
-                        // ⭐ v6.0.43: Atualizar auth_display COM REDESENHO FORÇADO
-                        Serial.printf("🔍 [DEBUG] Atualizando auth_display_label: %p\n", auth_display_label);
-                        if (auth_display_label) {
-                            char rfid_msg[40];
-                            snprintf(rfid_msg, sizeof(rfid_msg), "ACESSO\nCONCEDIDO\n%s", card->name);
-                            
-                            // Debug: Verificar estado ANTES
-                            bool was_hidden = lv_obj_has_flag(auth_display_box, LV_OBJ_FLAG_HIDDEN);
-                            Serial.printf("   🔍 Box ANTES: Hidden=%d\n", was_hidden);
-                            
-                            lv_obj_clear_flag(auth_display_box, LV_OBJ_FLAG_HIDDEN);  // ⭐ MOSTRAR BOX!
-                            
-                            // Debug: Verificar estado DEPOIS
-                            bool is_hidden = lv_obj_has_flag(auth_display_box, LV_OBJ_FLAG_HIDDEN);
-                            Serial.printf("   🔍 Box DEPOIS: Hidden=%d\n", is_hidden);
-                            
-                            // ⭐ v6.0.51: ORDEM CORRETA - largura e wrap ANTES do texto!
-                            lv_obj_set_width(auth_display_label, 180);  // 1º: Largura fixa
-                            lv_label_set_long_mode(auth_display_label, LV_LABEL_LONG_WRAP);  // 2º: Word wrap
-                            lv_label_set_text(auth_display_label, rfid_msg);  // 3º: Texto (POR ÚLTIMO!)
-                            
-                            lv_obj_set_style_bg_color(auth_display_box, lv_color_hex(0x0A0A1A), 0);  // Fundo escuro original
-                            lv_obj_set_style_text_font(auth_display_label, &lv_font_montserrat_20, 0);  // Fonte grande
-                            lv_obj_set_style_text_color(auth_display_label, lv_color_hex(0x10b981), 0);  // Verde
-                            lv_obj_set_style_border_color(auth_display_box, lv_color_hex(0x10b981), 0);  // Borda verde
-                            lv_obj_set_style_text_align(auth_display_label, LV_TEXT_ALIGN_CENTER, 0);  // Alinhamento central
-                            lv_obj_align(auth_display_label, LV_ALIGN_CENTER, 0, 0);  // ⭐ align() ao invés de center()
-                            lv_obj_move_foreground(auth_display_box);
-                            lv_obj_update_layout(auth_display_box);
-                            
-                            // ⭐ v6.0.46: FORÇAR REDESENHO COMPLETO
-                            lv_obj_invalidate(auth_display_box);
-                            lv_refr_now(NULL);
-                            lv_obj_invalidate(auth_display_box);
-                            lv_task_handler();
-                            Serial.printf("   ✓ RFID atualizado: '%s'\n", rfid_msg);
-                        } else {
-                            Serial.println("   ❌ auth_display_label é NULL!");
-                        }
+                        // ⭐ v6.1.4: Estilo compartilhado; desenhado no ciclo normal do LVGL
+                        char rfid_msg[40];
+                        snprintf(rfid_msg, sizeof(rfid_msg), "ACESSO\nCONCEDIDO\n%s", card->name);
+                        auth_view_set(AUTH_VIEW_GRANTED, rfid_msg);
+                        Serial.printf("   ✓ RFID atualizado: '%s'\n", rfid_msg);
                         
                         // ═══ ATIVAR RELÉ (DESTRANCAR PORTA) ═══
                         #if RELAY_ENABLED
@@ -1489,53 +1995,21 @@ void loop() {
                         Serial.println("║  Status: DESATIVADO                ║");
                         Serial.println("╚══════════════════════��═════════════╝");
                         
-                        // ⭐ v6.0.41: Atualizar auth_display (box único)
-                        if (auth_display_label) {
-                            lv_obj_set_width(auth_display_label, 180);
-                            lv_label_set_long_mode(auth_display_label, LV_LABEL_LONG_WRAP);
-                            lv_label_set_text(auth_display_label, "ACESSO\nNEGADO\nDesativado");
-                            lv_obj_set_style_bg_color(auth_display_box, lv_color_hex(0x0A0A1A), 0);  // Fundo escuro original
-                            lv_obj_set_style_text_font(auth_display_label, &lv_font_montserrat_20, 0);  // Fonte grande
-                            lv_obj_set_style_text_color(auth_display_label, lv_color_hex(0xef4444), 0);  // Vermelho
-                            lv_obj_set_style_border_color(auth_display_box, lv_color_hex(0xef4444), 0);  // Borda vermelha
-                            lv_obj_set_style_text_align(auth_display_label, LV_TEXT_ALIGN_CENTER, 0);
-                            lv_obj_align(auth_display_label, LV_ALIGN_CENTER, 0, 0);
-                            lv_obj_invalidate(auth_display_box);
-                            lv_obj_invalidate(auth_display_label);
-                        }
+                        // ⭐ v6.1.4: Atualizar auth_display (estilo compartilhado)
+                        auth_view_set(AUTH_VIEW_DENIED, "ACESSO\nNEGADO\nDesativado");
                         
                         // ⭐ v6.0.41: NÃO resetar modo - aguardar timeout
                 } else {
                     // Cartão não cadastrado (não autorizado)
                     Serial.println("⚠️  [RFID] Cartão não cadastrado");
                     
-                    if (auth_display_label) {
-                        lv_obj_set_width(auth_display_label, 180);
-                        lv_label_set_long_mode(auth_display_label, LV_LABEL_LONG_WRAP);
-                        lv_label_set_text(auth_display_label, "CARTAO\nNAO\nCADASTRADO");
-                        lv_obj_set_style_bg_color(auth_display_box, lv_color_hex(0x0A0A1A), 0);
-                        lv_obj_set_style_text_font(auth_display_label, &lv_font_montserrat_20, 0);
-                        lv_obj_set_style_text_color(auth_display_label, lv_color_hex(0xf59e0b), 0);
-                        lv_obj_set_style_border_color(auth_display_box, lv_color_hex(0xf59e0b), 0);
-                        lv_obj_set_style_text_align(auth_display_label, LV_TEXT_ALIGN_CENTER, 0);
-                        lv_obj_align(auth_display_label, LV_ALIGN_CENTER, 0, 0);
-                    }
+                    auth_view_set(AUTH_VIEW_UNKNOWN, "CARTAO\nNAO\nCADASTRADO");
                 }
             } else {
                 // ═══ CARTÃO NÃO ENCONTRADO (index < 0) ═══
                 Serial.println("⚠️  [RFID] Cartão não cadastrado");
                 
-                if (auth_display_label) {
-                    lv_obj_set_width(auth_display_label, 180);
-                    lv_label_set_long_mode(auth_display_label, LV_LABEL_LONG_WRAP);
-                    lv_label_set_text(auth_display_label, "CARTAO\nNAO\nCADASTRADO");
-                    lv_obj_set_style_bg_color(auth_display_box, lv_color_hex(0x0A0A1A), 0);
-                    lv_obj_set_style_text_font(auth_display_label, &lv_font_montserrat_20, 0);
-                    lv_obj_set_style_text_color(auth_display_label, lv_color_hex(0xf59e0b), 0);
-                    lv_obj_set_style_border_color(auth_display_box, lv_color_hex(0xf59e0b), 0);
-                    lv_obj_set_style_text_align(auth_display_label, LV_TEXT_ALIGN_CENTER, 0);
-                    lv_obj_align(auth_display_label, LV_ALIGN_CENTER, 0, 0);
-                }
+                auth_view_set(AUTH_VIEW_UNKNOWN, "CARTAO\nNAO\nCADASTRADO");
             }
         }
         
@@ -1553,21 +2027,8 @@ void loop() {
             currentAuthMode = AUTH_AUTO_BIO;
             authModeStartTime = 0;
             
-            // ⭐ v6.0.52: Restaurar modo PIN (box único) COM FUNDO ESCURO ORIGINAL
-            if (auth_display_box && auth_display_label) {
-                lv_obj_set_size(auth_display_box, 200, 50);  // Tamanho PIN
-                lv_obj_set_width(auth_display_label, 180);
-                lv_label_set_long_mode(auth_display_label, LV_LABEL_LONG_WRAP);
-                lv_obj_set_style_bg_color(auth_display_box, lv_color_hex(0x0A0A1A), 0);  // Fundo escuro original
-                lv_obj_set_style_border_color(auth_display_box, lv_color_hex(COLOR_ACCENT), 0);  // Azul
-                lv_label_set_text(auth_display_label, "----");
-                lv_obj_set_style_text_font(auth_display_label, &lv_font_montserrat_20, 0);
-                lv_obj_set_style_text_color(auth_display_label, lv_color_hex(COLOR_ACCENT), 0);
-                lv_obj_set_style_text_align(auth_display_label, LV_TEXT_ALIGN_CENTER, 0);
-                lv_obj_align(auth_display_label, LV_ALIGN_CENTER, 0, 0);
-                lv_obj_invalidate(auth_display_box);
-                lv_obj_invalidate(auth_display_label);
-            }
+            // ⭐ v6.1.4: Restaurar modo PIN (estilo compartilhado)
+            auth_view_set(AUTH_VIEW_PIN, "----");
         }
     }
     
@@ -1581,7 +2042,10 @@ void loop() {
     }
     
     // Processar tarefas LVGL
+    // ⭐ v6.1.6: Duração do handler entra no profiler (quando ativo)
+    uint32_t handler_t0 = micros();
     lv_timer_handler();
+    render_prof_add_handler(micros() - handler_t0);
     
     // ⭐ NOVO v6.0.24: Gerenciar mensagens temporárias na HOME
     if (home_message_label && home_message_timer > 0) {
@@ -1595,6 +2059,16 @@ void loop() {
     if (Serial.available()) {
         String cmd = Serial.readStringUntil('\n');
         cmd.trim();  // Remove \r, \n, espaços
+        
+        // ⭐ v6.1.18: Linhas da lista do lote vão sem conversão (nomes); a lista
+        // colada é lida de uma vez para não estourar o buffer de RX do Serial
+        while (bioBatch.isReceiving()) {
+            bioBatch.feedLine(cmd);
+            cmd = "";
+            if (!Serial.available()) break;
+            cmd = Serial.readStringUntil('\n');
+            cmd.trim();
+        }
         cmd.toUpperCase();  // Converte para maiúsculas
         
         if (cmd.startsWith("P") && cmd.length() == 2) {
@@ -1604,7 +2078,8 @@ void loop() {
         }
     }
     
-    delay(5);
+    // ⭐ v6.1.7: Tela apagada → loop mais lento (sensores continuam sendo lidos)
+    delay(idleManager.isOff() ? IDLE_OFF_LOOP_DELAY_MS : 5);
     esp_task_wdt_reset();
 }
 
@@ -1612,53 +2087,118 @@ void loop() {
 // GERENCIAMENTO DE TELAS
 // ========================================
 
+/**
+ * @brief Telas mantidas vivas (ocultas) entre trocas
+ * ⭐ v6.1.3: HOME é exibida após cada timeout de autenticação e AJUDA é
+ * estática; as demais continuam sendo criadas sob demanda e destruídas.
+ */
+static bool tela_persistente(Screen tela) {
+    #if SCREEN_CACHE_ENABLED
+    return tela == SCREEN_HOME || tela == SCREEN_CONTROLS;
+    #else
+    return false;
+    #endif
+}
+
+/**
+ * @brief Reaplica os dados dinâmicos da HOME ao reexibi-la do cache
+ * Deixa a tela no mesmo estado visual de uma HOME recém-criada.
+ */
+static void rebind_tela_home() {
+    auth_view_set(AUTH_VIEW_PIN, "----");
+    
+    // Botões de modo: ACESSO destacado, BIO/RFID neutros
+    for (int i = 0; i < 6; i++) {
+        if (nav_buttons[i] == NULL) continue;
+        if (i == 0) {
+            lv_obj_set_style_bg_color(nav_buttons[i], lv_color_hex(COLOR_BLUE), 0);
+            lv_obj_set_style_border_width(nav_buttons[i], 0, 0);
+        } else {
+            lv_obj_set_style_bg_color(nav_buttons[i], lv_color_hex(0x252540), 0);
+            lv_obj_set_style_border_color(nav_buttons[i], lv_color_hex(0x404060), 0);
+            lv_obj_set_style_border_width(nav_buttons[i], 1, 0);
+        }
+    }
+    
+    if (home_message_label != NULL) {
+        lv_obj_add_flag(home_message_label, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
 void mudar_tela(Screen nova_tela) {
     Serial.printf("🔄 Mudando tela: %d → %d\n", currentScreen, nova_tela);
+    uint32_t t0 = micros();
     
+    Screen tela_anterior = currentScreen;
     currentScreen = nova_tela;
+    lvgl_mem_set_tag(nova_tela);  // ⭐ v6.1.5: Alocações a partir daqui contam para a nova tela
+    render_prof_set_screen(nova_tela);  // ⭐ v6.1.6: Frames a partir daqui contam para a nova tela
     
-    // Limpar conteúdo anterior
+    // Limpar conteúdo anterior (telas persistentes só são ocultadas)
     if (content_container != NULL) {
-        lv_obj_del(content_container);
+        if (screen_cache[tela_anterior] == content_container) {
+            lv_obj_add_flag(content_container, LV_OBJ_FLAG_HIDDEN);
+            if (tela_anterior == SCREEN_HOME && home_message_label != NULL) {
+                lv_obj_add_flag(home_message_label, LV_OBJ_FLAG_HIDDEN);
+            }
+        } else {
+            lv_obj_del(content_container);
+        }
         content_container = NULL;
     }
     
-    // ⭐ LAYOUT ATUALIZADO: Header(20px) + Content(300px) = 320px (SEM FOOTER)
-    content_container = lv_obj_create(lv_scr_act());
-    lv_obj_set_size(content_container, 480, 300);
-    lv_obj_align(content_container, LV_ALIGN_TOP_LEFT, 0, 20);
-    lv_obj_set_style_bg_color(content_container, lv_color_hex(COLOR_BG_DARK), 0);
-    lv_obj_set_style_border_width(content_container, 0, 0);
-    lv_obj_set_style_pad_all(content_container, 6, 0);
-    lv_obj_clear_flag(content_container, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_clear_flag(content_container, LV_OBJ_FLAG_CLICKABLE); // ⭐ NÃO capturar eventos
-    
-    // Renderizar conteúdo da tela
-    switch (nova_tela) {
-        case SCREEN_HOME:
-            criar_conteudo_home();
-            break;
-        case SCREEN_BIOMETRIC:
-            criar_conteudo_biometric();
-            break;
-        case SCREEN_RFID:
-            criar_conteudo_rfid();
-            break;
-        case SCREEN_MAINTENANCE:
-            criar_conteudo_maintenance();
-            break;
-        case SCREEN_CONTROLS:
-            criar_conteudo_controls();
-            break;
-        case SCREEN_SETTINGS:
-            criar_conteudo_settings();
-            break;
-        case SCREEN_CALIBRATION:
-            criar_conteudo_calibration();
-            break;
-        case SCREEN_ADMIN_AUTH:
-            criar_conteudo_admin_auth();
-            break;
+    // ⭐ v6.1.3: Tela já em cache → apenas reexibir e reaplicar dados
+    bool from_cache = (screen_cache[nova_tela] != NULL);
+    if (from_cache) {
+        content_container = screen_cache[nova_tela];
+        lv_obj_clear_flag(content_container, LV_OBJ_FLAG_HIDDEN);
+        if (nova_tela == SCREEN_HOME) {
+            rebind_tela_home();
+        }
+    } else {
+        // ⭐ LAYOUT ATUALIZADO: Header(20px) + Content(300px) = 320px (SEM FOOTER)
+        content_container = lv_obj_create(lv_scr_act());
+        lv_obj_set_size(content_container, 480, 300);
+        lv_obj_align(content_container, LV_ALIGN_TOP_LEFT, 0, 20);
+        lv_obj_set_style_bg_color(content_container, lv_color_hex(COLOR_BG_DARK), 0);
+        lv_obj_set_style_border_width(content_container, 0, 0);
+        lv_obj_set_style_pad_all(content_container, 6, 0);
+        lv_obj_clear_flag(content_container, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_clear_flag(content_container, LV_OBJ_FLAG_CLICKABLE); // ⭐ NÃO capturar eventos
+
+        // Renderizar conteúdo da tela
+        switch (nova_tela) {
+            case SCREEN_HOME:
+                criar_conteudo_home();
+                break;
+            case SCREEN_BIOMETRIC:
+                criar_conteudo_biometric();
+                break;
+            case SCREEN_RFID:
+                criar_conteudo_rfid();
+                break;
+            case SCREEN_MAINTENANCE:
+                criar_conteudo_maintenance();
+                break;
+            case SCREEN_CONTROLS:
+                criar_conteudo_controls();
+                break;
+            case SCREEN_SETTINGS:
+                criar_conteudo_settings();
+                break;
+            case SCREEN_CALIBRATION:
+                criar_conteudo_calibration();
+                break;
+            case SCREEN_ADMIN_AUTH:
+                criar_conteudo_admin_auth();
+                break;
+            default:
+                break;
+        }
+
+        if (tela_persistente(nova_tela)) {
+            screen_cache[nova_tela] = content_container;
+        }
     }
     
     // Atualizar navegação (apenas se os botões existirem - HOME screen)
@@ -1666,6 +2206,16 @@ void mudar_tela(Screen nova_tela) {
         atualizar_navegacao();
     }
     
+    // ⭐ v6.1.3: Tempo de troca e uso de memória LVGL
+    // ⭐ v6.1.5: lv_mem_monitor() não funciona com LV_MEM_CUSTOM → estatísticas do lvgl_mem
+    uint32_t dt = micros() - t0;
+    LvglMemStats mem;
+    lvgl_mem_get_stats(&mem);
+    Serial.printf("⏱️  Tela %s %s em %lu us | LVGL mem: PSRAM %u%% usado, %u%% frag | interna %u bytes | pico da tela %u bytes\n",
+                  screen_names[nova_tela], from_cache ? "reexibida (cache)" : "criada",
+                  (unsigned long)dt, mem.used_pct, mem.frag_pct, (unsigned)mem.internal_used,
+                  (unsigned)lvgl_mem_tag_peak(nova_tela));
+    
     esp_task_wdt_reset();
 }
 
@@ -1732,12 +2282,136 @@ void processar_comando_calibracao(String cmd) {
         Serial.println("LOAD       - Carregar calibração da Flash");
         Serial.println("RESET      - Resetar para valores padrão");
         Serial.println("TEST       - Entrar em modo de teste");
+        Serial.println("MEM        - Memória LVGL (uso, fragmentação, pico por tela)");
+        Serial.println("IDLE       - Estado de ociosidade e latência de despertar");
+        Serial.println("SPI        - Uso do barramento SPI2 por dispositivo");
+        Serial.println("BOOT       - Perfil do boot (etapas e tempo até porta pronta)");
+        Serial.println("DISPLAY    - Reaplicar registradores do display e redesenhar");
+        Serial.println("TPL BACKUP - Salvar templates do AS608 em " TPL_ARCHIVE_FILE);
+        Serial.println("TPL RESTORE- Gravar no AS608 os templates do arquivo");
+        Serial.println("TPL STATUS - Progresso/vazão do último backup ou restauração");
+        Serial.println("BIO INDEX  - Ler tabela de índice do AS608 e conferir com os metadados");
+        Serial.println("BIO COMPACT- Mover templates para os slots mais baixos (busca menor)");
+        Serial.println("BIO SEARCH - Latência da busca 1:N por quantidade de páginas");
+        Serial.println("RFID LINK n id - Vincular cartão n (lista RFID) à digital id (0 = desvincular)");
+        Serial.println("ROSTER LOAD- Receber lista do lote (linhas 'slot,nome'; ROSTER END encerra)");
+        Serial.println("BATCH START- Iniciar/continuar o cadastro em lote");
+        Serial.println("BATCH PAUSE- Pausar o lote (progresso fica salvo)");
+        Serial.println("BATCH SKIP - Pular o usuário atual do lote");
+        Serial.println("BATCH STATUS - Progresso do lote e usuários por minuto");
+        Serial.println("BATCH CLEAR- Apagar lista e progresso do lote");
+        Serial.println("RELAY LOG  - Últimos acionamentos do relé (tempo aberto medido)");
+        Serial.println("API STATS  - Requisições/s da API HTTP e intervalo do loop no período");
+        Serial.println("PROF ON    - Ativar profiler de renderização + overlay FPS");
+        Serial.println("PROF OFF   - Desativar profiler");
+        Serial.println("PROF DUMP  - Agregados por tela (render/flush/pixels/handler)");
         Serial.println("HELP       - Mostrar esta ajuda");
         Serial.println("═══════════════════════════════════════\n");
     }
     else if (cmd == "STATUS") {
         imprimir_status_calibracao();
     }
+    else if (cmd == "MEM") {
+        lvgl_mem_print_stats(screen_names, SCREEN_COUNT);
+    }
+    else if (cmd == "IDLE") {
+        idleManager.printStatus();
+    }
+    else if (cmd == "SPI") {
+        spiArbiter.printStats();
+    }
+    else if (cmd == "BOOT") {
+        bootProfiler.print();
+    }
+    else if (cmd == "DISPLAY") {
+        uint32_t dt = display_health_repair(true);
+        Serial.printf("🩺 Display: registradores reaplicados em %lu us (reparo #%lu)\n",
+                      (unsigned long)dt, (unsigned long)display_repairs);
+    }
+    else if (cmd == "TPL BACKUP") {
+        if (!templateArchive.startBackup()) templateArchive.printStatus();
+    }
+    else if (cmd == "TPL RESTORE") {
+        if (!templateArchive.startRestore()) templateArchive.printStatus();
+    }
+    else if (cmd == "TPL STATUS") {
+        templateArchive.printStatus();
+    }
+    else if (cmd == "BIO INDEX") {
+        if (!bioManager.isReady()) {
+            Serial.println("❌ AS608 indisponível");
+        } else {
+            bioManager.reconcileSensor();
+        }
+    }
+    else if (cmd == "BIO COMPACT") {
+        if (!bioManager.isReady()) {
+            Serial.println("❌ AS608 indisponível");
+        } else if (bioBatch.hasRoster() || templateArchive.busy()) {
+            // ⭐ v6.1.20: Lista do lote e backup de templates guardam slots fixos
+            Serial.println("❌ Lista do lote (BATCH CLEAR) ou backup de templates em andamento");
+        } else {
+            bioManager.compactSlots();
+        }
+    }
+    else if (cmd == "BIO SEARCH") {
+        bioManager.printSearchStats();
+    }
+    else if (cmd == "ROSTER LOAD") {
+        bioBatch.beginReceive();  // ⭐ v6.1.18
+    }
+    else if (cmd == "BATCH START") {
+        if (!bioBatch.start()) bioBatch.printStatus();
+    }
+    else if (cmd == "BATCH PAUSE") {
+        bioBatch.pause();
+    }
+    else if (cmd == "BATCH SKIP") {
+        bioBatch.skip();
+    }
+    else if (cmd == "BATCH STATUS") {
+        bioBatch.printStatus();
+    }
+    else if (cmd == "BATCH CLEAR") {
+        bioBatch.clear();
+    }
+    else if (cmd == "RELAY LOG") {
+        // ⭐ v6.1.19: Travamento pelo esp_timer, eventos com timestamp
+        #if RELAY_ENABLED
+        relayController.printEvents();
+        #else
+        Serial.println("💡 RELAY_ENABLED=false (relé não ativado)");
+        #endif
+    }
+    else if (cmd == "API STATS") {
+        // ⭐ v6.1.19: AsyncWebServer - carga da API × latência do loop
+        #if WIFI_ENABLED
+        printApiStats(loopStatMaxUs, loopStatCount ? (uint32_t)(loopStatSumUs / loopStatCount) : 0);
+        #endif
+        loopStatMaxUs = 0;
+        loopStatSumUs = 0;
+        loopStatCount = 0;
+    }
+    else if (cmd.startsWith("RFID LINK")) {
+        // ⭐ v6.1.17: Cartão + digital (AUTH_CARD_AND_FINGER)
+        int n = 0, id = -1;
+        if (sscanf(cmd.c_str(), "RFID LINK %d %d", &n, &id) != 2 || id < 0) {
+            Serial.println("❌ Uso: RFID LINK <cartão 1..N> <ID da digital | 0>");
+        } else if (id > 0 && bioManager.findFingerprintIndex(id) < 0) {
+            Serial.printf("❌ Digital ID=%d não cadastrada\n", id);
+        } else if (!rfidManager.linkFinger(n - 1, id)) {
+            Serial.printf("❌ Cartão %d não existe (total: %d)\n", n, rfidManager.getCardCount());
+        }
+    }
+    else if (cmd == "PROF ON") {
+        render_prof_enable(true);
+    }
+    else if (cmd == "PROF OFF") {
+        render_prof_enable(false);
+    }
+    else if (cmd == "PROF DUMP") {
+        render_prof_print(screen_names, SCREEN_COUNT);
+    }
     else if (cmd == "SAVE") {
         salvar_calibracao();
     }
@@ -1903,8 +2577,7 @@ void btn_pin_number_clicked(lv_event_t * e) {
 void btn_pin_clear_clicked(lv_event_t * e) {
     Serial.println("🗑️ Botão CLR clicado!");
     currentPin = "";
-    lv_label_set_text(pin_display_label, "----");
-    lv_obj_set_style_text_color(pin_display_label, lv_color_hex(COLOR_ACCENT), 0);
+    auth_view_set(AUTH_VIEW_PIN, "----");
     Serial.println("🗑️ PIN limpo");
 }
 
@@ -1931,12 +2604,10 @@ void btn_pin_confirm_clicked(lv_event_t * e) {
     
     if (currentPin == correctPin) {
         Serial.println("✅ PIN CORRETO! Liberando acesso...");
-        lv_label_set_text(pin_display_label, "ACESSO OK!");
-        lv_obj_set_style_text_color(pin_display_label, lv_color_hex(COLOR_SUCCESS), 0);
+        auth_view_set(AUTH_VIEW_GRANTED, "ACESSO OK!");
     } else {
         Serial.printf("❌ PIN INCORRETO! Esperado: %s, Recebido: %s\n", correctPin.c_str(), currentPin.c_str());
-        lv_label_set_text(pin_display_label, "PIN ERRADO!");
-        lv_obj_set_style_text_color(pin_display_label, lv_color_hex(COLOR_ERROR), 0);
+        auth_view_set(AUTH_VIEW_DENIED, "PIN ERRADO!");
     }
     
     currentPin = "";
@@ -1953,6 +2624,91 @@ void btn_pin_confirm_clicked(lv_event_t * e) {
 // ⭐ Array ESTÁTICO para preservar os ponteiros
 static const char * keypad_numeros[] = {"1","2","3","4","5","6","7","8","9","*","0","#"};
 
+// ════════════════════════════════════════════════════════════════
+// ⭐ v6.1.4: ESTILOS COMPARTILHADOS DA CAIXA DE AUTENTICAÇÃO
+// ════════════════════════════════════════════════════════════════
+// Estilos estáticos inicializados uma vez; trocar de estado é remover o
+// estilo do estado anterior e adicionar o do novo (sem alocar estilos
+// locais a cada leitura). O redesenho acontece no ciclo normal do LVGL.
+
+static lv_style_t auth_style_box_base;
+static lv_style_t auth_style_label_base;
+static lv_style_t auth_style_box[AUTH_VIEW_COUNT];
+static lv_style_t auth_style_label[AUTH_VIEW_COUNT];
+static bool auth_styles_prontos = false;
+static AuthView auth_view_atual = AUTH_VIEW_PIN;
+
+static void auth_styles_init() {
+    if (auth_styles_prontos) return;
+    
+    static const uint32_t cores[AUTH_VIEW_COUNT] = {
+        COLOR_ACCENT,   // PIN
+        0xa78bfa,       // BIO
+        0x06b6d4,       // RFID
+        0x10b981,       // Concedido
+        0xef4444,       // Negado
+        0xf59e0b        // Não cadastrado
+    };
+    
+    lv_style_init(&auth_style_box_base);
+    lv_style_set_bg_color(&auth_style_box_base, lv_color_hex(0x0A0A1A));  // Fundo escuro original
+    lv_style_set_border_width(&auth_style_box_base, 2);
+    lv_style_set_radius(&auth_style_box_base, 4);
+    
+    lv_style_init(&auth_style_label_base);
+    lv_style_set_text_font(&auth_style_label_base, &lv_font_montserrat_20);
+    lv_style_set_text_align(&auth_style_label_base, LV_TEXT_ALIGN_CENTER);
+    
+    for (int i = 0; i < AUTH_VIEW_COUNT; i++) {
+        lv_style_init(&auth_style_box[i]);
+        lv_style_set_border_color(&auth_style_box[i], lv_color_hex(cores[i]));
+        lv_style_init(&auth_style_label[i]);
+        lv_style_set_text_color(&auth_style_label[i], lv_color_hex(cores[i]));
+    }
+    
+    auth_styles_prontos = true;
+}
+
+/**
+ * @brief Aplica os estilos base + estado PIN a uma caixa recém-criada
+ */
+void auth_view_attach(lv_obj_t * box, lv_obj_t * label) {
+    auth_styles_init();
+    lv_obj_add_style(box, &auth_style_box_base, 0);
+    lv_obj_add_style(box, &auth_style_box[AUTH_VIEW_PIN], 0);
+    lv_obj_add_style(label, &auth_style_label_base, 0);
+    lv_obj_add_style(label, &auth_style_label[AUTH_VIEW_PIN], 0);
+    auth_view_atual = AUTH_VIEW_PIN;
+}
+
+/**
+ * @brief Troca o estado visual da caixa de autenticação
+ * @param view Novo estado (PIN/BIO/RFID/concedido/negado/não cadastrado)
+ * @param texto Texto exibido
+ */
+void auth_view_set(AuthView view, const char* texto) {
+    if (auth_display_box == NULL || auth_display_label == NULL) return;
+    
+    if (view != auth_view_atual) {
+        lv_obj_remove_style(auth_display_box, &auth_style_box[auth_view_atual], 0);
+        lv_obj_remove_style(auth_display_label, &auth_style_label[auth_view_atual], 0);
+        lv_obj_add_style(auth_display_box, &auth_style_box[view], 0);
+        lv_obj_add_style(auth_display_label, &auth_style_label[view], 0);
+        auth_view_atual = view;
+    }
+    
+    // Modos de entrada definem o tamanho; resultados mantêm o tamanho do modo
+    if (view == AUTH_VIEW_PIN) {
+        lv_obj_set_size(auth_display_box, 200, 50);
+    } else if (view == AUTH_VIEW_BIO || view == AUTH_VIEW_RFID) {
+        lv_obj_set_size(auth_display_box, 200, 70);
+    }
+    
+    lv_obj_clear_flag(auth_display_box, LV_OBJ_FLAG_HIDDEN);
+    lv_label_set_text(auth_display_label, texto);
+    lv_obj_align(auth_display_label, LV_ALIGN_CENTER, 0, 0);
+}
+
 void criar_conteudo_home() {
     Serial.println("🏠 Criando TELA HOME - Layout 2 Colunas Organizado");
     
@@ -1997,21 +2753,16 @@ void criar_conteudo_home() {
     auth_display_box = lv_obj_create(left_column);  // ⭐ DIRETO no left_column!
     lv_obj_set_size(auth_display_box, 200, 50);  // Tamanho inicial PIN (menor)
     lv_obj_set_pos(auth_display_box, 17, 10);  // Posição absoluta: X=17 (centralizado), Y=10
-    lv_obj_set_style_bg_color(auth_display_box, lv_color_hex(0x0A0A1A), 0);
-    lv_obj_set_style_border_color(auth_display_box, lv_color_hex(COLOR_ACCENT), 0);  // Azul padrão (PIN)
-    lv_obj_set_style_border_width(auth_display_box, 2, 0);
-    lv_obj_set_style_radius(auth_display_box, 4, 0);
     lv_obj_clear_flag(auth_display_box, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_clear_flag(auth_display_box, LV_OBJ_FLAG_CLICKABLE);
     
     auth_display_label = lv_label_create(auth_display_box);
     lv_obj_set_width(auth_display_label, 180);  // ⭐ Largura fixa ANTES do texto
     lv_label_set_long_mode(auth_display_label, LV_LABEL_LONG_WRAP);  // ⭐ Wrap ANTES do texto
-    lv_label_set_text(auth_display_label, "----");  // Texto inicial (PIN)
-    lv_obj_set_style_text_font(auth_display_label, &lv_font_montserrat_20, 0);
-    lv_obj_set_style_text_color(auth_display_label, lv_color_hex(COLOR_ACCENT), 0);  // Azul padrão
-    lv_obj_set_style_text_align(auth_display_label, LV_TEXT_ALIGN_CENTER, 0);
-    lv_obj_align(auth_display_label, LV_ALIGN_CENTER, 0, 0);  // ⭐ CORRIGIDO: align() ao invés de center()
+    
+    // ⭐ v6.1.4: Fundo/borda/fonte/cor vêm dos estilos compartilhados (estado PIN)
+    auth_view_attach(auth_display_box, auth_display_label);
+    auth_view_set(AUTH_VIEW_PIN, "----");  // Texto inicial (PIN)
     lv_obj_move_foreground(auth_display_box);  // ⭐ v6.0.46: Box sempre na frente!
     lv_obj_add_flag(left_column, LV_OBJ_FLAG_OVERFLOW_VISIBLE);  // ⭐ PERMITIR OVERFLOW!
     
@@ -2119,19 +2870,7 @@ void criar_conteudo_home() {
                 
                 // ⭐ v6.0.52: Modo PIN - AZUL VIBRANTE COM FUNDO ESCURO ORIGINAL
                 Serial.printf("   🔧 Mudando para modo PIN (box: %p, label: %p)\n", auth_display_box, auth_display_label);
-                lv_obj_set_size(auth_display_box, 200, 50);  // Tamanho PIN (menor)
-                lv_obj_set_width(auth_display_label, 180);
-                lv_label_set_long_mode(auth_display_label, LV_LABEL_LONG_WRAP);
-                lv_obj_set_style_bg_color(auth_display_box, lv_color_hex(0x0A0A1A), 0);  // ⭐ Fundo escuro original
-                lv_obj_set_style_border_color(auth_display_box, lv_color_hex(COLOR_ACCENT), 0);  // Borda azul
-                lv_label_set_text(auth_display_label, "----");
-                lv_obj_set_style_text_font(auth_display_label, &lv_font_montserrat_20, 0);  // Fonte grande
-                lv_obj_set_style_text_color(auth_display_label, lv_color_hex(COLOR_ACCENT), 0);  // Azul
-                lv_obj_set_style_text_align(auth_display_label, LV_TEXT_ALIGN_CENTER, 0);
-                lv_obj_align(auth_display_label, LV_ALIGN_CENTER, 0, 0);
-                lv_obj_move_foreground(auth_display_box);  // Trazer para frente
-                lv_obj_invalidate(auth_display_box);  // Forçar redesenho
-                lv_obj_invalidate(auth_display_label);  // Forçar redesenho do label
+                auth_view_set(AUTH_VIEW_PIN, "----");  // ⭐ v6.1.4: Estilo compartilhado
                 Serial.printf("   ✅ Modo PIN ativado: Texto='%s', Cor=AZUL/BRANCO\n", lv_label_get_text(auth_display_label));
                 Serial.printf("   📊 Box: %dx%d, Hidden=%d, Label: '%s'\n", 
                     lv_obj_get_width(auth_display_box), 
@@ -2151,19 +2890,7 @@ void criar_conteudo_home() {
                 
                 // ⭐ v6.0.52: Modo BIO - ROXO VIBRANTE COM FUNDO ESCURO ORIGINAL
                 Serial.printf("   🔧 Mudando para modo BIO (box: %p, label: %p)\n", auth_display_box, auth_display_label);
-                lv_obj_set_size(auth_display_box, 200, 70);  // Tamanho BIO (maior)
-                lv_obj_set_width(auth_display_label, 180);
-                lv_label_set_long_mode(auth_display_label, LV_LABEL_LONG_WRAP);
-                lv_obj_set_style_bg_color(auth_display_box, lv_color_hex(0x0A0A1A), 0);  // ⭐ Fundo escuro original
-                lv_obj_set_style_border_color(auth_display_box, lv_color_hex(0xa78bfa), 0);  // Borda roxa
-                lv_label_set_text(auth_display_label, "Posicione\ndedo...");
-                lv_obj_set_style_text_font(auth_display_label, &lv_font_montserrat_20, 0);  // ⭐ Fonte grande
-                lv_obj_set_style_text_color(auth_display_label, lv_color_hex(0xa78bfa), 0);  // Roxo
-                lv_obj_set_style_text_align(auth_display_label, LV_TEXT_ALIGN_CENTER, 0);
-                lv_obj_align(auth_display_label, LV_ALIGN_CENTER, 0, 0);
-                lv_obj_move_foreground(auth_display_box);  // Trazer para frente
-                lv_obj_invalidate(auth_display_box);  // Forçar redesenho
-                lv_obj_invalidate(auth_display_label);  // Forçar redesenho do label
+                auth_view_set(AUTH_VIEW_BIO, "Posicione\ndedo...");  // ⭐ v6.1.4: Estilo compartilhado
                 Serial.printf("   ✅ Modo BIO ativado: Texto='%s', Cor=ROXO/BRANCO\n", lv_label_get_text(auth_display_label));
                 Serial.printf("   📊 Box: %dx%d, Hidden=%d, Label: '%s'\n", 
                     lv_obj_get_width(auth_display_box), 
@@ -2180,25 +2907,11 @@ void criar_conteudo_home() {
                 Serial.println("💳 Botão RFID clicado!");
                 Serial.println("💳 Leitura RFID solicitada");
                 
-                // ⭐ v6.0.52: Modo RFID - COM REDESENHO FORÇADO
+                // ⭐ v6.0.52: Modo RFID - CIANO COM FUNDO ESCURO ORIGINAL
                 Serial.printf("   🔧 Mudando para modo RFID (box: %p, label: %p)\n", auth_display_box, auth_display_label);
-                lv_obj_clear_flag(auth_display_box, LV_OBJ_FLAG_HIDDEN);  // ⭐ GARANTIR visível ANTES!
-                lv_obj_set_size(auth_display_box, 200, 70);  // Tamanho RFID (maior)
-                lv_obj_set_width(auth_display_label, 180);
-                lv_label_set_long_mode(auth_display_label, LV_LABEL_LONG_WRAP);
-                lv_obj_set_style_bg_color(auth_display_box, lv_color_hex(0x0A0A1A), 0);  // Fundo escuro original
-                lv_obj_set_style_border_color(auth_display_box, lv_color_hex(0x06b6d4), 0);  // Borda ciano
-                lv_label_set_text(auth_display_label, "Aproxime\ncartao...");
-                lv_obj_set_style_text_font(auth_display_label, &lv_font_montserrat_20, 0);  // Fonte grande
-                lv_obj_set_style_text_color(auth_display_label, lv_color_hex(0x06b6d4), 0);  // Ciano
-                lv_obj_set_style_text_align(auth_display_label, LV_TEXT_ALIGN_CENTER, 0);
-                lv_obj_align(auth_display_label, LV_ALIGN_CENTER, 0, 0);
-                lv_obj_move_foreground(auth_display_box);  // Trazer para frente
-                lv_obj_invalidate(auth_display_box);  // Forçar redesenho
-                lv_obj_invalidate(auth_display_label);  // Forçar redesenho do label
-                lv_refr_now(NULL);  // ⭐ FORÇAR REDESENHO IMEDIATO!
+                auth_view_set(AUTH_VIEW_RFID, "Aproxime\ncartao...");  // ⭐ v6.1.4: Estilo compartilhado (sem lv_refr_now)
                 Serial.printf("   ✅ Modo RFID ativado: Texto='%s', Cor=CIANO/BRANCO\n", lv_label_get_text(auth_display_label));
-                Serial.printf("   📊 Box APÓS lv_refr_now(): %dx%d, Label: '%s'\n", 
+                Serial.printf("   📊 Box: %dx%d, Label: '%s'\n", 
                     lv_obj_get_width(auth_display_box), 
                     lv_obj_get_height(auth_display_box),
                     lv_label_get_text(auth_display_label));
@@ -3382,7 +4095,9 @@ void criar_settings_rfid() {
     lv_obj_set_flex_align(rfid_list_container, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
     lv_obj_set_scrollbar_mode(rfid_list_container, LV_SCROLLBAR_MODE_AUTO);
     
-    // Listar cartões cadastrados
+    // Listar cartões cadastrados (⭐ v6.1.19: lista travada contra a API HTTP)
+    RFIDLock cardsLock(rfidManager);
+    card_count = rfidManager.getCardCount();
     for (int i = 0; i < card_count && i < 10; i++) {
         RFIDCard* card = rfidManager.getCard(i);
         if (!card) continue;
@@ -4001,7 +4716,7 @@ void processar_cadastro_biometrico() {
                 break;
                 
             case BIO_ERROR_FULL:
-                lv_label_set_text(bio_status_label, "Memória cheia (127 digitais)");
+                lv_label_set_text_fmt(bio_status_label, "Memória cheia (%d digitais)", bioManager.getCapacity());
                 lv_obj_set_style_text_color(bio_status_label, lv_color_hex(0xef4444), 0);
                 bio_enrolling = false;
                 break;
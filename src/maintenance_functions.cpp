@@ -1,8 +1,8 @@
 /**
  * @file maintenance_functions.cpp
  * @brief Implementação das funções do sistema de requisição de manutenção
- * @version 1.0.0
- * @date 2025-11-24
+ * @version 1.1.0
+ * @date 2025-12-05
  * 
  * Este arquivo contém todas as funções auxiliares para o sistema de
  * requisição de manutenção, incluindo validação, salvamento e envio de e-mail.
@@ -15,6 +15,8 @@
 #include <lvgl.h>
 #include "maintenance_types.h"
 #include "smtp_config.h"
+#include "maintenance_store.h"  // ⭐ v1.1.0: Store indexado em LittleFS
+#include "email_template.h"     // ⭐ v1.1.0: Template HTML em flash
 
 // Referências externas
 extern lv_obj_t * manut_keyboard;
@@ -142,138 +144,34 @@ void evento_cancelar_requisicao(lv_event_t * e) {
 }
 
 /**
- * @brief Salva requisição no NVS (memória não-volátil)
+ * @brief Salva requisição no armazenamento persistente
+ * @note ⭐ v1.1.0: Antes gravava blobs "req_NNNNN" no NVS (20KB, nunca limpos).
+ *       Agora usa MaintenanceStore (LittleFS + índice por status + retenção).
+ *       Nome mantido para compatibilidade com main.cpp.
  */
 bool salvar_requisicao_nvs(const MaintenanceRequest* req) {
-    Preferences prefs;
-    
-    if (!prefs.begin("manutencao", false)) {
-        Serial.println("❌ Erro ao abrir namespace NVS 'manutencao'");
+    if (!maintenanceStore.save(req)) {
+        Serial.printf("❌ Erro ao salvar requisição #%05u\n", req->id);
         return false;
     }
-    
-    // Gera chave única: req_00001, req_00002, etc
-    char key[16];
-    snprintf(key, sizeof(key), "req_%05u", req->id);
-    
-    // Salva estrutura completa como blob binário
-    size_t written = prefs.putBytes(key, req, sizeof(MaintenanceRequest));
-    
-    bool success = (written == sizeof(MaintenanceRequest));
-    
-    if (success) {
-        // Atualiza contador global
-        prefs.putUInt("req_counter", req->id);
-        
-        // Incrementa contador de pendentes se não enviado
-        if (!req->email_enviado) {
-            uint16_t pending = prefs.getUInt("pending_count", 0);
-            prefs.putUInt("pending_count", pending + 1);
-        }
-        
-        Serial.printf("✅ Requisição #%05u salva no NVS (chave: %s)\\n", req->id, key);
-    } else {
-        Serial.printf("❌ Erro ao salvar no NVS: esperado %u bytes, gravado %u bytes\\n", 
-                     sizeof(MaintenanceRequest), written);
-    }
-    
-    prefs.end();
-    return success;
+    return true;
 }
 
 /**
  * @brief Monta corpo do e-mail em HTML profissional
+ * @note ⭐ v1.1.0: Renderizado a partir de template em flash para um único
+ *       buffer de tamanho exato (sem "String +="). Liberar com free().
  */
-String montar_corpo_email_html(const MaintenanceRequest* req) {
-    String html = "<!DOCTYPE html><html><head><meta charset='UTF-8'><style>";
-    
-    // CSS inline
-    html += "body{font-family:Arial,sans-serif;background:#f3f4f6;margin:0;padding:20px;}";
-    html += ".container{max-width:600px;margin:0 auto;background:white;border-radius:8px;overflow:hidden;box-shadow:0 4px 6px rgba(0,0,0,0.1);}";
-    html += ".header{background:#1a1a2e;color:#FBBF24;padding:25px;text-align:center;}";
-    html += ".header h2{margin:0;font-size:24px;}";
-    html += ".header p{margin:5px 0 0 0;opacity:0.8;font-size:14px;}";
-    html += ".content{padding:25px;}";
-    html += ".field{margin:18px 0;border-left:4px solid #E5E7EB;padding-left:15px;}";
-    html += ".field-label{font-weight:bold;color:#6B7280;font-size:11px;text-transform:uppercase;margin-bottom:6px;}";
-    html += ".field-value{color:#1F2937;font-size:15px;background:#F9FAFB;padding:12px;border-radius:6px;}";
-    html += ".priority-badge{display:inline-block;padding:10px 18px;border-radius:6px;color:white;font-weight:bold;}";
-    html += ".footer{text-align:center;padding:20px;color:#9CA3AF;font-size:12px;border-top:1px solid #E5E7EB;}";
-    html += "</style></head><body><div class='container'>";
-    
-    // Header
-    html += "<div class='header'>";
-    html += "<h2>🔧 REQUISIÇÃO DE MANUTENÇÃO</h2>";
-    html += "<p>Requisição #";
-    html += req->id;
-    html += "</p>";
-    html += "</div>";
-    
-    // Content
-    html += "<div class='content'>";
-    
-    // Prioridade com destaque
-    html += "<div class='field' style='border-left-color:";
-    html += prioridadeToColor(req->prioridade);
-    html += ";'><div class='field-label'>PRIORIDADE</div>";
-    html += "<span class='priority-badge' style='background:";
-    html += prioridadeToColor(req->prioridade);
-    html += ";'>";
-    html += prioridadeToString(req->prioridade);
-    html += "</span></div>";
-    
-    // Local
-    html += "<div class='field'><div class='field-label'>LOCAL</div>";
-    html += "<div class='field-value'>";
-    html += req->local_nome;
-    html += "</div></div>";
-    
-    // Problema/Defeito
-    html += "<div class='field'><div class='field-label'>PROBLEMA / DEFEITO RELATADO</div>";
-    html += "<div class='field-value'>";
-    html += req->problema;
-    html += "</div></div>";
-    
-    // Contato (se fornecido)
-    if (strlen(req->contato) > 0) {
-        html += "<div class='field'><div class='field-label'>CONTATO</div>";
-        html += "<div class='field-value'>";
-        html += req->contato;
-        html += "</div></div>";
-    }
-    
-    // Data e Hora
-    html += "<div class='field'><div class='field-label'>DATA E HORA</div>";
-    html += "<div class='field-value'>";
-    html += "📅 ";
-    html += req->datetime;
-    html += "</div></div>";
-    
-    // Informações do Sistema
-    html += "<div class='field'><div class='field-label'>INFORMAÇÕES DO SISTEMA</div>";
-    html += "<div class='field-value'>";
-    html += "🌐 <strong>IP:</strong> ";
-    html += req->ip_origem;
-    html += "<br>";
-    html += "🔌 <strong>MAC:</strong> ";
-    html += req->mac_address;
-    html += "<br>";
-    html += "💾 <strong>Firmware:</strong> v";
-    html += req->versao_firmware;
-    html += "</div></div>";
-    
-    html += "</div>";  // Fecha content
-    
-    // Footer
-    html += "<div class='footer'>";
-    html += "<strong>Sistema de Controle de Acesso ESP32-S3</strong><br>";
-    html += "Este é um e-mail automático.<br>";
-    html += "Em caso de dúvidas, contate a equipe de TI.";
-    html += "</div>";
-    
-    html += "</div></body></html>";
-    
-    return html;
+char* montar_corpo_email_html(const MaintenanceRequest* req, size_t* len) {
+    return email_render_manutencao(req, len);
+}
+
+/**
+ * @brief Loga estado do heap interno (diagnóstico do envio SMTP)
+ */
+static void log_heap_email(const char* fase) {
+    Serial.printf("🧠 Heap [%s]: livre=%u | mínimo=%u | maior bloco=%u\n",
+                  fase, ESP.getFreeHeap(), ESP.getMinFreeHeap(), ESP.getMaxAllocHeap());
 }
 
 /**
@@ -355,9 +253,18 @@ bool enviar_email_smtp(const MaintenanceRequest* req) {
     // Destinatário
     message.addRecipient("Manutenção", recipient.c_str());
     
-    // Corpo HTML
-    String htmlBody = montar_corpo_email_html(req);
-    message.html.content = htmlBody.c_str();
+    // Corpo HTML (buffer único, liberado ao final)
+    log_heap_email("antes do corpo");
+    size_t htmlLen = 0;
+    char* htmlBody = montar_corpo_email_html(req, &htmlLen);
+    if (htmlBody == nullptr) {
+        return false;
+    }
+    Serial.printf("📄 Corpo HTML: %u bytes\n", htmlLen);
+    log_heap_email("após corpo");
+    // nonCopyContent: a biblioteca lê direto do buffer (sem cópia para MB_String);
+    // htmlBody precisa viver até sendMail() retornar
+    message.html.nonCopyContent = htmlBody;
     message.html.charSet = "utf-8";
     message.html.transfer_encoding = Content_Transfer_Encoding::enc_qp;
     
@@ -374,10 +281,12 @@ bool enviar_email_smtp(const MaintenanceRequest* req) {
         Serial.println("❌ Falha ao conectar ao servidor SMTP");
         Serial.print("Erro: ");
         Serial.println(smtp.errorReason());
+        free(htmlBody);
         return false;
     }
     
     Serial.println("✅ Conectado ao servidor SMTP");
+    log_heap_email("após TLS");
     
     // Envia e-mail
     Serial.println("📨 Enviando e-mail...");
@@ -387,6 +296,8 @@ bool enviar_email_smtp(const MaintenanceRequest* req) {
         Serial.print("Erro: ");
         Serial.println(smtp.errorReason());
         smtp.closeSession();
+        free(htmlBody);
+        log_heap_email("após falha");
         return false;
     }
     
@@ -396,6 +307,8 @@ bool enviar_email_smtp(const MaintenanceRequest* req) {
     
     // Fecha sessão
     smtp.closeSession();
+    free(htmlBody);
+    log_heap_email("após envio");
     
     return true;
 }
@@ -450,11 +363,8 @@ void evento_enviar_requisicao(lv_event_t * e) {
     Serial.println("\\n📝 Preenchendo estrutura...");
     inicializarRequisicao(&currentRequest);
     
-    // ID único
-    Preferences prefs;
-    prefs.begin("manutencao", false);
-    maintenance_id_counter = prefs.getUInt("req_counter", 0) + 1;
-    prefs.end();
+    // ID único (contador persistido no índice do MaintenanceStore)
+    maintenance_id_counter = maintenanceStore.nextId();
     
     currentRequest.id = maintenance_id_counter;
     Serial.printf("   ID: #%05u\\n", currentRequest.id);
@@ -504,15 +414,15 @@ void evento_enviar_requisicao(lv_event_t * e) {
         return;
     }
     
-    // ═════════ SALVA NO NVS ═════════
-    Serial.println("\\n💾 Salvando no NVS...");
+    // ═════════ SALVA NO STORE ═════════
+    Serial.println("\\n💾 Salvando requisição...");
     
     if (!salvar_requisicao_nvs(&currentRequest)) {
         mostrar_erro_manutencao("Erro ao salvar");
         return;
     }
     
-    Serial.println("✅ Salvo no NVS!");
+    Serial.println("✅ Requisição salva!");
     
     // Imprime resumo
     printRequisicao(&currentRequest);
@@ -541,7 +451,7 @@ void evento_enviar_requisicao(lv_event_t * e) {
         salvar_requisicao_nvs(&currentRequest);
         
         mostrar_status_manutencao("⚠️ Salva localmente", COLOR_WARNING);
-        Serial.println("\\n⚠️ E-mail falhou, mas salvo no NVS");
+        Serial.println("\\n⚠️ E-mail falhou, mas requisição salva (pendente de reenvio)");
     }
     
     Serial.println("═══════════════════════════════════════════════════\\n");
@@ -0,0 +1,381 @@
+/**
+ * @file maintenance_store.cpp
+ * @brief Implementação do armazenamento indexado de requisições de manutenção
+ * @version 1.0.0
+ * @date 2025-12-05
+ */
+
+#include <Preferences.h>
+#include <algorithm>
+#include "maintenance_store.h"
+
+// Instância global
+MaintenanceStore maintenanceStore;
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONSTRUTOR
+// ═══════════════════════════════════════════════════════════════════════
+
+MaintenanceStore::MaintenanceStore() : initialized(false), lastId(0) {
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// INICIALIZAÇÃO
+// ═══════════════════════════════════════════════════════════════════════
+
+bool MaintenanceStore::begin() {
+    if (initialized) return true;
+
+    Serial.println("🔧 [MaintenanceStore] Inicializando...");
+
+    // Inicializar LittleFS (se ainda não foi inicializado)
+    if (!LittleFS.begin(true)) {
+        Serial.println("❌ [MaintenanceStore] Erro ao inicializar LittleFS");
+        return false;
+    }
+
+    if (!LittleFS.exists(MAINT_STORE_DIR)) {
+        LittleFS.mkdir(MAINT_STORE_DIR);
+    }
+
+    if (!loadIndex()) {
+        Serial.println("⚠️  [MaintenanceStore] Índice não encontrado (primeira inicialização)");
+        saveIndex();
+    }
+
+    initialized = true;
+
+    // Requisições antigas no NVS são movidas para cá (libera a partição NVS)
+    migrateFromNVS();
+
+    Serial.printf("✅ [MaintenanceStore] Pronto! %u requisição(ões), %u pendente(s), %u com erro\n",
+        count(), countByStatus(STATUS_PENDENTE), countByStatus(STATUS_ERRO_ENVIO));
+
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// OPERAÇÕES DE REGISTRO
+// ═══════════════════════════════════════════════════════════════════════
+
+bool MaintenanceStore::save(const MaintenanceRequest* req) {
+    if (!initialized && !begin()) return false;
+    if (req == nullptr || req->id == 0) return false;
+
+    uint8_t newStatus = (uint8_t)req->status;
+    if (newStatus >= MAINT_STORE_STATUS_COUNT) newStatus = STATUS_PENDENTE;
+
+    int oldStatus = findStatus(req->id);
+
+    // Registro novo: garantir espaço antes de gravar
+    if (oldStatus < 0 && !enforceRetention()) {
+        Serial.println("❌ [MaintenanceStore] Limite atingido (todas pendentes)");
+        return false;
+    }
+
+    char path[32];
+    recordPath(req->id, path, sizeof(path));
+
+    File file = LittleFS.open(path, "w");
+    if (!file) {
+        Serial.printf("❌ [MaintenanceStore] Erro ao abrir %s\n", path);
+        return false;
+    }
+
+    size_t written = file.write((const uint8_t*)req, sizeof(MaintenanceRequest));
+    file.close();
+
+    if (written != sizeof(MaintenanceRequest)) {
+        Serial.printf("❌ [MaintenanceStore] Escrita incompleta: %u/%u bytes\n",
+            written, sizeof(MaintenanceRequest));
+        if (oldStatus < 0) LittleFS.remove(path);
+        return false;
+    }
+
+    // Atualizar índice apenas se mudou
+    if (oldStatus != (int)newStatus) {
+        if (oldStatus >= 0) indexErase((uint8_t)oldStatus, req->id);
+        indexInsert(newStatus, req->id);
+    }
+    if (req->id > lastId) lastId = req->id;
+
+    if (!saveIndex()) return false;
+
+    Serial.printf("✅ [MaintenanceStore] Requisição #%05u salva (%s)\n",
+        req->id, statusToString((StatusRequisicao)newStatus));
+    return true;
+}
+
+bool MaintenanceStore::load(uint32_t id, MaintenanceRequest* out) {
+    if (!initialized || out == nullptr) return false;
+
+    char path[32];
+    recordPath(id, path, sizeof(path));
+
+    File file = LittleFS.open(path, "r");
+    if (!file) return false;
+
+    size_t got = file.read((uint8_t*)out, sizeof(MaintenanceRequest));
+    file.close();
+
+    return got == sizeof(MaintenanceRequest);
+}
+
+bool MaintenanceStore::remove(uint32_t id) {
+    if (!initialized) return false;
+
+    int status = findStatus(id);
+    if (status < 0) return false;
+
+    char path[32];
+    recordPath(id, path, sizeof(path));
+    LittleFS.remove(path);
+
+    indexErase((uint8_t)status, id);
+    return saveIndex();
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONSULTAS
+// ═══════════════════════════════════════════════════════════════════════
+
+size_t MaintenanceStore::listByStatus(StatusRequisicao status, std::vector<uint32_t>& out, size_t maxItems) {
+    out.clear();
+    if ((uint8_t)status >= MAINT_STORE_STATUS_COUNT) return 0;
+
+    const std::vector<uint32_t>& bucket = byStatus[status];
+    size_t n = bucket.size();
+    if (maxItems > 0 && maxItems < n) n = maxItems;
+
+    out.assign(bucket.begin(), bucket.begin() + n);
+    return n;
+}
+
+size_t MaintenanceStore::countByStatus(StatusRequisicao status) const {
+    if ((uint8_t)status >= MAINT_STORE_STATUS_COUNT) return 0;
+    return byStatus[status].size();
+}
+
+size_t MaintenanceStore::count() const {
+    size_t total = 0;
+    for (uint8_t s = 0; s < MAINT_STORE_STATUS_COUNT; s++) {
+        total += byStatus[s].size();
+    }
+    return total;
+}
+
+uint32_t MaintenanceStore::nextId() {
+    if (!initialized) begin();
+    lastId++;
+    saveIndex();
+    return lastId;
+}
+
+void MaintenanceStore::printSummary() {
+    Serial.println("\n🔧 REQUISIÇÕES DE MANUTENÇÃO:");
+    Serial.printf("  Total: %u / %u (último ID: #%05u)\n",
+        count(), MAINT_STORE_MAX_RECORDS, lastId);
+
+    for (uint8_t s = 0; s < MAINT_STORE_STATUS_COUNT; s++) {
+        Serial.printf("  %-14s %u\n", statusToString((StatusRequisicao)s), byStatus[s].size());
+    }
+
+    const std::vector<uint32_t>& pend = byStatus[STATUS_PENDENTE];
+    for (size_t i = 0; i < pend.size(); i++) {
+        Serial.printf("  ⏳ #%05u\n", pend[i]);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// ÍNDICE
+// ═══════════════════════════════════════════════════════════════════════
+
+bool MaintenanceStore::loadIndex() {
+    File file = LittleFS.open(MAINT_STORE_INDEX_FILE, "r");
+    if (!file) return false;
+
+    MaintenanceIndexHeader header;
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != MAINT_STORE_MAGIC) {
+        Serial.println("⚠️  [MaintenanceStore] Índice inválido - recriando");
+        file.close();
+        return false;
+    }
+
+    lastId = header.lastId;
+    for (uint8_t s = 0; s < MAINT_STORE_STATUS_COUNT; s++) byStatus[s].clear();
+
+    MaintenanceIndexEntry entry;
+    for (uint16_t i = 0; i < header.count; i++) {
+        if (file.read((uint8_t*)&entry, sizeof(entry)) != sizeof(entry)) break;
+        if (entry.status >= MAINT_STORE_STATUS_COUNT) continue;
+        indexInsert(entry.status, entry.id);
+    }
+
+    file.close();
+    return true;
+}
+
+bool MaintenanceStore::saveIndex() {
+    File file = LittleFS.open(MAINT_STORE_INDEX_TMP, "w");
+    if (!file) {
+        Serial.println("❌ [MaintenanceStore] Erro ao gravar índice");
+        return false;
+    }
+
+    MaintenanceIndexHeader header;
+    header.magic = MAINT_STORE_MAGIC;
+    header.lastId = lastId;
+    header.count = (uint16_t)count();
+    file.write((const uint8_t*)&header, sizeof(header));
+
+    MaintenanceIndexEntry entry;
+    for (uint8_t s = 0; s < MAINT_STORE_STATUS_COUNT; s++) {
+        entry.status = s;
+        for (size_t i = 0; i < byStatus[s].size(); i++) {
+            entry.id = byStatus[s][i];
+            file.write((const uint8_t*)&entry, sizeof(entry));
+        }
+    }
+    file.close();
+
+    // rename substitui o índice anterior de forma atômica no LittleFS
+    if (!LittleFS.rename(MAINT_STORE_INDEX_TMP, MAINT_STORE_INDEX_FILE)) {
+        Serial.println("❌ [MaintenanceStore] Erro ao substituir índice");
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// MIGRAÇÃO NVS → LITTLEFS
+// ═══════════════════════════════════════════════════════════════════════
+
+void MaintenanceStore::migrateFromNVS() {
+    Preferences prefs;
+    if (!prefs.begin("manutencao", false)) return;
+
+    uint32_t nvsCounter = prefs.getUInt("req_counter", 0);
+    if (nvsCounter == 0) {
+        prefs.end();
+        return;
+    }
+
+    Serial.printf("🔄 [MaintenanceStore] Migrando requisições do NVS (até #%05u)...\n", nvsCounter);
+
+    MaintenanceRequest req;
+    char key[16];
+    uint16_t migrated = 0;
+    uint16_t kept = 0;
+
+    for (uint32_t id = 1; id <= nvsCounter; id++) {
+        snprintf(key, sizeof(key), "req_%05u", id);
+        if (!prefs.isKey(key)) continue;
+
+        if (prefs.getBytes(key, &req, sizeof(req)) != sizeof(req)) {
+            // Registro ilegível: não há o que migrar
+            Serial.printf("⚠️ [MaintenanceStore] %s corrompido, descartado\n", key);
+            prefs.remove(key);
+            continue;
+        }
+        if (!save(&req)) {
+            // Fica no NVS para a próxima inicialização (ex.: retenção cheia de pendentes)
+            Serial.printf("❌ [MaintenanceStore] #%05u não migrada, mantida no NVS\n", id);
+            kept++;
+            continue;
+        }
+        prefs.remove(key);
+        migrated++;
+    }
+
+    if (nvsCounter > lastId) {
+        lastId = nvsCounter;
+        saveIndex();
+    }
+
+    if (kept) {
+        prefs.end();
+        Serial.printf("⚠️ [MaintenanceStore] %u migrada(s), %u aguardando espaço\n", migrated, kept);
+        return;
+    }
+
+    prefs.remove("req_counter");
+    prefs.remove("pending_count");
+    prefs.end();
+
+    Serial.printf("✅ [MaintenanceStore] %u requisição(ões) migrada(s), NVS liberado\n", migrated);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// RETENÇÃO
+// ═══════════════════════════════════════════════════════════════════════
+
+bool MaintenanceStore::enforceRetention() {
+    // Ordem de descarte: finalizadas primeiro, depois erros; pendentes nunca
+    static const uint8_t finalizadas[] = {
+        STATUS_ATENDIDA, STATUS_CANCELADA, STATUS_ENVIADA
+    };
+
+    while (count() >= MAINT_STORE_MAX_RECORDS) {
+        uint8_t victimStatus = 0xFF;
+        uint32_t victimId = UINT32_MAX;
+
+        // Entre as finalizadas, descartar a mais antiga (menor ID)
+        for (uint8_t i = 0; i < sizeof(finalizadas); i++) {
+            const std::vector<uint32_t>& bucket = byStatus[finalizadas[i]];
+            if (!bucket.empty() && bucket.front() < victimId) {
+                victimId = bucket.front();
+                victimStatus = finalizadas[i];
+            }
+        }
+        if (victimStatus == 0xFF && !byStatus[STATUS_ERRO_ENVIO].empty()) {
+            victimId = byStatus[STATUS_ERRO_ENVIO].front();
+            victimStatus = STATUS_ERRO_ENVIO;
+        }
+        if (victimStatus == 0xFF) return false;
+
+        char path[32];
+        recordPath(victimId, path, sizeof(path));
+        LittleFS.remove(path);
+        indexErase(victimStatus, victimId);
+
+        Serial.printf("🗑️  [MaintenanceStore] Retenção: #%05u (%s) descartada\n",
+            victimId, statusToString((StatusRequisicao)victimStatus));
+    }
+
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// HELPERS PRIVADOS
+// ═══════════════════════════════════════════════════════════════════════
+
+int MaintenanceStore::findStatus(uint32_t id) const {
+    for (uint8_t s = 0; s < MAINT_STORE_STATUS_COUNT; s++) {
+        if (std::binary_search(byStatus[s].begin(), byStatus[s].end(), id)) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+void MaintenanceStore::indexInsert(uint8_t status, uint32_t id) {
+    std::vector<uint32_t>& bucket = byStatus[status];
+    // IDs são crescentes: caso comum é inserir no final
+    if (bucket.empty() || bucket.back() < id) {
+        bucket.push_back(id);
+        return;
+    }
+    std::vector<uint32_t>::iterator it = std::lower_bound(bucket.begin(), bucket.end(), id);
+    if (it == bucket.end() || *it != id) bucket.insert(it, id);
+}
+
+void MaintenanceStore::indexErase(uint8_t status, uint32_t id) {
+    std::vector<uint32_t>& bucket = byStatus[status];
+    std::vector<uint32_t>::iterator it = std::lower_bound(bucket.begin(), bucket.end(), id);
+    if (it != bucket.end() && *it == id) bucket.erase(it);
+}
+
+void MaintenanceStore::recordPath(uint32_t id, char* buf, size_t len) {
+    snprintf(buf, len, MAINT_STORE_DIR "/%05u.req", id);
+}
@@ -0,0 +1,252 @@
+/**
+ * @file record_table.cpp
+ * @brief Implementação da tabela de registros em LittleFS
+ * @version 1.0.0
+ * @date 2025-12-07
+ */
+
+#include "record_table.h"
+#include <LittleFS.h>
+#include <Preferences.h>
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONSTRUTOR
+// ═══════════════════════════════════════════════════════════════════════
+
+RecordTable::RecordTable(const char* path, const char* tmpPath, uint32_t magic, uint16_t recordSize,
+                         uint16_t maxRecords, const char* nvsNamespace, const char* nvsPrefix,
+                         const char* nvsBlobKey)
+    : path(path),
+      tmpPath(tmpPath),
+      magic(magic),
+      recordSize(recordSize),
+      maxRecords(maxRecords),
+      nvsNamespace(nvsNamespace),
+      nvsPrefix(nvsPrefix),
+      nvsBlobKey(nvsBlobKey),
+      fileCount(-1),
+      legacyCount(-1),
+      legacyBlob(false) {
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// CARGA / MIGRAÇÃO
+// ═══════════════════════════════════════════════════════════════════════
+
+uint16_t RecordTable::load(void* records) {
+    uint16_t count = 0;
+    bool fromFile = readFile(records, count);
+
+    // Formato antigo no NVS: primeiro boot ou migração que não terminou
+    legacyCount = -1;
+    legacyBlob = false;
+    Preferences prefs;
+    if (prefs.begin(nvsNamespace, true)) {
+        legacyBlob = nvsBlobKey && prefs.getBytesLength(nvsBlobKey) > 0;
+        if (prefs.isKey("count")) {
+            int32_t n = prefs.getInt("count", 0);
+            legacyCount = n > 0 ? n : 0;
+        }
+        prefs.end();
+    }
+
+    if (!fromFile && legacyPending()) {
+        count = loadLegacy(records);
+    }
+
+    if (legacyPending()) {
+        Serial.printf("🔄 [Tabela] %s: migrando %u registro(s) do NVS '%s'\n",
+                      path, count, nvsNamespace);
+        save(records, count);
+    }
+    return count;
+}
+
+bool RecordTable::readFile(void* records, uint16_t& count) {
+    fileCount = -1;
+    File f = LittleFS.open(path, "r");
+    if (!f) return false;
+
+    RecordTableHeader hdr;
+    bool ok = f.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              hdr.magic == magic && hdr.recordSize > 0 &&
+              hdr.recordSize <= recordSize && hdr.count <= maxRecords;
+
+    // Registro gravado por uma versão com struct menor: campos novos ficam 0
+    uint8_t* dst = (uint8_t*)records;
+    for (uint16_t i = 0; ok && i < hdr.count; i++) {
+        memset(dst + (size_t)i * recordSize, 0, recordSize);
+        ok = f.read(dst + (size_t)i * recordSize, hdr.recordSize) == hdr.recordSize;
+    }
+    f.close();
+
+    if (!ok) {
+        Serial.printf("❌ [Tabela] %s inválido - ignorado\n", path);
+        return false;
+    }
+    count = hdr.count;
+    // Tamanho antigo: gravação no lugar não vale até o próximo save()
+    if (hdr.recordSize == recordSize) fileCount = hdr.count;
+    return true;
+}
+
+uint16_t RecordTable::loadLegacy(void* records) {
+    Preferences prefs;
+    if (!prefs.begin(nvsNamespace, true)) return 0;
+
+    uint8_t* dst = (uint8_t*)records;
+    uint16_t count = 0;
+    if (legacyBlob) {
+        // Blob da tabela inteira (substitui as chaves por registro)
+        size_t len = prefs.getBytesLength(nvsBlobKey);
+        count = (uint16_t)(len / recordSize > maxRecords ? maxRecords : len / recordSize);
+        if (prefs.getBytes(nvsBlobKey, dst, (size_t)count * recordSize) != (size_t)count * recordSize) {
+            count = 0;
+        }
+    } else {
+        count = (uint16_t)(legacyCount > maxRecords ? maxRecords : legacyCount);
+        char key[16];
+        for (uint16_t i = 0; i < count; i++) {
+            legacyKey(key, sizeof(key), i);
+            // Registros de versões anteriores podem ser mais curtos (resto fica 0)
+            memset(dst + (size_t)i * recordSize, 0, recordSize);
+            prefs.getBytes(key, dst + (size_t)i * recordSize, recordSize);
+        }
+    }
+    prefs.end();
+    return count;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// GRAVAÇÃO
+// ═══════════════════════════════════════════════════════════════════════
+
+bool RecordTable::save(const void* records, uint16_t count) {
+    if (writeFile(records, count)) {
+        fileCount = count;
+        if (legacyPending()) {
+            removeLegacy();
+            Serial.printf("✅ [Tabela] %s: formato antigo do NVS removido (%u registros)\n",
+                          path, count);
+        }
+        return true;
+    }
+
+    fileCount = -1;
+    Serial.printf("❌ [Tabela] Falha ao gravar %s (%u registros)\n", path, count);
+    if (!legacyPending()) return false;
+
+    // Migração ainda não confirmada: os dados continuam no formato antigo,
+    // que passa a ser a cópia válida (arquivo antigo não pode vencer no load)
+    LittleFS.remove(path);
+    bool ok = saveLegacy(records, count);
+    Serial.println(ok ? "⚠️ [Tabela] Dados mantidos no formato antigo do NVS"
+                      : "❌ [Tabela] Formato antigo do NVS também falhou");
+    return ok;
+}
+
+bool RecordTable::saveRange(const void* records, uint16_t count, uint16_t first, uint16_t n) {
+    if (fileCount < 0 || legacyPending() || count < fileCount || first + n > count) {
+        return save(records, count);
+    }
+    // Registros novos no fim entram junto (o arquivo não pode ficar com buraco)
+    if (count > fileCount) {
+        if (first > fileCount) first = (uint16_t)fileCount;
+        n = count - first;
+    }
+    if (n == 0) return true;
+
+    File f = LittleFS.open(path, "r+");
+    if (!f) return save(records, count);
+
+    size_t bytes = (size_t)n * recordSize;
+    const uint8_t* src = (const uint8_t*)records + (size_t)first * recordSize;
+    bool ok = f.seek(sizeof(RecordTableHeader) + (size_t)first * recordSize) &&
+              f.write(src, bytes) == bytes;
+    if (ok && count != fileCount) {
+        // Cabeçalho por último: total só cresce com os registros já gravados
+        RecordTableHeader hdr = { magic, recordSize, count };
+        ok = f.seek(0) && f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+    }
+    f.close();
+
+    if (!ok) {
+        fileCount = -1;             // Próxima gravação regrava tudo
+        Serial.printf("❌ [Tabela] Falha ao regravar %u registro(s) de %s\n", n, path);
+        return false;
+    }
+    fileCount = count;
+    return true;
+}
+
+bool RecordTable::writeFile(const void* records, uint16_t count) {
+    File f = LittleFS.open(tmpPath, "w");
+    if (!f) return false;
+
+    RecordTableHeader hdr = { magic, recordSize, count };
+    size_t bytes = (size_t)count * recordSize;
+    bool ok = f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              (bytes == 0 || f.write((const uint8_t*)records, bytes) == bytes);
+    f.close();
+
+    // rename substitui a tabela anterior de forma atômica no LittleFS
+    if (!ok || !LittleFS.rename(tmpPath, path)) {
+        LittleFS.remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// FORMATO ANTIGO (NVS)
+// ═══════════════════════════════════════════════════════════════════════
+
+void RecordTable::legacyKey(char* key, size_t len, int i) const {
+    snprintf(key, len, "%s%d", nvsPrefix, i);
+}
+
+bool RecordTable::saveLegacy(const void* records, uint16_t count) {
+    Preferences prefs;
+    if (!prefs.begin(nvsNamespace, false)) return false;
+
+    const uint8_t* src = (const uint8_t*)records;
+    bool ok = true;
+    if (legacyBlob) {
+        size_t bytes = (size_t)count * recordSize;
+        ok = bytes ? prefs.putBytes(nvsBlobKey, src, bytes) == bytes : prefs.remove(nvsBlobKey);
+    } else {
+        char key[16];
+        for (uint16_t i = 0; i < count; i++) {
+            legacyKey(key, sizeof(key), i);
+            ok &= prefs.putBytes(key, src + (size_t)i * recordSize, recordSize) == recordSize;
+        }
+        // Registros além do novo total (remoções) saem depois de o total ser gravado
+        ok &= prefs.putInt("count", count) == sizeof(int32_t);
+        if (ok) {
+            for (int32_t i = count; i < legacyCount; i++) {
+                legacyKey(key, sizeof(key), i);
+                prefs.remove(key);
+            }
+            legacyCount = count;
+        }
+    }
+    prefs.end();
+    return ok;
+}
+
+void RecordTable::removeLegacy() {
+    Preferences prefs;
+    if (!prefs.begin(nvsNamespace, false)) return;
+
+    char key[16];
+    for (int32_t i = 0; i < legacyCount; i++) {
+        legacyKey(key, sizeof(key), i);
+        prefs.remove(key);
+    }
+    prefs.remove("count");
+    if (nvsBlobKey) prefs.remove(nvsBlobKey);
+    prefs.end();
+
+    legacyCount = -1;
+    legacyBlob = false;
+}
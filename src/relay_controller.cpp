@@ -1,7 +1,7 @@
 /**
  * @file relay_controller.cpp
  * @brief Implementação do controlador de relé
- * @version 1.1.0
+ * @version 1.2.0
  * @date 2025-11-28
  * 
  * ATUALIZADO: GPIO20 → GPIO19 conforme pinagem v5.1.0
@@ -17,7 +17,13 @@ RelayController::RelayController()
     : unlocked(false), 
       temporaryUnlock(false),
       unlockStartTime(0),
-      unlockDuration(0) {
+      unlockDuration(0),
+      lockTimer(nullptr),
+      unlockUs(0),
+      eventHead(0),
+      eventPrinted(0) {
+    portMUX_INITIALIZE(&mux);
+    memset(events, 0, sizeof(events));
 }
 
 // ═══════════════════════════════════════════════════════════════════════
@@ -30,6 +36,17 @@ void RelayController::begin() {
     // Configurar GPIO como saída
     pinMode(RELAY_PIN, OUTPUT);
     
+    // ⭐ v1.2.0: Travamento pelo esp_timer (independente do loop)
+    esp_timer_create_args_t args = {};
+    args.callback = onLockTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "relay_lock";
+    if (esp_timer_create(&args, &lockTimer) != ESP_OK) {
+        lockTimer = nullptr;
+        Serial.println("⚠️  [RelayController] esp_timer indisponível - travamento pelo loop");
+    }
+    
     // Garantir que começa trancada
     lock();
     
@@ -43,30 +60,53 @@ void RelayController::begin() {
 void RelayController::unlock(uint32_t duration) {
     Serial.printf("🔓 [RelayController] Destrancando porta (%dms)\n", duration);
     
-    activateRelay();
+    if (lockTimer) esp_timer_stop(lockTimer);   // Novo prazo substitui o anterior
     
-    unlocked = true;
+    portENTER_CRITICAL(&mux);
+    applyLocked(true, RELAY_EV_UNLOCK, duration);
     temporaryUnlock = true;
     unlockStartTime = millis();
     unlockDuration = duration;
+    portEXIT_CRITICAL(&mux);
+    
+    if (lockTimer) esp_timer_start_once(lockTimer, (uint64_t)duration * 1000);
 }
 
 void RelayController::unlockPermanent() {
     Serial.println("🔓 [RelayController] Destrancando porta (PERMANENTE)");
     
-    activateRelay();
+    if (lockTimer) esp_timer_stop(lockTimer);
     
-    unlocked = true;
+    portENTER_CRITICAL(&mux);
+    applyLocked(true, RELAY_EV_UNLOCK_PERMANENT, 0);
     temporaryUnlock = false;
+    portEXIT_CRITICAL(&mux);
 }
 
 void RelayController::lock() {
     Serial.println("🔒 [RelayController] Trancando porta");
     
-    deactivateRelay();
+    if (lockTimer) esp_timer_stop(lockTimer);
     
-    unlocked = false;
-    temporaryUnlock = false;
+    portENTER_CRITICAL(&mux);
+    applyLocked(false, RELAY_EV_LOCK, 0);
+    portEXIT_CRITICAL(&mux);
+}
+
+/**
+ * @brief Prazo do destravamento temporizado (tarefa do esp_timer)
+ * Um disparo atrasado de um prazo já substituído por unlock() é ignorado.
+ */
+void RelayController::onLockTimer(void* arg) {
+    RelayController* self = static_cast<RelayController*>(arg);
+    
+    portENTER_CRITICAL(&self->mux);
+    uint64_t openUs = esp_timer_get_time() - self->unlockUs;
+    if (self->unlocked && self->temporaryUnlock &&
+        openUs + 1000 >= (uint64_t)self->unlockDuration * 1000) {
+        self->applyLocked(false, RELAY_EV_LOCK_TIMER, self->unlockDuration);
+    }
+    portEXIT_CRITICAL(&self->mux);
 }
 
 bool RelayController::isUnlocked() {
@@ -78,13 +118,26 @@ bool RelayController::isUnlocked() {
 // ═══════════════════════════════════════════════════════════════════════
 
 void RelayController::update() {
-    // Verificar se é destravamento temporizado
-    if (temporaryUnlock && unlocked) {
-        // Verificar se tempo expirou
+    // Sem esp_timer: prazo conferido aqui (comportamento anterior)
+    if (!lockTimer && temporaryUnlock && unlocked) {
         if (millis() - unlockStartTime >= unlockDuration) {
             Serial.println("⏱️  [RelayController] Timer expirado - Trancando porta");
-            lock();
+            portENTER_CRITICAL(&mux);
+            applyLocked(false, RELAY_EV_LOCK_TIMER, unlockDuration);
+            portEXIT_CRITICAL(&mux);
+        }
+    }
+    
+    // ⭐ v1.2.0: Eventos gravados fora do loop (esp_timer) saem no Serial aqui
+    while (eventPrinted != eventHead) {
+        portENTER_CRITICAL(&mux);
+        if (eventHead - eventPrinted > RELAY_EVENT_LOG) {
+            eventPrinted = eventHead - RELAY_EVENT_LOG;     // Sobrescritos antes de imprimir
         }
+        RelayEvent ev = events[eventPrinted % RELAY_EVENT_LOG];
+        eventPrinted++;
+        portEXIT_CRITICAL(&mux);
+        printEvent(ev);
     }
 }
 
@@ -96,26 +149,86 @@ void RelayController::logAccess(const char* method, const char* user) {
     Serial.printf("📝 [RelayController] Acesso: %s | Usuário: %s\n", method, user);
 }
 
+void RelayController::printEvent(const RelayEvent& ev) {
+    unsigned long s = (unsigned long)(ev.timestampUs / 1000000);
+    unsigned long us = (unsigned long)(ev.timestampUs % 1000000);
+    
+    switch (ev.type) {
+        case RELAY_EV_UNLOCK:
+            Serial.printf("📜 [RELAY] t=%lu.%06lus DESTRAVADO (%lu ms)\n", s, us, (unsigned long)ev.requestedMs);
+            break;
+        case RELAY_EV_UNLOCK_PERMANENT:
+            Serial.printf("📜 [RELAY] t=%lu.%06lus DESTRAVADO (permanente)\n", s, us);
+            break;
+        case RELAY_EV_LOCK:
+            Serial.printf("📜 [RELAY] t=%lu.%06lus TRAVADO (comando) | aberto %lu.%03lu ms\n",
+                          s, us, (unsigned long)(ev.openUs / 1000), (unsigned long)(ev.openUs % 1000));
+            break;
+        case RELAY_EV_LOCK_TIMER:
+            Serial.printf("📜 [RELAY] t=%lu.%06lus TRAVADO (prazo) | aberto %lu.%03lu ms de %lu ms (%+lld us)\n",
+                          s, us, (unsigned long)(ev.openUs / 1000), (unsigned long)(ev.openUs % 1000),
+                          (unsigned long)ev.requestedMs, (long long)ev.openUs - (long long)ev.requestedMs * 1000);
+            break;
+    }
+}
+
+void RelayController::printEvents() {
+    Serial.println("\n🔌 ═══════════════════════════════════════");
+    Serial.println("   EVENTOS DO RELÉ");
+    Serial.println("═══════════════════════════════════════");
+    Serial.printf("Travamento   : %s\n", lockTimer ? "esp_timer (one-shot)" : "loop (update)");
+    Serial.printf("Estado       : %s\n", unlocked ? "DESTRANCADO" : "TRANCADO");
+    
+    portENTER_CRITICAL(&mux);
+    uint32_t head = eventHead;
+    portEXIT_CRITICAL(&mux);
+    uint32_t first = head > RELAY_EVENT_LOG ? head - RELAY_EVENT_LOG : 0;
+    if (head == 0) Serial.println("Nenhum evento desde o boot");
+    for (uint32_t i = first; i < head; i++) {
+        portENTER_CRITICAL(&mux);
+        RelayEvent ev = events[i % RELAY_EVENT_LOG];
+        portEXIT_CRITICAL(&mux);
+        printEvent(ev);
+    }
+    Serial.println("═══════════════════════════════════════\n");
+}
+
 // ═══════════════════════════════════════════════════════════════════════
 // HELPERS PRIVADOS
 // ═══════════════════════════════════════════════════════════════════════
 
-void RelayController::activateRelay() {
-    if (RELAY_ACTIVE_HIGH) {
-        digitalWrite(RELAY_PIN, HIGH);  // HIGH = destravar
-        Serial.printf("  ⚡ GPIO%d = HIGH (Relé ATIVADO)\n", RELAY_PIN);
+/**
+ * @brief GPIO + estado + evento (chamar com 'mux' travado)
+ */
+void RelayController::applyLocked(bool unlock, RelayEventType type, uint32_t requestedMs) {
+    if (unlock) {
+        activateRelay();
     } else {
-        digitalWrite(RELAY_PIN, LOW);   // LOW = destravar
-        Serial.printf("  ⚡ GPIO%d = LOW (Relé ATIVADO)\n", RELAY_PIN);
+        deactivateRelay();
     }
+    uint64_t now = esp_timer_get_time();
+    
+    // Travar porta já travada (boot, FECHAR repetido) não gera evento
+    if (unlock || unlocked) {
+        RelayEvent& ev = events[eventHead % RELAY_EVENT_LOG];
+        ev.timestampUs = now;
+        ev.type = type;
+        ev.requestedMs = requestedMs;
+        ev.openUs = unlock ? 0 : now - unlockUs;
+        eventHead++;
+    }
+    
+    if (unlock) unlockUs = now;
+    unlocked = unlock;
+    if (!unlock) temporaryUnlock = false;
+}
+
+// ⭐ v1.2.0: Sem Serial aqui - chamadas em seção crítica/tarefa do esp_timer
+// (o evento correspondente sai no Serial em update())
+void RelayController::activateRelay() {
+    digitalWrite(RELAY_PIN, RELAY_ACTIVE_HIGH ? HIGH : LOW);    // Destravar
 }
 
 void RelayController::deactivateRelay() {
-    if (RELAY_ACTIVE_HIGH) {
-        digitalWrite(RELAY_PIN, LOW);   // LOW = trancar
-        Serial.printf("  ⚡ GPIO%d = LOW (Relé DESATIVADO)\n", RELAY_PIN);
-    } else {
-        digitalWrite(RELAY_PIN, HIGH);  // HIGH = trancar
-        Serial.printf("  ⚡ GPIO%d = HIGH (Relé DESATIVADO)\n", RELAY_PIN);
-    }
+    digitalWrite(RELAY_PIN, RELAY_ACTIVE_HIGH ? LOW : HIGH);    // Trancar
 }
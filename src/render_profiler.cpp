@@ -0,0 +1,206 @@
+/**
+ * @file render_profiler.cpp
+ * @brief Implementação do profiler de renderização LVGL
+ * @version 1.0.0
+ * @date 2025-12-06
+ */
+
+#include "render_profiler.h"
+
+// ════════════════════════════════════════════════════════════════
+// ESTADO
+// ════════════════════════════════════════════════════════════════
+
+static bool prof_on = false;
+static int prof_screen = 0;
+static uint32_t prof_screen_since = 0;
+
+static RenderProfStats screen_stats[RENDER_PROF_MAX_SCREENS];
+static RenderProfStats window_stats;        // Janela do overlay
+static uint32_t window_since = 0;
+
+// Acumulado do frame em andamento (preenchido pelo flush_cb)
+static uint32_t frame_flush_us = 0;
+static uint32_t frame_px = 0;
+
+static lv_obj_t* overlay_label = NULL;
+static lv_timer_t* overlay_timer = NULL;
+
+// ════════════════════════════════════════════════════════════════
+// AUXILIARES
+// ════════════════════════════════════════════════════════════════
+
+static void record_frame(RenderProfStats& s, uint32_t render_us, uint32_t flush_us, uint32_t px) {
+    s.frames++;
+    s.render_us += render_us;
+    s.flush_us += flush_us;
+    s.pixels += px;
+    if (render_us > s.render_max_us) s.render_max_us = render_us;
+    if (flush_us > s.flush_max_us) s.flush_max_us = flush_us;
+}
+
+static void record_handler(RenderProfStats& s, uint32_t us) {
+    s.handler_calls++;
+    s.handler_us += us;
+    if (us > s.handler_max_us) s.handler_max_us = us;
+}
+
+/**
+ * @brief Substitui o callback do refr_timer: mede o refresh completo
+ */
+static void prof_refr_timer(lv_timer_t* t) {
+    if (!prof_on) {
+        _lv_disp_refr_timer(t);
+        return;
+    }
+
+    frame_flush_us = 0;
+    frame_px = 0;
+
+    uint32_t t0 = micros();
+    _lv_disp_refr_timer(t);
+    uint32_t dt = micros() - t0;
+
+    if (frame_px == 0) return;  // Nada foi redesenhado
+
+    uint32_t render_us = dt > frame_flush_us ? dt - frame_flush_us : 0;
+    record_frame(screen_stats[prof_screen], render_us, frame_flush_us, frame_px);
+    record_frame(window_stats, render_us, frame_flush_us, frame_px);
+}
+
+// ════════════════════════════════════════════════════════════════
+// OVERLAY
+// ════════════════════════════════════════════════════════════════
+
+static void overlay_update(lv_timer_t* t) {
+    (void)t;
+    uint32_t now = millis();
+    uint32_t win_ms = now - window_since;
+    const RenderProfStats& w = window_stats;
+
+    float fps = win_ms ? w.frames * 1000.0f / win_ms : 0.0f;
+    float r = w.frames ? w.render_us / 1000.0f / w.frames : 0.0f;
+    float f = w.frames ? w.flush_us / 1000.0f / w.frames : 0.0f;
+    float h = w.handler_calls ? w.handler_us / 1000.0f / w.handler_calls : 0.0f;
+    uint32_t kpx = w.frames ? (uint32_t)(w.pixels / w.frames / 1000) : 0;
+
+    // Zera a janela antes de mudar o texto: o redraw do próprio overlay
+    // entra na próxima janela, não nesta
+    memset(&window_stats, 0, sizeof(window_stats));
+    window_since = now;
+
+    // snprintf da libc: lv_snprintf não formata float (LV_SPRINTF_USE_FLOAT=0)
+    char txt[64];
+    snprintf(txt, sizeof(txt), "%.0f fps  R %.1f  F %.1f  H %.1f ms  %ukpx",
+             fps, r, f, h, (unsigned)kpx);
+    lv_label_set_text(overlay_label, txt);
+}
+
+static void overlay_show(bool show) {
+    if (show && overlay_label == NULL) {
+        overlay_label = lv_label_create(lv_layer_top());
+        lv_obj_set_style_text_font(overlay_label, &lv_font_montserrat_10, 0);
+        lv_obj_set_style_text_color(overlay_label, lv_color_hex(0x10b981), 0);
+        lv_obj_set_style_bg_color(overlay_label, lv_color_hex(0x000000), 0);
+        lv_obj_set_style_bg_opa(overlay_label, LV_OPA_70, 0);
+        lv_obj_set_style_pad_hor(overlay_label, 4, 0);
+        lv_obj_align(overlay_label, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+        lv_label_set_text(overlay_label, "PROF...");
+        overlay_timer = lv_timer_create(overlay_update, RENDER_PROF_OVERLAY_MS, NULL);
+    } else if (!show && overlay_label != NULL) {
+        lv_timer_del(overlay_timer);
+        lv_obj_del(overlay_label);
+        overlay_timer = NULL;
+        overlay_label = NULL;
+    }
+}
+
+// ════════════════════════════════════════════════════════════════
+// API
+// ════════════════════════════════════════════════════════════════
+
+void render_prof_install(lv_disp_t* disp) {
+    if (disp == NULL || disp->refr_timer == NULL) {
+        Serial.println("⚠️ [Profiler] Display sem refr_timer - profiler indisponível");
+        return;
+    }
+    lv_timer_set_cb(disp->refr_timer, prof_refr_timer);
+    render_prof_reset();
+    Serial.println("✅ [Profiler] Instalado (use 'PROF ON' para ativar)");
+}
+
+void render_prof_enable(bool on) {
+    if (on == prof_on) return;
+
+    if (on) {
+        render_prof_reset();
+    } else {
+        screen_stats[prof_screen].active_ms += millis() - prof_screen_since;
+    }
+    prof_on = on;
+    overlay_show(on);
+
+    Serial.printf("📈 [Profiler] %s\n", on ? "ATIVADO" : "DESATIVADO");
+}
+
+bool render_prof_enabled() {
+    return prof_on;
+}
+
+void render_prof_set_screen(int screen) {
+    if (screen < 0 || screen >= RENDER_PROF_MAX_SCREENS) return;
+
+    uint32_t now = millis();
+    if (prof_on) {
+        screen_stats[prof_screen].active_ms += now - prof_screen_since;
+    }
+    prof_screen = screen;
+    prof_screen_since = now;
+}
+
+void render_prof_add_flush(uint32_t us, uint32_t px) {
+    if (!prof_on) return;
+    frame_flush_us += us;
+    frame_px += px;
+}
+
+void render_prof_add_handler(uint32_t us) {
+    if (!prof_on) return;
+    record_handler(screen_stats[prof_screen], us);
+    record_handler(window_stats, us);
+}
+
+void render_prof_reset() {
+    memset(screen_stats, 0, sizeof(screen_stats));
+    memset(&window_stats, 0, sizeof(window_stats));
+    prof_screen_since = window_since = millis();
+}
+
+void render_prof_print(const char* const* names, int count) {
+    Serial.println("\n📈 ═══════════════════════════════════════");
+    Serial.println("   PROFILER DE RENDERIZAÇÃO (por tela)");
+    Serial.println("═══════════════════════════════════════");
+    if (!prof_on) {
+        Serial.println("(profiler desativado - dados da última sessão)");
+    }
+    Serial.println("Tela          Frames  FPS   Render med/max  Flush med/max   px/frame  Handler med/max (ms)");
+
+    uint32_t now = millis();
+    for (int i = 0; i < RENDER_PROF_MAX_SCREENS; i++) {
+        const RenderProfStats& s = screen_stats[i];
+        if (s.frames == 0 && s.handler_calls == 0) continue;
+
+        uint32_t active = s.active_ms + ((prof_on && i == prof_screen) ? now - prof_screen_since : 0);
+        const char* nome = (names != NULL && i < count) ? names[i] : "?";
+
+        Serial.printf("%-12s %7u %5.1f  %6.2f/%6.2f  %6.2f/%6.2f  %8u  %6.2f/%6.2f\n",
+                      nome, s.frames,
+                      active ? s.frames * 1000.0f / active : 0.0f,
+                      s.frames ? s.render_us / 1000.0f / s.frames : 0.0f, s.render_max_us / 1000.0f,
+                      s.frames ? s.flush_us / 1000.0f / s.frames : 0.0f, s.flush_max_us / 1000.0f,
+                      s.frames ? (unsigned)(s.pixels / s.frames) : 0u,
+                      s.handler_calls ? s.handler_us / 1000.0f / s.handler_calls : 0.0f,
+                      s.handler_max_us / 1000.0f);
+    }
+    Serial.println("═══════════════════════════════════════\n");
+}
@@ -1,58 +1,312 @@
 /**
  * @file rfid_handlers_simple.cpp
  * @brief Implementação dos handlers HTTP para RFID
- * @version 1.0.0
+ * @version 1.1.0
  * @date 2025-11-27
- * 
- * NOTA: Este arquivo é um STUB que será ativado quando
- * o webserver AsyncWebServer for integrado ao projeto.
- * 
- * Por enquanto, contém apenas placeholders para compilação.
+ *
+ * v1.1.0: Implementação real sobre o AsyncWebServer (antes STUB).
+ * Handlers rodam na tarefa async_tcp: respostas montadas na hora, sem
+ * esperar o loop; a lista do RFIDManager é lida/alterada sob RFIDLock.
  */
 
 #include "rfid_handlers_simple.h"
+#include "wifi_config.h"
+#include "rfid_manager.h"
+#include <esp_heap_caps.h>
 
 // ═══════════════════════════════════════════════════════════════════════
-// NOTA: IMPLEMENTAÇÃO STUB
-// ═══════════════════════════════════════════════════════════════════════
-// 
-// Estas funções serão implementadas quando:
-// 1. AsyncWebServer estiver integrado ao main.cpp
-// 2. RFIDStorage estiver funcional
-// 3. PN532 estiver conectado e testado
-//
-// Por enquanto, apenas compilam sem erro.
+// CONFIGURAÇÃO DOS ENDPOINTS
 // ═══════════════════════════════════════════════════════════════════════
 
 void setupRFIDEndpointsSimple(AsyncWebServer& server) {
-    // Stub - será implementado quando AsyncWebServer estiver ativo
-    Serial.println("⚠️  [RFID Handlers] STUB - Aguardando integração com AsyncWebServer");
+    // Preflight CORS (OPTIONS)
+    server.on("/api/rfid/status", HTTP_OPTIONS, handleCORS);
+    server.on("/api/rfid/list", HTTP_OPTIONS, handleCORS);
+    server.on("/api/rfid/stats", HTTP_OPTIONS, handleCORS);
+    server.on("/api/rfid/register", HTTP_OPTIONS, handleCORS);
+    server.on("/api/rfid/delete", HTTP_OPTIONS, handleCORS);
+
+    server.on("/api/rfid/status", HTTP_GET, handleRFIDStatus);
+    server.on("/api/rfid/list", HTTP_GET, handleRFIDList);
+    server.on("/api/rfid/stats", HTTP_GET, handleRFIDStats);
+
+    // Corpo acumulado em _tempObject (liberado pelo servidor); resposta só no fim
+    server.on("/api/rfid/register", HTTP_POST,
+        [](AsyncWebServerRequest *request) {
+            if (request->contentLength() > RFID_API_MAX_BODY) {
+                sendRFIDError(request, "Corpo muito grande", 413);
+            } else if (!request->_tempObject) {
+                sendRFIDError(request, "Corpo JSON obrigatório");
+            } else {
+                handleRFIDRegister(request, (uint8_t*)request->_tempObject, request->contentLength());
+            }
+        },
+        nullptr,
+        [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            if (total > RFID_API_MAX_BODY) return;
+            if (index == 0) request->_tempObject = malloc(total);
+            if (request->_tempObject) memcpy((uint8_t*)request->_tempObject + index, data, len);
+        });
+
+    // "/api/rfid/delete" também casa "/api/rfid/delete/<uid>"
+    server.on("/api/rfid/delete", HTTP_DELETE, handleRFIDDelete);
+
+    Serial.println("[API] Rotas RFID configuradas:");
+    Serial.println("  GET    /api/rfid/status");
+    Serial.println("  GET    /api/rfid/list");
+    Serial.println("  GET    /api/rfid/stats");
+    Serial.println("  POST   /api/rfid/register");
+    Serial.println("  DELETE /api/rfid/delete/<uid>");
 }
 
+// ═══════════════════════════════════════════════════════════════════════
+// HANDLERS
+// ═══════════════════════════════════════════════════════════════════════
+
 void handleRFIDStatus(AsyncWebServerRequest *request) {
-    // Stub
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+
+    StaticJsonDocument<256> doc;
+    doc["hardware"] = rfidManager.isReady();    // Sem SPI: o PN532 é do loop
+    {
+        RFIDLock guard(rfidManager);
+        doc["cards"] = rfidManager.getCardCount();
+        doc["active"] = rfidManager.getActiveCardCount();
+    }
+    doc["max_cards"] = MAX_RFID_CARDS;
+    doc["enroll_state"] = rfidManager.getEnrollStateString();
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    serializeJson(doc, *response);
+    request->send(response);
 }
 
 void handleRFIDList(AsyncWebServerRequest *request) {
-    // Stub
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+
+    // ⭐ v6.1.20: Cópia da lista sob o lock (memcpy de até ~21KB); o JSON é
+    // montado depois, sem segurar o loop. AsyncResponseStream guarda a
+    // resposta inteira em RAM antes do envio - lista grande: /api/cards paginado
+    RFIDCard* cards = nullptr;
+    int count;
+    {
+        RFIDLock guard(rfidManager);
+        count = rfidManager.getCardCount();
+        if (count > 0) {
+            size_t bytes = count * sizeof(RFIDCard);
+            cards = (RFIDCard*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+            if (!cards) cards = (RFIDCard*)malloc(bytes);
+            if (cards) memcpy(cards, rfidManager.getCard(0), bytes);
+        }
+    }
+    if (count > 0 && !cards) {
+        sendRFIDError(request, "Sem memória para a lista", 503);
+        return;
+    }
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    response->printf("{\"count\":%d,\"cards\":[", count);
+
+    for (int i = 0; i < count; i++) {
+        RFIDCard* card = &cards[i];
+
+        StaticJsonDocument<256> obj;
+        obj["index"] = i + 1;
+        obj["uid"] = rfidManager.uidToString(card->uid, card->uid_length);
+        obj["name"] = card->name;
+        obj["active"] = card->active;
+        obj["timestamp"] = card->timestamp;
+        obj["access_count"] = card->access_count;
+        obj["last_access"] = card->last_access;
+        obj["finger_slot"] = card->finger_slot;
+
+        if (i) response->print(',');
+        serializeJson(obj, *response);
+    }
+    response->print("]}");
+    free(cards);
+    request->send(response);
 }
 
 void handleRFIDStats(AsyncWebServerRequest *request) {
-    // Stub
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+
+    int count, active, logCount, granted = 0;
+    uint32_t accesses = 0;
+    {
+        RFIDLock guard(rfidManager);
+        count = rfidManager.getCardCount();
+        active = rfidManager.getActiveCardCount();
+        for (int i = 0; i < count; i++) {
+            accesses += rfidManager.getCard(i)->access_count;
+        }
+        logCount = rfidManager.getLogCount();
+        for (int i = 0; i < logCount; i++) {
+            if (rfidManager.getLog(i)->granted) granted++;
+        }
+    }
+
+    StaticJsonDocument<256> doc;
+    doc["cards"] = count;
+    doc["active"] = active;
+    doc["inactive"] = count - active;
+    doc["free"] = MAX_RFID_CARDS - count;
+    doc["total_accesses"] = accesses;
+    doc["logs"] = logCount;
+    doc["logs_granted"] = granted;
+    doc["logs_denied"] = logCount - granted;
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    serializeJson(doc, *response);
+    request->send(response);
 }
 
 void handleRFIDRegister(AsyncWebServerRequest *request, uint8_t *data, size_t len) {
-    // Stub
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+    if (!rfidManager.isLoaded()) {
+        sendRFIDError(request, "Lista de cartões carregando", 503);
+        return;
+    }
+
+    StaticJsonDocument<RFID_API_MAX_BODY> doc;
+    if (deserializeJson(doc, (const char*)data, len)) {
+        sendRFIDError(request, "JSON inválido");
+        return;
+    }
+
+    uint8_t uid[RFID_UID_LENGTH];
+    uint8_t uidLength = parseRFIDUid(doc["uid"] | "", uid);
+    const char* name = doc["name"] | "";
+
+    if (uidLength == 0) {
+        sendRFIDError(request, "UID inválido (4 ou 7 bytes em hex)");
+        return;
+    }
+    if (strlen(name) == 0 || strlen(name) >= RFID_NAME_LENGTH) {
+        sendRFIDError(request, "Nome obrigatório (até 19 caracteres)");
+        return;
+    }
+
+    // Duplicata/limite conferidos sob o mesmo lock do addCard
+    RFIDLock guard(rfidManager);
+    if (rfidManager.findCardIndex(uid, uidLength) >= 0) {
+        sendRFIDError(request, "Cartão já cadastrado", 409);
+        return;
+    }
+    if (rfidManager.getCardCount() >= MAX_RFID_CARDS) {
+        sendRFIDError(request, "Memória cheia", 507);
+        return;
+    }
+    if (!rfidManager.addCard(uid, uidLength, name)) {
+        sendRFIDError(request, "Falha ao salvar", 500);
+        return;
+    }
+
+    Serial.printf("[API] POST /api/rfid/register: %s (%s)\n",
+                  name, rfidManager.uidToString(uid, uidLength).c_str());
+
+    AsyncWebServerResponse *response = request->beginResponse(201, "application/json",
+        "{\"success\":true,\"message\":\"Cartão cadastrado\"}");
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    request->send(response);
 }
 
 void handleRFIDDelete(AsyncWebServerRequest *request) {
-    // Stub
+    ApiRequestTimer timer;
+    if (!checkAPIKey(request)) return;
+    if (!rfidManager.isLoaded()) {
+        sendRFIDError(request, "Lista de cartões carregando", 503);
+        return;
+    }
+
+    // UID no caminho (/api/rfid/delete/<uid>) ou em ?uid=
+    String uidText;
+    String url = request->url();
+    int slash = url.lastIndexOf('/');
+    if (url.length() > strlen("/api/rfid/delete") && slash >= 0) {
+        uidText = url.substring(slash + 1);
+    } else if (request->hasParam("uid")) {
+        uidText = request->getParam("uid")->value();
+    }
+
+    uint8_t uid[RFID_UID_LENGTH];
+    uint8_t uidLength = parseRFIDUid(uidText, uid);
+    if (uidLength == 0) {
+        sendRFIDError(request, "UID inválido (4 ou 7 bytes em hex)");
+        return;
+    }
+
+    {
+        RFIDLock guard(rfidManager);
+        int index = rfidManager.findCardIndex(uid, uidLength);
+        if (index < 0) {
+            sendRFIDError(request, "Cartão não encontrado", 404);
+            return;
+        }
+        if (!rfidManager.removeCard(index)) {     // ⭐ v6.1.20: Tabela não gravada (cartão mantido)
+            sendRFIDError(request, "Falha ao salvar", 500);
+            return;
+        }
+    }
+
+    Serial.printf("[API] DELETE /api/rfid/delete: %s\n", uidText.c_str());
+    sendRFIDSuccess(request, "Cartão removido");
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════
+
+uint8_t parseRFIDUid(const String& text, uint8_t* uid) {
+    uint8_t len = 0;
+    int nibbles = 0;
+    uint8_t value = 0;
+
+    for (unsigned int i = 0; i < text.length(); i++) {
+        char c = text[i];
+        if (c == ':' || c == '-' || c == ' ') {
+            if (nibbles % 2) return 0;          // Byte pela metade
+            continue;
+        }
+        if (!isxdigit((unsigned char)c)) return 0;
+
+        value = (value << 4) | (isdigit((unsigned char)c) ? c - '0' : (tolower(c) - 'a' + 10));
+        if (++nibbles % 2 == 0) {
+            if (len >= RFID_UID_LENGTH - 1) return 0;
+            uid[len++] = value;
+            value = 0;
+        }
+    }
+    if (nibbles % 2) return 0;
+    return (len == 4 || len == 7) ? len : 0;
 }
 
 void sendRFIDError(AsyncWebServerRequest *request, const char* message, int code) {
-    // Stub
+    StaticJsonDocument<128> doc;
+    doc["success"] = false;
+    doc["error"] = message;
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->setCode(code);
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    serializeJson(doc, *response);
+    request->send(response);
 }
 
 void sendRFIDSuccess(AsyncWebServerRequest *request, const char* message) {
-    // Stub
+    StaticJsonDocument<128> doc;
+    doc["success"] = true;
+    doc["message"] = message;
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    serializeJson(doc, *response);
+    request->send(response);
 }
@@ -6,6 +6,7 @@
 #include "rfid_manager.h"
 #include "config.h"
 #include "pins.h"
+#include "spi_arbiter.h"
 #include <SPI.h>
 
 // ════════════════════════════════════════════════════════════════
@@ -18,12 +19,17 @@ RFIDManager rfidManager;
 // CONSTRUTOR/DESTRUTOR
 // ════════════════════════════════════════════════════════════════
 
-RFIDManager::RFIDManager() {
+RFIDManager::RFIDManager()
+    : table(RFID_CARDS_FILE, RFID_CARDS_TMP, RFID_CARDS_MAGIC, sizeof(RFIDCard), MAX_RFID_CARDS,
+            "rfid_cards", "card_") {
     card_count = 0;
     log_count = 0;
     last_read_time = 0;
     enrollState = RFID_IDLE;
     pn532 = nullptr;
+    mutex = xSemaphoreCreateRecursiveMutex();
+    data_gen = 0;
+    loaded = false;
 }
 
 RFIDManager::~RFIDManager() {
@@ -40,6 +46,19 @@ bool RFIDManager::init() {
     Serial.println("║     INICIALIZANDO RFID MANAGER (PN532)       ║");
     Serial.println("╚══════════════════════════════════════════════╝");
     
+    // ⭐ v6.1.20: Lista carregada antes do PN532 - sem o leitor a API e a
+    // importação continuam editando a lista gravada (antes partiam de uma
+    // lista vazia e a primeira gravação apagava a tabela)
+    Serial.println("🔧 Carregando cartões e logs...");
+    {
+        RFIDLock guard(*this);  // A API HTTP pode subir antes (tarefa do Wi-Fi)
+        loadCards();
+        loadLogsFromNVS();
+        loaded = true;
+    }
+    Serial.printf("✅ %d cartão(s) cadastrado(s)\n", card_count);
+    Serial.printf("✅ %d log(s) de acesso\n", log_count);
+    
     // ════════════════════════════════════════════════════════════════════════════
     // 🟢 HARDWARE CONECTADO - CÓDIGO HABILITADO v5.1.1
     // ════════════════════════════════════════════════════════════════════════════
@@ -55,40 +74,43 @@ bool RFIDManager::init() {
     Serial.println("⚠️  DIP Switch: CH1 (I0) = OFF, CH2 (I1) = ON (Modo SPI)");
     
     // ✅ v6.0.5: SEGUIR CÓDIGO FUNCIONAL - Passar &SPI no construtor
+    // ⭐ v6.1.10: Instância só é publicada em 'pn532' no fim do init (o loop
+    // não usa o leitor enquanto a tarefa de boot o configura)
     Serial.println("🔧 Criando instância PN532 (SPI)...");
-    pn532 = new Adafruit_PN532(PN532_SS_PIN, &SPI);  // ⭐ CRÍTICO: Passar &SPI
+    Adafruit_PN532* dev = new Adafruit_PN532(PN532_SS_PIN, &SPI);  // ⭐ CRÍTICO: Passar &SPI
     
-    // ✅ v6.0.5: PASSO 1 - Configurar GPIO21 (CS/SS) ANTES do begin()
-    Serial.println("🔧 Configurando pino CS do PN532...");
+    // ✅ v6.0.5: PASSO 1 - CS em HIGH antes do begin() (spiArbiter.begin() já o deixou assim)
     pinMode(PN532_SS_PIN, OUTPUT);
     digitalWrite(PN532_SS_PIN, HIGH);  // Desativar PN532 inicialmente
-    delay(10);  // Estabilização do pino
-    
-    // ✅ v6.0.5: PASSO 2 - Delay para estabilização do barramento SPI
-    Serial.println("   ⏱️  Aguardando estabilização (100ms)...");
-    delay(100);  // PN532 precisa ~7ms para sair do Power Down mode
     
-    // ✅ v6.0.5: PASSO 3 - Inicializar PN532 usando begin() da biblioteca
+    // ✅ v6.0.5: PASSO 2 - Inicializar PN532 usando begin() da biblioteca
     Serial.println("🔧 Chamando pn532->begin()...");
-    pn532->begin();  // ⭐ CRÍTICO: Biblioteca faz todo o wakeup automaticamente!
-    
-    // ✅ v6.0.5: PASSO 4 - Delay adicional após begin()
-    Serial.println("   ⏱️  Aguardando PN532 entrar em modo SPI (200ms)...");
-    delay(200);  // Permite que o PN532 entre em modo de comunicação SPI
+    {
+        SpiBusGuard bus(SPI_DEV_PN532, SPI_ARB_WAIT_FOREVER);
+        dev->begin();  // ⭐ CRÍTICO: Biblioteca faz todo o wakeup automaticamente!
+    }
     
-    // ✅ v6.0.5: PASSO 5 - Verificar firmware (com retry - até 3 tentativas)
+    // ⭐ v6.1.10: PASSO 3 - Polling do firmware no lugar dos delays fixos
+    // (10+100+200 ms e 500 ms entre tentativas). O PN532 sai do power-down em
+    // ~7 ms; cada tentativa reserva o SPI2 só pela própria transação, então o
+    // display continua desenhando entre elas.
     Serial.println("🔧 Verificando firmware do PN532...");
     uint32_t versiondata = 0;
-    for (int attempt = 1; attempt <= 3 && !versiondata; attempt++) {
-        if (attempt > 1) {
-            Serial.printf("   🔄 Tentativa %d/3...\n", attempt);
-            delay(500);  // Aguardar antes de nova tentativa
+    uint32_t t0 = millis();
+    uint8_t attempts = 0;
+    while (!versiondata) {
+        attempts++;
+        {
+            SpiBusGuard bus(SPI_DEV_PN532, SPI_ARB_WAIT_FOREVER);
+            versiondata = dev->getFirmwareVersion();
         }
-        versiondata = pn532->getFirmwareVersion();
+        if (versiondata || millis() - t0 >= PN532_READY_TIMEOUT_MS) break;
+        vTaskDelay(pdMS_TO_TICKS(PN532_READY_POLL_MS));
     }
     
     if (!versiondata) {
-        Serial.println("❌ PN532 não encontrado após 3 tentativas!");  // v6.0.5: Corrigido
+        Serial.printf("❌ PN532 não encontrado (%u tentativas em %lu ms)!\n",
+                      attempts, (unsigned long)(millis() - t0));
         Serial.println("\n🔍 CHECKLIST DE VERIFICAÇÃO:");
         Serial.println("═══════════════════════════════════════");
         Serial.printf("   1️⃣ PINAGEM SPI:\n");
@@ -113,12 +135,13 @@ bool RFIDManager::init() {
         Serial.println("      • LED do PN532 aceso (se houver)");
         Serial.println("═══════════════════════════════════════");
         Serial.println("✅ Sistema continuará sem RFID\n");
-        delete pn532;
-        pn532 = nullptr;
+        delete dev;
         return false;
     }
     
     // Exibir versão do firmware
+    Serial.printf("✅ PN532 respondeu em %lu ms (%u tentativa(s))\n",
+                  (unsigned long)(millis() - t0), attempts);
     Serial.print("✅ PN532 conectado! Firmware v");
     Serial.print((versiondata >> 24) & 0xFF, DEC);
     Serial.print('.');
@@ -126,23 +149,36 @@ bool RFIDManager::init() {
     
     // Configurar para leitura de cartões Mifare
     Serial.println("🔧 Configurando para modo Mifare...");
-    pn532->SAMConfig();
+    {
+        SpiBusGuard bus(SPI_DEV_PN532, SPI_ARB_WAIT_FOREVER);
+        dev->SAMConfig();
+    }
     Serial.println("✅ PN532 configurado para Mifare/NTAG/Ultralight");
     
-    // Carregar dados do NVS
-    Serial.println("🔧 Carregando dados do NVS...");
-    loadFromNVS();
-    loadLogsFromNVS();
-    
-    Serial.printf("✅ %d cartão(s) cadastrado(s)\n", card_count);
-    Serial.printf("✅ %d log(s) de acesso\n", log_count);
     Serial.println("╚══════════════════════════════════════════════╝\n");
     
+    pn532 = dev;
     return true;
 }
 
+// ════════════════════════════════════════════════════════════════
+// ACESSO CONCORRENTE
+// ════════════════════════════════════════════════════════════════
+
+bool RFIDManager::lock(uint32_t timeoutMs) {
+    if (!mutex) return true;
+    TickType_t ticks = timeoutMs == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+    return xSemaphoreTakeRecursive(mutex, ticks) == pdTRUE;
+}
+
+void RFIDManager::unlock() {
+    if (mutex) xSemaphoreGiveRecursive(mutex);
+}
+
 bool RFIDManager::isHardwareConnected() {
     if (!pn532) return false;
+    SpiBusGuard bus(SPI_DEV_PN532, SPI_ARB_PN532_WAIT_MS);
+    if (!bus) return false;
     uint32_t versiondata = pn532->getFirmwareVersion();
     return (versiondata != 0);
 }
@@ -157,6 +193,9 @@ bool RFIDManager::detectCard() {
     uint8_t uid[7];
     uint8_t uidLength;
     
+    SpiBusGuard bus(SPI_DEV_PN532, SPI_ARB_PN532_WAIT_MS);
+    if (!bus) return false;
+    
     // Timeout rápido para não bloquear
     return pn532->readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, &uidLength, 50);
 }
@@ -172,6 +211,9 @@ bool RFIDManager::readCard(uint8_t* uid, uint8_t* uid_length) {
         return false;
     }
     
+    SpiBusGuard bus(SPI_DEV_PN532, SPI_ARB_PN532_WAIT_MS);
+    if (!bus) return false;
+    
     // Ler cartão com timeout de 1 segundo
     bool success = pn532->readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, uid_length, 1000);
     
@@ -189,6 +231,7 @@ bool RFIDManager::readCard(uint8_t* uid, uint8_t* uid_length) {
 // ════════════════════════════════════════════════════════════════
 
 bool RFIDManager::addCard(uint8_t* uid, uint8_t uid_length, const char* name) {
+    RFIDLock guard(*this);
     // Verificar se já existe
     if (findCardIndex(uid, uid_length) >= 0) {
         Serial.println("❌ Cartão já cadastrado!");
@@ -197,7 +240,7 @@ bool RFIDManager::addCard(uint8_t* uid, uint8_t uid_length, const char* name) {
     
     // Verificar limite
     if (card_count >= MAX_RFID_CARDS) {
-        Serial.println("❌ Memória cheia! Máximo: 50 cartões");
+        Serial.printf("❌ Memória cheia! Máximo: %d cartões\n", MAX_RFID_CARDS);
         return false;
     }
     
@@ -212,9 +255,14 @@ bool RFIDManager::addCard(uint8_t* uid, uint8_t uid_length, const char* name) {
     card->active = true;
     card->access_count = 0;
     card->last_access = 0;
+    card->finger_slot = 0;
     
     card_count++;
-    saveToNVS();
+    if (!saveCards()) {
+        card_count--;   // Registro novo é o último: desfaz só em RAM
+        Serial.println("❌ Falha ao gravar o cartão");
+        return false;
+    }
     
     Serial.printf("✅ Cartão cadastrado: %s (%s)\n", name, uidToString(uid, uid_length).c_str());
     
@@ -222,6 +270,7 @@ bool RFIDManager::addCard(uint8_t* uid, uint8_t uid_length, const char* name) {
 }
 
 bool RFIDManager::removeCard(int index) {
+    RFIDLock guard(*this);
     if (index < 0 || index >= card_count) {
         Serial.println("❌ Índice inválido");
         return false;
@@ -235,34 +284,41 @@ bool RFIDManager::removeCard(int index) {
     }
     
     card_count--;
-    saveToNVS();
+    if (!saveCards()) {
+        loadCards();    // Tabela anterior continua intacta (rename não aconteceu)
+        Serial.println("❌ Falha ao gravar - cartão mantido");
+        return false;
+    }
     
     Serial.println("✅ Cartão removido");
     return true;
 }
 
 bool RFIDManager::removeCardByUID(uint8_t* uid, uint8_t uid_length) {
+    RFIDLock guard(*this);
     int index = findCardIndex(uid, uid_length);
     if (index < 0) return false;
     return removeCard(index);
 }
 
 bool RFIDManager::editCardName(int index, const char* new_name) {
+    RFIDLock guard(*this);
     if (index < 0 || index >= card_count) return false;
     
     strncpy(cards[index].name, new_name, RFID_NAME_LENGTH - 1);
     cards[index].name[RFID_NAME_LENGTH - 1] = '\0';
-    saveToNVS();
+    if (!saveCard(index)) return false;
     
     Serial.printf("✏️ Nome alterado: %s\n", new_name);
     return true;
 }
 
 bool RFIDManager::toggleCardActive(int index) {
+    RFIDLock guard(*this);
     if (index < 0 || index >= card_count) return false;
     
     cards[index].active = !cards[index].active;
-    saveToNVS();
+    if (!saveCard(index)) return false;
     
     Serial.printf("🔄 Cartão %s: %s\n", 
                   cards[index].name, 
@@ -270,11 +326,46 @@ bool RFIDManager::toggleCardActive(int index) {
     return true;
 }
 
+/**
+ * @brief Vincula o cartão ao slot da digital do titular (cartão + digital)
+ * Na leitura do cartão o AS608 só confere este slot (Match 1:1).
+ */
+bool RFIDManager::linkFinger(int index, uint16_t slot) {
+    RFIDLock guard(*this);
+    if (index < 0 || index >= card_count) return false;
+    
+    cards[index].finger_slot = slot;
+    if (!saveCard(index)) return false;
+    
+    if (slot) {
+        Serial.printf("🔗 Cartão %s → digital ID=%d\n", cards[index].name, slot);
+    } else {
+        Serial.printf("🔗 Cartão %s sem digital vinculada\n", cards[index].name);
+    }
+    return true;
+}
+
+/**
+ * @brief Acompanha a compactação/remoção de templates no AS608
+ */
+void RFIDManager::moveFingerSlot(uint16_t from, uint16_t to) {
+    RFIDLock guard(*this);
+    bool changed = false;
+    for (int i = 0; i < card_count; i++) {
+        if (cards[i].finger_slot == from) {
+            cards[i].finger_slot = to;
+            changed = true;
+        }
+    }
+    if (changed) saveCards();
+}
+
 // ════════════════════════════════════════════════════════════════
 // AUTENTICAÇÃO
 // ════════════════════════════════════════════════════════════════
 
 bool RFIDManager::isCardAuthorized(uint8_t* uid, uint8_t uid_length) {
+    RFIDLock guard(*this);
     int index = findCardIndex(uid, uid_length);
     
     if (index < 0) {
@@ -294,7 +385,7 @@ bool RFIDManager::isCardAuthorized(uint8_t* uid, uint8_t uid_length) {
     // Atualizar estatísticas
     card->access_count++;
     card->last_access = millis() / 1000;
-    saveToNVS();
+    saveCard(index);    // ⭐ v6.1.20: Só o registro (~42 bytes), não a lista
     
     Serial.printf("✅ Acesso autorizado: %s\n", card->name);
     logAccess(uid, uid_length, card->name, true);
@@ -303,6 +394,7 @@ bool RFIDManager::isCardAuthorized(uint8_t* uid, uint8_t uid_length) {
 }
 
 int RFIDManager::findCardIndex(uint8_t* uid, uint8_t uid_length) {
+    RFIDLock guard(*this);
     for (int i = 0; i < card_count; i++) {
         if (cards[i].uid_length == uid_length) {
             if (compareUID(cards[i].uid, uid, uid_length)) {
@@ -329,6 +421,7 @@ int RFIDManager::getCardCount() {
 }
 
 int RFIDManager::getActiveCardCount() {
+    RFIDLock guard(*this);
     int count = 0;
     for (int i = 0; i < card_count; i++) {
         if (cards[i].active) count++;
@@ -353,6 +446,7 @@ String RFIDManager::uidToString(uint8_t* uid, uint8_t uid_length) {
 }
 
 void RFIDManager::listCards() {
+    RFIDLock guard(*this);
     Serial.println("\n╔══════════════════════════════════════════════╗");
     Serial.println("║          CARTÕES RFID CADASTRADOS            ║");
     Serial.println("╠══════════════════════════════════════════════╣");
@@ -370,6 +464,9 @@ void RFIDManager::listCards() {
         Serial.printf("║      Acessos: %-4d  Último: %-12lu ║\n",
                       card->access_count,
                       card->last_access);
+        if (card->finger_slot) {
+            Serial.printf("║      Digital: ID %-3d                        ║\n", card->finger_slot);
+        }
         
         if (i < card_count - 1) {
             Serial.println("╠──────────────────────────────────────────────╣");
@@ -384,6 +481,7 @@ void RFIDManager::listCards() {
 // ════════════════════════════════════════════════════════════════
 
 void RFIDManager::logAccess(uint8_t* uid, uint8_t uid_length, const char* name, bool granted) {
+    RFIDLock guard(*this);
     if (log_count >= MAX_ACCESS_LOGS) {
         // Remover log mais antigo (FIFO)
         for (int i = 0; i < MAX_ACCESS_LOGS - 1; i++) {
@@ -418,12 +516,14 @@ AccessLog* RFIDManager::getLog(int index) {
 }
 
 void RFIDManager::clearLogs() {
+    RFIDLock guard(*this);
     log_count = 0;
     saveLogsToNVS();
     Serial.println("🗑️ Logs limpos");
 }
 
 String RFIDManager::logsToJSON() {
+    RFIDLock guard(*this);
     DynamicJsonDocument doc(4096);
     JsonArray array = doc.to<JsonArray>();
     
@@ -446,18 +546,12 @@ String RFIDManager::logsToJSON() {
 // ════════════════════════════════════════════════════════════════
 
 String RFIDManager::exportToJSON() {
+    RFIDLock guard(*this);
     DynamicJsonDocument doc(8192);
     JsonArray array = doc.to<JsonArray>();
     
     for (int i = 0; i < card_count; i++) {
-        RFIDCard* card = &cards[i];
-        JsonObject obj = array.createNestedObject();
-        obj["uid"] = uidToString(card->uid, card->uid_length);
-        obj["name"] = card->name;
-        obj["timestamp"] = card->timestamp;
-        obj["active"] = card->active;
-        obj["access_count"] = card->access_count;
-        obj["last_access"] = card->last_access;
+        cardToJSON(cards[i], array.createNestedObject());
     }
     
     String output;
@@ -465,7 +559,21 @@ String RFIDManager::exportToJSON() {
     return output;
 }
 
+/**
+ * @brief ⭐ v6.1.19: Um cartão em JSON (exportação e API paginada)
+ */
+void RFIDManager::cardToJSON(const RFIDCard& card, JsonObject obj, uint16_t fields) {
+    if (fields & RFID_FIELD_UID)          obj["uid"] = uidToString((uint8_t*)card.uid, card.uid_length);
+    if (fields & RFID_FIELD_NAME)         obj["name"] = card.name;
+    if (fields & RFID_FIELD_TIMESTAMP)    obj["timestamp"] = card.timestamp;
+    if (fields & RFID_FIELD_ACTIVE)       obj["active"] = card.active;
+    if (fields & RFID_FIELD_ACCESS_COUNT) obj["access_count"] = card.access_count;
+    if (fields & RFID_FIELD_LAST_ACCESS)  obj["last_access"] = card.last_access;
+    if (fields & RFID_FIELD_FINGER_SLOT)  obj["finger_slot"] = card.finger_slot;
+}
+
 bool RFIDManager::importFromJSON(const String& json) {
+    RFIDLock guard(*this);
     DynamicJsonDocument doc(8192);
     DeserializationError error = deserializeJson(doc, json);
     
@@ -504,19 +612,97 @@ bool RFIDManager::importFromJSON(const String& json) {
         card->active = obj["active"];
         card->access_count = obj["access_count"];
         card->last_access = obj["last_access"];
+        card->finger_slot = obj["finger_slot"] | 0;
         
         card_count++;
         imported++;
     }
     
-    saveToNVS();
+    if (!saveCards()) {
+        loadCards();
+        Serial.println("❌ Falha ao gravar a importação - lista anterior mantida");
+        return false;
+    }
     Serial.printf("✅ Importados %d cartões\n", imported);
     return true;
 }
 
+/**
+ * @brief ⭐ v6.1.20: Insere/atualiza um lote de cartões numa só transação
+ * Cartão existente mantém cadastro e estatísticas; só os campos informados
+ * mudam. A tabela é gravada uma vez no fim (e só se algo mudou): lote só de
+ * inclusões acrescenta os registros no fim do arquivo; com alterações a
+ * tabela é regravada inteira (temporário + rename, nada fica pela metade).
+ * Se a gravação falhar a lista volta ao que está em flash e os registros do
+ * lote ficam RFID_UPSERT_FAILED.
+ * @return Registros inseridos ou alterados (0 se a gravação falhou)
+ */
+int RFIDManager::upsertCards(RFIDUpsert* batch, uint8_t n) {
+    RFIDLock guard(*this);
+    int changed = 0;
+    int stored = card_count;    // Registros já no arquivo
+    bool updated = false;
+    
+    for (uint8_t k = 0; k < n; k++) {
+        RFIDUpsert& r = batch[k];
+        int index = findCardIndex(r.uid, r.uid_length);
+        
+        if (index < 0) {
+            if (card_count >= MAX_RFID_CARDS) {
+                r.result = RFID_UPSERT_FULL;
+                continue;
+            }
+            RFIDCard* card = &cards[card_count++];
+            memset(card, 0, sizeof(RFIDCard));
+            memcpy(card->uid, r.uid, r.uid_length);
+            card->uid_length = r.uid_length;
+            strncpy(card->name, r.name, RFID_NAME_LENGTH - 1);
+            card->timestamp = millis() / 1000;
+            card->active = (r.fields & RFID_FIELD_ACTIVE) ? r.active : true;
+            card->finger_slot = (r.fields & RFID_FIELD_FINGER_SLOT) ? r.finger_slot : 0;
+            r.result = RFID_UPSERT_INSERTED;
+            changed++;
+            continue;
+        }
+        
+        RFIDCard* card = &cards[index];
+        bool diff = strncmp(card->name, r.name, RFID_NAME_LENGTH) != 0 ||
+                    ((r.fields & RFID_FIELD_ACTIVE) && card->active != r.active) ||
+                    ((r.fields & RFID_FIELD_FINGER_SLOT) && card->finger_slot != r.finger_slot);
+        if (!diff) {
+            r.result = RFID_UPSERT_UNCHANGED;
+            continue;
+        }
+        strncpy(card->name, r.name, RFID_NAME_LENGTH - 1);
+        card->name[RFID_NAME_LENGTH - 1] = '\0';
+        if (r.fields & RFID_FIELD_ACTIVE) card->active = r.active;
+        if (r.fields & RFID_FIELD_FINGER_SLOT) card->finger_slot = r.finger_slot;
+        r.result = RFID_UPSERT_UPDATED;
+        updated = true;
+        changed++;
+    }
+    
+    if (changed == 0) return 0;
+    data_gen++;
+    bool ok = updated ? table.save(cards, card_count)
+                      : table.saveRange(cards, card_count, stored, card_count - stored);
+    if (!ok) {
+        for (uint8_t k = 0; k < n; k++) {
+            if (batch[k].result == RFID_UPSERT_INSERTED || batch[k].result == RFID_UPSERT_UPDATED) {
+                batch[k].result = RFID_UPSERT_FAILED;
+            }
+        }
+        loadCards();
+        Serial.printf("❌ Falha ao gravar lote de %d cartão(ões) - desfeito\n", changed);
+        return 0;
+    }
+    return changed;
+}
+
 void RFIDManager::clearAll() {
+    RFIDLock guard(*this);
     card_count = 0;
-    saveToNVS();
+    saveCards();
     Serial.println("🗑️ Todos os cartões removidos");
 }
 
@@ -579,7 +765,7 @@ String RFIDManager::getEnrollStateString() {
         case RFID_SAVING: return "Salvando...";
         case RFID_SUCCESS: return "Cadastrado com sucesso!";
         case RFID_ERROR_DUPLICATE: return "Erro: Cartao ja existe";
-        case RFID_ERROR_FULL: return "Erro: Memoria cheia (50)";
+        case RFID_ERROR_FULL: return "Erro: Memoria cheia";
         case RFID_ERROR_READ: return "Erro: Falha na leitura";
         case RFID_ERROR_HARDWARE: return "Erro: PN532 desconectado";
         default: return "Desconhecido";
@@ -587,33 +773,33 @@ String RFIDManager::getEnrollStateString() {
 }
 
 // ════════════════════════════════════════════════════════════════
-// PERSISTÊNCIA NVS
+// PERSISTÊNCIA (CARTÕES EM LITTLEFS, LOGS EM NVS)
 // ════════════════════════════════════════════════════════════════
 
-void RFIDManager::loadFromNVS() {
-    preferences.begin("rfid_cards", true);  // Read-only
-    
-    card_count = preferences.getInt("count", 0);
-    
-    for (int i = 0; i < card_count; i++) {
-        String key = "card_" + String(i);
-        preferences.getBytes(key.c_str(), &cards[i], sizeof(RFIDCard));
-    }
-    
-    preferences.end();
+/**
+ * @brief ⭐ v6.1.20: Tabela RFID_CARDS_FILE; sem ela, "count" + "card_N" do NVS
+ * As chaves antigas só saem depois de a tabela estar gravada (RecordTable).
+ */
+void RFIDManager::loadCards() {
+    data_gen++;
+    card_count = table.load(cards);
 }
 
-void RFIDManager::saveToNVS() {
-    preferences.begin("rfid_cards", false);  // Read-write
-    
-    preferences.putInt("count", card_count);
-    
-    for (int i = 0; i < card_count; i++) {
-        String key = "card_" + String(i);
-        preferences.putBytes(key.c_str(), &cards[i], sizeof(RFIDCard));
-    }
-    
-    preferences.end();
+/**
+ * @brief Regrava a lista inteira (inclusão, remoção, importação)
+ * @return true se os cartões estão em flash
+ */
+bool RFIDManager::saveCards() {
+    data_gen++;     // ⭐ v6.1.19: ETag da API (lista mudou)
+    return table.save(cards, card_count);
+}
+
+/**
+ * @brief Regrava só o registro do cartão (acesso, nome, ativo, digital)
+ */
+bool RFIDManager::saveCard(int index) {
+    data_gen++;
+    return table.saveRecord(cards, card_count, index);
 }
 
 void RFIDManager::loadLogsFromNVS() {
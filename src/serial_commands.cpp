@@ -37,6 +37,9 @@
 // Incluir interface dos managers (sem conflitos de estruturas)
 #include "manager_interface.h"
 
+// Requisições de manutenção (LittleFS)
+#include "maintenance_store.h"
+
 // Handlers RFID simples
 #include "rfid_handlers_simple.h"
 
@@ -92,6 +95,9 @@ void processSerialCommands() {
         Serial.println("CLEAR_BIO        - Remove TODOS os usuários");
         Serial.println("EXPORT_BIO       - Exporta dados em JSON");
         
+        Serial.println("\n=== MANUTENÇÃO ===");
+        Serial.println("MANUT            - Resumo e requisições pendentes");
+        
         Serial.println("\n=== BACKUP ===");
         Serial.println("BACKUP           - Faz backup completo");
         Serial.println("RESTORE          - Restaura backup");
@@ -302,7 +308,7 @@ void processSerialCommands() {
         uint16_t nextSlot = bioStorage.getNextFreeSlot();
         
         if (nextSlot > MAX_FINGERPRINTS) {
-            Serial.println("❌ Memória cheia (127 slots)");
+            Serial.printf("❌ Memória cheia (%d slots)\n", MAX_FINGERPRINTS);
         } else {
             BiometricUser user;
             user.slotId = nextSlot;
@@ -422,6 +428,15 @@ void processSerialCommands() {
         Serial.println("✅ Backup restaurado!");
     }
     
+    // ═══════════════════════════════════════════════════════════════
+    // COMANDOS DE MANUTENÇÃO
+    // ═══════════════════════════════════════════════════════════════
+    
+    else if (cmd == "MANUT") {
+        maintenanceStore.printSummary();
+        Serial.println("═══════════════════════════════════\n");
+    }
+    
     // ═══════════════════════════════════════════════════════════════
     // COMANDOS DE DEBUG
     // ═══════════════════════════════════════════════════════════════
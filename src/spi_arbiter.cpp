@@ -0,0 +1,153 @@
+/**
+ * @file spi_arbiter.cpp
+ * @brief Implementação do árbitro do barramento SPI2
+ * @version 1.1.0
+ * @date 2025-12-07
+ */
+
+#include "spi_arbiter.h"
+#include "pins.h"
+#include "config.h"
+
+SpiArbiter spiArbiter;
+
+// Dispositivos (ordem de SpiDevice)
+static const SpiDeviceConfig DEVICE_CONFIG[SPI_DEV_COUNT] = {
+    { "DISPLAY", TFT_CS       },
+    { "TOUCH",   TOUCH_CS     },
+    { "PN532",   PN532_SS_PIN },
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONSTRUTOR / INICIALIZAÇÃO
+// ═══════════════════════════════════════════════════════════════════════
+
+SpiArbiter::SpiArbiter()
+    : mutex(NULL),
+      currentOwner(SPI_DEV_COUNT),
+      holdStartUs(0),
+      statsSinceMs(0) {
+    memset((void*)waiting, 0, sizeof(waiting));
+    memset(stats, 0, sizeof(stats));
+}
+
+void SpiArbiter::begin() {
+    if (mutex == NULL) {
+        mutex = xSemaphoreCreateMutex();
+    }
+
+    for (int i = 0; i < SPI_DEV_COUNT; i++) {
+        if (DEVICE_CONFIG[i].csPin >= 0) {
+            pinMode(DEVICE_CONFIG[i].csPin, OUTPUT);
+            digitalWrite(DEVICE_CONFIG[i].csPin, HIGH);
+        }
+    }
+    resetStats();
+
+    Serial.println("✅ [SpiArbiter] Barramento SPI2: DISPLAY, TOUCH, PN532");
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// ARBITRAGEM
+// ═══════════════════════════════════════════════════════════════════════
+
+bool SpiArbiter::higherPriorityWaiting(SpiDevice dev) const {
+    for (int i = 0; i < dev; i++) {
+        if (waiting[i]) return true;
+    }
+    return false;
+}
+
+bool SpiArbiter::acquire(SpiDevice dev, uint32_t timeoutMs) {
+    if (mutex == NULL) return true;  // Antes do begin(): sem arbitragem
+
+    uint32_t t0 = micros();
+    uint32_t start = millis();
+    waiting[dev]++;
+
+    while (true) {
+        if (!higherPriorityWaiting(dev) && xSemaphoreTake(mutex, 0) == pdTRUE) {
+            break;
+        }
+        if (timeoutMs != SPI_ARB_WAIT_FOREVER && millis() - start >= timeoutMs) {
+            waiting[dev]--;
+            stats[dev].deferred++;
+            return false;
+        }
+        vTaskDelay(1);
+    }
+
+    waiting[dev]--;
+    currentOwner = dev;
+    holdStartUs = micros();
+
+    uint32_t waited = holdStartUs - t0;
+    stats[dev].acquisitions++;
+    stats[dev].waitUs += waited;
+    if (waited > stats[dev].waitMaxUs) stats[dev].waitMaxUs = waited;
+    return true;
+}
+
+void SpiArbiter::release(SpiDevice dev) {
+    if (mutex == NULL) return;
+    if (currentOwner != dev) {
+        Serial.printf("⚠️ [SpiArbiter] release(%s) sem ser o dono\n", DEVICE_CONFIG[dev].name);
+        return;
+    }
+
+    uint32_t held = micros() - holdStartUs;
+    stats[dev].holdUs += held;
+    if (held > stats[dev].holdMaxUs) stats[dev].holdMaxUs = held;
+
+    currentOwner = SPI_DEV_COUNT;
+    xSemaphoreGive(mutex);
+}
+
+const SpiDeviceConfig& SpiArbiter::config(SpiDevice dev) const {
+    return DEVICE_CONFIG[dev];
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// ESTATÍSTICAS
+// ═══════════════════════════════════════════════════════════════════════
+
+void SpiArbiter::resetStats() {
+    memset(stats, 0, sizeof(stats));
+    statsSinceMs = millis();
+}
+
+void SpiArbiter::printStats() {
+    uint32_t windowMs = millis() - statsSinceMs;
+
+    Serial.println("\n🔌 ═══════════════════════════════════════");
+    Serial.println("   BARRAMENTO SPI2 - USO POR DISPOSITIVO");
+    Serial.println("═══════════════════════════════════════");
+    Serial.printf("Janela: %lu ms | Dono atual: %s\n", (unsigned long)windowMs,
+                  currentOwner < SPI_DEV_COUNT ? DEVICE_CONFIG[currentOwner].name : "livre");
+    Serial.println("Disp.     Transações  Uso%   Hold máx(us)  Espera méd/máx(us)  Adiados");
+
+    for (int i = 0; i < SPI_DEV_COUNT; i++) {
+        const SpiDeviceStats& s = stats[i];
+        float usage = windowMs ? (float)s.holdUs / 10.0f / windowMs : 0.0f;  // us / (ms*1000) * 100
+        Serial.printf("%-8s %10lu %6.2f %13lu %9lu/%-9lu %8lu\n",
+                      DEVICE_CONFIG[i].name,
+                      (unsigned long)s.acquisitions, usage,
+                      (unsigned long)s.holdMaxUs,
+                      (unsigned long)(s.acquisitions ? s.waitUs / s.acquisitions : 0),
+                      (unsigned long)s.waitMaxUs,
+                      (unsigned long)s.deferred);
+    }
+    Serial.println("═══════════════════════════════════════\n");
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// GUARDA DE ESCOPO
+// ═══════════════════════════════════════════════════════════════════════
+
+SpiBusGuard::SpiBusGuard(SpiDevice dev, uint32_t timeoutMs)
+    : device(dev), granted(spiArbiter.acquire(dev, timeoutMs)) {
+}
+
+SpiBusGuard::~SpiBusGuard() {
+    if (granted) spiArbiter.release(device);
+}
@@ -0,0 +1,337 @@
+/**
+ * @file template_archive.cpp
+ * @brief Implementação do backup/restauração de templates do AS608
+ * @version 1.0.0
+ * @date 2025-12-07
+ */
+
+#include "template_archive.h"
+#include <esp_rom_crc.h>
+
+TemplateArchive templateArchive;
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONSTRUTOR
+// ═══════════════════════════════════════════════════════════════════════
+
+TemplateArchive::TemplateArchive()
+    : state(TPL_ARCHIVE_IDLE),
+      lastOp(TPL_ARCHIVE_IDLE),
+      idCount(0),
+      nextId(0),
+      remaining(0),
+      packetLen(0),
+      cur(0),
+      pipelined(true),
+      waiting(false),
+      replyPending(false),
+      total(0),
+      okCount(0),
+      failCount(0),
+      retryCount(0),
+      corruptCount(0),
+      bytes(0),
+      startUs(0),
+      elapsedUs(0),
+      aborted(false) {
+    memset(bufLen, 0, sizeof(bufLen));
+    memset(bufId, 0, sizeof(bufId));
+    memset(bufValid, 0, sizeof(bufValid));
+    memset(&lastReply, 0, sizeof(lastReply));
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// INÍCIO
+// ═══════════════════════════════════════════════════════════════════════
+
+bool TemplateArchive::startBackup() {
+    if (busy()) return false;
+
+    idCount = 0;
+    for (int i = 0; i < bioManager.getCount() && idCount < MAX_FINGERPRINTS; i++) {
+        Fingerprint* fp = bioManager.getFingerprint(i);
+        if (fp) ids[idCount++] = fp->id;
+    }
+    if (idCount == 0) {
+        Serial.println("⚠️  [TPL] Nenhuma digital cadastrada para backup");
+        return false;
+    }
+
+    if (!bioManager.beginBulk()) {
+        Serial.println("❌ [TPL] Sensor não disponível");
+        return false;
+    }
+
+    file = LittleFS.open(TPL_ARCHIVE_TMP, "w");
+    if (!file) {
+        Serial.println("❌ [TPL] Erro ao criar " TPL_ARCHIVE_TMP);
+        bioManager.endBulk();
+        return false;
+    }
+    TplArchiveHeader hdr = { TPL_ARCHIVE_MAGIC, 0, bioManager.getPacketLength() };
+    file.write((const uint8_t*)&hdr, sizeof(hdr));
+
+    state = lastOp = TPL_ARCHIVE_BACKUP;
+    total = idCount;
+    okCount = failCount = retryCount = corruptCount = 0;
+    bytes = 0;
+    aborted = false;
+    nextId = 0;
+    cur = 0;
+    pipelined = true;
+    startUs = micros();
+
+    Serial.printf("💾 [TPL] Backup de %u templates iniciado\n", total);
+    bufId[cur] = ids[nextId++];
+    if (!issue()) finish();
+    return true;
+}
+
+bool TemplateArchive::startRestore() {
+    if (busy()) return false;
+
+    file = LittleFS.open(TPL_ARCHIVE_FILE, "r");
+    if (!file) {
+        Serial.println("❌ [TPL] " TPL_ARCHIVE_FILE " não encontrado");
+        return false;
+    }
+    TplArchiveHeader hdr;
+    if (file.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr) || hdr.magic != TPL_ARCHIVE_MAGIC) {
+        Serial.println("❌ [TPL] Arquivo de templates inválido");
+        file.close();
+        return false;
+    }
+
+    if (!bioManager.beginBulk()) {
+        Serial.println("❌ [TPL] Sensor não disponível");
+        file.close();
+        return false;
+    }
+    packetLen = bioManager.getPacketLength();
+    if (hdr.packetLen != packetLen) {
+        // O template em si não depende do pacote; só a fragmentação muda
+        Serial.printf("⚠️  [TPL] Arquivo gerado com pacote de %u bytes, sensor usa %u\n",
+                      hdr.packetLen, packetLen);
+    }
+
+    state = lastOp = TPL_ARCHIVE_RESTORE;
+    total = remaining = hdr.count;
+    okCount = failCount = retryCount = corruptCount = 0;
+    bytes = 0;
+    aborted = false;
+    cur = 0;
+    pipelined = true;
+    startUs = micros();
+
+    Serial.printf("♻️  [TPL] Restauração de %u templates iniciada\n", total);
+    if (!readRecord(cur) || !issue()) {
+        finish();
+        return true;
+    }
+    readRecord(cur ^ 1);    // Próximo já conferido enquanto este vai pela UART
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// PIPELINE
+// ═══════════════════════════════════════════════════════════════════════
+
+void TemplateArchive::onReply(const As608Reply& reply, void* ctx) {
+    TemplateArchive* self = static_cast<TemplateArchive*>(ctx);
+    self->lastReply = reply;
+    self->replyPending = true;
+}
+
+bool TemplateArchive::issue() {
+    As608Async& drv = bioManager.driver();
+    bool sent;
+    if (state == TPL_ARCHIVE_BACKUP) {
+        sent = drv.upload(bufId[cur], buf[cur], AS608_TEMPLATE_MAX, TPL_ARCHIVE_TIMEOUT_MS,
+                          onReply, this, pipelined);
+    } else {
+        sent = drv.download(bufId[cur], buf[cur], bufLen[cur], packetLen, TPL_ARCHIVE_TIMEOUT_MS,
+                            onReply, this, pipelined);
+    }
+    waiting = sent;
+    replyPending = false;
+    return sent;
+}
+
+void TemplateArchive::update() {
+    if (state == TPL_ARCHIVE_IDLE) return;
+
+    bioManager.driver().poll();
+    if (!replyPending) {
+        // Chamada síncrona no meio (syncSensor) cancelou a transferência
+        if (waiting && !bioManager.driver().busy()) {
+            Serial.println("⚠️  [TPL] Transferência cancelada por outro uso do sensor");
+            aborted = true;
+            finish();
+        }
+        return;
+    }
+    replyPending = false;
+    waiting = false;
+
+    const As608Reply& r = lastReply;
+    bool ok = (r.transport == AS608_REPLY_OK && r.code == AS608_OK);
+    if (state == TPL_ARCHIVE_BACKUP) ok = ok && r.bulkLen > 0;
+
+    if (!ok && pipelined) {
+        // Sensor perdeu bytes com a escrita contínua: mesmo ID, passo a passo
+        retryCount++;
+        pipelined = false;
+        if (!issue()) finish();
+        return;
+    }
+    pipelined = true;
+
+    if (!ok) {
+        failCount++;
+        Serial.printf("❌ [TPL] ID %u: cmd 0x%02X %s (código 0x%02X)\n", bufId[cur], r.command,
+                      r.transport == AS608_REPLY_OK ? "recusado" :
+                      r.transport == AS608_REPLY_TIMEOUT ? "timeout" : "pacote inválido", r.code);
+    }
+
+    if (state == TPL_ARCHIVE_BACKUP) {
+        if (ok) bufLen[cur] = r.bulkLen;
+        backupStep(ok);
+    } else {
+        restoreStep(ok);
+    }
+}
+
+void TemplateArchive::backupStep(bool ok) {
+    uint8_t done = cur;
+
+    // Próxima leitura já sai antes de gravar esta no LittleFS
+    bool sent = false;
+    if (nextId < idCount) {
+        cur ^= 1;
+        bufId[cur] = ids[nextId++];
+        sent = issue();
+    }
+
+    if (ok) {
+        if (writeRecord(done)) {
+            okCount++;
+            bytes += bufLen[done];
+        } else {
+            failCount++;
+        }
+    }
+
+    if (!sent) finish();
+}
+
+void TemplateArchive::restoreStep(bool ok) {
+    if (ok) {
+        okCount++;
+        bytes += bufLen[cur];
+    }
+    bufValid[cur] = false;
+
+    cur ^= 1;
+    if (!bufValid[cur] || !issue()) {
+        finish();
+        return;
+    }
+    readRecord(cur ^ 1);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// ARQUIVO
+// ═══════════════════════════════════════════════════════════════════════
+
+bool TemplateArchive::readRecord(uint8_t slot) {
+    bufValid[slot] = false;
+
+    while (remaining > 0) {
+        remaining--;
+        TplRecordHeader rec;
+        if (file.read((uint8_t*)&rec, sizeof(rec)) != sizeof(rec) ||
+            rec.len == 0 || rec.len > AS608_TEMPLATE_MAX ||
+            file.read(buf[slot], rec.len) != rec.len) {
+            // Arquivo truncado: o resto não é confiável
+            corruptCount += remaining + 1;
+            remaining = 0;
+            Serial.println("❌ [TPL] Arquivo truncado");
+            return false;
+        }
+        if (esp_rom_crc32_le(0, buf[slot], rec.len) != rec.crc) {
+            corruptCount++;
+            Serial.printf("⚠️  [TPL] ID %u: CRC inválido, ignorado\n", rec.id);
+            continue;
+        }
+        bufId[slot] = rec.id;
+        bufLen[slot] = rec.len;
+        bufValid[slot] = true;
+        return true;
+    }
+    return false;
+}
+
+bool TemplateArchive::writeRecord(uint8_t slot) {
+    TplRecordHeader rec = { bufId[slot], bufLen[slot], esp_rom_crc32_le(0, buf[slot], bufLen[slot]) };
+    if (file.write((const uint8_t*)&rec, sizeof(rec)) != sizeof(rec) ||
+        file.write(buf[slot], bufLen[slot]) != bufLen[slot]) {
+        Serial.printf("❌ [TPL] ID %u: erro de escrita no LittleFS\n", bufId[slot]);
+        return false;
+    }
+    return true;
+}
+
+void TemplateArchive::finish() {
+    elapsedUs = micros() - startUs;
+
+    if (state == TPL_ARCHIVE_BACKUP) {
+        TplArchiveHeader hdr = { TPL_ARCHIVE_MAGIC, okCount, bioManager.getPacketLength() };
+        file.seek(0);
+        file.write((const uint8_t*)&hdr, sizeof(hdr));
+        file.close();
+
+        // Backup incompleto não substitui o anterior
+        if (!aborted && okCount > 0 && LittleFS.rename(TPL_ARCHIVE_TMP, TPL_ARCHIVE_FILE)) {
+            Serial.println("✅ [TPL] Backup salvo em " TPL_ARCHIVE_FILE);
+        } else {
+            LittleFS.remove(TPL_ARCHIVE_TMP);
+            Serial.println("❌ [TPL] Backup descartado");
+        }
+    } else {
+        file.close();
+    }
+
+    state = TPL_ARCHIVE_IDLE;
+    waiting = false;
+    replyPending = false;
+    bioManager.endBulk();
+    printStatus();
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// RELATÓRIO
+// ═══════════════════════════════════════════════════════════════════════
+
+void TemplateArchive::printStatus() {
+    uint32_t us = busy() ? micros() - startUs : elapsedUs;
+
+    Serial.println("\n🧬 ═══════════════════════════════════════");
+    Serial.println("   TEMPLATES DO AS608");
+    Serial.println("═══════════════════════════════════════");
+    if (lastOp == TPL_ARCHIVE_IDLE) {
+        Serial.println("Nenhuma operação desde o boot");
+        Serial.println("═══════════════════════════════════════\n");
+        return;
+    }
+    Serial.printf("Operação     : %s%s\n", lastOp == TPL_ARCHIVE_BACKUP ? "backup" : "restauração",
+                  busy() ? " (em andamento)" : aborted ? " (cancelada)" : "");
+    Serial.printf("Templates    : %u/%u ok | %u falhas | %u CRC/truncados\n",
+                  okCount, total, failCount, corruptCount);
+    Serial.printf("Repetições   : %u (passo a passo)\n", retryCount);
+    Serial.printf("Tempo        : %lu ms\n", (unsigned long)(us / 1000));
+    if (us > 0 && okCount > 0) {
+        Serial.printf("Vazão        : %.2f templates/s (%lu bytes/s)\n",
+                      okCount * 1000000.0f / us, (unsigned long)((uint64_t)bytes * 1000000 / us));
+    }
+    Serial.println("═══════════════════════════════════════\n");
+}
@@ -2,7 +2,7 @@
  * @file wifi_api.cpp
  * @brief Implementação da API REST para gerenciamento Wi-Fi
  * @date 22/11/2025
- * @version 1.0
+ * @version 1.1
  * 
  * Sistema completo de gerenciamento Wi-Fi:
  * - Conexão a redes Wi-Fi existentes
@@ -11,10 +11,17 @@
  * - Portal web de configuração
  * - Persistência de credenciais
  * - Reconexão automática
+ * 
+ * v1.1: AsyncWebServer (tarefa async_tcp). Nada aqui pode bloquear essa
+ * tarefa: scan usa o modo assíncrono do WiFi e connect/disconnect rodam em
+ * uma tarefa FreeRTOS própria (wifi_connect_task).
  */
 
 #include "config.h"
 #include "wifi_config.h"
+#include "rfid_handlers_simple.h"
+#include "credential_api.h"
+#include "credential_import.h"
 
 #if WIFI_ENABLED && WIFI_MDNS_ENABLED
 #include <ESPmDNS.h>
@@ -24,8 +31,9 @@
  * VARIÁVEIS GLOBAIS
  * ========================================================================== */
 
-WebServer server(WEBSERVER_PORT);
+AsyncWebServer server(WEBSERVER_PORT);
 Preferences wifiPrefs;
+ApiStats apiStats = {0, 0, 0};
 
 bool wifiConnected = false;
 bool wifiAPMode = false;
@@ -33,6 +41,12 @@ String currentSSID = "";
 String currentPassword = "";
 unsigned long lastWiFiCheck = 0;
 
+// Conexão pedida pela API (executada em wifi_connect_task)
+static String pendingSSID;
+static String pendingPassword;
+static volatile bool wifiConnecting = false;
+static volatile bool wifiDisconnectPending = false;
+
 /* ============================================================================
  * INICIALIZAÇÃO WI-FI
  * ========================================================================== */
@@ -298,12 +312,7 @@ String getEncryptionType(uint8_t encryptionType) {
  * ========================================================================== */
 
 void setupAPIRoutes() {
-    // ⚠️ IMPORTANTE: Configurar WebServer para aceitar headers customizados
-    const char* headerKeys[] = {"X-API-Key"};
-    size_t headerKeysSize = sizeof(headerKeys) / sizeof(char*);
-    server.collectHeaders(headerKeys, headerKeysSize);
-    
-    Serial.println("[API] Headers customizados configurados: X-API-Key");
+    // AsyncWebServer guarda todos os headers: X-API-Key disponível sem collectHeaders()
     
     // Preflight CORS (OPTIONS)
     server.on("/api/wifi/scan", HTTP_OPTIONS, handleCORS);
@@ -313,10 +322,28 @@ void setupAPIRoutes() {
     
     // Rotas da API
     server.on("/api/wifi/scan", HTTP_GET, handleWiFiScan);
-    server.on("/api/wifi/connect", HTTP_POST, handleWiFiConnect);
+    server.on("/api/wifi/connect", HTTP_POST,
+        [](AsyncWebServerRequest *request) {
+            if (!request->_tempObject) {
+                request->send(400, "application/json", "{\"error\":\"JSON inválido\"}");
+            } else {
+                handleWiFiConnect(request, (uint8_t*)request->_tempObject, request->contentLength());
+            }
+        },
+        nullptr,
+        [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            if (total > 512) return;    // Mesmo limite do StaticJsonDocument do handler
+            if (index == 0) request->_tempObject = malloc(total);
+            if (request->_tempObject) memcpy((uint8_t*)request->_tempObject + index, data, len);
+        });
     server.on("/api/wifi/status", HTTP_GET, handleWiFiStatus);
     server.on("/api/wifi/disconnect", HTTP_POST, handleWiFiDisconnect);
     
+    // ⭐ v1.1: Endpoints RFID (rfid_handlers_simple.cpp)
+    setupRFIDEndpointsSimple(server);
+    setupCredentialImport(server);     // Antes de /api/cards (casaria /api/cards/import)
+    setupCredentialEndpoints(server);  // Paginado + ETag (credential_api.cpp)
+    
     // Página principal
     server.on("/", HTTP_GET, handleRoot);
     
@@ -334,61 +361,122 @@ void setupAPIRoutes() {
  * AUTENTICAÇÃO E CORS
  * ========================================================================== */
 
-bool checkAPIKey() {
-    Serial.println("[API] Verificando autenticação...");
-    Serial.printf("[API] API_KEY esperada: '%s' (length=%d)\n", API_KEY, strlen(API_KEY));
-    
-    // Listar TODOS os headers recebidos para debug
-    Serial.println("[API] Headers recebidos:");
-    for (int i = 0; i < server.headers(); i++) {
-        Serial.printf("  [%d] %s: %s\n", i, server.headerName(i).c_str(), server.header(i).c_str());
-    }
-    
-    if (!server.hasHeader("X-API-Key")) {
-        server.send(401, "application/json", "{\"error\":\"API Key obrigatória\"}");
-        Serial.println("[API] ✗ Requisição sem API Key");
-        Serial.println("[API] ✗ Header X-API-Key não encontrado!");
+bool checkAPIKey(AsyncWebServerRequest *request) {
+    // ⭐ v1.1: Sem dump de headers por requisição (Serial na tarefa async_tcp
+    // vira o gargalo com vários clientes)
+    if (!request->hasHeader("X-API-Key")) {
+        request->send(401, "application/json", "{\"error\":\"API Key obrigatória\"}");
+        Serial.printf("[API] ✗ %s sem API Key\n", request->url().c_str());
         return false;
     }
     
-    String apiKey = server.header("X-API-Key");
-    Serial.printf("[API] API_KEY recebida: '%s' (length=%d)\n", apiKey.c_str(), apiKey.length());
-    
-    if (apiKey != API_KEY) {
-        server.send(403, "application/json", "{\"error\":\"API Key inválida\"}");
-        Serial.println("[API] ✗ API Key inválida");
-        Serial.printf("[API] ✗ Esperado: '%s'\n", API_KEY);
-        Serial.printf("[API] ✗ Recebido: '%s'\n", apiKey.c_str());
+    if (request->getHeader("X-API-Key")->value() != API_KEY) {
+        request->send(403, "application/json", "{\"error\":\"API Key inválida\"}");
+        Serial.printf("[API] ✗ %s com API Key inválida\n", request->url().c_str());
         return false;
     }
     
-    Serial.println("[API] ✓ API Key válida!");
     return true;
 }
 
-void handleCORS() {
-    server.sendHeader("Access-Control-Allow-Origin", "*");
-    server.sendHeader("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
-    server.sendHeader("Access-Control-Allow-Headers", "Content-Type, X-API-Key");
-    server.send(200);
+void handleCORS(AsyncWebServerRequest *request) {
+    AsyncWebServerResponse *response = request->beginResponse(200);
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    response->addHeader("Access-Control-Allow-Methods", "GET, POST, DELETE, OPTIONS");
+    response->addHeader("Access-Control-Allow-Headers", "Content-Type, X-API-Key");
+    request->send(response);
+}
+
+ApiRequestTimer::~ApiRequestTimer() {
+    uint32_t us = micros() - t0;
+    apiStats.requests++;
+    apiStats.busyUs += us;
+    if (us > apiStats.maxUs) apiStats.maxUs = us;
+}
+
+void printApiStats(uint32_t loopMaxUs, uint32_t loopAvgUs) {
+    static uint32_t lastMs = 0;
+    static uint32_t lastRequests = 0;
+    
+    uint32_t now = millis();
+    uint32_t elapsed = lastMs ? now - lastMs : now;
+    uint32_t requests = apiStats.requests - lastRequests;
+    
+    Serial.println("\n🌐 ═══════════════════════════════════════");
+    Serial.println("   API HTTP (AsyncWebServer)");
+    Serial.println("═══════════════════════════════════════");
+    Serial.printf("Período      : %lu ms\n", (unsigned long)elapsed);
+    Serial.printf("Requisições : %lu (%.1f req/s)\n", (unsigned long)requests,
+                  elapsed ? requests * 1000.0f / elapsed : 0.0f);
+    Serial.printf("Handlers     : média %lu us | máx %lu us (total %lu)\n",
+                  (unsigned long)(apiStats.requests ? apiStats.busyUs / apiStats.requests : 0),
+                  (unsigned long)apiStats.maxUs, (unsigned long)apiStats.requests);
+    Serial.printf("Loop         : média %lu us | máx %lu us\n",
+                  (unsigned long)loopAvgUs, (unsigned long)loopMaxUs);
+    Serial.println("═══════════════════════════════════════\n");
+    
+    lastMs = now;
+    lastRequests = apiStats.requests;
+    apiStats.maxUs = 0;
 }
 
 /* ============================================================================
  * HANDLERS DA API
  * ========================================================================== */
 
-void handleWiFiScan() {
+/**
+ * @brief Connect/disconnect pedidos pela API (tarefa própria, podem levar 20 s)
+ */
+static void wifi_connect_task(void* arg) {
+    vTaskDelay(pdMS_TO_TICKS(500));     // Resposta 202 sai antes de o rádio trocar de modo
+    
+    if (wifiDisconnectPending) {
+        WiFi.disconnect();
+        wifiConnected = false;
+        clearSavedCredentials();
+        startAPMode();
+        wifiDisconnectPending = false;
+        Serial.println("[WiFi] Desconectado e modo AP iniciado");
+    } else {
+        connectToWiFi(pendingSSID, pendingPassword);
+    }
+    
+    wifiConnecting = false;
+    vTaskDelete(NULL);
+}
+
+static bool startWiFiTask() {
+    if (wifiConnecting) return false;
+    wifiConnecting = true;
+    if (xTaskCreate(wifi_connect_task, "wifi_api", BOOT_WIFI_TASK_STACK, NULL, 1, NULL) != pdPASS) {
+        wifiConnecting = false;
+        return false;
+    }
+    return true;
+}
+
+void handleWiFiScan(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
     Serial.println("[API] GET /api/wifi/scan");
     
     // Verificar autenticação
-    if (!checkAPIKey()) return;
-    
-    // Escanear redes
-    Serial.println("[WiFi] Escaneando redes...");
-    int networksFound = WiFi.scanNetworks();
+    if (!checkAPIKey(request)) return;
+    
+    // ⭐ v1.1: Scan assíncrono - WiFi.scanNetworks() bloquearia a tarefa async_tcp ~2 s
+    int networksFound = WiFi.scanComplete();
+    if (networksFound == WIFI_SCAN_FAILED) {
+        WiFi.scanNetworks(true);
+        networksFound = WIFI_SCAN_RUNNING;
+    }
+    if (networksFound == WIFI_SCAN_RUNNING) {
+        AsyncWebServerResponse *response = request->beginResponse(202, "application/json", "{\"scanning\":true}");
+        response->addHeader("Access-Control-Allow-Origin", "*");
+        request->send(response);
+        return;
+    }
     
     // Criar JSON de resposta
-    StaticJsonDocument<4096> doc;
+    DynamicJsonDocument doc(4096);
     JsonArray networks = doc.createNestedArray("networks");
     
     for (int i = 0; i < networksFound; i++) {
@@ -400,70 +488,71 @@ void handleWiFiScan() {
         network["bssid"] = WiFi.BSSIDstr(i);
     }
     
-    String response;
-    serializeJson(doc, response);
-    
     // Enviar resposta com CORS
-    server.sendHeader("Access-Control-Allow-Origin", "*");
-    server.send(200, "application/json", response);
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    serializeJson(doc, *response);
+    request->send(response);
     
     Serial.printf("[WiFi] %d redes encontradas\n", networksFound);
     
-    // Limpar resultado do scan
+    // Limpar resultado do scan (próxima chamada escaneia de novo)
     WiFi.scanDelete();
 }
 
-void handleWiFiConnect() {
+void handleWiFiConnect(AsyncWebServerRequest *request, uint8_t *data, size_t len) {
+    ApiRequestTimer timer;
     Serial.println("[API] POST /api/wifi/connect");
     
     // Verificar autenticação
-    if (!checkAPIKey()) return;
+    if (!checkAPIKey(request)) return;
     
     // Parsear JSON
     StaticJsonDocument<512> doc;
-    DeserializationError error = deserializeJson(doc, server.arg("plain"));
+    DeserializationError error = deserializeJson(doc, (const char*)data, len);
     
     if (error) {
-        server.send(400, "application/json", "{\"error\":\"JSON inválido\"}");
+        request->send(400, "application/json", "{\"error\":\"JSON inválido\"}");
         Serial.println("[API] ✗ JSON inválido");
         return;
     }
     
-    String ssid = doc["ssid"].as<String>();
-    String password = doc["password"].as<String>();
-    
-    Serial.printf("[WiFi] Tentando conectar: SSID='%s'\n", ssid.c_str());
+    if (wifiConnecting) {
+        request->send(409, "application/json", "{\"error\":\"Conexão já em andamento\"}");
+        return;
+    }
     
-    // Tentar conectar
-    bool success = connectToWiFi(ssid, password);
+    pendingSSID = doc["ssid"].as<String>();
+    pendingPassword = doc["password"].as<String>();
     
-    // Resposta
-    StaticJsonDocument<256> response;
-    response["success"] = success;
-    response["message"] = success ? "Conectado com sucesso" : "Falha na conexão";
+    Serial.printf("[WiFi] Tentando conectar: SSID='%s'\n", pendingSSID.c_str());
     
-    if (success) {
-        response["ip"] = WiFi.localIP().toString();
-        response["rssi"] = WiFi.RSSI();
-    }
+    // ⭐ v1.1: Conexão fora da tarefa async_tcp; resultado em /api/wifi/status
+    bool started = startWiFiTask();
     
-    String responseStr;
-    serializeJson(response, responseStr);
+    StaticJsonDocument<128> response;
+    response["success"] = started;
+    response["message"] = started ? "Conectando..." : "Falha ao iniciar conexão";
     
-    server.sendHeader("Access-Control-Allow-Origin", "*");
-    server.send(200, "application/json", responseStr);
+    AsyncResponseStream *stream = request->beginResponseStream("application/json");
+    stream->setCode(started ? 202 : 500);
+    stream->addHeader("Access-Control-Allow-Origin", "*");
+    serializeJson(response, *stream);
+    request->send(stream);
 }
 
-void handleWiFiStatus() {
+void handleWiFiStatus(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
     Serial.println("[API] GET /api/wifi/status");
     
     // Verificar autenticação
-    if (!checkAPIKey()) return;
+    if (!checkAPIKey(request)) return;
     
     // Criar JSON de status
     StaticJsonDocument<512> doc;
     
     doc["connected"] = (WiFi.status() == WL_CONNECTED);
+    doc["connecting"] = (bool)wifiConnecting;
     doc["ap_mode"] = wifiAPMode;
     
     if (WiFi.status() == WL_CONNECTED) {
@@ -479,36 +568,34 @@ void handleWiFiStatus() {
         doc["ap_clients"] = WiFi.softAPgetStationNum();
     }
     
-    String response;
-    serializeJson(doc, response);
-    
-    server.sendHeader("Access-Control-Allow-Origin", "*");
-    server.send(200, "application/json", response);
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    serializeJson(doc, *response);
+    request->send(response);
 }
 
-void handleWiFiDisconnect() {
+void handleWiFiDisconnect(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
     Serial.println("[API] POST /api/wifi/disconnect");
     
     // Verificar autenticação
-    if (!checkAPIKey()) return;
-    
-    // Desconectar
-    WiFi.disconnect();
-    wifiConnected = false;
-    
-    // Limpar credenciais salvas
-    clearSavedCredentials();
+    if (!checkAPIKey(request)) return;
     
-    // Iniciar modo AP
-    startAPMode();
-    
-    server.sendHeader("Access-Control-Allow-Origin", "*");
-    server.send(200, "application/json", "{\"success\":true}");
+    // Desconectar + limpar credenciais + modo AP na tarefa do Wi-Fi
+    wifiDisconnectPending = true;
+    if (!startWiFiTask()) {
+        wifiDisconnectPending = false;
+        request->send(409, "application/json", "{\"error\":\"Conexão já em andamento\"}");
+        return;
+    }
     
-    Serial.println("[WiFi] Desconectado e modo AP iniciado");
+    AsyncWebServerResponse *response = request->beginResponse(200, "application/json", "{\"success\":true}");
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    request->send(response);
 }
 
-void handleRoot() {
+void handleRoot(AsyncWebServerRequest *request) {
+    ApiRequestTimer timer;
     String html = R"HTMLPAGE(
 <!DOCTYPE html>
 <html lang="pt-BR">
@@ -704,9 +791,15 @@ void handleRoot() {
       console.log('[Scan] Enviando requisicao com API_KEY:', API_KEY);
       
       try {
-        const res = await fetch('/api/wifi/scan', {
-          headers: { 'X-API-Key': API_KEY }
-        });
+        // Scan roda em segundo plano no ESP32: 202 = ainda escaneando
+        let res;
+        for (let i = 0; i < 20; i++) {
+          res = await fetch('/api/wifi/scan', {
+            headers: { 'X-API-Key': API_KEY }
+          });
+          if (res.status !== 202) break;
+          await new Promise(r => setTimeout(r, 500));
+        }
         
         console.log('[Scan] Status:', res.status);
         console.log('[Scan] Headers enviados:', { 'X-API-Key': API_KEY });
@@ -771,9 +864,10 @@ void handleRoot() {
         const data = await res.json();
         
         if (data.success) {
+          // A conexão termina depois da resposta; na troca AP -> rede o portal cai
           status.innerHTML = `<div class="status success">
-            Conectado com sucesso!<br>
-            <small>IP: ${data.ip} | Sinal: ${data.rssi} dBm</small>
+            ${data.message}<br>
+            <small>Se o ESP32 entrar na rede, acesse pelo IP novo ou http://controlacesso.local</small>
           </div>`;
           setTimeout(() => {
             status.innerHTML += '<div class="status info">Recarregando pagina...</div>';
@@ -797,16 +891,16 @@ void handleRoot() {
 </html>
 )HTMLPAGE";
     
-    server.send(200, "text/html", html);
+    request->send(200, "text/html", html);
 }
 
-void handleNotFound() {
+void handleNotFound(AsyncWebServerRequest *request) {
     StaticJsonDocument<128> doc;
     doc["error"] = "Rota não encontrada";
-    doc["path"] = server.uri();
+    doc["path"] = request->url();
     
     String response;
     serializeJson(doc, response);
     
-    server.send(404, "application/json", response);
+    request->send(404, "application/json", response);
 }
\ No newline at end of file
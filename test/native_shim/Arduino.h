@@ -0,0 +1,93 @@
+/**
+ * @file Arduino.h
+ * @brief Shim mínimo do core Arduino para os testes nativos (env:native)
+ *
+ * Relógio simulado (native_now_us) e um HardwareSerial que é a ponta do
+ * host de uma UART virtual: o teste liga o outro lado a um AS608 simulado
+ * (onWrite) e entrega os bytes do sensor com inject(), que chama o
+ * callback de onReceive() como a tarefa de eventos da UART do core.
+ * Serial (console) descarta as mensagens.
+ */
+
+#ifndef NATIVE_SHIM_ARDUINO_H
+#define NATIVE_SHIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+#include "freertos/FreeRTOS.h"
+
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════
+// RELÓGIO SIMULADO
+// ═══════════════════════════════════════════════════════════════════════
+
+// native_now_us / vTaskDelay: freertos/FreeRTOS.h deste diretório
+inline uint32_t millis() { return (uint32_t)(native_now_us / 1000); }
+inline uint32_t micros() { return (uint32_t)native_now_us; }
+
+// ═══════════════════════════════════════════════════════════════════════
+// UART VIRTUAL
+// ═══════════════════════════════════════════════════════════════════════
+
+class HardwareSerial {
+public:
+    int available() { return (int)rx.size(); }
+
+    int read() {
+        if (rx.empty()) return -1;
+        uint8_t b = rx.front();
+        rx.pop_front();
+        return b;
+    }
+
+    size_t write(const uint8_t* buf, size_t len) {
+        if (len == 0) return 0;
+        if (onWrite) onWrite(buf, len);
+        return len;
+    }
+
+    void onReceive(std::function<void()> cb) { rxCb = cb; }
+
+    // Lado do sensor simulado
+    std::function<void(const uint8_t* buf, size_t len)> onWrite;
+
+    void inject(const uint8_t* buf, size_t len) {
+        rx.insert(rx.end(), buf, buf + len);
+        if (rxCb) rxCb();
+    }
+
+    void reset() {
+        rx.clear();
+        rxCb = nullptr;
+        onWrite = nullptr;
+    }
+
+private:
+    std::deque<uint8_t> rx;
+    std::function<void()> rxCb;
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+// CONSOLE
+// ═══════════════════════════════════════════════════════════════════════
+
+class NativeConsole {
+public:
+    template <typename... Args> int printf(const char*, Args...) { return 0; }
+    template <typename T> size_t print(const T&) { return 0; }
+    template <typename T> size_t println(const T&) { return 0; }
+    size_t println() { return 0; }
+};
+
+inline NativeConsole Serial;
+
+#endif // NATIVE_SHIM_ARDUINO_H
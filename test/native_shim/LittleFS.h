@@ -0,0 +1,115 @@
+/**
+ * @file LittleFS.h
+ * @brief Shim do LittleFS em memória para os testes nativos (env:native)
+ *
+ * Arquivos num std::map. Como no LittleFS, o que foi escrito só vale no
+ * close() (o conteúdo parcial de uma escrita curta também). Falhas
+ * injetáveis: writeBudget (bytes até as escritas pararem) e failRename.
+ */
+
+#ifndef NATIVE_SHIM_LITTLEFS_H
+#define NATIVE_SHIM_LITTLEFS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class NativeFS;
+
+class File {
+public:
+    File() : fs(nullptr), pos(0), writable(false) {}
+    File(NativeFS* fs, const std::string& path, std::vector<uint8_t> data, bool writable)
+        : fs(fs), path(path), data(data), pos(0), writable(writable) {}
+
+    explicit operator bool() const { return fs != nullptr; }
+
+    size_t read(uint8_t* buf, size_t len) {
+        if (!fs || pos >= data.size()) return 0;
+        size_t n = len < data.size() - pos ? len : data.size() - pos;
+        memcpy(buf, &data[pos], n);
+        pos += n;
+        return n;
+    }
+
+    size_t write(const uint8_t* buf, size_t len);
+    size_t write(uint8_t b) { return write(&b, 1); }
+
+    bool seek(uint32_t p) {
+        if (!fs || p > data.size()) return false;
+        pos = p;
+        return true;
+    }
+
+    size_t size() const { return data.size(); }
+    void close();
+
+private:
+    NativeFS* fs;
+    std::string path;
+    std::vector<uint8_t> data;
+    size_t pos;
+    bool writable;
+};
+
+class NativeFS {
+public:
+    std::map<std::string, std::vector<uint8_t>> files;
+    long writeBudget = -1;          // Bytes que ainda podem ser escritos (-1 = sem limite)
+    bool failRename = false;
+
+    bool begin(bool formatOnFail = false) { (void)formatOnFail; return true; }
+
+    File open(const char* path, const char* mode) {
+        std::string m(mode);
+        auto it = files.find(path);
+        if (m == "r") {
+            if (it == files.end()) return File();
+            return File(this, path, it->second, false);
+        }
+        if (m == "r+") {
+            if (it == files.end()) return File();
+            return File(this, path, it->second, true);
+        }
+        return File(this, path, std::vector<uint8_t>(), true);     // "w"
+    }
+
+    bool exists(const char* path) { return files.count(path) > 0; }
+    bool remove(const char* path) { return files.erase(path) > 0; }
+
+    bool rename(const char* from, const char* to) {
+        auto it = files.find(from);
+        if (failRename || it == files.end()) return false;
+        files[to] = it->second;
+        files.erase(from);
+        return true;
+    }
+
+    void reset() {
+        files.clear();
+        writeBudget = -1;
+        failRename = false;
+    }
+};
+
+inline NativeFS LittleFS;
+
+inline size_t File::write(const uint8_t* buf, size_t len) {
+    if (!fs || !writable) return 0;
+    if (fs->writeBudget >= 0 && (long)len > fs->writeBudget) len = (size_t)fs->writeBudget;
+    if (fs->writeBudget >= 0) fs->writeBudget -= (long)len;
+    if (pos + len > data.size()) data.resize(pos + len);
+    if (len) memcpy(&data[pos], buf, len);
+    pos += len;
+    return len;
+}
+
+inline void File::close() {
+    if (fs && writable) fs->files[path] = data;
+    fs = nullptr;
+}
+
+#endif // NATIVE_SHIM_LITTLEFS_H
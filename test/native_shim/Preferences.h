@@ -0,0 +1,76 @@
+/**
+ * @file Preferences.h
+ * @brief Shim do Preferences (NVS) em memória para os testes nativos (env:native)
+ *
+ * Como no core: begin() só leitura falha se o namespace não existe e
+ * getBytes() recusa buffer menor que o valor gravado. failPut simula a
+ * partição cheia.
+ */
+
+#ifndef NATIVE_SHIM_PREFERENCES_H
+#define NATIVE_SHIM_PREFERENCES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+struct NativeNvs {
+    std::map<std::string, std::map<std::string, std::vector<uint8_t>>> data;
+    bool failPut = false;
+
+    void reset() {
+        data.clear();
+        failPut = false;
+    }
+};
+
+inline NativeNvs native_nvs;
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        if (readOnly && !native_nvs.data.count(name)) return false;
+        ns = &native_nvs.data[name];
+        return true;
+    }
+
+    void end() { ns = nullptr; }
+
+    bool isKey(const char* key) { return ns && ns->count(key) > 0; }
+
+    bool remove(const char* key) { return ns && ns->erase(key) > 0; }
+
+    int32_t getInt(const char* key, int32_t def = 0) {
+        if (!isKey(key) || (*ns)[key].size() != sizeof(int32_t)) return def;
+        int32_t v;
+        memcpy(&v, (*ns)[key].data(), sizeof(v));
+        return v;
+    }
+
+    size_t putInt(const char* key, int32_t v) { return putBytes(key, &v, sizeof(v)); }
+
+    size_t getBytesLength(const char* key) { return isKey(key) ? (*ns)[key].size() : 0; }
+
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        if (!isKey(key)) return 0;
+        std::vector<uint8_t>& v = (*ns)[key];
+        if (v.size() > maxLen) return 0;
+        memcpy(buf, v.data(), v.size());
+        return v.size();
+    }
+
+    size_t putBytes(const char* key, const void* buf, size_t len) {
+        if (!ns || native_nvs.failPut) return 0;
+        const uint8_t* p = (const uint8_t*)buf;
+        (*ns)[key] = std::vector<uint8_t>(p, p + len);
+        return len;
+    }
+
+private:
+    std::map<std::string, std::vector<uint8_t>>* ns = nullptr;
+};
+
+#endif // NATIVE_SHIM_PREFERENCES_H
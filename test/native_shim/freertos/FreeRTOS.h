@@ -0,0 +1,33 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Shim do FreeRTOS para os testes nativos (env:native)
+ *
+ * Uma só thread no host: seções críticas viram no-op e vTaskDelay avança o
+ * relógio simulado (lido por millis()/micros() do Arduino.h deste diretório).
+ */
+
+#ifndef NATIVE_SHIM_FREERTOS_H
+#define NATIVE_SHIM_FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+
+typedef struct {
+    int owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    { 0 }
+#define portENTER_CRITICAL(mux)         ((void)(mux))
+#define portEXIT_CRITICAL(mux)          ((void)(mux))
+
+// Relógio simulado (1 tick = 1 ms)
+inline uint64_t native_now_us = 0;
+inline void (*native_delay_hook)(uint32_t ms) = nullptr;   // O teste avança o tempo (e a simulação)
+
+inline void vTaskDelay(TickType_t ticks) {
+    if (native_delay_hook) native_delay_hook(ticks);
+    else native_now_us += (uint64_t)ticks * 1000;
+}
+
+#endif // NATIVE_SHIM_FREERTOS_H
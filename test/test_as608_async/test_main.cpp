@@ -0,0 +1,500 @@
+/**
+ * @file test_main.cpp
+ * @brief Testes nativos do As608Async contra um AS608 simulado (pio test -e native)
+ * @version 1.1.0
+ * @date 2025-12-07
+ *
+ * O HardwareSerial do shim é uma UART virtual: o que o driver escreve vai
+ * para o sensor simulado abaixo, que monta os pacotes de comando e agenda
+ * os ACKs no relógio simulado. step() avança 1 ms, entrega os bytes que
+ * venceram (callback onReceive, como a tarefa de eventos da UART) e chama
+ * poll(), como o loop.
+ */
+
+#include <unity.h>
+#include <memory>
+#include "as608_async.h"
+
+// ═══════════════════════════════════════════════════════════════════════
+// AS608 SIMULADO
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Resposta roteirizada para o próximo comando 'cmd'
+ */
+struct SimReply {
+    uint8_t cmd;
+    uint8_t code;
+    std::vector<uint8_t> data;
+    uint32_t delayMs;
+    bool badChecksum;
+    bool drop;                  // Sensor não responde
+};
+
+struct SimPending {
+    uint64_t atUs;
+    std::vector<uint8_t> bytes;
+};
+
+struct SimCommand {
+    uint8_t cmd;
+    uint32_t atMs;
+};
+
+static HardwareSerial uart;
+static std::unique_ptr<As608Async> drv;
+static std::deque<SimReply> script;
+static std::vector<SimPending> outbox;
+static std::vector<SimCommand> received;
+static std::vector<uint8_t> hostBytes;
+
+// Templates: o que o UpChar devolve e o que chegou em pacotes de dados
+static std::vector<uint8_t> simTemplate;
+static uint16_t simPacketLen;
+static int simCorruptPacket;            // Pacote de dados do UpChar com soma errada (-1 = nenhum)
+static std::vector<uint8_t> sensorData;
+static int sensorDataPackets;
+
+static std::vector<uint8_t> simPacket(uint8_t pid, const std::vector<uint8_t>& body, bool badChecksum) {
+    uint16_t len = (uint16_t)(body.size() + 2);
+    std::vector<uint8_t> p = { 0xEF, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, pid,
+                               (uint8_t)(len >> 8), (uint8_t)len };
+    p.insert(p.end(), body.begin(), body.end());
+    uint16_t sum = pid + (len >> 8) + (len & 0xFF);
+    for (uint8_t b : body) sum += b;
+    if (badChecksum) sum ^= 0x5A;
+    p.push_back((uint8_t)(sum >> 8));
+    p.push_back((uint8_t)sum);
+    return p;
+}
+
+static std::vector<uint8_t> ackPacket(uint8_t code, const std::vector<uint8_t>& data, bool badChecksum) {
+    std::vector<uint8_t> body = { code };
+    body.insert(body.end(), data.begin(), data.end());
+    return simPacket(0x07, body, badChecksum);
+}
+
+/**
+ * @brief Resposta padrão (sem roteiro): dedo presente, match no slot 5
+ */
+static SimReply defaultReply(uint8_t cmd) {
+    SimReply r = { cmd, AS608_OK, {}, 5, false, false };
+    if (cmd == AS608_CMD_HISPEEDSEARCH) r.data = { 0x00, 0x05, 0x00, 100 };
+    if (cmd == AS608_CMD_MATCH) r.data = { 0x00, 80 };
+    return r;
+}
+
+static void simCommand(uint8_t cmd) {
+    received.push_back({ cmd, millis() });
+
+    SimReply r = defaultReply(cmd);
+    if (!script.empty() && script.front().cmd == cmd) {
+        r = script.front();
+        script.pop_front();
+    }
+    if (r.drop) return;
+    uint64_t at = native_now_us + (uint64_t)r.delayMs * 1000;
+    outbox.push_back({ at, ackPacket(r.code, r.data, r.badChecksum) });
+
+    // UpChar aceito: arquivo de característica em pacotes, 1 ms cada
+    if (cmd == AS608_CMD_UPCHAR && r.code == AS608_OK) {
+        int n = 0;
+        for (size_t off = 0; off < simTemplate.size(); off += simPacketLen, n++) {
+            size_t end = off + simPacketLen < simTemplate.size() ? off + simPacketLen : simTemplate.size();
+            std::vector<uint8_t> body(simTemplate.begin() + off, simTemplate.begin() + end);
+            at += 1000;
+            outbox.push_back({ at, simPacket(end == simTemplate.size() ? 0x08 : 0x02, body,
+                                             n == simCorruptPacket) });
+        }
+    }
+}
+
+/**
+ * @brief Lado do sensor da UART: monta os pacotes escritos pelo driver
+ */
+static void simWrite(const uint8_t* buf, size_t len) {
+    hostBytes.insert(hostBytes.end(), buf, buf + len);
+    while (hostBytes.size() >= 9) {
+        TEST_ASSERT_EQUAL_HEX8(0xEF, hostBytes[0]);
+        TEST_ASSERT_EQUAL_HEX8(0x01, hostBytes[1]);
+        size_t total = 9 + (((size_t)hostBytes[7] << 8) | hostBytes[8]);
+        if (hostBytes.size() < total) return;
+        if (hostBytes[6] == 0x01) simCommand(hostBytes[9]);
+        if (hostBytes[6] == 0x02 || hostBytes[6] == 0x08) {
+            sensorData.insert(sensorData.end(), hostBytes.begin() + 9, hostBytes.begin() + total - 2);
+            sensorDataPackets++;
+        }
+        hostBytes.erase(hostBytes.begin(), hostBytes.begin() + total);
+    }
+}
+
+static void simStep() {
+    native_now_us += 1000;
+    for (size_t i = 0; i < outbox.size();) {
+        if (outbox[i].atUs <= native_now_us) {
+            std::vector<uint8_t> bytes = outbox[i].bytes;
+            outbox.erase(outbox.begin() + i);
+            uart.inject(bytes.data(), bytes.size());
+        } else {
+            i++;
+        }
+    }
+}
+
+static void simDelay(uint32_t ms) {
+    while (ms--) simStep();
+}
+
+static void step(uint32_t ms = 1) {
+    while (ms--) {
+        simStep();
+        drv->poll();
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// CAPTURA DOS CALLBACKS
+// ═══════════════════════════════════════════════════════════════════════
+
+static bool replyDone;
+static As608Reply lastReply;
+static int searchDone;
+static As608SearchResult lastSearch;
+static bool restartOnFinish;
+
+static void onReply(const As608Reply& r, void*) {
+    lastReply = r;
+    replyDone = true;
+}
+
+static void onSearch(const As608SearchResult& r, void*) {
+    lastSearch = r;
+    searchDone++;
+    // Como o TemplateArchive/verificação contínua: próximo comando já no callback
+    if (restartOnFinish) {
+        restartOnFinish = false;
+        TEST_ASSERT_TRUE(drv->startSearch(1, 10, onSearch, nullptr));
+    }
+}
+
+static void runUntil(bool (*done)(), uint32_t maxMs) {
+    for (uint32_t i = 0; i < maxMs && !done(); i++) step();
+}
+
+static bool isReplyDone() { return replyDone; }
+static bool isSearchDone() { return searchDone > 0; }
+static bool isSecondSearchDone() { return searchDone > 1; }
+
+static void injectAck(uint8_t code, const std::vector<uint8_t>& data, bool badChecksum = false) {
+    std::vector<uint8_t> p = ackPacket(code, data, badChecksum);
+    uart.inject(p.data(), p.size());
+}
+
+void setUp() {
+    native_now_us = 1000000;
+    native_delay_hook = simDelay;
+    script.clear();
+    outbox.clear();
+    received.clear();
+    hostBytes.clear();
+    simTemplate.clear();
+    for (int i = 0; i < 512; i++) simTemplate.push_back((uint8_t)(i * 7 + 3));
+    simPacketLen = 128;
+    simCorruptPacket = -1;
+    sensorData.clear();
+    sensorDataPackets = 0;
+    replyDone = false;
+    searchDone = 0;
+    restartOnFinish = false;
+    memset(&lastReply, 0, sizeof(lastReply));
+    memset(&lastSearch, 0, sizeof(lastSearch));
+
+    uart.reset();
+    uart.onWrite = simWrite;
+    drv.reset(new As608Async());
+    drv->begin(&uart);
+}
+
+void tearDown() {
+    drv.reset();
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// PARSER DE PACOTES
+// ═══════════════════════════════════════════════════════════════════════
+
+void test_parser_fragmented_frame_after_noise() {
+    script.push_back({ AS608_CMD_GENIMG, 0, {}, 0, false, true });
+    TEST_ASSERT_TRUE(drv->send(AS608_CMD_GENIMG, nullptr, 0, AS608_ASYNC_CMD_TIMEOUT_MS, onReply, nullptr));
+
+    const uint8_t noise[] = { 0x00, 0xEF, 0x55, 0x01 };
+    uart.inject(noise, sizeof(noise));
+    std::vector<uint8_t> p = ackPacket(AS608_OK, {}, false);
+    for (uint8_t b : p) {
+        uart.inject(&b, 1);
+        TEST_ASSERT_FALSE(replyDone);
+    }
+    step();
+
+    TEST_ASSERT_TRUE(replyDone);
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastReply.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_GENIMG, lastReply.command);
+    TEST_ASSERT_EQUAL_HEX8(AS608_OK, lastReply.code);
+    TEST_ASSERT_FALSE(drv->busy());
+}
+
+void test_parser_bad_checksum() {
+    script.push_back({ AS608_CMD_GENIMG, AS608_OK, {}, 5, true, false });
+    TEST_ASSERT_TRUE(drv->send(AS608_CMD_GENIMG, nullptr, 0, AS608_ASYNC_CMD_TIMEOUT_MS, onReply, nullptr));
+    runUntil(isReplyDone, 50);
+
+    TEST_ASSERT_TRUE(replyDone);
+    TEST_ASSERT_EQUAL(AS608_REPLY_BAD_FRAME, lastReply.transport);
+    TEST_ASSERT_EQUAL_UINT32(1, drv->badFrameCount());
+}
+
+void test_parser_ack_length_checked_against_command() {
+    script.push_back({ AS608_CMD_HISPEEDSEARCH, 0, {}, 0, false, true });
+    const uint8_t p[] = { 1, 0, 1, 0, 10 };
+    TEST_ASSERT_TRUE(drv->send(AS608_CMD_HISPEEDSEARCH, p, sizeof(p), AS608_ASYNC_SEARCH_TIMEOUT_MS, onReply, nullptr));
+
+    injectAck(AS608_NOFINGER, {});                  // ACK de GenImg fora de hora
+    step();
+    TEST_ASSERT_FALSE(replyDone);
+
+    injectAck(AS608_OK, { 0x00, 0x07, 0x00, 0x42 });
+    step();
+    TEST_ASSERT_TRUE(replyDone);
+    TEST_ASSERT_EQUAL_HEX8(AS608_OK, lastReply.code);
+    TEST_ASSERT_EQUAL_UINT8(4, lastReply.dataLen);
+    TEST_ASSERT_EQUAL_HEX8(0x07, lastReply.data[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, drv->staleCount());
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// PIPELINE GENIMG → IMG2TZ → SEARCH
+// ═══════════════════════════════════════════════════════════════════════
+
+void test_search_match() {
+    TEST_ASSERT_TRUE(drv->startSearch(1, 10, onSearch, nullptr));
+    runUntil(isSearchDone, 100);
+
+    TEST_ASSERT_EQUAL(1, searchDone);
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastSearch.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_HISPEEDSEARCH, lastSearch.stage);
+    TEST_ASSERT_EQUAL_HEX8(AS608_OK, lastSearch.code);
+    TEST_ASSERT_TRUE(lastSearch.fingerSeen);
+    TEST_ASSERT_EQUAL_UINT16(5, lastSearch.id);
+    TEST_ASSERT_EQUAL_UINT16(100, lastSearch.score);
+
+    TEST_ASSERT_EQUAL(3, (int)received.size());
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_GENIMG, received[0].cmd);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_IMG2TZ, received[1].cmd);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_HISPEEDSEARCH, received[2].cmd);
+}
+
+void test_search_no_finger() {
+    script.push_back({ AS608_CMD_GENIMG, AS608_NOFINGER, {}, 5, false, false });
+    TEST_ASSERT_TRUE(drv->startSearch(1, 10, onSearch, nullptr));
+    runUntil(isSearchDone, 100);
+
+    TEST_ASSERT_EQUAL(1, searchDone);
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastSearch.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_GENIMG, lastSearch.stage);
+    TEST_ASSERT_EQUAL_HEX8(AS608_NOFINGER, lastSearch.code);
+    TEST_ASSERT_FALSE(lastSearch.fingerSeen);
+    TEST_ASSERT_EQUAL(1, (int)received.size());
+}
+
+void test_search_not_found() {
+    script.push_back({ AS608_CMD_HISPEEDSEARCH, AS608_NOTFOUND, { 0, 0, 0, 0 }, 5, false, false });
+    TEST_ASSERT_TRUE(drv->startSearch(1, 10, onSearch, nullptr));
+    runUntil(isSearchDone, 100);
+
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastSearch.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_HISPEEDSEARCH, lastSearch.stage);
+    TEST_ASSERT_EQUAL_HEX8(AS608_NOTFOUND, lastSearch.code);
+    TEST_ASSERT_TRUE(lastSearch.fingerSeen);
+    TEST_ASSERT_EQUAL_UINT16(0, lastSearch.id);
+}
+
+void test_search_timeout() {
+    script.push_back({ AS608_CMD_IMG2TZ, 0, {}, 0, false, true });
+    TEST_ASSERT_TRUE(drv->startSearch(1, 10, onSearch, nullptr));
+    runUntil(isSearchDone, AS608_ASYNC_CMD_TIMEOUT_MS + 100);
+
+    TEST_ASSERT_EQUAL(1, searchDone);
+    TEST_ASSERT_EQUAL(AS608_REPLY_TIMEOUT, lastSearch.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_IMG2TZ, lastSearch.stage);
+    TEST_ASSERT_EQUAL_UINT32(1, drv->timeoutCount());
+    TEST_ASSERT_FALSE(drv->busy());
+}
+
+void test_late_ack_not_taken_by_next_command() {
+    // GenImg responde (sem dedo) depois do timeout; a nova busca sai no callback
+    script.push_back({ AS608_CMD_GENIMG, AS608_NOFINGER, {}, AS608_ASYNC_CMD_TIMEOUT_MS + 100, false, false });
+    restartOnFinish = true;
+    TEST_ASSERT_TRUE(drv->startSearch(1, 10, onSearch, nullptr));
+    runUntil(isSecondSearchDone, 2 * AS608_ASYNC_CMD_TIMEOUT_MS);
+
+    TEST_ASSERT_EQUAL(2, searchDone);
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastSearch.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_OK, lastSearch.code);
+    TEST_ASSERT_EQUAL_UINT16(5, lastSearch.id);
+    TEST_ASSERT_TRUE(drv->staleCount() >= 1);
+
+    // O segundo GenImg só foi escrito depois da janela de ACK atrasado
+    TEST_ASSERT_EQUAL(4, (int)received.size());
+    TEST_ASSERT_TRUE(received[1].atMs - received[0].atMs >= AS608_ASYNC_CMD_TIMEOUT_MS + AS608_ASYNC_LATE_MS);
+}
+
+void test_match_one_to_one() {
+    TEST_ASSERT_TRUE(drv->startMatch(7, onSearch, nullptr));
+    runUntil(isSearchDone, 100);
+
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastSearch.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_MATCH, lastSearch.stage);
+    TEST_ASSERT_EQUAL_UINT16(7, lastSearch.id);
+    TEST_ASSERT_EQUAL_UINT16(80, lastSearch.score);
+    TEST_ASSERT_EQUAL(4, (int)received.size());
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_LOADCHAR, received[2].cmd);
+}
+
+void test_wait_idle_covers_late_window() {
+    script.push_back({ AS608_CMD_GENIMG, 0, {}, 0, false, true });
+    TEST_ASSERT_TRUE(drv->send(AS608_CMD_GENIMG, nullptr, 0, AS608_ASYNC_CMD_TIMEOUT_MS, onReply, nullptr));
+    runUntil(isReplyDone, AS608_ASYNC_CMD_TIMEOUT_MS + 10);
+    TEST_ASSERT_EQUAL(AS608_REPLY_TIMEOUT, lastReply.transport);
+
+    uint32_t t0 = millis();
+    TEST_ASSERT_TRUE(drv->waitIdle(AS608_ASYNC_LATE_MS * 2));
+    TEST_ASSERT_TRUE(millis() - t0 >= AS608_ASYNC_LATE_MS - 10);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// TRANSFERÊNCIA DE TEMPLATES (UPCHAR / DOWNCHAR)
+// ═══════════════════════════════════════════════════════════════════════
+
+static uint8_t xferBuf[AS608_TEMPLATE_MAX];
+
+void test_upload_pipelined_data_packets() {
+    memset(xferBuf, 0, sizeof(xferBuf));
+    TEST_ASSERT_TRUE(drv->upload(7, xferBuf, sizeof(xferBuf), AS608_ASYNC_CMD_TIMEOUT_MS, onReply, nullptr));
+    runUntil(isReplyDone, 100);
+
+    TEST_ASSERT_TRUE(replyDone);
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastReply.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_UPCHAR, lastReply.command);
+    TEST_ASSERT_EQUAL_HEX8(AS608_OK, lastReply.code);
+    TEST_ASSERT_EQUAL_UINT16(512, lastReply.bulkLen);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(simTemplate.data(), xferBuf, 512);
+
+    // LoadChar e UpChar escritos juntos, sem esperar o 1º ACK
+    TEST_ASSERT_EQUAL(2, (int)received.size());
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_LOADCHAR, received[0].cmd);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_UPCHAR, received[1].cmd);
+    TEST_ASSERT_EQUAL_UINT32(received[0].atMs, received[1].atMs);
+}
+
+void test_upload_bad_data_packet_then_step_by_step() {
+    // 2º pacote de dados corrompido: TemplateArchive repete passo a passo
+    simCorruptPacket = 1;
+    TEST_ASSERT_TRUE(drv->upload(7, xferBuf, sizeof(xferBuf), AS608_ASYNC_CMD_TIMEOUT_MS, onReply, nullptr));
+    runUntil(isReplyDone, 100);
+
+    TEST_ASSERT_EQUAL(AS608_REPLY_BAD_FRAME, lastReply.transport);
+    TEST_ASSERT_EQUAL_UINT16(128, lastReply.bulkLen);
+    TEST_ASSERT_FALSE(drv->busy());
+
+    // Repetição no próprio ciclo: pacotes restantes ainda chegando
+    simCorruptPacket = -1;
+    replyDone = false;
+    memset(xferBuf, 0, sizeof(xferBuf));
+    TEST_ASSERT_TRUE(drv->upload(7, xferBuf, sizeof(xferBuf), AS608_ASYNC_CMD_TIMEOUT_MS, onReply, nullptr, false));
+    runUntil(isReplyDone, AS608_ASYNC_LATE_MS + 100);
+
+    TEST_ASSERT_TRUE(replyDone);
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastReply.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_UPCHAR, lastReply.command);
+    TEST_ASSERT_EQUAL_UINT16(512, lastReply.bulkLen);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(simTemplate.data(), xferBuf, 512);
+
+    // Passo a passo: UpChar só depois do ACK do LoadChar
+    TEST_ASSERT_EQUAL(4, (int)received.size());
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_LOADCHAR, received[2].cmd);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_UPCHAR, received[3].cmd);
+    TEST_ASSERT_TRUE(received[3].atMs > received[2].atMs);
+}
+
+void test_download_store_pipelined() {
+    TEST_ASSERT_TRUE(drv->download(9, simTemplate.data(), 512, 128, AS608_ASYNC_CMD_TIMEOUT_MS,
+                                   onReply, nullptr));
+    runUntil(isReplyDone, 100);
+
+    TEST_ASSERT_TRUE(replyDone);
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastReply.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_STORE, lastReply.command);
+    TEST_ASSERT_EQUAL_HEX8(AS608_OK, lastReply.code);
+
+    // DownChar, 4 pacotes (último = fim) e Store na mesma escrita
+    TEST_ASSERT_EQUAL(2, (int)received.size());
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_DOWNCHAR, received[0].cmd);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_STORE, received[1].cmd);
+    TEST_ASSERT_EQUAL_UINT32(received[0].atMs, received[1].atMs);
+    TEST_ASSERT_EQUAL(4, sensorDataPackets);
+    TEST_ASSERT_EQUAL(512, (int)sensorData.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(simTemplate.data(), sensorData.data(), 512);
+}
+
+void test_download_failure_mid_transfer_then_step_by_step() {
+    // Sensor não recebeu os pacotes (0x0E); o ACK do Store ainda vem depois
+    script.push_back({ AS608_CMD_DOWNCHAR, 0x0E, {}, 5, false, false });
+    script.push_back({ AS608_CMD_STORE, 0x0E, {}, 10, false, false });
+    TEST_ASSERT_TRUE(drv->download(9, simTemplate.data(), 512, 128, AS608_ASYNC_CMD_TIMEOUT_MS,
+                                   onReply, nullptr));
+    runUntil(isReplyDone, 100);
+
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastReply.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_DOWNCHAR, lastReply.command);
+    TEST_ASSERT_EQUAL_HEX8(0x0E, lastReply.code);
+
+    // Repetição passo a passo: o ACK atrasado do Store não vale como DownChar
+    replyDone = false;
+    sensorData.clear();
+    sensorDataPackets = 0;
+    TEST_ASSERT_TRUE(drv->download(9, simTemplate.data(), 512, 128, AS608_ASYNC_CMD_TIMEOUT_MS,
+                                   onReply, nullptr, false));
+    runUntil(isReplyDone, AS608_ASYNC_LATE_MS + 100);
+
+    TEST_ASSERT_TRUE(replyDone);
+    TEST_ASSERT_EQUAL(AS608_REPLY_OK, lastReply.transport);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_STORE, lastReply.command);
+    TEST_ASSERT_EQUAL_HEX8(AS608_OK, lastReply.code);
+    TEST_ASSERT_TRUE(drv->staleCount() >= 1);
+
+    TEST_ASSERT_EQUAL(4, (int)received.size());
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_DOWNCHAR, received[2].cmd);
+    TEST_ASSERT_EQUAL_HEX8(AS608_CMD_STORE, received[3].cmd);
+    TEST_ASSERT_TRUE(received[3].atMs > received[2].atMs);
+    TEST_ASSERT_EQUAL(4, sensorDataPackets);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(simTemplate.data(), sensorData.data(), 512);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_parser_fragmented_frame_after_noise);
+    RUN_TEST(test_parser_bad_checksum);
+    RUN_TEST(test_parser_ack_length_checked_against_command);
+    RUN_TEST(test_search_match);
+    RUN_TEST(test_search_no_finger);
+    RUN_TEST(test_search_not_found);
+    RUN_TEST(test_search_timeout);
+    RUN_TEST(test_late_ack_not_taken_by_next_command);
+    RUN_TEST(test_match_one_to_one);
+    RUN_TEST(test_wait_idle_covers_late_window);
+    RUN_TEST(test_upload_pipelined_data_packets);
+    RUN_TEST(test_upload_bad_data_packet_then_step_by_step);
+    RUN_TEST(test_download_store_pipelined);
+    RUN_TEST(test_download_failure_mid_transfer_then_step_by_step);
+    return UNITY_END();
+}
@@ -0,0 +1,269 @@
+/**
+ * @file test_main.cpp
+ * @brief Testes nativos da RecordTable: migração do NVS e gravação no lugar (pio test -e native)
+ * @version 1.0.0
+ * @date 2025-12-07
+ *
+ * LittleFS e Preferences são os shims em memória de test/native_shim, com
+ * falhas injetáveis. O registro imita o RFIDCard (v6.1.17: finger_slot no
+ * fim, ausente nos registros antigos do NVS).
+ */
+
+#include <unity.h>
+#include <LittleFS.h>
+#include <Preferences.h>
+#include "record_table.h"
+
+#define TEST_FILE       "/rfid_table.bin"
+#define TEST_TMP        "/rfid_table.tmp"
+#define TEST_MAGIC      0x52464331
+#define TEST_MAX        8
+
+struct __attribute__((packed)) TestCard {
+    uint8_t uid[8];
+    uint8_t uid_length;
+    char name[20];
+    uint32_t timestamp;
+    bool active;
+    uint16_t access_count;
+    uint32_t last_access;
+    uint16_t finger_slot;
+};
+
+static TestCard cards[TEST_MAX];
+
+static RecordTable cardTable() {
+    return RecordTable(TEST_FILE, TEST_TMP, TEST_MAGIC, sizeof(TestCard), TEST_MAX, "rfid_cards", "card_");
+}
+
+static TestCard makeCard(uint8_t n) {
+    TestCard c;
+    memset(&c, 0, sizeof(c));
+    for (int i = 0; i < 4; i++) c.uid[i] = (uint8_t)(n * 16 + i);
+    c.uid_length = 4;
+    snprintf(c.name, sizeof(c.name), "Cartao %u", n);
+    c.timestamp = 1000 + n;
+    c.active = true;
+    c.access_count = n;
+    c.finger_slot = n;
+    return c;
+}
+
+/**
+ * @brief Formato antigo: "count" + card_N no namespace rfid_cards
+ */
+static void putLegacyCards(uint8_t n, size_t recordLen = sizeof(TestCard)) {
+    Preferences prefs;
+    prefs.begin("rfid_cards", false);
+    prefs.putInt("count", n);
+    for (uint8_t i = 0; i < n; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "card_%u", i);
+        TestCard c = makeCard(i);
+        prefs.putBytes(key, &c, recordLen);
+    }
+    prefs.end();
+}
+
+static bool legacyKey(const char* key) {
+    Preferences prefs;
+    if (!prefs.begin("rfid_cards", true)) return false;
+    bool found = prefs.isKey(key);
+    prefs.end();
+    return found;
+}
+
+void setUp() {
+    LittleFS.reset();
+    native_nvs.reset();
+    memset(cards, 0, sizeof(cards));
+}
+
+void tearDown() {
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// MIGRAÇÃO DO NVS
+// ═══════════════════════════════════════════════════════════════════════
+
+void test_migrates_legacy_keys_to_table() {
+    putLegacyCards(3);
+
+    RecordTable table = cardTable();
+    TEST_ASSERT_EQUAL(3, table.load(cards));
+    for (uint8_t i = 0; i < 3; i++) {
+        TestCard expected = makeCard(i);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(&expected, &cards[i], sizeof(TestCard));
+    }
+
+    // Arquivo confirmado: chaves antigas removidas
+    TEST_ASSERT_TRUE(LittleFS.exists(TEST_FILE));
+    TEST_ASSERT_FALSE(LittleFS.exists(TEST_TMP));
+    TEST_ASSERT_FALSE(table.legacyPending());
+    TEST_ASSERT_FALSE(legacyKey("count"));
+    TEST_ASSERT_FALSE(legacyKey("card_0"));
+    TEST_ASSERT_FALSE(legacyKey("card_2"));
+
+    // Próximo boot lê só o arquivo
+    memset(cards, 0, sizeof(cards));
+    RecordTable reboot = cardTable();
+    TEST_ASSERT_EQUAL(3, reboot.load(cards));
+    TestCard expected = makeCard(2);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(&expected, &cards[2], sizeof(TestCard));
+}
+
+void test_legacy_short_records_zero_filled() {
+    // Gravados antes de finger_slot existir
+    putLegacyCards(2, sizeof(TestCard) - sizeof(uint16_t));
+
+    RecordTable table = cardTable();
+    TEST_ASSERT_EQUAL(2, table.load(cards));
+    TEST_ASSERT_EQUAL_UINT16(0, cards[1].finger_slot);
+    TEST_ASSERT_EQUAL_UINT16(1, cards[1].access_count);
+    TEST_ASSERT_EQUAL_STRING("Cartao 1", cards[1].name);
+}
+
+void test_migration_rolls_back_when_write_fails() {
+    putLegacyCards(3);
+
+    // LittleFS sem espaço: nada pode sair do NVS
+    LittleFS.writeBudget = 4;
+    RecordTable table = cardTable();
+    TEST_ASSERT_EQUAL(3, table.load(cards));
+    TEST_ASSERT_TRUE(table.legacyPending());
+    TEST_ASSERT_FALSE(LittleFS.exists(TEST_FILE));
+    TEST_ASSERT_FALSE(LittleFS.exists(TEST_TMP));
+    TEST_ASSERT_TRUE(legacyKey("count"));
+    TEST_ASSERT_TRUE(legacyKey("card_2"));
+
+    // Alteração durante a falha vai para o formato antigo (remoção do último)
+    strcpy(cards[0].name, "Editado");
+    TEST_ASSERT_TRUE(table.save(cards, 2));
+    TEST_ASSERT_FALSE(legacyKey("card_2"));
+
+    // Boot com o LittleFS de volta: migra a versão editada
+    LittleFS.writeBudget = -1;
+    memset(cards, 0, sizeof(cards));
+    RecordTable reboot = cardTable();
+    TEST_ASSERT_EQUAL(2, reboot.load(cards));
+    TEST_ASSERT_EQUAL_STRING("Editado", cards[0].name);
+    TEST_ASSERT_FALSE(reboot.legacyPending());
+    TEST_ASSERT_TRUE(LittleFS.exists(TEST_FILE));
+    TEST_ASSERT_FALSE(legacyKey("count"));
+}
+
+void test_migration_fails_everywhere_reports_false() {
+    putLegacyCards(2);
+    LittleFS.writeBudget = 0;
+
+    RecordTable table = cardTable();
+    TEST_ASSERT_EQUAL(2, table.load(cards));
+    native_nvs.failPut = true;
+    TEST_ASSERT_FALSE(table.save(cards, 2));
+    TEST_ASSERT_TRUE(legacyKey("card_1"));
+}
+
+void test_migrates_legacy_blob() {
+    TestCard blob[3] = { makeCard(0), makeCard(1), makeCard(2) };
+    Preferences prefs;
+    prefs.begin("fingerprints", false);
+    prefs.putBytes("fp_table", blob, sizeof(blob));
+    prefs.end();
+
+    RecordTable table("/bio_table.bin", "/bio_table.tmp", 0x46505431, sizeof(TestCard), TEST_MAX,
+                      "fingerprints", "fp_", "fp_table");
+    TEST_ASSERT_EQUAL(3, table.load(cards));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(blob, cards, sizeof(blob));
+    TEST_ASSERT_TRUE(LittleFS.exists("/bio_table.bin"));
+
+    prefs.begin("fingerprints", true);
+    TEST_ASSERT_FALSE(prefs.isKey("fp_table"));
+    prefs.end();
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// GRAVAÇÃO NO LUGAR
+// ═══════════════════════════════════════════════════════════════════════
+
+void test_save_record_in_place_and_append() {
+    RecordTable table = cardTable();
+    TEST_ASSERT_EQUAL(0, table.load(cards));
+    for (uint8_t i = 0; i < 3; i++) cards[i] = makeCard(i);
+    TEST_ASSERT_TRUE(table.save(cards, 3));
+    size_t size = LittleFS.files[TEST_FILE].size();
+
+    // Acesso: só o registro 1 (arquivo não muda de tamanho nem passa pelo .tmp)
+    cards[1].access_count = 77;
+    LittleFS.failRename = true;
+    TEST_ASSERT_TRUE(table.saveRecord(cards, 3, 1));
+    TEST_ASSERT_EQUAL(size, LittleFS.files[TEST_FILE].size());
+
+    // Inclusão no fim: registro + cabeçalho
+    cards[3] = makeCard(3);
+    TEST_ASSERT_TRUE(table.saveRecord(cards, 4, 3));
+
+    TestCard loaded[TEST_MAX];
+    RecordTable reboot = cardTable();
+    TEST_ASSERT_EQUAL(4, reboot.load(loaded));
+    TEST_ASSERT_EQUAL_UINT16(77, loaded[1].access_count);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(&cards[3], &loaded[3], sizeof(TestCard));
+}
+
+void test_in_place_failure_reported_then_full_rewrite() {
+    RecordTable table = cardTable();
+    table.load(cards);
+    for (uint8_t i = 0; i < 3; i++) cards[i] = makeCard(i);
+    TEST_ASSERT_TRUE(table.save(cards, 3));
+
+    cards[2].active = false;
+    LittleFS.writeBudget = 2;
+    TEST_ASSERT_FALSE(table.saveRecord(cards, 3, 2));
+
+    // Depois da falha a próxima gravação regrava a tabela inteira
+    LittleFS.writeBudget = -1;
+    LittleFS.failRename = true;
+    TEST_ASSERT_FALSE(table.saveRecord(cards, 3, 2));
+    LittleFS.failRename = false;
+    TEST_ASSERT_TRUE(table.saveRecord(cards, 3, 2));
+
+    TestCard loaded[TEST_MAX];
+    RecordTable reboot = cardTable();
+    TEST_ASSERT_EQUAL(3, reboot.load(loaded));
+    TEST_ASSERT_FALSE(loaded[2].active);
+}
+
+void test_rename_failure_keeps_previous_table() {
+    RecordTable table = cardTable();
+    table.load(cards);
+    for (uint8_t i = 0; i < 3; i++) cards[i] = makeCard(i);
+    TEST_ASSERT_TRUE(table.save(cards, 3));
+
+    // Remoção = regravação completa; rename falhou: tabela anterior intacta
+    LittleFS.failRename = true;
+    TEST_ASSERT_FALSE(table.save(cards, 2));
+    TEST_ASSERT_FALSE(LittleFS.exists(TEST_TMP));
+
+    TestCard loaded[TEST_MAX];
+    RecordTable reboot = cardTable();
+    TEST_ASSERT_EQUAL(3, reboot.load(loaded));
+}
+
+void test_corrupt_file_ignored() {
+    LittleFS.files[TEST_FILE] = { 0x00, 0x01, 0x02 };
+    RecordTable table = cardTable();
+    TEST_ASSERT_EQUAL(0, table.load(cards));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_migrates_legacy_keys_to_table);
+    RUN_TEST(test_legacy_short_records_zero_filled);
+    RUN_TEST(test_migration_rolls_back_when_write_fails);
+    RUN_TEST(test_migration_fails_everywhere_reports_false);
+    RUN_TEST(test_migrates_legacy_blob);
+    RUN_TEST(test_save_record_in_place_and_append);
+    RUN_TEST(test_in_place_failure_reported_then_full_rewrite);
+    RUN_TEST(test_rename_failure_keeps_previous_table);
+    RUN_TEST(test_corrupt_file_ignored);
+    return UNITY_END();
+}